@@ -16,6 +16,7 @@
 #include "unit.h"
 #include "map.h"
 #include "faction_type.h"
+#include "config.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Graphics;
@@ -232,6 +233,111 @@ UpgradeTask * UpgradeTask::loadGame(const XmlNode *rootNode, Faction *faction) {
 	return newTask;
 }
 
+// =====================================================
+// 	class AiRuleTiming
+// =====================================================
+
+const int64 AiRuleTiming::bucketLimitsMicros[AiRuleTiming::bucketCount - 1] = { 100, 500, 1000, 5000, 20000 };
+
+AiRuleTiming::AiRuleTiming() {
+	for(int i = 0; i < bucketCount; ++i) {
+		buckets[i] = 0;
+	}
+	runCount	= 0;
+	totalMicros	= 0;
+	maxMicros	= 0;
+}
+
+void AiRuleTiming::addRun(int64 micros) {
+	int bucketIndex = 0;
+	for(; bucketIndex < bucketCount - 1; ++bucketIndex) {
+		if(micros < bucketLimitsMicros[bucketIndex]) {
+			break;
+		}
+	}
+	buckets[bucketIndex]++;
+
+	runCount++;
+	totalMicros += micros;
+	if(micros > maxMicros) {
+		maxMicros = micros;
+	}
+}
+
+string AiRuleTiming::toString() const {
+	string result = "runs: " + intToStr(runCount) +
+			" avg us: " + intToStr(runCount > 0 ? totalMicros / runCount : 0) +
+			" max us: " + intToStr(maxMicros) + " [";
+	for(int i = 0; i < bucketCount; ++i) {
+		if(i > 0) {
+			result += ", ";
+		}
+		if(i < bucketCount - 1) {
+			result += "<" + intToStr(bucketLimitsMicros[i]);
+		}
+		else {
+			result += ">=" + intToStr(bucketLimitsMicros[bucketCount - 2]);
+		}
+		result += ": " + intToStr(buckets[i]);
+	}
+	result += "]";
+	return result;
+}
+
+// =====================================================
+// 	class AiRuleScheduler
+// =====================================================
+
+AiRuleScheduler::AiRuleScheduler() {
+	mutex				= new Mutex(CODE_AT_LINE);
+	frameBudgetMicros	= 0;
+	budgetFrame			= -1;
+	budgetSpentMicros	= 0;
+
+	setFrameBudgetMillis(Config::getInstance().getInt("AiRuleFrameBudgetMillis","0"));
+}
+
+AiRuleScheduler::~AiRuleScheduler() {
+	delete mutex;
+	mutex = NULL;
+}
+
+void AiRuleScheduler::setFrameBudgetMillis(int millis) {
+	frameBudgetMicros = (millis > 0 ? (int64)millis * 1000 : 0);
+}
+
+bool AiRuleScheduler::hasBudgetLeft(int frame) {
+	if(isBudgetEnabled() == false) {
+		return true;
+	}
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	if(frame != budgetFrame) {
+		return true;
+	}
+	return (budgetSpentMicros < frameBudgetMicros);
+}
+
+void AiRuleScheduler::consumeBudget(int frame, int64 micros) {
+	if(isBudgetEnabled() == false) {
+		return;
+	}
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	if(frame != budgetFrame) {
+		budgetFrame			= frame;
+		budgetSpentMicros	= 0;
+	}
+	budgetSpentMicros += micros;
+}
+
+// Spreads the factions evenly over the rule interval and offsets each rule
+// so the heavy rules of all AI players don't test on the same frame
+int AiRuleScheduler::getRulePhase(int factionIndex, int ruleIndex, int intervalFrames) {
+	if(intervalFrames <= 1) {
+		return 0;
+	}
+	return (factionIndex * intervalFrames / GameConstants::maxPlayers + ruleIndex) % intervalFrames;
+}
+
 // =====================================================
 // 	class Ai
 // =====================================================
@@ -314,6 +420,12 @@ void Ai::init(AiInterface *aiInterface, int useStartLocation) {
 	aiRules.push_back(new AiRuleExpand(this));
 	aiRules.push_back(new AiRuleRepair(this));
 	aiRules.push_back(new AiRuleRepair(this));
+
+	ruleTimings.clear();
+	ruleTimings.resize(aiRules.size());
+	ruleDeferred.clear();
+	ruleDeferred.resize(aiRules.size(),false);
+	deferredRules.clear();
 }
 
 Ai::~Ai() {
@@ -394,37 +506,81 @@ void Ai::update() {
 	}
 
 	//process ai rules
+	AiRuleScheduler *scheduler = aiInterface->getRuleScheduler();
+	const int frame = aiInterface->getWorld()->getFrameCount();
+
+	// Rules deferred by the frame budget run first, then the rules due this frame
+	vector<int> runRules;
+	runRules.swap(deferredRules);
 	for(unsigned int ruleIdx = 0; ruleIdx < aiRules.size(); ++ruleIdx) {
-		AiRule *rule = aiRules[ruleIdx];
-		if(rule == NULL) {
+		if(aiRules[ruleIdx] == NULL) {
 			throw megaglest_runtime_error("rule == NULL");
 		}
+		if(ruleDeferred[ruleIdx] == false && isRuleDue(ruleIdx) == true) {
+			runRules.push_back(ruleIdx);
+		}
+	}
+
+	for(unsigned int runIdx = 0; runIdx < runRules.size(); ++runIdx) {
+		int ruleIdx = runRules[runIdx];
+
+		// Each faction always gets one rule per frame so nobody starves
+		if(runIdx > 0 && scheduler != NULL && scheduler->hasBudgetLeft(frame) == false) {
+			ruleDeferred[ruleIdx] = true;
+			deferredRules.push_back(ruleIdx);
+			continue;
+		}
+		ruleDeferred[ruleIdx] = false;
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis(),ruleIdx);
-        // Determines wether to process AI rules. Whether a particular rule is processed, is weighted by getTestInterval().
-        // Values returned by getTestInterval() are defined in ai_rule.h.
-		if((aiInterface->getTimer() % (rule->getTestInterval() * GameConstants::updateFps / 1000)) == 0) {
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d, before runRule()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis(),ruleIdx);
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d, before rule->test()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis(),ruleIdx);
+		runRule(ruleIdx, scheduler, frame);
 
-			//printf("Testing AI Faction # %d RULE Name[%s]\n",aiInterface->getFactionIndex(),rule->getName().c_str());
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d, after runRule() [%s]]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis(),ruleIdx,aiRules[ruleIdx]->getName().c_str());
+	}
 
-            // Test to see if AI can execute rule e.g. is there a worker available to for harvesting wood?
-			if(rule->test()) {
-				if(outputAIBehaviourToConsole()) printf("\n\nYYYYY Executing AI Faction # %d RULE Name[%s]\n\n",aiInterface->getFactionIndex(),rule->getName().c_str());
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld [END]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+}
 
-				aiInterface->printLog(3, intToStr(1000 * aiInterface->getTimer() / GameConstants::updateFps) + ": Executing rule: " + rule->getName() + '\n');
+bool Ai::isRuleDue(int ruleIdx) const {
+	// Determines wether to process AI rules. Whether a particular rule is processed, is weighted by getTestInterval().
+	// Values returned by getTestInterval() are defined in ai_rule.h.
+	int intervalFrames = max(1, aiRules[ruleIdx]->getTestInterval() * GameConstants::updateFps / 1000);
+	int phase = AiRuleScheduler::getRulePhase(aiInterface->getFactionIndex(), ruleIdx, intervalFrames);
+	return ((aiInterface->getTimer() + phase) % intervalFrames) == 0;
+}
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d, before rule->execute() [%s]]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis(),ruleIdx,rule->getName().c_str());
-               // Execute the rule.
-				rule->execute();
+void Ai::runRule(int ruleIdx, AiRuleScheduler *scheduler, int frame) {
+	AiRule *rule = aiRules[ruleIdx];
+	Chrono chronoRule(true);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld [ruleIdx = %d, after rule->execute() [%s]]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis(),ruleIdx,rule->getName().c_str());
-			}
-		}
+	//printf("Testing AI Faction # %d RULE Name[%s]\n",aiInterface->getFactionIndex(),rule->getName().c_str());
+
+	// Test to see if AI can execute rule e.g. is there a worker available to for harvesting wood?
+	if(rule->test()) {
+		if(outputAIBehaviourToConsole()) printf("\n\nYYYYY Executing AI Faction # %d RULE Name[%s]\n\n",aiInterface->getFactionIndex(),rule->getName().c_str());
+
+		aiInterface->printLog(3, intToStr(1000 * aiInterface->getTimer() / GameConstants::updateFps) + ": Executing rule: " + rule->getName() + '\n');
+
+		// Execute the rule.
+		rule->execute();
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld [END]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	int64 elapsedMicros = chronoRule.getMicros();
+	ruleTimings[ruleIdx].addRun(elapsedMicros);
+	if(scheduler != NULL) {
+		scheduler->consumeBudget(frame, elapsedMicros);
+	}
+}
+
+string Ai::getRuleTimingReport() const {
+	string result = "";
+	for(unsigned int ruleIdx = 0; ruleIdx < aiRules.size() && ruleIdx < ruleTimings.size(); ++ruleIdx) {
+		if(ruleTimings[ruleIdx].getRunCount() > 0) {
+			result += aiRules[ruleIdx]->getName() + " " + ruleTimings[ruleIdx].toString() + "\n";
+		}
+	}
+	return result;
 }
 
 
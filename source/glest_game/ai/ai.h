@@ -121,6 +121,59 @@ public:
 	static UpgradeTask * loadGame(const XmlNode *rootNode, Faction *faction);
 };
 
+// ===============================
+// 	class AiRuleTiming
+//
+///	Run time histogram of one AI rule
+// ===============================
+
+class AiRuleTiming {
+public:
+	static const int bucketCount= 6;
+	static const int64 bucketLimitsMicros[bucketCount - 1];
+
+private:
+	int64 buckets[bucketCount];
+	int64 runCount;
+	int64 totalMicros;
+	int64 maxMicros;
+
+public:
+	AiRuleTiming();
+
+	void addRun(int64 micros);
+	int64 getRunCount() const	{return runCount;}
+	string toString() const;
+};
+
+// ===============================
+// 	class AiRuleScheduler
+//
+///	Shares a per frame time budget between the rules of all AI factions
+// ===============================
+
+class AiRuleScheduler {
+private:
+	Mutex *mutex;
+	int64 frameBudgetMicros;
+	int budgetFrame;
+	int64 budgetSpentMicros;
+
+	AiRuleScheduler(const AiRuleScheduler &obj);
+	AiRuleScheduler & operator=(const AiRuleScheduler &obj);
+
+public:
+	AiRuleScheduler();
+	~AiRuleScheduler();
+
+	void setFrameBudgetMillis(int millis);
+	bool isBudgetEnabled() const	{return frameBudgetMicros > 0;}
+	bool hasBudgetLeft(int frame);
+	void consumeBudget(int frame, int64 micros);
+
+	static int getRulePhase(int factionIndex, int ruleIndex, int intervalFrames);
+};
+
 // ===============================
 // 	class AI
 //
@@ -154,12 +207,16 @@ public:
 
 private:
 	typedef vector<AiRule *> AiRules;
+	typedef vector<AiRuleTiming> AiRuleTimings;
 	typedef list<const Task*> Tasks;
 	typedef deque<Vec2i> Positions;
 
 private:
     AiInterface *aiInterface;
 	AiRules aiRules;
+	AiRuleTimings ruleTimings;
+	vector<bool> ruleDeferred;
+	vector<int> deferredRules;
     int startLoc;
     bool randomMinWarriorsReached;
 	Tasks tasks;
@@ -169,6 +226,8 @@ private:
 	int minWarriors;
 
 	bool getAdjacentUnits(std::map<float, std::map<int, const Unit *> > &signalAdjacentUnits, const Unit *unit);
+	bool isRuleDue(int ruleIdx) const;
+	void runRule(int ruleIdx, AiRuleScheduler *scheduler, int frame);
 
 public:
 	Ai() {
@@ -195,6 +254,7 @@ public:
 
 	void init(AiInterface *aiInterface,int useStartLocation=-1);
     void update();
+    string getRuleTimingReport() const;
 
     //state requests
 	AiInterface *getAiInterface() const		{return aiInterface;}
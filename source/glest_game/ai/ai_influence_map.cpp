@@ -0,0 +1,153 @@
+//
+//	ai_influence_map.cpp:
+//
+//	This file is part of ZetaGlest <https://github.com/ZetaGlest>
+//
+//	Copyright (C) 2018  The ZetaGlest team
+//
+//	ZetaGlest is a fork of MegaGlest <https://megaglest.org>
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>
+
+#include "ai_influence_map.h"
+
+#include "world.h"
+#include "map.h"
+#include "unit.h"
+#include "unit_type.h"
+#include "faction.h"
+#include "leak_dumper.h"
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	class AiInfluenceMap
+// =====================================================
+
+const int AiInfluenceMap::cellSize= 8;
+
+AiInfluenceMap::TeamLayers::TeamLayers() {
+	builtFrame= -1;
+}
+
+AiInfluenceMap::AiInfluenceMap() {
+	mutex= new Mutex(CODE_AT_LINE);
+	mapW= 0;
+	mapH= 0;
+	w= 0;
+	h= 0;
+}
+
+AiInfluenceMap::~AiInfluenceMap() {
+	delete mutex;
+	mutex= NULL;
+}
+
+void AiInfluenceMap::init(int mapW, int mapH) {
+	this->mapW= mapW;
+	this->mapH= mapH;
+	w= (mapW + cellSize - 1) / cellSize;
+	h= (mapH + cellSize - 1) / cellSize;
+
+	for(int i = 0; i < GameConstants::maxPlayers; ++i) {
+		TeamLayers &layers= teams[i];
+		layers.builtFrame= -1;
+		layers.enemyCount.assign((w + 1) * (h + 1), 0);
+		layers.visibleEnemies.clear();
+	}
+}
+
+bool AiInfluenceMap::refresh(const World *world, int team, int frame) {
+	if(team < 0 || team >= GameConstants::maxPlayers) {
+		return false;
+	}
+
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	const Map *map= world->getMap();
+	if(map->getW() != mapW || map->getH() != mapH) {
+		init(map->getW(), map->getH());
+	}
+
+	//units move and come into sight every frame, older layers would miss them
+	TeamLayers &layers= teams[team];
+	if(layers.builtFrame == frame) {
+		return true;
+	}
+
+	updateUnitLayers(world, team, layers);
+	layers.builtFrame= frame;
+	return true;
+}
+
+void AiInfluenceMap::updateUnitLayers(const World *world, int team, TeamLayers &layers) {
+	const Map *map= world->getMap();
+
+	vector<int> &table= layers.enemyCount;
+	table.assign((w + 1) * (h + 1), 0);
+	layers.visibleEnemies.clear();
+
+	for(int i = 0; i < world->getFactionCount(); ++i) {
+		const Faction *faction= world->getFaction(i);
+		const int factionTeam= faction->getTeam();
+		if(factionTeam == team || factionTeam == GameConstants::maxPlayers -1 + fpt_Observer) {
+			continue;
+		}
+
+		for(int j = 0; j < faction->getUnitCount(); ++j) {
+			//the world does not change while the AI threads run
+			Unit *unit= faction->getUnit(j);
+			const Vec2i unitPos= unit->getPosNotThreadSafe();
+			if(unit->isAlive() == false || map->isInside(unitPos) == false) {
+				continue;
+			}
+			const SurfaceCell *sc= map->getSurfaceCell(Map::toSurfCoords(unitPos));
+			bool cannotSeeUnit = (unit->getType()->hasCellMap() == true &&
+								  unit->getType()->getAllowEmptyCellMap() == true &&
+								  unit->getType()->hasEmptyCellMap() == true);
+			if(sc->isVisible(team) == true && cannotSeeUnit == false) {
+				table[(unitPos.y / cellSize + 1) * (w + 1) + (unitPos.x / cellSize + 1)]++;
+				layers.visibleEnemies.push_back(unit);
+			}
+		}
+	}
+
+	//turn the cell counts into sums of everything above and left of each cell
+	for(int y = 1; y <= h; ++y) {
+		for(int x = 1; x <= w; ++x) {
+			table[y * (w + 1) + x] += table[(y - 1) * (w + 1) + x] +
+									  table[y * (w + 1) + x - 1] -
+									  table[(y - 1) * (w + 1) + x - 1];
+		}
+	}
+}
+
+int AiInfluenceMap::sumArea(const vector<int> &table, const Vec2i &topLeft, const Vec2i &bottomRight) const {
+	if(w <= 0 || h <= 0 || table.empty() == true ||
+		bottomRight.x < 0 || bottomRight.y < 0 || topLeft.x >= mapW || topLeft.y >= mapH) {
+		return 0;
+	}
+	const int xStart= max(0, topLeft.x) / cellSize;
+	const int yStart= max(0, topLeft.y) / cellSize;
+	const int xEnd= min(mapW - 1, bottomRight.x) / cellSize;
+	const int yEnd= min(mapH - 1, bottomRight.y) / cellSize;
+
+	return table[(yEnd + 1) * (w + 1) + xEnd + 1] - table[yStart * (w + 1) + xEnd + 1] -
+		   table[(yEnd + 1) * (w + 1) + xStart] + table[yStart * (w + 1) + xStart];
+}
+
+int AiInfluenceMap::getEnemyCount(int team, const Vec2i &topLeft, const Vec2i &bottomRight) const {
+	return sumArea(teams[team].enemyCount, topLeft, bottomRight);
+}
+
+}}//end namespace
@@ -0,0 +1,93 @@
+//
+//	ai_influence_map.h:
+//
+//	This file is part of ZetaGlest <https://github.com/ZetaGlest>
+//
+//	Copyright (C) 2018  The ZetaGlest team
+//
+//	ZetaGlest is a fork of MegaGlest <https://megaglest.org>
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>
+
+#ifndef _GLEST_GAME_AIINFLUENCEMAP_H_
+#define _GLEST_GAME_AIINFLUENCEMAP_H_
+
+#include <vector>
+#include "vec.h"
+#include "thread.h"
+#include "game_constants.h"
+#include "leak_dumper.h"
+
+using std::vector;
+using Shared::Graphics::Vec2i;
+using Shared::Platform::Mutex;
+
+namespace Glest{ namespace Game{
+
+class World;
+class Map;
+class Unit;
+
+// =====================================================
+// 	class AiInfluenceMap
+//
+///	Coarse grid of visible enemy units per team, shared by
+/// the AI factions of the team and rebuilt once per frame
+// =====================================================
+
+class AiInfluenceMap {
+public:
+	static const int cellSize;					//map cells per influence cell side
+
+private:
+	class TeamLayers {
+	public:
+		int builtFrame;
+		vector<int> enemyCount;				//summed area table, (w+1)*(h+1)
+		vector<Unit *> visibleEnemies;		//in world faction and unit order
+
+		TeamLayers();
+	};
+
+private:
+	Mutex *mutex;
+	int mapW;
+	int mapH;
+	int w;
+	int h;
+	TeamLayers teams[GameConstants::maxPlayers];
+
+	AiInfluenceMap(const AiInfluenceMap &obj);
+	AiInfluenceMap & operator=(const AiInfluenceMap &obj);
+
+	void init(int mapW, int mapH);
+	void updateUnitLayers(const World *world, int team, TeamLayers &layers);
+	int sumArea(const vector<int> &table, const Vec2i &topLeft, const Vec2i &bottomRight) const;
+
+public:
+	AiInfluenceMap();
+	~AiInfluenceMap();
+
+	//rebuilds the team layers unless they were built on this frame,
+	//returns false for teams without layers
+	bool refresh(const World *world, int team, int frame);
+
+	//areas are in map cells, both corners inclusive
+	int getEnemyCount(int team, const Vec2i &topLeft, const Vec2i &bottomRight) const;
+	const vector<Unit *> &getVisibleEnemies(int team) const	{return teams[team].visibleEnemies;}
+};
+
+}}//end namespace
+
+#endif
@@ -204,6 +204,8 @@ AiInterface::AiInterface(Game &game, int factionIndex, int teamIndex,
 	this->commander= game.getCommander();
 	this->console= game.getConsole();
 	this->gameSettings = game.getGameSettings();
+	this->ruleScheduler = game.getAiRuleScheduler();
+	this->influenceMap = game.getAiInfluenceMap();
 
 	this->factionIndex= factionIndex;
 	this->teamIndex= teamIndex;
@@ -272,6 +274,8 @@ void AiInterface::init() {
     fp=NULL;;
     aiMutex=NULL;
     workerThread=NULL;
+    ruleScheduler=NULL;
+    influenceMap=NULL;
 }
 
 AiInterface::~AiInterface() {
@@ -288,6 +292,14 @@ AiInterface::~AiInterface() {
 		workerThread = NULL;
 	}
 
+	string ruleTimingReport = ai.getRuleTimingReport();
+	if(ruleTimingReport != "") {
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] AI rule timings for factionIndex = %d:\n%s",__FILE__,__FUNCTION__,__LINE__,this->factionIndex,ruleTimingReport.c_str());
+		if(fp != NULL) {
+			fprintf(fp, "\nAI rule timings (microseconds):\n%s", ruleTimingReport.c_str());
+		}
+	}
+
     if(fp) {
     	fclose(fp);
     	fp = NULL;
@@ -759,7 +771,6 @@ bool AiInterface::getNearestSightedResource(const ResourceType *rt, const Vec2i
 											Vec2i &resultPos, bool usableResourceTypeOnly) {
 	Faction *faction = world->getFaction(factionIndex);
 	//float tmpDist=0;
-	float nearestDist= infinity;
 	bool anyResource= false;
 	resultPos.x = -1;
 	resultPos.y = -1;
@@ -796,29 +807,8 @@ bool AiInterface::getNearestSightedResource(const ResourceType *rt, const Vec2i
 		}
 		else {
 			const Map *map		= world->getMap();
-			for(int i = 0; i < map->getW(); ++i) {
-				for(int j = 0; j < map->getH(); ++j) {
-					Vec2i resPos = Vec2i(i, j);
-					Vec2i surfPos= Map::toSurfCoords(resPos);
-					SurfaceCell *sc = map->getSurfaceCell(surfPos);
-
-					//if explored cell
-					if(sc != NULL && sc->isExplored(teamIndex)) {
-						Resource *r= sc->getResource();
-
-						//if resource cell
-						if(r != NULL) {
-							if(r->getType() == rt) {
-								float tmpDist= pos.dist(resPos);
-								if(tmpDist < nearestDist) {
-									anyResource= true;
-									nearestDist= tmpDist;
-									resultPos= resPos;
-								}
-							}
-						}
-					}
-				}
+			if(map->findNearestExploredResource(rt, pos, teamIndex, resultPos) == true) {
+				anyResource= true;
 			}
 		}
 	}
@@ -858,8 +848,33 @@ void AiInterface::removeEnemyWarningPositionFromList(Vec2i &checkPos) {
 const Unit *AiInterface::getFirstOnSightEnemyUnit(Vec2i &pos, Field &field, int radius) {
 	Map *map= world->getMap();
 
-	const int CHECK_RADIUS = 12;
-	const int WARNING_ENEMY_COUNT = 6;
+	const AiInfluenceMap *influence = getInfluenceMap();
+	if(influence != NULL) {
+		// The team's visible enemies are listed once per frame in world order,
+		// so this finds the same unit as the scan below without the scan
+		const vector<Unit *> &enemies = influence->getVisibleEnemies(getInfluenceTeam());
+		const int homeRadius = min(radius, map->getW() + map->getH());
+		Vec2i home = getHomeLocation();
+		if(influence->getEnemyCount(getInfluenceTeam(), home - Vec2i(homeRadius), home + Vec2i(homeRadius)) == 0) {
+			// pos is left at the last enemy looked at, as the scan does
+			if(enemies.empty() == false) {
+				pos= enemies.back()->getPos();
+				field= enemies.back()->getCurrField();
+			}
+			return NULL;
+		}
+		for(unsigned int i = 0; i < enemies.size(); ++i) {
+			Unit *unit= enemies[i];
+			if(isAlly(unit) == false) {
+				pos= unit->getPos();
+				field= unit->getCurrField();
+				if(pos.dist(home) < radius) {
+					return checkEnemyWarning(unit, pos, field);
+				}
+			}
+		}
+		return NULL;
+	}
 
 	for(int i = 0; i < world->getFactionCount(); ++i) {
         for(int j = 0; j < world->getFaction(i)->getUnitCount(); ++j) {
@@ -874,40 +889,7 @@ const Unit *AiInterface::getFirstOnSightEnemyUnit(Vec2i &pos, Field &field, int
                 pos= unit->getPos();
     			field= unit->getCurrField();
                 if(pos.dist(getHomeLocation()) < radius) {
-                    printLog(2, "Being attacked at pos "+intToStr(pos.x)+","+intToStr(pos.y)+"\n");
-
-                    // Now check if there are more than x enemies in sight and if
-                    // so make note of the position
-                    int foundEnemies = 0;
-                    std::map<int,bool> foundEnemyList;
-                	for(int aiX = pos.x-CHECK_RADIUS; aiX < pos.x + CHECK_RADIUS; ++aiX) {
-                		for(int aiY = pos.y-CHECK_RADIUS; aiY < pos.y + CHECK_RADIUS; ++aiY) {
-                			Vec2i checkPos(aiX,aiY);
-                			if(map->isInside(checkPos) && map->isInsideSurface(map->toSurfCoords(checkPos))) {
-                				Cell *cAI = map->getCell(checkPos);
-                				SurfaceCell *scAI = map->getSurfaceCell(Map::toSurfCoords(checkPos));
-                				if(scAI != NULL && cAI != NULL && cAI->getUnit(field) != NULL && sc->isVisible(teamIndex)) {
-                					const Unit *checkUnit = cAI->getUnit(field);
-                					if(foundEnemyList.find(checkUnit->getId()) == foundEnemyList.end()) {
-										bool cannotSeeUnitAI = (checkUnit->getType()->hasCellMap() == true &&
-															checkUnit->getType()->getAllowEmptyCellMap() == true &&
-															checkUnit->getType()->hasEmptyCellMap() == true);
-										if(cannotSeeUnitAI == false && isAlly(checkUnit) == false
-												&& checkUnit->isAlive() == true) {
-											foundEnemies++;
-											foundEnemyList[checkUnit->getId()] = true;
-										}
-                					}
-                				}
-                			}
-                		}
-                	}
-                	if(foundEnemies >= WARNING_ENEMY_COUNT) {
-                		if(std::find(enemyWarningPositionList.begin(),enemyWarningPositionList.end(),pos) == enemyWarningPositionList.end()) {
-                			enemyWarningPositionList.push_back(pos);
-                		}
-                	}
-                    return unit;
+                    return checkEnemyWarning(unit, pos, field);
                 }
             }
         }
@@ -915,6 +897,61 @@ const Unit *AiInterface::getFirstOnSightEnemyUnit(Vec2i &pos, Field &field, int
     return NULL;
 }
 
+const Unit *AiInterface::checkEnemyWarning(Unit *unit, const Vec2i &pos, Field field) {
+	Map *map= world->getMap();
+	SurfaceCell *sc= map->getSurfaceCell(Map::toSurfCoords(unit->getPos()));
+
+	const int CHECK_RADIUS = 12;
+	const int WARNING_ENEMY_COUNT = 6;
+
+    printLog(2, "Being attacked at pos "+intToStr(pos.x)+","+intToStr(pos.y)+"\n");
+
+    // Now check if there are more than x enemies in sight and if
+    // so make note of the position
+    int foundEnemies = 0;
+    std::map<int,bool> foundEnemyList;
+	for(int aiX = pos.x-CHECK_RADIUS; aiX < pos.x + CHECK_RADIUS; ++aiX) {
+		for(int aiY = pos.y-CHECK_RADIUS; aiY < pos.y + CHECK_RADIUS; ++aiY) {
+			Vec2i checkPos(aiX,aiY);
+			if(map->isInside(checkPos) && map->isInsideSurface(map->toSurfCoords(checkPos))) {
+				Cell *cAI = map->getCell(checkPos);
+				SurfaceCell *scAI = map->getSurfaceCell(Map::toSurfCoords(checkPos));
+				if(scAI != NULL && cAI != NULL && cAI->getUnit(field) != NULL && sc->isVisible(teamIndex)) {
+					const Unit *checkUnit = cAI->getUnit(field);
+					if(foundEnemyList.find(checkUnit->getId()) == foundEnemyList.end()) {
+						bool cannotSeeUnitAI = (checkUnit->getType()->hasCellMap() == true &&
+											checkUnit->getType()->getAllowEmptyCellMap() == true &&
+											checkUnit->getType()->hasEmptyCellMap() == true);
+						if(cannotSeeUnitAI == false && isAlly(checkUnit) == false
+								&& checkUnit->isAlive() == true) {
+							foundEnemies++;
+							foundEnemyList[checkUnit->getId()] = true;
+						}
+					}
+				}
+			}
+		}
+	}
+	if(foundEnemies >= WARNING_ENEMY_COUNT) {
+		if(std::find(enemyWarningPositionList.begin(),enemyWarningPositionList.end(),pos) == enemyWarningPositionList.end()) {
+			enemyWarningPositionList.push_back(pos);
+		}
+	}
+    return unit;
+}
+
+const AiInfluenceMap *AiInterface::getInfluenceMap() {
+	if(influenceMap == NULL ||
+		influenceMap->refresh(world, getInfluenceTeam(), world->getFrameCount()) == false) {
+		return NULL;
+	}
+	return influenceMap;
+}
+
+int AiInterface::getInfluenceTeam() const {
+	return world->getFaction(factionIndex)->getTeam();
+}
+
 Map * AiInterface::getMap() {
 	Map *map= world->getMap();
 	return map;
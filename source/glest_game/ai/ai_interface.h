@@ -28,6 +28,7 @@
 #include "command.h"
 #include "conversion.h"
 #include "ai.h"
+#include "ai_influence_map.h"
 #include "game_settings.h"
 #include <map>
 #include "leak_dumper.h"
@@ -92,6 +93,8 @@ private:
     Mutex *aiMutex;
 
     AiInterfaceThread *workerThread;
+    AiRuleScheduler *ruleScheduler;
+    AiInfluenceMap *influenceMap;
     std::vector<Vec2i> enemyWarningPositionList;
 
 public:
@@ -124,6 +127,9 @@ public:
 	//get
 	int getTimer() const		{return timer;}
 	int getFactionIndex() const	{return factionIndex;}
+	AiRuleScheduler *getRuleScheduler()	{return ruleScheduler;}
+	const AiInfluenceMap *getInfluenceMap();
+	int getInfluenceTeam() const;
 
     //misc
     void printLog(int logLevel, const string &s);
@@ -174,6 +180,7 @@ public:
 private:
 	string getLogFilename() const	{return "ai"+intToStr(factionIndex)+".log";}
 	bool executeCommandOverNetwork();
+	const Unit *checkEnemyWarning(Unit *unit, const Vec2i &pos, Field field);
 
 	void init();
 };
@@ -453,7 +453,8 @@ std::pair<CommandResult,string> Commander::pushNetworkCommand(const NetworkComma
 		networkCommand->getNetworkCommandType() != nctSwitchTeamVote &&
 		networkCommand->getNetworkCommandType() != nctPauseResume &&
 		networkCommand->getNetworkCommandType() != nctPlayerStatusChange &&
-		networkCommand->getNetworkCommandType() != nctDisconnectNetworkPlayer) {
+		networkCommand->getNetworkCommandType() != nctDisconnectNetworkPlayer &&
+		networkCommand->getNetworkCommandType() != nctSetNetworkFramePeriod) {
 		unit= world->findUnitById(networkCommand->getUnitId());
 		if(unit == NULL) {
 			char szBuf[8096]="";
@@ -528,6 +529,10 @@ void Commander::updateNetwork(Game *game) {
 
 	//check that this is a keyframe
 	if(game != NULL) {
+		// a period change announced earlier must be in place before the
+		// keyframe test below
+		game->applyPendingNetworkFramePeriod(world->getFrameCount());
+
         GameSettings *gameSettings = game->getGameSettings();
         if( networkManager.isNetworkGame() == false ||
             (world->getFrameCount() % gameSettings->getNetworkFramePeriod()) == 0) {
@@ -855,6 +860,37 @@ void Commander::giveNetworkCommand(NetworkCommand* networkCommand) const {
 			}
 			break;
 
+        case nctSetNetworkFramePeriod:
+			{
+			commandWasHandled = true;
+
+			// Every peer runs this at the same keyframe, so they all pick
+			// the same switch frame: the first multiple of the larger
+			// period at least leadFrames ahead. That frame is a keyframe
+			// under both periods.
+			int networkFramePeriod	= networkCommand->getUnitId();
+			int leadFrames			= networkCommand->getTargetId();
+			int frameCount			= world->getFrameCount();
+			Game *game				= this->world->getGame();
+			int currentPeriod		= game->getGameSettings()->getNetworkFramePeriod();
+
+			if(networkFramePeriod <= 0 || currentPeriod <= 0 || leadFrames < 0 ||
+				(networkFramePeriod % currentPeriod != 0 && currentPeriod % networkFramePeriod != 0)) {
+				SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] ignoring invalid network frame period %d (current %d, lead %d)\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,networkFramePeriod,currentPeriod,leadFrames);
+				break;
+			}
+
+			int alignPeriod = max(networkFramePeriod,currentPeriod);
+			int switchFrame = ((frameCount + leadFrames + alignPeriod - 1) / alignPeriod) * alignPeriod;
+			if(switchFrame <= frameCount) {
+				switchFrame += alignPeriod;
+			}
+			game->setPendingNetworkFramePeriod(networkFramePeriod,switchFrame);
+
+			if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] found nctSetNetworkFramePeriod period: %d at frame: %d (now %d)\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,networkFramePeriod,switchFrame,frameCount);
+			}
+			break;
+
     }
 
     if(commandWasHandled == false) {
@@ -41,6 +41,7 @@
 #include "cache_manager.h"
 #include "conversion.h"
 #include "steam.h"
+#include "spectator_feed.h"
 
 #include "leak_dumper.h"
 
@@ -98,6 +99,8 @@ Game::Game() : ProgramState(NULL) {
 	avgRenderFps=0;
 	currentAvgRenderFpsTotal=0;
 	paused=false;
+	pendingNetworkFramePeriod=0;
+	pendingNetworkFramePeriodFrame=0;
 	networkPauseGameForLaggedClientsRequested=false;
 	networkResumeGameForLaggedClientsRequested=false;
 	pausedForJoinGame=false;
@@ -181,6 +184,9 @@ Game::Game() : ProgramState(NULL) {
 
 	loadGameNode = NULL;
 	lastworldFrameCountForReplay = -1;
+	spectatorFeedClient = NULL;
+	spectatorFrameLimit = 0;
+	spectatorFeedEnded = false;
 	lastNetworkPlayerConnectionCheck = time(NULL);
 	inJoinGameLoading = false;
 	quitGameCalled = false;
@@ -211,6 +217,8 @@ void Game::resetMembers() {
 	playerIndexDisconnect=0;
 	lastMasterServerGameStatsDump=0;
 	highlightCellTexture=NULL;
+	pendingNetworkFramePeriod=0;
+	pendingNetworkFramePeriodFrame=0;
 	totalRenderFps       =0;
 	lastMaxUnitCalcTime  =0;
 	renderExtraTeamColor =0;
@@ -301,6 +309,9 @@ void Game::resetMembers() {
 
 	loadGameNode = NULL;
 	lastworldFrameCountForReplay = -1;
+	spectatorFeedClient = NULL;
+	spectatorFrameLimit = 0;
+	spectatorFeedEnded = false;
 
 	lastNetworkPlayerConnectionCheck = time(NULL);
 
@@ -465,6 +476,9 @@ Game::~Game() {
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] aiInterfaces.size() = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,aiInterfaces.size());
 
+	delete spectatorFeedClient;
+	spectatorFeedClient = NULL;
+
 	delete videoPlayer;
 	videoPlayer = NULL;
 	playingStaticVideo = false;
@@ -1873,8 +1887,13 @@ void Game::update() {
 		//console
 		console.update();
 
+		updateSpectatorFeed();
+
 		// b) Updates depandant on speed
 		int updateLoops= getUpdateLoops();
+		if(isSpectatorFeedStalled() == true) {
+			updateLoops = 0;
+		}
 
 		// Temp speed boost when player first joins an in progress game
 		if(this->initialResumeSpeedLoops == true) {
@@ -2043,7 +2062,7 @@ void Game::update() {
 				if(replayTotal > 0) {
 					replayCommandsPlayed = (replayTotal - commander.getReplayCommandListForFrameCount());
 				}
-				for(int i = 0; i < updateLoops; ++i) {
+				for(int i = 0; i < updateLoops && isSpectatorFeedStalled() == false; ++i) {
 					//if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
 					if(showPerfStats) {
 						sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
@@ -2285,7 +2304,8 @@ void Game::update() {
 					//good_fpu_control_registers(NULL,extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 				}
 			}
-			while (commander.hasReplayCommandListForFrame() == true);
+			while ((commander.hasReplayCommandListForFrame() == true || isSpectatorFeedBehind() == true) &&
+					isSpectatorFeedStalled() == false);
 		}
 		//else if(role == nrClient) {
 		else {
@@ -6305,6 +6325,29 @@ void Game::setPaused(bool value,bool forceAllowPauseStateChange,bool clearCaches
 	}
 }
 
+void Game::setPendingNetworkFramePeriod(int networkFramePeriod, int switchFrame) {
+	pendingNetworkFramePeriod		= networkFramePeriod;
+	pendingNetworkFramePeriodFrame	= switchFrame;
+}
+
+void Game::applyPendingNetworkFramePeriod(int frameCount) {
+	if(pendingNetworkFramePeriod <= 0 || frameCount < pendingNetworkFramePeriodFrame) {
+		return;
+	}
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] frame: %d network frame period %d -> %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,frameCount,gameSettings.getNetworkFramePeriod(),pendingNetworkFramePeriod);
+
+	// The network interface keeps its own copy of the settings which
+	// decides when clients send their command lists
+	gameSettings.setNetworkFramePeriod(pendingNetworkFramePeriod);
+	GameNetworkInterface *gameNetworkInterface = NetworkManager::getInstance().getGameNetworkInterface(false);
+	if(gameNetworkInterface != NULL) {
+		gameNetworkInterface->getGameSettingsPtr()->setNetworkFramePeriod(pendingNetworkFramePeriod);
+	}
+	pendingNetworkFramePeriod		= 0;
+	pendingNetworkFramePeriodFrame	= 0;
+}
+
 bool Game::getPaused()
 {
 	bool speedChangesAllowed= !NetworkManager::getInstance().isNetworkGame();
@@ -6420,6 +6463,53 @@ void Game::addNetworkCommandToReplayList(NetworkCommand* networkCommand, int wor
 	}
 }
 
+void Game::updateSpectatorFeed() {
+	if(spectatorFeedClient == NULL || spectatorFeedEnded == true) {
+		return;
+	}
+
+	SpectatorRecord record;
+	for(int count = 0; count < 1000 && spectatorFeedClient->receiveRecord(record, 0) == true; ++count) {
+		if(record.type == srt_Frame) {
+			NetworkMessageCommandList networkMessageCommandList;
+			if(record.payload.empty() == true ||
+				networkMessageCommandList.decodeCompact(&record.payload[0],(unsigned int)record.payload.size()) == false) {
+				SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] invalid spectator frame %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,record.frame);
+				spectatorFeedClient->disconnect();
+				break;
+			}
+			for(int index = 0; index < networkMessageCommandList.getCommandCount(); ++index) {
+				NetworkCommand command = *networkMessageCommandList.getCommand(index);
+				commander.addToReplayCommandList(command,record.frame);
+			}
+			spectatorFrameLimit = record.frame;
+		}
+		else if(record.type == srt_End) {
+			spectatorFeedEnded = true;
+			break;
+		}
+	}
+
+	if(spectatorFeedEnded == false && spectatorFeedClient->isConnected() == false) {
+		spectatorFeedEnded = true;
+	}
+	if(spectatorFeedEnded == true) {
+		Lang &lang= Lang::getInstance();
+		console.addLine(lang.hasString("SpectatorFeedEnded") == true ?
+				lang.getString("SpectatorFeedEnded") : "The spectated game has ended");
+	}
+}
+
+bool Game::isSpectatorFeedStalled() const {
+	// The next world update needs the commands of the frame after it
+	return (spectatorFeedClient != NULL && world.getFrameCount() >= spectatorFrameLimit);
+}
+
+bool Game::isSpectatorFeedBehind() const {
+	// After joining, or a hiccup, run ahead to the feed like a replay
+	return (spectatorFeedClient != NULL && spectatorFrameLimit - world.getFrameCount() > GameConstants::updateFps);
+}
+
 void Game::renderVideoPlayer() {
 	if(videoPlayer != NULL) {
 		if(videoPlayer->isPlaying() == true) {
@@ -6807,66 +6897,123 @@ string Game::saveGame(string name, const string &path) {
 	return saveGameFile;
 }
 
-void Game::loadGame(string name,Program *programPtr,bool isMasterserverMode,const GameSettings *joinGameSettings) {
-	Config &config= Config::getInstance();
-	// This condition will re-play all the commands from a replay file
-	// INSTEAD of saving from a saved game.
-	if(joinGameSettings == NULL && config.getBool("SaveCommandsForReplay","false") == true) {
-		XmlTree	xmlTreeReplay(XML_RAPIDXML_ENGINE);
-		std::map<string,string> mapExtraTagReplacementValues;
-		xmlTreeReplay.load(name + ".replay", Properties::getTagReplacementValues(&mapExtraTagReplacementValues),true);
+Game * Game::createReplayGame(const XmlNode *rootNode, Program *programPtr, bool isMasterserverMode) {
+	if(rootNode->hasChild("megaglest-saved-game") == true) {
+		rootNode = rootNode->getChild("megaglest-saved-game");
+	}
 
-		const XmlNode *rootNode= xmlTreeReplay.getRootNode();
+	//const XmlNode *versionNode= rootNode->getChild("megaglest-saved-game");
+	const XmlNode *versionNode= rootNode;
 
-		if(rootNode->hasChild("megaglest-saved-game") == true) {
-			rootNode = rootNode->getChild("megaglest-saved-game");
-		}
+	Lang &lang= Lang::getInstance();
+	string gameVer = versionNode->getAttribute("version")->getValue();
+	if(gameVer != glestVersionString && checkVersionComptability(gameVer, glestVersionString) == false){
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,lang.getString("SavedGameBadVersion").c_str(),gameVer.c_str(),glestVersionString.c_str());
+		throw megaglest_runtime_error(szBuf,true);
+	}
 
-		//const XmlNode *versionNode= rootNode->getChild("megaglest-saved-game");
-		const XmlNode *versionNode= rootNode;
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Found saved game version that matches your application version: [%s] --> [%s]\n",gameVer.c_str(),glestVersionString.c_str());
 
-		Lang &lang= Lang::getInstance();
-		string gameVer = versionNode->getAttribute("version")->getValue();
-		if(gameVer != glestVersionString && checkVersionComptability(gameVer, glestVersionString) == false){
-			char szBuf[8096]="";
-			snprintf(szBuf,8096,lang.getString("SavedGameBadVersion").c_str(),gameVer.c_str(),glestVersionString.c_str());
-			throw megaglest_runtime_error(szBuf,true);
-		}
+	XmlNode *gameNode = rootNode->getChild("Game");
 
-		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Found saved game version that matches your application version: [%s] --> [%s]\n",gameVer.c_str(),glestVersionString.c_str());
+	GameSettings newGameSettingsReplay;
+	newGameSettingsReplay.loadGame(gameNode);
+	//printf("Loading scenario [%s]\n",newGameSettingsReplay.getScenarioDir().c_str());
+	if(newGameSettingsReplay.getScenarioDir() != "" && fileExists(newGameSettingsReplay.getScenarioDir()) == false) {
+		newGameSettingsReplay.setScenarioDir(Scenario::getScenarioPath(Config::getInstance().getPathListForType(ptScenarios),newGameSettingsReplay.getScenario()));
 
-		XmlNode *gameNode = rootNode->getChild("Game");
+		//printf("Loading scenario #2 [%s]\n",newGameSettingsReplay.getScenarioDir().c_str());
+	}
 
-		GameSettings newGameSettingsReplay;
-		newGameSettingsReplay.loadGame(gameNode);
-		//printf("Loading scenario [%s]\n",newGameSettingsReplay.getScenarioDir().c_str());
-		if(newGameSettingsReplay.getScenarioDir() != "" && fileExists(newGameSettingsReplay.getScenarioDir()) == false) {
-			newGameSettingsReplay.setScenarioDir(Scenario::getScenarioPath(Config::getInstance().getPathListForType(ptScenarios),newGameSettingsReplay.getScenario()));
+	//GameSettings newGameSettings;
+	//newGameSettings.loadGame(gameNode);
+	//if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Game settings loaded\n");
 
-			//printf("Loading scenario #2 [%s]\n",newGameSettingsReplay.getScenarioDir().c_str());
-		}
+	NetworkManager &networkManager= NetworkManager::getInstance();
+	networkManager.end();
+	networkManager.init(nrServer,true);
 
-		//GameSettings newGameSettings;
-		//newGameSettings.loadGame(gameNode);
-		//if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Game settings loaded\n");
+	Game *newGame = new Game(programPtr, &newGameSettingsReplay, isMasterserverMode);
+	newGame->lastworldFrameCountForReplay = gameNode->getAttribute("LastWorldFrameCount")->getIntValue();
 
-		NetworkManager &networkManager= NetworkManager::getInstance();
-		networkManager.end();
-		networkManager.init(nrServer,true);
+	vector<XmlNode *> networkCommandNodeList = gameNode->getChildList("NetworkCommand");
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("networkCommandNodeList.size() = " MG_SIZE_T_SPECIFIER "\n",networkCommandNodeList.size());
+	for(unsigned int i = 0; i < networkCommandNodeList.size(); ++i) {
+		XmlNode *node = networkCommandNodeList[i];
+		int worldFrameCount = node->getAttribute("worldFrameCount")->getIntValue();
+		NetworkCommand command;
+		command.loadGame(node);
+		newGame->commander.addToReplayCommandList(command,worldFrameCount);
+	}
+
+	return newGame;
+}
 
-		Game *newGame = new Game(programPtr, &newGameSettingsReplay, isMasterserverMode);
-		newGame->lastworldFrameCountForReplay = gameNode->getAttribute("LastWorldFrameCount")->getIntValue();
+void Game::loadSpectatorFeed(const string &serverIp, int portNumber, Program *programPtr) {
+	Config &config= Config::getInstance();
+	int joinTimeoutSeconds = config.getInt("SpectatorFeedJoinTimeoutSeconds","120");
 
-		vector<XmlNode *> networkCommandNodeList = gameNode->getChildList("NetworkCommand");
-		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("networkCommandNodeList.size() = " MG_SIZE_T_SPECIFIER "\n",networkCommandNodeList.size());
-		for(unsigned int i = 0; i < networkCommandNodeList.size(); ++i) {
-			XmlNode *node = networkCommandNodeList[i];
-			int worldFrameCount = node->getAttribute("worldFrameCount")->getIntValue();
-			NetworkCommand command;
-			command.loadGame(node);
-			newGame->commander.addToReplayCommandList(command,worldFrameCount);
+	SpectatorFeedClient *client = new SpectatorFeedClient(serverIp, portNumber, sr_Viewer);
+	string feedName = serverIp + ":" + intToStr(portNumber);
+	if(client->connect() == false) {
+		delete client;
+		throw megaglest_runtime_error("Could not connect to the spectator feed at [" + feedName + "]");
+	}
+
+	// The feed holds the game back for its delay, so the first
+	// snapshot can take that long to arrive
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Waiting for the game from spectator feed [%s]\n",feedName.c_str());
+	SpectatorRecord snapshot;
+	time_t waitStart = time(NULL);
+	for(;snapshot.type != srt_Snapshot;) {
+		if(client->receiveRecord(snapshot, 250) == true) {
+			if(snapshot.type == srt_End) {
+				delete client;
+				throw megaglest_runtime_error("The game at spectator feed [" + feedName + "] has already ended");
+			}
+		}
+		else if(client->isConnected() == false || difftime(time(NULL),waitStart) > joinTimeoutSeconds) {
+			delete client;
+			throw megaglest_runtime_error("No game received from spectator feed [" + feedName + "]");
+		}
+	}
+
+	Game *newGame = NULL;
+	try {
+		string snapshotData;
+		if(snapshot.getPayloadData(snapshotData) == false) {
+			throw megaglest_runtime_error("Invalid game snapshot from spectator feed [" + feedName + "]");
 		}
+		XmlTree	xmlTreeSnapshot(XML_RAPIDXML_ENGINE);
+		std::map<string,string> mapExtraTagReplacementValues;
+		xmlTreeSnapshot.loadFromString(snapshotData, Properties::getTagReplacementValues(&mapExtraTagReplacementValues));
+
+		// The commands up to the snapshot replay like a saved replay,
+		// later ones come in from the feed as the game goes on
+		newGame = createReplayGame(xmlTreeSnapshot.getRootNode(), programPtr, false);
+	}
+	catch(...) {
+		delete client;
+		throw;
+	}
+	newGame->spectatorFeedClient = client;
+	newGame->spectatorFrameLimit = snapshot.frame;
+	newGame->commander.setPauseNetworkCommands(true);
+
+	programPtr->setState(newGame);
+}
+
+void Game::loadGame(string name,Program *programPtr,bool isMasterserverMode,const GameSettings *joinGameSettings) {
+	Config &config= Config::getInstance();
+	// This condition will re-play all the commands from a replay file
+	// INSTEAD of saving from a saved game.
+	if(joinGameSettings == NULL && config.getBool("SaveCommandsForReplay","false") == true) {
+		XmlTree	xmlTreeReplay(XML_RAPIDXML_ENGINE);
+		std::map<string,string> mapExtraTagReplacementValues;
+		xmlTreeReplay.load(name + ".replay", Properties::getTagReplacementValues(&mapExtraTagReplacementValues),true);
 
+		Game *newGame = createReplayGame(xmlTreeReplay.getRootNode(), programPtr, isMasterserverMode);
 		programPtr->setState(newGame);
 		return;
 	}
@@ -54,6 +54,10 @@ namespace Shared { namespace Graphics {
 	class VideoPlayer;
 }};
 
+namespace Shared { namespace PlatformCommon {
+	class SpectatorFeedClient;
+}};
+
 namespace Glest{ namespace Game{
 
 class GraphicMessageBox;
@@ -87,6 +91,8 @@ private:
 	//main data
 	World world;
     AiInterfaces aiInterfaces;
+    AiRuleScheduler aiRuleScheduler;
+    AiInfluenceMap aiInfluenceMap;
     Gui gui;
     GameCamera gameCamera;
     Commander commander;
@@ -136,6 +142,10 @@ private:
 	//misc ptr
 	ParticleSystem *weatherParticleSystem;
 	GameSettings gameSettings;
+
+	// network frame period announced by the server and the frame it takes effect
+	int pendingNetworkFramePeriod;
+	int pendingNetworkFramePeriodFrame;
 	Vec2i lastMousePos;
 	time_t lastRenderLog2d;
 	DisplayMessageFunction originalDisplayMsgCallback;
@@ -212,6 +222,11 @@ private:
 	int lastworldFrameCountForReplay;
 	std::vector<std::pair<int,NetworkCommand> > replayCommandList;
 
+	// watching another game through its spectator feed
+	::Shared::PlatformCommon::SpectatorFeedClient *spectatorFeedClient;
+	int spectatorFrameLimit;
+	bool spectatorFeedEnded;
+
 	std::vector<string> streamingVideos;
 	::Shared::Graphics::VideoPlayer *videoPlayer;
 	bool playingStaticVideo;
@@ -266,6 +281,8 @@ public:
 	Gui *getGuiPtr()							{return &gui;}
 	const Gui *getGui() const				{return &gui;}
 	Commander *getCommander()				{return &commander;}
+	AiRuleScheduler *getAiRuleScheduler()	{return &aiRuleScheduler;}
+	AiInfluenceMap *getAiInfluenceMap()		{return &aiInfluenceMap;}
 	Console *getConsole()					{return &console;}
 	ScriptManager *getScriptManager()		{return &scriptManager;}
 	World *getWorld()						{return &world;}
@@ -286,6 +303,8 @@ public:
 	bool getPaused();
 	void setPaused(bool value, bool forceAllowPauseStateChange,bool clearCaches,bool joinNetworkGame);
 	void tryPauseToggle(bool pause);
+	void setPendingNetworkFramePeriod(int networkFramePeriod, int switchFrame);
+	void applyPendingNetworkFramePeriod(int frameCount);
 	void setupRenderForVideo();
 	void saveGame();
 	const int getTotalRenderFps() const					{return totalRenderFps;}
@@ -349,6 +368,7 @@ public:
 
 	string saveGame(string name, const string &path="saved/");
 	static void loadGame(string name,Program *programPtr,bool isMasterserverMode, const GameSettings *joinGameSettings=NULL);
+	static void loadSpectatorFeed(const string &serverIp, int portNumber, Program *programPtr);
 
 	void addNetworkCommandToReplayList(NetworkCommand* networkCommand,int worldFrameCount);
 
@@ -389,6 +409,11 @@ private:
 	void decSpeed();
 	int getUpdateLoops();
 
+	static Game * createReplayGame(const XmlNode *rootNode, Program *programPtr, bool isMasterserverMode);
+	void updateSpectatorFeed();
+	bool isSpectatorFeedStalled() const;
+	bool isSpectatorFeedBehind() const;
+
 	void showLoseMessageBox();
 	void showWinMessageBox();
 	void showMessageBox(const string &text, const string &header, bool toggle);
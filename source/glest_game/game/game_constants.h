@@ -130,6 +130,7 @@ public:
 	static const int maxPlayers						= 10;
 	static const int serverPort						= 61357;
 	static const int serverAdminPort				= 61355;
+	static const int serverSpectatorPort			= 61356;
 	static int updateFps;
 	static int cameraFps;
 
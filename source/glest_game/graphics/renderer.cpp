@@ -128,6 +128,8 @@ const float Renderer::lightAmbFactor= 0.4f;
 
 const int Renderer::maxMouse2dAnim= 100;
 
+const int Renderer::unitCullTileSize= 16;
+
 const GLenum Renderer::baseTexUnit= GL_TEXTURE0;
 const GLenum Renderer::fowTexUnit= GL_TEXTURE1;
 const GLenum Renderer::shadowTexUnit= GL_TEXTURE2;
@@ -168,6 +170,8 @@ Renderer::Renderer() : BaseRenderer(), saveScreenShotThreadAccessor(new Mutex(CO
 	//assert(0==1);
 
 	Renderer::rendererEnded = false;
+	unitCullTilesW = 0;
+	unitCullTilesH = 0;
 	shadowIntensity = 0;
 	shadowFrameSkip = 0;
 	triangleCount = 0;
@@ -192,7 +196,14 @@ Renderer::Renderer() : BaseRenderer(), saveScreenShotThreadAccessor(new Mutex(CO
 	textRenderer = NULL;
 	textRenderer3D = NULL;
 	particleRenderer = NULL;
-	saveScreenShotThread = NULL;
+	saveScreenShotThreads.clear();
+	saveScreenQueueLimit = 0;
+	screenReadbackIndex = 0;
+	screenReadbackFrame = 0;
+	recordingScreen = false;
+	recordFrameInterval = 1;
+	recordFrameCount = 0;
+	recordFrameIndex = 0;
 	mapSurfaceData.clear();
 	visibleFrameUnitList.clear();
 	visibleFrameUnitListCameraKey = "";
@@ -257,16 +268,24 @@ Renderer::Renderer() : BaseRenderer(), saveScreenShotThreadAccessor(new Mutex(CO
 	}
 
 	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == false) {
+		saveScreenQueueLimit = max(1,config.getInt("ScreenshotQueueLimit","32"));
+		int encoderThreadCount = max(1,config.getInt("ScreenshotEncoderThreads","2"));
+
 		static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
-		saveScreenShotThread = new SimpleTaskThread(this,0,25);
-		saveScreenShotThread->setUniqueID(mutexOwnerId);
-		saveScreenShotThread->start();
+		for(int i = 0; i < encoderThreadCount; ++i) {
+			SimpleTaskThread *saveScreenShotThread = new SimpleTaskThread(this,0,25);
+			saveScreenShotThread->setUniqueID(mutexOwnerId);
+			saveScreenShotThread->start();
+			saveScreenShotThreads.push_back(saveScreenShotThread);
+		}
 	}
 }
 
 void Renderer::cleanupScreenshotThread() {
-    if(saveScreenShotThread) {
-		saveScreenShotThread->signalQuit();
+    if(saveScreenShotThreads.empty() == false) {
+		for(unsigned int i = 0; i < saveScreenShotThreads.size(); ++i) {
+			saveScreenShotThreads[i]->signalQuit();
+		}
 //		for(time_t elapsed = time(NULL);
 //			getSaveScreenQueueSize() > 0 && difftime((long int)time(NULL),elapsed) <= 7;) {
 //			sleep(0);
@@ -277,10 +296,12 @@ void Renderer::cleanupScreenshotThread() {
 //			delete saveScreenShotThread;
 //		}
 //		saveScreenShotThread = NULL;
-		if(saveScreenShotThread->shutdownAndWait() == true) {
-			delete saveScreenShotThread;
+		for(unsigned int i = 0; i < saveScreenShotThreads.size(); ++i) {
+			if(saveScreenShotThreads[i]->shutdownAndWait() == true) {
+				delete saveScreenShotThreads[i];
+			}
 		}
-		saveScreenShotThread = NULL;
+		saveScreenShotThreads.clear();
 
 
 		if(getSaveScreenQueueSize() > 0) {
@@ -358,25 +379,36 @@ Renderer::~Renderer() {
 }
 
 void Renderer::simpleTask(BaseThread *callingThread,void *userdata) {
-	// This code reads pixmaps from a queue and saves them to disk
-	Pixmap2D *savePixMapBuffer=NULL;
-	string path="";
+	// This code reads pixmaps from a queue and saves them to disk, every
+	// encoder thread keeps taking frames until the queue is empty
 	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
-	MutexSafeWrapper safeMutex(saveScreenShotThreadAccessor,mutexOwnerId);
-	if(saveScreenQueue.empty() == false) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line %d] saveScreenQueue.size() = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,saveScreenQueue.size());
+	for(;callingThread->getQuitStatus() == false;) {
+		Pixmap2D *savePixMapBuffer=NULL;
+		string path="";
 
-		savePixMapBuffer = saveScreenQueue.front().second;
-		path = saveScreenQueue.front().first;
+		MutexSafeWrapper safeMutex(saveScreenShotThreadAccessor,mutexOwnerId);
+		if(saveScreenQueue.empty() == false) {
+			if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line %d] saveScreenQueue.size() = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,saveScreenQueue.size());
 
-		saveScreenQueue.pop_front();
-	}
-	safeMutex.ReleaseLock();
+			savePixMapBuffer = saveScreenQueue.front().second;
+			path = saveScreenQueue.front().first;
+
+			saveScreenQueue.pop_front();
+		}
+		safeMutex.ReleaseLock();
+
+		if(savePixMapBuffer == NULL) {
+			break;
+		}
 
-	if(savePixMapBuffer != NULL) {
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line %d] about to save [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,path.c_str());
 
-		savePixMapBuffer->save(path);
+		try {
+			savePixMapBuffer->save(path);
+		}
+		catch(const exception &ex) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error saving [%s]: %s\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,path.c_str(),ex.what());
+		}
 		delete savePixMapBuffer;
 	}
 }
@@ -702,6 +734,7 @@ void Renderer::end() {
 	crcFactionPreviewTextureCache.clear();
 
 	// Wait for the queue to become empty or timeout the thread at 7 seconds
+	cleanupScreenReadbacks();
 	cleanupScreenshotThread();
 
 	mapSurfaceData.clear();
@@ -759,6 +792,7 @@ void Renderer::endScenario() {
 	worldToScreenPosCache.clear();
 	ReleaseSurfaceVBOs();
 	mapSurfaceData.clear();
+	mapRenderer.destroy();
 }
 
 void Renderer::endGame(bool isFinalEnd) {
@@ -814,6 +848,7 @@ void Renderer::endGame(bool isFinalEnd) {
 	worldToScreenPosCache.clear();
 	ReleaseSurfaceVBOs();
 	mapSurfaceData.clear();
+	mapRenderer.destroy();
 }
 
 void Renderer::endMenu() {
@@ -1019,6 +1054,19 @@ void Renderer::swapBuffers() {
 	//glFlush(); // should not be required - http://www.opengl.org/wiki/Common_Mistakes
 	//glFlush();
 
+	// capture the finished back buffer before it is presented
+	if(recordingScreen == true) {
+		if(recordFrameCount % recordFrameInterval == 0) {
+			char szBuf[8096]="";
+			snprintf(szBuf,8096,"%sframe%06d.%s",recordPath.c_str(),recordFrameIndex,recordFileFormat.c_str());
+			saveScreen(szBuf);
+			recordFrameIndex++;
+		}
+		recordFrameCount++;
+	}
+	processScreenReadbacks(false);
+	screenReadbackFrame++;
+
 	GraphicsInterface::getInstance().getCurrentContext()->swapBuffers();
 }
 
@@ -1460,6 +1508,92 @@ bool Renderer::CubeInFrustum(vector<vector<float> > &frustum, float x, float y,
    return true;
 }
 
+Renderer::FrustumCullResult Renderer::BoxInFrustum(vector<vector<float> > &frustum, const Vec3f &boxMin, const Vec3f &boxMax) {
+	bool allInside = true;
+	for(unsigned int p = 0; p < frustum.size(); ++p) {
+		int cornersInside = 0;
+		for(int corner = 0; corner < 8; ++corner) {
+			float x = ((corner & 1) ? boxMax.x : boxMin.x);
+			float y = ((corner & 2) ? boxMax.y : boxMin.y);
+			float z = ((corner & 4) ? boxMax.z : boxMin.z);
+			if(frustum[p][0] * x + frustum[p][1] * y + frustum[p][2] * z + frustum[p][3] > 0) {
+				cornersInside++;
+			}
+		}
+		if(cornersInside == 0) {
+			return fcrOutside;
+		}
+		if(cornersInside < 8) {
+			allInside = false;
+		}
+	}
+	return (allInside == true ? fcrInside : fcrIntersect);
+}
+
+// Collects the cube of every unit and grows the bounding box of the
+// tile it falls in. A tile completely outside (or inside) the frustum
+// gives the same answer CubeInFrustum would give for each of its units.
+void Renderer::buildUnitCullTiles(const World *world) {
+	const Map *map = world->getMap();
+	const int tilesW = (map->getW() + unitCullTileSize - 1) / unitCullTileSize;
+	const int tilesH = (map->getH() + unitCullTileSize - 1) / unitCullTileSize;
+	if(tilesW != unitCullTilesW || tilesH != unitCullTilesH) {
+		unitCullTilesW = tilesW;
+		unitCullTilesH = tilesH;
+		unitCullTiles.resize(tilesW * tilesH);
+	}
+	for(unsigned int i = 0; i < unitCullTiles.size(); ++i) {
+		unitCullTiles[i].empty = true;
+		unitCullTiles[i].result = fcrUnknown;
+	}
+	unitCullCubes.clear();
+
+	for(int i = 0; i < world->getFactionCount(); ++i) {
+		const Faction *faction = world->getFaction(i);
+		for(int j = 0; j < faction->getUnitCount(); ++j) {
+			Unit *unit = faction->getUnit(j);
+
+			UnitCullCube cube;
+			cube.center = unit->getCurrMidHeightVector();
+			cube.size = unit->getType()->getRenderSize();
+
+			int tileX = clamp((int)cube.center.x / unitCullTileSize, 0, unitCullTilesW - 1);
+			int tileY = clamp((int)cube.center.z / unitCullTileSize, 0, unitCullTilesH - 1);
+			cube.tileIndex = tileY * unitCullTilesW + tileX;
+			unitCullCubes.push_back(cube);
+
+			const Vec3f cubeMin = cube.center - Vec3f(cube.size);
+			const Vec3f cubeMax = cube.center + Vec3f(cube.size);
+			UnitCullTile &tile = unitCullTiles[cube.tileIndex];
+			if(tile.empty == true) {
+				tile.empty = false;
+				tile.boxMin = cubeMin;
+				tile.boxMax = cubeMax;
+			}
+			else {
+				tile.boxMin.x = min(tile.boxMin.x, cubeMin.x);
+				tile.boxMin.y = min(tile.boxMin.y, cubeMin.y);
+				tile.boxMin.z = min(tile.boxMin.z, cubeMin.z);
+				tile.boxMax.x = max(tile.boxMax.x, cubeMax.x);
+				tile.boxMax.y = max(tile.boxMax.y, cubeMax.y);
+				tile.boxMax.z = max(tile.boxMax.z, cubeMax.z);
+			}
+		}
+	}
+}
+
+bool Renderer::isUnitCubeInFrustum(int unitIndex) {
+	const UnitCullCube &cube = unitCullCubes[unitIndex];
+	UnitCullTile &tile = unitCullTiles[cube.tileIndex];
+	if(tile.result == fcrUnknown) {
+		tile.result = BoxInFrustum(quadCache.frustumData, tile.boxMin, tile.boxMax);
+	}
+	if(tile.result == fcrIntersect) {
+		return CubeInFrustum(quadCache.frustumData, cube.center.x, cube.center.y, cube.center.z, cube.size);
+	}
+	return (tile.result == fcrInside);
+}
+
 void Renderer::computeVisibleQuad() {
 	visibleQuad = this->gameCamera->computeVisibleQuad();
 
@@ -4458,11 +4592,232 @@ void Renderer::MapRenderer::render(const Map* map,float coordStep,VisibleQuadCon
 	assertGl();
 }
 
+Renderer::MapRenderer::Chunk::~Chunk() {
+	if(vbo_vertices) glDeleteBuffersARB(1,&vbo_vertices);
+	if(vbo_normals) glDeleteBuffersARB(1,&vbo_normals);
+	if(vbo_fowTexCoords) glDeleteBuffersARB(1,&vbo_fowTexCoords);
+	if(vbo_surfTexCoords) glDeleteBuffersARB(1,&vbo_surfTexCoords);
+	if(vbo_indices) glDeleteBuffersARB(1,&vbo_indices);
+}
+
+// emits the four corners of a surface quad in the same order as the layer loaders
+static void _emitSurfaceQuadGeometry(const Map *map, const Vec2i &pos,
+		std::vector<Vec3f> &vertices, std::vector<Vec3f> &normals) {
+	const SurfaceCell *tc[4] = {
+		map->getSurfaceCell(pos.x,pos.y),
+		map->getSurfaceCell(pos.x+1,pos.y),
+		map->getSurfaceCell(pos.x,pos.y+1),
+		map->getSurfaceCell(pos.x+1,pos.y+1)
+	};
+	const int loopIndexes[4] = { 2,0,3,1 };
+	for(int i=0; i < 4; i++) {
+		vertices.push_back(tc[loopIndexes[i]]->getVertex());
+		normals.push_back(tc[loopIndexes[i]]->getNormal());
+	}
+}
+
+void Renderer::MapRenderer::loadChunks(float coordStep) {
+	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
+		return;
+	}
+
+	const int chunkSize = Map::surfaceChunkSize;
+	const int quadsW = map->getSurfaceW() - 1;
+	const int quadsH = map->getSurfaceH() - 1;
+	chunksW = map->getSurfaceChunksW();
+	chunksH = map->getSurfaceChunksH();
+	chunks.reserve(chunksW * chunksH);
+
+	for(int cy = 0; cy < chunksH; ++cy) {
+		for(int cx = 0; cx < chunksW; ++cx) {
+			Chunk *chunk = new Chunk();
+			chunk->surfRect = Rect2i(cx * chunkSize, cy * chunkSize,
+					min(quadsW, (cx + 1) * chunkSize) - 1,
+					min(quadsH, (cy + 1) * chunkSize) - 1);
+			chunk->version = map->getSurfaceChunkVersion(cx,cy);
+			chunks.push_back(chunk);
+
+			// group the quads by texture so each layer is one contiguous index run
+			std::map<int, vector<Vec2i> > cellsByTexture;
+			for(int y = chunk->surfRect.p[0].y; y <= chunk->surfRect.p[1].y; ++y) {
+				for(int x = chunk->surfRect.p[0].x; x <= chunk->surfRect.p[1].x; ++x) {
+					int textureHandle = static_cast<const Texture2DGl*>(map->getSurfaceCell(x,y)->getSurfaceTexture())->getHandle();
+					cellsByTexture[textureHandle].push_back(Vec2i(x,y));
+				}
+			}
+			if(cellsByTexture.empty() == true) {
+				continue;
+			}
+
+			std::vector<Vec3f> vertices, normals;
+			std::vector<Vec2f> fowTexCoords, surfTexCoords;
+			std::vector<GLuint> indices;
+			for(std::map<int, vector<Vec2i> >::iterator iterMap = cellsByTexture.begin();
+					iterMap != cellsByTexture.end(); ++iterMap) {
+				ChunkLayer layer;
+				layer.textureHandle = iterMap->first;
+				layer.indexOffset = (int)indices.size();
+
+				const vector<Vec2i> &cells = iterMap->second;
+				for(unsigned int i = 0; i < cells.size(); ++i) {
+					const Vec2i &pos = cells[i];
+					const int index = (int)vertices.size();
+					chunk->cellOrder.push_back(pos);
+					_emitSurfaceQuadGeometry(map,pos,vertices,normals);
+
+					fowTexCoords.push_back(map->getSurfaceCell(pos.x,pos.y+1)->getFowTexCoord());
+					fowTexCoords.push_back(map->getSurfaceCell(pos.x,pos.y)->getFowTexCoord());
+					fowTexCoords.push_back(map->getSurfaceCell(pos.x+1,pos.y+1)->getFowTexCoord());
+					fowTexCoords.push_back(map->getSurfaceCell(pos.x+1,pos.y)->getFowTexCoord());
+
+					const Vec2f &surfCoord = map->getSurfaceCell(pos.x,pos.y)->getSurfTexCoord();
+					surfTexCoords.push_back(surfCoord+Vec2f(0,coordStep));
+					surfTexCoords.push_back(surfCoord+Vec2f(0,0));
+					surfTexCoords.push_back(surfCoord+Vec2f(coordStep,coordStep));
+					surfTexCoords.push_back(surfCoord+Vec2f(coordStep,0));
+
+					indices.push_back(index + 0);
+					indices.push_back(index + 1);
+					indices.push_back(index + 2);
+					indices.push_back(index + 1);
+					indices.push_back(index + 3);
+					indices.push_back(index + 2);
+				}
+				layer.indexCount = (int)indices.size() - layer.indexOffset;
+				chunk->layers.push_back(layer);
+			}
+
+			_loadVBO(chunk->vbo_vertices,vertices);
+			_loadVBO(chunk->vbo_normals,normals);
+			_loadVBO(chunk->vbo_fowTexCoords,fowTexCoords);
+			_loadVBO(chunk->vbo_surfTexCoords,surfTexCoords);
+			_loadVBO(chunk->vbo_indices,indices,GL_ELEMENT_ARRAY_BUFFER_ARB);
+		}
+	}
+}
+
+void Renderer::MapRenderer::updateChunk(Chunk *chunk) {
+	if(chunk->vbo_vertices == 0) {
+		return;
+	}
+
+	std::vector<Vec3f> vertices, normals;
+	vertices.reserve(chunk->cellOrder.size() * 4);
+	normals.reserve(chunk->cellOrder.size() * 4);
+	for(unsigned int i = 0; i < chunk->cellOrder.size(); ++i) {
+		_emitSurfaceQuadGeometry(map,chunk->cellOrder[i],vertices,normals);
+	}
+
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB,chunk->vbo_vertices);
+	glBufferSubDataARB(GL_ARRAY_BUFFER_ARB,0,sizeof(Vec3f)*vertices.size(),&vertices[0]);
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB,chunk->vbo_normals);
+	glBufferSubDataARB(GL_ARRAY_BUFFER_ARB,0,sizeof(Vec3f)*normals.size(),&normals[0]);
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB,0);
+	assertGl();
+}
+
+void Renderer::MapRenderer::renderChunks(const Map* map,float coordStep,VisibleQuadContainerCache &qCache) {
+	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
+		return;
+	}
+
+	if(map != this->map) {
+		destroy(); // clear any previous map data
+		this->map = map;
+		loadChunks(coordStep);
+	}
+	if(chunks.empty() == true) {
+		return;
+	}
+
+	// chunks touched by the bounding rect of the visible quad, in surface cells
+	Quad2i visibleQuad = qCache.lastVisibleQuad;
+	Quad2i scaledQuad = visibleQuad / Map::cellScale;
+	int minX = scaledQuad.p[0].x, maxX = scaledQuad.p[0].x;
+	int minY = scaledQuad.p[0].y, maxY = scaledQuad.p[0].y;
+	for(int i = 1; i < 4; ++i) {
+		minX = min(minX, scaledQuad.p[i].x);
+		maxX = max(maxX, scaledQuad.p[i].x);
+		minY = min(minY, scaledQuad.p[i].y);
+		maxY = max(maxY, scaledQuad.p[i].y);
+	}
+	const int chunkSize = Map::surfaceChunkSize;
+	const int chunkXStart = max(0, minX / chunkSize);
+	const int chunkYStart = max(0, minY / chunkSize);
+	const int chunkXEnd = min(chunksW - 1, maxX / chunkSize);
+	const int chunkYEnd = min(chunksH - 1, maxY / chunkSize);
+
+	glClientActiveTexture(fowTexUnit);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glClientActiveTexture(baseTexUnit);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_NORMAL_ARRAY);
+
+	int lastTextureHandle = -1;
+	for(int cy = chunkYStart; cy <= chunkYEnd; ++cy) {
+		for(int cx = chunkXStart; cx <= chunkXEnd; ++cx) {
+			Chunk *chunk = chunks[cy * chunksW + cx];
+			if(chunk->vbo_vertices == 0) {
+				continue;
+			}
+
+			uint32 version = map->getSurfaceChunkVersion(cx,cy);
+			if(chunk->version != version) {
+				updateChunk(chunk);
+				chunk->version = version;
+			}
+
+			glBindBufferARB(GL_ARRAY_BUFFER_ARB,chunk->vbo_vertices);
+			glVertexPointer(3,GL_FLOAT,0,NULL);
+			glBindBufferARB(GL_ARRAY_BUFFER_ARB,chunk->vbo_normals);
+			glNormalPointer(GL_FLOAT,0,NULL);
+
+			glClientActiveTexture(fowTexUnit);
+			glBindBufferARB(GL_ARRAY_BUFFER_ARB,chunk->vbo_fowTexCoords);
+			glTexCoordPointer(2,GL_FLOAT,0,NULL);
+
+			glClientActiveTexture(baseTexUnit);
+			glBindBufferARB(GL_ARRAY_BUFFER_ARB,chunk->vbo_surfTexCoords);
+			glTexCoordPointer(2,GL_FLOAT,0,NULL);
+
+			glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB,chunk->vbo_indices);
+			for(unsigned int i = 0; i < chunk->layers.size(); ++i) {
+				const ChunkLayer &layer = chunk->layers[i];
+				if(layer.textureHandle != lastTextureHandle) {
+					glBindTexture(GL_TEXTURE_2D,layer.textureHandle);
+					lastTextureHandle = layer.textureHandle;
+				}
+				glDrawElements(GL_TRIANGLES,layer.indexCount,GL_UNSIGNED_INT,
+						(const GLvoid *)(layer.indexOffset * sizeof(GLuint)));
+			}
+		}
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER_ARB,0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER_ARB,0);
+	glDisableClientState(GL_NORMAL_ARRAY);
+	glClientActiveTexture(fowTexUnit);
+	glBindTexture(GL_TEXTURE_2D,0);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glClientActiveTexture(baseTexUnit);
+	glBindTexture(GL_TEXTURE_2D,0);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	assertGl();
+}
+
 void Renderer::MapRenderer::destroy() {
 	while(layers.empty() == false) {
 		delete layers.back();
 		layers.pop_back();
 	}
+	while(chunks.empty() == false) {
+		delete chunks.back();
+		chunks.pop_back();
+	}
+	chunksW = 0;
+	chunksH = 0;
 	map = NULL;
 }
 
@@ -4499,10 +4854,24 @@ void Renderer::renderSurface(const int renderFps) {
 	glEnable(GL_TEXTURE_2D);
 	glBindTexture(GL_TEXTURE_2D, static_cast<const Texture2DGl*>(fowTex)->getHandle());
 
-	glTexSubImage2D(
-		GL_TEXTURE_2D, 0, 0, 0,
-		fowTex->getPixmapConst()->getW(), fowTex->getPixmapConst()->getH(),
-		GL_ALPHA, GL_UNSIGNED_BYTE, fowTex->getPixmapConst()->getPixels());
+	// only upload the part of the fog of war that changed since the last frame
+	Vec2i fowDirtyPos;
+	Vec2i fowDirtySize;
+	if(world->getMinimap()->getFowTexDirtyRect(fowDirtyPos, fowDirtySize) == true) {
+		const Pixmap2D *fowPixmap = fowTex->getPixmapConst();
+
+		glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, fowPixmap->getW());
+		glTexSubImage2D(
+			GL_TEXTURE_2D, 0, fowDirtyPos.x, fowDirtyPos.y,
+			fowDirtySize.x, fowDirtySize.y,
+			GL_ALPHA, GL_UNSIGNED_BYTE,
+			fowPixmap->getPixels() + fowDirtyPos.y * fowPixmap->getW() + fowDirtyPos.x);
+		glPopClientAttrib();
+
+		world->getMinimap()->clearFowTexDirtyRect();
+	}
 
 	if(shadowsOffDueToMinRender == false) {
 		//shadow texture
@@ -4527,7 +4896,8 @@ void Renderer::renderSurface(const int renderFps) {
 	if(useVBORendering == true) {
 		VisibleQuadContainerCache &qCache = getQuadCache();
 		//mapRenderer.render(map,coordStep,qCache);
-		mapRenderer.renderVisibleLayers(map,coordStep,qCache);
+		//mapRenderer.renderVisibleLayers(map,coordStep,qCache);
+		mapRenderer.renderChunks(map,coordStep,qCache);
 	}
 	else if(qCache.visibleScaledCellList.empty() == false) {
 
@@ -4890,6 +5260,91 @@ void Renderer::renderSurface(const int renderFps) {
 	)
 }
 
+// column major equivalent of glTranslatef(pos), glRotatef(rotZ,z), glRotatef(rotX,x), glRotatef(rotY,y)
+static Matrix4f computeModelTransform(const Vec3f &pos, float rotY, float rotX, float rotZ) {
+	const float cy= std::cos(degToRad(rotY)), sy= std::sin(degToRad(rotY));
+	const float cx= std::cos(degToRad(rotX)), sx= std::sin(degToRad(rotX));
+	const float cz= std::cos(degToRad(rotZ)), sz= std::sin(degToRad(rotZ));
+
+	const float rotationY[3][3]= {{ cy, 0.f, sy }, { 0.f, 1.f, 0.f }, { -sy, 0.f, cy }};
+	const float rotationX[3][3]= {{ 1.f, 0.f, 0.f }, { 0.f, cx, -sx }, { 0.f, sx, cx }};
+	const float rotationZ[3][3]= {{ cz, -sz, 0.f }, { sz, cz, 0.f }, { 0.f, 0.f, 1.f }};
+
+	float rotationXY[3][3];
+	float rotation[3][3];
+	for(int i = 0; i < 3; ++i) {
+		for(int j = 0; j < 3; ++j) {
+			rotationXY[i][j]= rotationX[i][0] * rotationY[0][j] + rotationX[i][1] * rotationY[1][j] + rotationX[i][2] * rotationY[2][j];
+		}
+	}
+	for(int i = 0; i < 3; ++i) {
+		for(int j = 0; j < 3; ++j) {
+			rotation[i][j]= rotationZ[i][0] * rotationXY[0][j] + rotationZ[i][1] * rotationXY[1][j] + rotationZ[i][2] * rotationXY[2][j];
+		}
+	}
+
+	Matrix4f result;
+	for(int column = 0; column < 3; ++column) {
+		for(int row = 0; row < 3; ++row) {
+			result[column * 4 + row]= rotation[row][column];
+		}
+		result[column * 4 + 3]= 0.f;
+	}
+	result[12]= pos.x;
+	result[13]= pos.y;
+	result[14]= pos.z;
+	result[15]= 1.f;
+	return result;
+}
+
+// Visible models sharing everything but their transform, drawn with one renderInstances call
+class ModelInstanceBatch {
+public:
+	Model *model;
+	float animProgress;
+	bool cycleAnimation;
+	const Texture *teamTexture;
+	float fowFactor;
+	vector<Matrix4f> transforms;
+
+	ModelInstanceBatch(Model *model, float animProgress, bool cycleAnimation,
+			const Texture *teamTexture, float fowFactor) :
+		model(model), animProgress(animProgress), cycleAnimation(cycleAnimation),
+		teamTexture(teamTexture), fowFactor(fowFactor) {}
+
+	bool operator<(const ModelInstanceBatch &other) const {
+		if(model != other.model) return model < other.model;
+		if(animProgress != other.animProgress) return animProgress < other.animProgress;
+		if(cycleAnimation != other.cycleAnimation) return cycleAnimation < other.cycleAnimation;
+		if(teamTexture != other.teamTexture) return teamTexture < other.teamTexture;
+		return fowFactor < other.fowFactor;
+	}
+};
+
+// Keeps batches in the order their first member was visited so draw order stays close to the per model loop
+class ModelInstanceBatchList {
+private:
+	std::map<ModelInstanceBatch, int> batchIndexes;
+	vector<ModelInstanceBatch> batches;
+
+public:
+	void add(const ModelInstanceBatch &key, const Matrix4f &transform) {
+		std::map<ModelInstanceBatch, int>::iterator iterFind= batchIndexes.find(key);
+		int index= 0;
+		if(iterFind == batchIndexes.end()) {
+			index= (int)batches.size();
+			batchIndexes[key]= index;
+			batches.push_back(key);
+		}
+		else {
+			index= iterFind->second;
+		}
+		batches[index].transforms.push_back(transform);
+	}
+
+	vector<ModelInstanceBatch> & getBatches() { return batches; }
+};
+
 void Renderer::renderObjects(const int renderFps) {
 	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
 		return;
@@ -4911,6 +5366,9 @@ void Renderer::renderObjects(const int renderFps) {
 
 	VisibleQuadContainerCache &qCache = getQuadCache();
 
+	// identical models under the same fog of war value and animation frame are drawn together
+	ModelInstanceBatchList batchList;
+
 	//	for(int visibleIndex = 0;
 	//			visibleIndex < qCache.visibleObjectList.size(); ++visibleIndex) {
 	// render from last to first object so animated objects which are on bottom of screen are
@@ -4923,6 +5381,32 @@ void Renderer::renderObjects(const int renderFps) {
 		//objModel->updateInterpolationData(o->getAnimProgress(), true);
 		const Vec3f v= o->getConstPos();
 
+		//ambient and diffuse color is taken from cell color
+		float fowFactor= fowTexPixmap->getPixelf(o->getMapPos().x / Map::cellScale, o->getMapPos().y / Map::cellScale);
+
+		//objModel->updateInterpolationData(0.f, true);
+		//if(this->gameCamera->getPos().dist(o->getPos()) <= SKIP_INTERPOLATION_DISTANCE) {
+		float animProgress= 0.f;
+		if (tilesetObjectsToAnimate == -1) {
+			animProgress= o->getAnimProgress();
+		} else if (tilesetObjectsToAnimate > 0 && o->isAnimated()) {
+			tilesetObjectsToAnimate--;
+			animProgress= o->getAnimProgress();
+		}
+
+		//We use OpenGL Lights so no manual action is needed here. In fact this call did bad things on lighting big rocks for example
+		//		if(o->getRotation() != 0.0) {
+		//			setupLightingForRotatedModel();
+		//		}
+		batchList.add(ModelInstanceBatch(objModel, animProgress, true, NULL, fowFactor),
+				computeModelTransform(v, o->getRotation(), 0.f, 0.f));
+	}
+
+	vector<ModelInstanceBatch> &batches= batchList.getBatches();
+	for(unsigned int batchIndex = 0; batchIndex < batches.size(); ++batchIndex) {
+		ModelInstanceBatch &batch= batches[batchIndex];
+		Model *objModel= batch.model;
+
 		if(modelRenderStarted == false) {
 			modelRenderStarted = true;
 
@@ -4945,45 +5429,17 @@ void Renderer::renderObjects(const int renderFps) {
 
 			modelRenderer->begin(true, true, false, false);
 		}
-		//ambient and diffuse color is taken from cell color
 
-		float fowFactor= fowTexPixmap->getPixelf(o->getMapPos().x / Map::cellScale, o->getMapPos().y / Map::cellScale);
-		Vec4f color= Vec4f(Vec3f(fowFactor), 1.f);
+		Vec4f color= Vec4f(Vec3f(batch.fowFactor), 1.f);
 		glColor4fv(color.ptr());
 		glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, (color * ambFactor).ptr());
-		glFogfv(GL_FOG_COLOR, (baseFogColor * fowFactor).ptr());
-
-		glMatrixMode(GL_MODELVIEW);
-		glPushMatrix();
-		glTranslatef(v.x, v.y, v.z);
-		glRotatef(o->getRotation(), 0.f, 1.f, 0.f);
-
-		//We use OpenGL Lights so no manual action is needed here. In fact this call did bad things on lighting big rocks for example
-		//		if(o->getRotation() != 0.0) {
-		//			setupLightingForRotatedModel();
-		//		}
+		glFogfv(GL_FOG_COLOR, (baseFogColor * batch.fowFactor).ptr());
 
-		//objModel->updateInterpolationData(0.f, true);
-		//if(this->gameCamera->getPos().dist(o->getPos()) <= SKIP_INTERPOLATION_DISTANCE) {
+		objModel->updateInterpolationData(batch.animProgress, true);
+		static_cast<ModelRendererGl*>(modelRenderer)->renderInstances(objModel, batch.transforms);
 
-
-		if (tilesetObjectsToAnimate == -1) {
-			objModel->updateInterpolationData(o->getAnimProgress(), true);
-		} else if (tilesetObjectsToAnimate > 0 && o->isAnimated()) {
-			tilesetObjectsToAnimate--;
-			objModel->updateInterpolationData(o->getAnimProgress(), true);
-		} else {
-			objModel->updateInterpolationData(0, true);
-		}
-
-//		objModel->updateInterpolationData(o->getAnimProgress(), true);
-		//}
-		modelRenderer->render(objModel);
-
-		triangleCount+= objModel->getTriangleCount();
-		pointCount+= objModel->getVertexCount();
-
-		glPopMatrix();
+		triangleCount+= objModel->getTriangleCount() * (int)batch.transforms.size();
+		pointCount+= objModel->getVertexCount() * (int)batch.transforms.size();
 	}
 
 	if(modelRenderStarted == true) {
@@ -5330,7 +5786,10 @@ void Renderer::renderUnits(bool airUnits, const int renderFps) {
 
 	VisibleQuadContainerCache &qCache = getQuadCache();
 	if(qCache.visibleQuadUnitList.empty() == false) {
-		bool modelRenderStarted = false;
+		// units of one type, team and animation frame are drawn together,
+		// fading corpses keep their own material so they are drawn one by one
+		ModelInstanceBatchList batchList;
+		vector<Unit *> fadingUnits;
 		for(int visibleUnitIndex = 0;
 				visibleUnitIndex < (int)qCache.visibleQuadUnitList.size(); ++visibleUnitIndex) {
 			Unit *unit = qCache.visibleQuadUnitList[visibleUnitIndex];
@@ -5338,29 +5797,77 @@ void Renderer::renderUnits(bool airUnits, const int renderFps) {
 			if(( airUnits==false && unit->getType()->getField()==fAir) || ( airUnits==true && unit->getType()->getField()!=fAir)){
 				continue;
 			}
-			meshCallbackTeamColor.setTeamTexture(unit->getFaction()->getTexture());
 
-			if(modelRenderStarted == false) {
-				modelRenderStarted = true;
+			Vec3f currVec= unit->getCurrVectorFlat();
 
-				glPushAttrib(GL_ENABLE_BIT | GL_FOG_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT);
-				glEnable(GL_COLOR_MATERIAL);
+			const SkillType *st= unit->getCurrSkill();
+			if(st->getClass() == scDie && static_cast<const DieSkillType*>(st)->getFade()) {
+				fadingUnits.push_back(unit);
+			}
+			else {
+				//render
+				Model *model= unit->getCurrentModelPtr();
+				batchList.add(ModelInstanceBatch(model, unit->getAnimProgressAsFloat(),
+						unit->isAlive() && !unit->isAnimProgressBound(),
+						unit->getFaction()->getTexture(), 1.f),
+						computeModelTransform(currVec, unit->getRotation(), unit->getRotationX(), unit->getRotationZ()));
+			}
+			unit->setVisible(true);
 
-				if(!shadowsOffDueToMinRender) {
-					if(shadows == sShadowMapping) {
-						glActiveTexture(shadowTexUnit);
-						glEnable(GL_TEXTURE_2D);
+			if(	showDebugUI == true &&
+				(showDebugUILevel & debugui_unit_titles) == debugui_unit_titles) {
 
-						glBindTexture(GL_TEXTURE_2D, shadowMapHandle);
+				unit->setScreenPos(computeScreenPosition(currVec));
+				visibleFrameUnitList.push_back(unit);
+				visibleFrameUnitListCameraKey = game->getGameCamera()->getCameraMovementKey();
+			}
+		}
 
-						static_cast<ModelRendererGl*>(modelRenderer)->setDuplicateTexCoords(true);
-						enableProjectiveTexturing();
-					}
-				}
-				glActiveTexture(baseTexUnit);
+		vector<ModelInstanceBatch> &batches= batchList.getBatches();
+		bool modelRenderStarted = false;
+		if(batches.empty() == false || fadingUnits.empty() == false) {
+			modelRenderStarted = true;
+
+			glPushAttrib(GL_ENABLE_BIT | GL_FOG_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT);
+			glEnable(GL_COLOR_MATERIAL);
+
+			if(!shadowsOffDueToMinRender) {
+				if(shadows == sShadowMapping) {
+					glActiveTexture(shadowTexUnit);
+					glEnable(GL_TEXTURE_2D);
+
+					glBindTexture(GL_TEXTURE_2D, shadowMapHandle);
 
-				modelRenderer->begin(true, true, true, false, &meshCallbackTeamColor);
+					static_cast<ModelRendererGl*>(modelRenderer)->setDuplicateTexCoords(true);
+					enableProjectiveTexturing();
+				}
 			}
+			glActiveTexture(baseTexUnit);
+
+			modelRenderer->begin(true, true, true, false, &meshCallbackTeamColor);
+		}
+
+		if(batches.empty() == false) {
+			glEnable(GL_COLOR_MATERIAL);
+			// we cut off a tiny bit here to avoid problems with fully transparent texture parts cutting units in background rendered later.
+			glAlphaFunc(GL_GREATER, 0.02f);
+		}
+		for(unsigned int batchIndex = 0; batchIndex < batches.size(); ++batchIndex) {
+			ModelInstanceBatch &batch= batches[batchIndex];
+			meshCallbackTeamColor.setTeamTexture(batch.teamTexture);
+
+			//if(this->gameCamera->getPos().dist(unit->getCurrVector()) <= SKIP_INTERPOLATION_DISTANCE) {
+				batch.model->updateInterpolationData(batch.animProgress, batch.cycleAnimation);
+			//}
+
+			static_cast<ModelRendererGl*>(modelRenderer)->renderInstances(batch.model, batch.transforms);
+			triangleCount+= batch.model->getTriangleCount() * (int)batch.transforms.size();
+			pointCount+= batch.model->getVertexCount() * (int)batch.transforms.size();
+		}
+
+		for(unsigned int fadingIndex = 0; fadingIndex < fadingUnits.size(); ++fadingIndex) {
+			Unit *unit = fadingUnits[fadingIndex];
+			meshCallbackTeamColor.setTeamTexture(unit->getFaction()->getTexture());
 
 			glMatrixMode(GL_MODELVIEW);
 			glPushMatrix();
@@ -5381,40 +5888,19 @@ void Renderer::renderUnits(bool airUnits, const int renderFps) {
 			glRotatef(unit->getRotation(), 0.f, 1.f, 0.f);
 
 			//dead alpha
-			const SkillType *st= unit->getCurrSkill();
-			if(st->getClass() == scDie && static_cast<const DieSkillType*>(st)->getFade()) {
-				float alpha= 1.0f - unit->getAnimProgressAsFloat();
-				glDisable(GL_COLOR_MATERIAL);
-				glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, Vec4f(1.0f, 1.0f, 1.0f, alpha).ptr());
-			}
-			else {
-				glEnable(GL_COLOR_MATERIAL);
-				// we cut off a tiny bit here to avoid problems with fully transparent texture parts cutting units in background rendered later.
-				glAlphaFunc(GL_GREATER, 0.02f);
-			}
+			float alpha= 1.0f - unit->getAnimProgressAsFloat();
+			glDisable(GL_COLOR_MATERIAL);
+			glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, Vec4f(1.0f, 1.0f, 1.0f, alpha).ptr());
 
 			//render
 			Model *model= unit->getCurrentModelPtr();
-			//printf("Rendering model [%d - %s]\n[%s]\nCamera [%s]\nDistance: %f\n",unit->getId(),unit->getType()->getName().c_str(),unit->getCurrVector().getString().c_str(),this->gameCamera->getPos().getString().c_str(),this->gameCamera->getPos().dist(unit->getCurrVector()));
-
-			//if(this->gameCamera->getPos().dist(unit->getCurrVector()) <= SKIP_INTERPOLATION_DISTANCE) {
-				model->updateInterpolationData(unit->getAnimProgressAsFloat(), unit->isAlive() && !unit->isAnimProgressBound());
-			//}
+			model->updateInterpolationData(unit->getAnimProgressAsFloat(), unit->isAlive() && !unit->isAnimProgressBound());
 
 			modelRenderer->render(model);
 			triangleCount+= model->getTriangleCount();
 			pointCount+= model->getVertexCount();
 
 			glPopMatrix();
-			unit->setVisible(true);
-
-			if(	showDebugUI == true &&
-				(showDebugUILevel & debugui_unit_titles) == debugui_unit_titles) {
-
-				unit->setScreenPos(computeScreenPosition(currVec));
-				visibleFrameUnitList.push_back(unit);
-				visibleFrameUnitListCameraKey = game->getGameCamera()->getCameraMovementKey();
-			}
 		}
 
 		if(modelRenderStarted == true) {
@@ -7719,7 +8205,43 @@ void Renderer::saveScreen(const string &path,int w, int h) {
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
-	Pixmap2D *pixmapScreenShot = new Pixmap2D(sm.getScreenW(),sm.getScreenH(), 3);
+	const int screenW = sm.getScreenW();
+	const int screenH = sm.getScreenH();
+
+	if(isGlExtensionSupported("GL_ARB_pixel_buffer_object") == true) {
+		// read into a pixel pack buffer, the copy to memory happens a frame later
+		ScreenReadback &readback = screenReadbacks[screenReadbackIndex];
+		if(readback.pending == true) {
+			finishScreenReadback(readback);
+		}
+
+		int bufferSize = screenW * screenH * 3;
+		if(readback.pbo == 0) {
+			glGenBuffersARB(1, &readback.pbo);
+		}
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readback.pbo);
+		if(readback.bufferSize != bufferSize) {
+			glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, bufferSize, NULL, GL_STREAM_READ_ARB);
+			readback.bufferSize = bufferSize;
+		}
+
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, screenW, screenH, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+		readback.pending = true;
+		readback.issuedFrame = screenReadbackFrame;
+		readback.path = path;
+		readback.width = screenW;
+		readback.height = screenH;
+		readback.scaleWidth = w;
+		readback.scaleHeight = h;
+
+		screenReadbackIndex = (screenReadbackIndex + 1) % 2;
+		return;
+	}
+
+	Pixmap2D *pixmapScreenShot = new Pixmap2D(screenW,screenH, 3);
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 	//glFinish();
@@ -7730,30 +8252,116 @@ void Renderer::saveScreen(const string &path,int w, int h) {
 	glReadPixels(0, 0, pixmapScreenShot->getW(), pixmapScreenShot->getH(),
 				 GL_RGB, GL_UNSIGNED_BYTE, pixmapScreenShot->getPixels());
 
-	if(w==0 || h==0){
-		h=sm.getScreenH();
-		w=sm.getScreenW();
-	}
-	else{
+	if(w!=0 && h!=0){
 		pixmapScreenShot->Scale(GL_RGB,w,h);
 	}
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-	// Signal the threads queue to add a screenshot save request
-	MutexSafeWrapper safeMutex(saveScreenShotThreadAccessor,string(extractFileFromDirectoryPath(__FILE__).c_str()) + "_" + intToStr(__LINE__));
-	saveScreenQueue.push_back(make_pair(path,pixmapScreenShot));
-	safeMutex.ReleaseLock();
+	queueScreenshot(path,pixmapScreenShot);
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 }
 
+void Renderer::queueScreenshot(const string &path, Pixmap2D *pixmap) {
+	// Signal the threads queue to add a screenshot save request, when the
+	// encoders fall behind the render thread waits instead of dropping frames
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(saveScreenShotThreadAccessor,mutexOwnerId);
+	for(;saveScreenShotThreads.empty() == false &&
+		 (int)saveScreenQueue.size() >= saveScreenQueueLimit;) {
+		safeMutex.ReleaseLock(true);
+		sleep(1);
+		safeMutex.Lock();
+	}
+	saveScreenQueue.push_back(make_pair(path,pixmap));
+	safeMutex.ReleaseLock();
+}
+
+void Renderer::finishScreenReadback(ScreenReadback &readback) {
+	readback.pending = false;
+
+	Pixmap2D *pixmapScreenShot = new Pixmap2D(readback.width,readback.height, 3);
+	glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readback.pbo);
+	const uint8 *pixels = static_cast<const uint8 *>(glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB));
+	if(pixels != NULL) {
+		memcpy(pixmapScreenShot->getPixels(), pixels, pixmapScreenShot->getPixelByteCount());
+		glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+	}
+	glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+	if(pixels == NULL) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] could not map screen readback for [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,readback.path.c_str());
+		delete pixmapScreenShot;
+		return;
+	}
+
+	if(readback.scaleWidth != 0 && readback.scaleHeight != 0) {
+		pixmapScreenShot->Scale(GL_RGB,readback.scaleWidth,readback.scaleHeight);
+	}
+	queueScreenshot(readback.path,pixmapScreenShot);
+}
+
+void Renderer::processScreenReadbacks(bool finishAll) {
+	// readbacks issued in an earlier frame have completed on the gpu by now
+	for(int i = 0; i < 2; ++i) {
+		int index = (screenReadbackIndex + i) % 2;
+		ScreenReadback &readback = screenReadbacks[index];
+		if(readback.pending == true &&
+			(finishAll == true || readback.issuedFrame < screenReadbackFrame)) {
+			finishScreenReadback(readback);
+		}
+	}
+}
+
+void Renderer::cleanupScreenReadbacks() {
+	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
+		return;
+	}
+	recordingScreen = false;
+	processScreenReadbacks(true);
+	for(int i = 0; i < 2; ++i) {
+		if(screenReadbacks[i].pbo != 0) {
+			glDeleteBuffersARB(1, &screenReadbacks[i].pbo);
+		}
+		screenReadbacks[i] = ScreenReadback();
+	}
+}
+
+void Renderer::startScreenRecording(const string &path, int frameInterval, const string &fileFormat) {
+	recordPath = path;
+	endPathWithSlash(recordPath);
+	if(isdir(recordPath.c_str()) == false) {
+		createDirectoryPaths(recordPath);
+	}
+	recordFileFormat = fileFormat;
+	recordFrameInterval = max(1,frameInterval);
+	recordFrameCount = 0;
+	recordFrameIndex = 0;
+	recordingScreen = true;
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Recording every %d frame(s) to [%s]\n",recordFrameInterval,recordPath.c_str());
+}
+
+void Renderer::stopScreenRecording() {
+	recordingScreen = false;
+	processScreenReadbacks(true);
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Recording stopped after %d frame(s)\n",recordFrameIndex);
+}
+
 unsigned int Renderer::getSaveScreenQueueSize() {
 	MutexSafeWrapper safeMutex(saveScreenShotThreadAccessor,string(extractFileFromDirectoryPath(__FILE__).c_str()) + "_" + intToStr(__LINE__));
 	int queueSize = (int)saveScreenQueue.size();
 	safeMutex.ReleaseLock();
 
+	// captures still waiting in a pixel buffer will be queued next frame
+	for(int i = 0; i < 2; ++i) {
+		if(screenReadbacks[i].pending == true) {
+			queueSize++;
+		}
+	}
 	return queueSize;
 }
 
@@ -9166,15 +9774,19 @@ VisibleQuadContainerCache & Renderer::getQuadCache(	bool updateOnDirtyFrame,
 			//}
 
 			// Unit calculations
+			if(VisibleQuadContainerCache::enableFrustumCalcs == true) {
+				buildUnitCullTiles(world);
+			}
+			int unitIndex = 0;
 			for(int i = 0; i < world->getFactionCount(); ++i) {
 				const Faction *faction = world->getFaction(i);
-				for(int j = 0; j < faction->getUnitCount(); ++j) {
+				for(int j = 0; j < faction->getUnitCount(); ++j, ++unitIndex) {
 					Unit *unit= faction->getUnit(j);
 
 					bool unitCheckedForRender = false;
 					if(VisibleQuadContainerCache::enableFrustumCalcs == true) {
 						//bool insideQuad 	= PointInFrustum(quadCache.frustumData, unit->getCurrVector().x, unit->getCurrVector().y, unit->getCurrVector().z );
-						bool insideQuad 	= CubeInFrustum(quadCache.frustumData, unit->getCurrMidHeightVector().x, unit->getCurrMidHeightVector().y, unit->getCurrMidHeightVector().z, unit->getType()->getRenderSize());
+						bool insideQuad 	= isUnitCubeInFrustum(unitIndex);
 						bool renderInMap 	= world->toRenderUnit(unit);
 						if(insideQuad == false || renderInMap == false) {
 							unit->setVisible(false);
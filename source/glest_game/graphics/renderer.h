@@ -70,6 +70,7 @@ class Object;
 class ConsoleLineInfo;
 class SurfaceCell;
 class Program;
+class World;
 // =====================================================
 // 	class MeshCallbackTeamColor
 // =====================================================
@@ -326,12 +327,71 @@ private:
 
 	std::vector<std::pair<ParticleSystem *, ResourceScope> > deferredParticleSystems;
 
-	SimpleTaskThread *saveScreenShotThread;
+	// encoder workers all drain the same bounded queue
+	std::vector<SimpleTaskThread *> saveScreenShotThreads;
 	Mutex *saveScreenShotThreadAccessor;
 	std::list<std::pair<string,Pixmap2D *> > saveScreenQueue;
+	int saveScreenQueueLimit;
+
+	// glReadPixels into one of two pixel pack buffers, mapped a frame later
+	class ScreenReadback {
+	public:
+		GLuint pbo;
+		int bufferSize;
+		bool pending;
+		int issuedFrame;
+		string path;
+		int width;
+		int height;
+		int scaleWidth;
+		int scaleHeight;
+
+		ScreenReadback() : pbo(0), bufferSize(0), pending(false), issuedFrame(0),
+			width(0), height(0), scaleWidth(0), scaleHeight(0) {}
+	};
+	ScreenReadback screenReadbacks[2];
+	int screenReadbackIndex;
+	int screenReadbackFrame;
+
+	// image sequence capture, one frame every recordFrameInterval swaps
+	bool recordingScreen;
+	string recordPath;
+	string recordFileFormat;
+	int recordFrameInterval;
+	int recordFrameCount;
+	int recordFrameIndex;
 
 	std::map<Vec3f,Vec3f> worldToScreenPosCache;
 
+	//units binned into map tiles so whole tiles can be frustum culled
+	enum FrustumCullResult {
+		fcrUnknown,
+		fcrOutside,
+		fcrIntersect,
+		fcrInside
+	};
+
+	class UnitCullTile {
+	public:
+		Vec3f boxMin;
+		Vec3f boxMax;
+		bool empty;
+		FrustumCullResult result;
+	};
+
+	class UnitCullCube {
+	public:
+		Vec3f center;
+		float size;
+		int tileIndex;
+	};
+
+	static const int unitCullTileSize;
+	int unitCullTilesW;
+	int unitCullTilesH;
+	std::vector<UnitCullTile> unitCullTiles;
+	std::vector<UnitCullCube> unitCullCubes;
+
 	//bool masterserverMode;
 
 	std::map<uint32,VisibleQuadContainerVBOCache > mapSurfaceVBOCache;
@@ -360,10 +420,11 @@ private:
 	
 	class MapRenderer {
 	public:
-		inline MapRenderer(): map(NULL) {}
+		inline MapRenderer(): map(NULL), chunksW(0), chunksH(0) {}
 		inline ~MapRenderer() { destroy(); }
 		void render(const Map* map,float coordStep,VisibleQuadContainerCache &qCache);
 		void renderVisibleLayers(const Map* map,float coordStep,VisibleQuadContainerCache &qCache);
+		void renderChunks(const Map* map,float coordStep,VisibleQuadContainerCache &qCache);
 		void destroy();
 	private:
 		void load(float coordStep);
@@ -424,12 +485,47 @@ private:
 		typedef std::vector<Layer*> Layers;
 		Layers layers;
 		Quad2i lastVisibleQuad;
+
+		// a run of indices in a chunk sharing one surface texture
+		struct ChunkLayer {
+			int textureHandle;
+			int indexOffset;
+			int indexCount;
+		};
+		// Map::surfaceChunkSize^2 surface quads kept in persistent VBOs,
+		// only vertices and normals are re-uploaded when the map version changes
+		struct Chunk {
+			inline Chunk():
+				vbo_vertices(0), vbo_normals(0),
+				vbo_fowTexCoords(0), vbo_surfTexCoords(0),
+				vbo_indices(0), version(0) {}
+			~Chunk();
+
+			GLuint vbo_vertices, vbo_normals,
+				vbo_fowTexCoords, vbo_surfTexCoords,
+				vbo_indices;
+			Rect2i surfRect;
+			std::vector<Vec2i> cellOrder;
+			std::vector<ChunkLayer> layers;
+			uint32 version;
+		};
+		typedef std::vector<Chunk*> Chunks;
+
+		void loadChunks(float coordStep);
+		void updateChunk(Chunk *chunk);
+
+		Chunks chunks;
+		int chunksW;
+		int chunksH;
 	} mapRenderer;
 
 	bool ExtractFrustum(VisibleQuadContainerCache &quadCacheItem);
 	//bool PointInFrustum(vector<vector<float> > &frustum, float x, float y, float z );
 	//bool SphereInFrustum(vector<vector<float> > &frustum,  float x, float y, float z, float radius);
 	bool CubeInFrustum(vector<vector<float> > &frustum, float x, float y, float z, float size );
+	FrustumCullResult BoxInFrustum(vector<vector<float> > &frustum, const Vec3f &boxMin, const Vec3f &boxMax);
+	void buildUnitCullTiles(const World *world);
+	bool isUnitCubeInFrustum(int unitIndex);
 
 private:
 	Renderer();
@@ -644,6 +740,10 @@ public:
 	std::size_t getCurrentPixelByteCount(ResourceScope rs=rsGame) const;
 	unsigned int getSaveScreenQueueSize();
 
+	void startScreenRecording(const string &path, int frameInterval, const string &fileFormat);
+	void stopScreenRecording();
+	bool isScreenRecording() const { return recordingScreen; }
+
 	//Texture2D *saveScreenToTexture(int x, int y, int width, int height);
 
 	void renderProgressBar(int size, int x, int y, Font2D *font,int customWidth=-1, string prefixLabel="", bool centeredText=true);
@@ -707,6 +807,10 @@ private:
 	//static
     static Texture2D::Filter strToTextureFilter(const string &s);
     void cleanupScreenshotThread();
+	void queueScreenshot(const string &path, Pixmap2D *pixmap);
+	void finishScreenReadback(ScreenReadback &readback);
+	void processScreenReadbacks(bool finishAll);
+	void cleanupScreenReadbacks();
 
     void render2dMenuSetup();
     void render3dSetup();
@@ -83,6 +83,7 @@
 #include <stdlib.h>
 #include "network_message.h"
 #include "network_protocol.h"
+#include "spectator_feed.h"
 #include "conversion.h"
 #include "gen_uuid.h"
 //#include "intro.h"
@@ -138,6 +139,16 @@ namespace
     static
       bool
       disableheadless_console = false;
+    static
+      int
+      headlessServerSessionCount = 1;
+    static
+      int
+      headlessServerSessionIndex = 0;
+    static
+      vector <
+      int >
+      headlessServerSessionPids;
     static
       bool
       disableBacktrace = false;
@@ -206,6 +217,150 @@ namespace
       DisplayMessage (const char *msg, bool exitApp);
     };
 
+// Compute the checksums the lobby and the game launch look up for every tech tree,
+// tileset and map. Sessions forked afterwards find them in the inherited memory
+// caches instead of each one scanning the same content again.
+    static void
+    preloadHeadlessServerContent ()
+    {
+      Config & config = Config::getInstance ();
+      time_t
+        elapsedTime = time (NULL);
+
+      vector < string > techPaths = config.getPathListForType (ptTechs, "");
+      vector < string > techs;
+      findDirs (techPaths, techs);
+      for (unsigned int index = 0; index < techs.size (); ++index)
+      {
+        string
+          techSearch = "/" + techs[index] + "/*";
+        getFolderTreeContentsCheckSumRecursively (techPaths, techSearch,
+                                                  ".xml", NULL);
+        getFolderTreeContentsCheckSumListRecursively (techPaths, techSearch,
+                                                      ".xml", NULL);
+
+        vector < string > factions;
+        for (unsigned int pathIndex = 0; pathIndex < techPaths.size ();
+             ++pathIndex)
+        {
+          string
+            techPath = techPaths[pathIndex];
+          endPathWithSlash (techPath);
+          findAll (techPath + techs[index] + "/factions/*.", factions, false,
+                   false);
+          if (factions.empty () == false)
+          {
+            break;
+          }
+        }
+        for (unsigned int factionIndex = 0; factionIndex < factions.size ();
+             ++factionIndex)
+        {
+          getFolderTreeContentsCheckSumRecursively (techPaths,
+                                                    "/" + techs[index] +
+                                                    "/factions/" +
+                                                    factions[factionIndex] +
+                                                    "/*", ".xml", NULL);
+        }
+      }
+
+      vector < string > tilesetPaths =
+        config.getPathListForType (ptTilesets, "");
+      vector < string > tilesets;
+      findDirs (tilesetPaths, tilesets);
+      for (unsigned int index = 0; index < tilesets.size (); ++index)
+      {
+        getFolderTreeContentsCheckSumRecursively (tilesetPaths,
+                                                  "/" + tilesets[index] +
+                                                  "/*", ".xml", NULL);
+      }
+
+      vector < string > mapPaths = config.getPathListForType (ptMaps, "");
+      vector < string > maps =
+        MapPreview::findAllValidMaps (mapPaths, "", false, true);
+      for (unsigned int index = 0; index < maps.size (); ++index)
+      {
+        Checksum
+          checksum;
+        checksum.addFile (Config::getMapPath (maps[index], "", false));
+        checksum.getSum ();
+      }
+
+      printf
+        ("Preloaded checksums of %d tech trees, %d tilesets and %d maps in %.0f seconds\n",
+         (int) techs.size (), (int) tilesets.size (), (int) maps.size (),
+         difftime (time (NULL), elapsedTime));
+    }
+
+// Fork one process per additional hosted game once the shared content is loaded.
+// The singletons (Config, NetworkManager, World, ...) only allow one game per
+// process, so each session gets its own process and shares what was loaded
+// before the fork copy-on-write. Returns the session index of this process.
+    static int
+    startHeadlessServerSessions (Config & config, int sessionCount,
+                                 bool haveSpecialOutputCommandLineOption)
+    {
+      preloadHeadlessServerContent ();
+
+// only the forking thread survives in the new processes
+      SystemFlags::stopThreadedLogger ();
+      int
+        sessionIndex =
+        forkProcessSessions (sessionCount, headlessServerSessionPids);
+      SystemFlags::init (haveSpecialOutputCommandLineOption);
+
+      if (sessionIndex > 0)
+      {
+// each session listens on its own block of ports: game, FTP with its passive
+// data ports, content transfer, status and spectator
+        int
+          internalPort = config.getInt ("PortServer",
+                                        intToStr (GameConstants::serverPort).
+                                        c_str ());
+        int
+          externalPort = config.getInt ("PortExternal",
+                                        intToStr (internalPort).c_str ());
+        int
+          ftpPort = config.getInt ("FTPServerPort",
+                                   intToStr (ServerSocket::getFTPServerPort ()).
+                                   c_str ());
+        int
+          statusPort = config.getInt ("ServerAdminPort",
+                                      intToStr (GameConstants::
+                                                serverAdminPort).c_str ());
+        int
+          spectatorPort = config.getInt ("SpectatorFeedPort",
+                                         intToStr (GameConstants::
+                                                   serverSpectatorPort).
+                                         c_str ());
+
+        vector < int >
+          sessionPorts =
+          ServerSocket::getHostedGamePorts (internalPort, ftpPort,
+                                            GameConstants::maxPlayers,
+                                            statusPort, spectatorPort);
+        if (externalPort != internalPort)
+        {
+          sessionPorts.push_back (externalPort);
+        }
+        int
+          portOffset =
+          sessionIndex * getSessionPortStride (sessionPorts, sessionCount);
+
+        config.setInt ("PortServer", internalPort + portOffset, true);
+        config.setInt ("PortExternal", externalPort + portOffset, true);
+        config.setInt ("FTPServerPort", ftpPort + portOffset, true);
+        config.setInt ("ServerAdminPort", statusPort + portOffset, true);
+        config.setInt ("SpectatorFeedPort", spectatorPort + portOffset, true);
+
+        printf
+          ("Headless server session #%d using internal port# %d, external port# %d, status port# %d\n",
+           sessionIndex + 1, internalPort + portOffset,
+           externalPort + portOffset, statusPort + portOffset);
+      }
+      return sessionIndex;
+    }
+
     void
     cleanupCRCThread ()
     {
@@ -314,6 +469,9 @@ namespace
         printf ("#4 IRCCLient Cache SHUTDOWN\n");
 
       cleanupCRCThread ();
+      Socket::stopSimulatedLatencyThread ();
+      reapProcessSessions (headlessServerSessionPids, true);
+      SocketReadReactor::shutdownReactor ();
       if (SystemFlags::VERBOSE_MODE_ENABLED)
         printf ("In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 
@@ -1796,6 +1954,40 @@ namespace
           Config & config = Config::getInstance ();
           config.reload ();
         }
+        else
+          if (isKeyPressed
+              (configKeys.getSDLKey ("ToggleScreenRecording"), key,
+               modifiersToCheck) == true)
+        {
+          Renderer & renderer = Renderer::getInstance ();
+          if (renderer.isScreenRecording () == true)
+          {
+            renderer.stopScreenRecording ();
+            program->consoleAddLine ("Screen recording stopped");
+          }
+          else
+          {
+            Config & config = Config::getInstance ();
+            string
+              userData = config.getString ("UserData_Root", "");
+            if (userData != "")
+            {
+              endPathWithSlash (userData);
+            }
+            string
+              path =
+              userData + GameConstants::folder_path_screenshots +
+              "recording_" + intToStr (time (NULL)) + "/";
+            renderer.startScreenRecording (path,
+                                           config.getInt
+                                           ("ScreenRecordingFrameInterval",
+                                            "1"),
+                                           config.getString
+                                           ("ScreenRecordingFileType",
+                                            "bmp"));
+            program->consoleAddLine ("Screen recording to: " + path);
+          }
+        }
         else
           if (isKeyPressed
               (configKeys.getSDLKey ("Screenshot"), key,
@@ -6611,6 +6803,46 @@ namespace
         }
       }
 
+      if (hasCommandArgument
+          (argc, argv,
+           string (GAME_ARGS[GAME_ARG_MASTERSERVER_SESSIONS])) == true
+          && GlobalStaticFlags::getIsNonGraphicalModeEnabled () == true)
+      {
+        int
+          foundParamIndIndex = -1;
+        hasCommandArgument (argc, argv,
+                            string (GAME_ARGS[GAME_ARG_MASTERSERVER_SESSIONS])
+                            + string ("="), &foundParamIndIndex);
+        if (foundParamIndIndex < 0)
+        {
+          hasCommandArgument (argc, argv,
+                              string (GAME_ARGS
+                                      [GAME_ARG_MASTERSERVER_SESSIONS]),
+                              &foundParamIndIndex);
+        }
+        string
+          paramValue = argv[foundParamIndIndex];
+        vector < string > paramPartTokens;
+        Tokenize (paramValue, paramPartTokens, "=");
+        if (paramPartTokens.size () >= 2 && paramPartTokens[1].length () > 0
+            && IsNumeric (paramPartTokens[1].c_str (), false) == true
+            && strToInt (paramPartTokens[1]) >= 1)
+        {
+          headlessServerSessionCount = strToInt (paramPartTokens[1]);
+          printf ("Hosting %d headless server sessions\n",
+                  headlessServerSessionCount);
+        }
+        else
+        {
+          printf
+            ("\nInvalid headless server session count specified on commandline [%s] value [%s]\n\n",
+             argv[foundParamIndIndex],
+             (paramPartTokens.size () >=
+              2 ? paramPartTokens[1].c_str () : NULL));
+          return 1;
+        }
+      }
+
       if (hasCommandArgument (argc, argv, GAME_ARGS[GAME_ARG_SERVER_TITLE]) ==
           true)
       {
@@ -7157,6 +7389,17 @@ namespace
              Socket::DEFAULT_SOCKET_RECVBUF_SIZE);
         }
 
+        int
+          simulatedLatencyMillis =
+          config.getInt ("NetworkSimulatedLatencyMillis", "0");
+        if (simulatedLatencyMillis > 0)
+        {
+          printf
+            ("*WARNING users wants to delay all socket sends by: %d msecs\n",
+             simulatedLatencyMillis);
+          Socket::setSimulatedLatencyMillis (simulatedLatencyMillis);
+        }
+
         shutdownFadeSoundMilliseconds =
           config.getInt ("ShutdownFadeSoundMilliseconds",
                          intToStr (shutdownFadeSoundMilliseconds).c_str ());
@@ -7349,6 +7592,68 @@ namespace
           return 0;
         }
 
+        if (hasCommandArgument
+            (argc, argv,
+             string (GAME_ARGS[GAME_ARG_SPECTATOR_RELAY])) == true)
+        {
+          int
+            foundParamIndIndex = -1;
+          hasCommandArgument (argc, argv,
+                              string (GAME_ARGS[GAME_ARG_SPECTATOR_RELAY]) +
+                              string ("="), &foundParamIndIndex);
+          vector < string > paramPartTokens;
+          if (foundParamIndIndex >= 0)
+          {
+            Tokenize (argv[foundParamIndIndex], paramPartTokens, "=");
+          }
+          vector < string > paramPartTokens2;
+          if (paramPartTokens.size () >= 2)
+          {
+            Tokenize (paramPartTokens[1], paramPartTokens2, ":");
+          }
+          if (paramPartTokens2.size () < 2
+              || paramPartTokens2[0].length () == 0
+              || strToInt (paramPartTokens2[1]) <= 0)
+          {
+            printf
+              ("\nInvalid spectator feed specified on commandline [%s]\n\n",
+               (foundParamIndIndex >= 0 ? argv[foundParamIndIndex] : ""));
+            return 1;
+          }
+
+          int
+            listenPort = config.getInt ("SpectatorFeedPort",
+                                        intToStr (GameConstants::
+                                                  serverSpectatorPort).
+                                        c_str ());
+          int
+            delaySeconds = config.getInt ("SpectatorFeedDelaySeconds", "0");
+          int
+            maxSpectators =
+            config.getInt ("SpectatorFeedMaxSpectators", "16");
+          SpectatorFeedServerThread *
+            relay = new SpectatorFeedServerThread (listenPort, delaySeconds,
+                                                   maxSpectators);
+          relay->setUpstream (paramPartTokens2[0],
+                              strToInt (paramPartTokens2[1]));
+          relay->start ();
+
+          printf ("Relaying spectator feed [%s:%s] on port: %d\n",
+                  paramPartTokens2[0].c_str (), paramPartTokens2[1].c_str (),
+                  listenPort);
+
+// the relay thread stops by itself once the game ended and the
+// spectators got the rest of it
+          for (sleep (250); relay->getRunningStatus () == true;)
+          {
+            sleep (250);
+          }
+          relay->shutdownAndWait ();
+          delete
+            relay;
+          return 0;
+        }
+
         if (hasCommandArgument (argc, argv, GAME_ARGS[GAME_ARG_DISABLE_SOUND])
             == true
             || hasCommandArgument (argc, argv,
@@ -7645,6 +7950,17 @@ namespace
         UPNP_Tools::isUPNP = !config.getBool ("DisableUPNP", "false");
         Texture::useTextureCompression =
           config.getBool ("EnableTextureCompression", "false");
+        if (Texture::useTextureCompression == true
+            && config.getBool ("EnableCompressedTextureCache", "true"))
+        {
+          string
+            textureCachePath = getCRCCacheFilePath () + "textures/";
+          if (isdir (textureCachePath.c_str ()) == false)
+          {
+            createDirectoryPaths (textureCachePath);
+          }
+          TextureGl::setCompressedTextureCachePath (textureCachePath);
+        }
 
 // 256 for English
 // 30000 for Chinese
@@ -7804,6 +8120,21 @@ namespace
           if (SystemFlags::VERBOSE_MODE_ENABLED)
             printf ("**INFO** Disabling Interpolation\n");
         }
+        if (config.getBool ("EnableGpuVertexInterpolation", "false"))
+        {
+          ModelRendererGl::setEnableGpuInterpolation (true);
+          if (SystemFlags::VERBOSE_MODE_ENABLED)
+            printf ("**INFO** Requesting GPU vertex interpolation\n");
+        }
+        if (config.getBool ("EnableInstancedModelRendering", "false"))
+        {
+          ModelRendererGl::setEnableInstancing (true);
+          if (SystemFlags::VERBOSE_MODE_ENABLED)
+            printf ("**INFO** Requesting instanced model rendering\n");
+        }
+        InterpolationData::setInterpolationSteps (config.getInt
+                                                  ("VertexInterpolationSteps",
+                                                   "0"));
 
 
         if (config.getBool ("EnableVSynch", "false") == true)
@@ -8129,6 +8460,26 @@ namespace
 
         }
 
+#ifndef WIN32
+        if (headlessServerSessionCount > 1)
+        {
+          headlessServerSessionIndex =
+            startHeadlessServerSessions (config, headlessServerSessionCount,
+                                         haveSpecialOutputCommandLineOption);
+          if (headlessServerSessionIndex > 0)
+          {
+// the console belongs to the first session
+            disableheadless_console = true;
+          }
+        }
+#else
+        if (headlessServerSessionCount > 1)
+        {
+          printf
+            ("Hosting several games from one process is not supported on this platform, hosting one.\n");
+        }
+#endif
+
         program = new Program ();
         mainProgram = program;
         renderer.setProgram (program);
@@ -8396,6 +8747,55 @@ namespace
           }
         }
 
+        else
+          if (hasCommandArgument
+              (argc, argv, string (GAME_ARGS[GAME_ARG_SPECTATE_GAME])) == true)
+        {
+          int
+            foundParamIndIndex = -1;
+          hasCommandArgument (argc, argv,
+                              string (GAME_ARGS[GAME_ARG_SPECTATE_GAME]) +
+                              string ("="), &foundParamIndIndex);
+          vector < string > paramPartTokens;
+          if (foundParamIndIndex >= 0)
+          {
+            Tokenize (argv[foundParamIndIndex], paramPartTokens, "=");
+          }
+          if (paramPartTokens.size () >= 2
+              && paramPartTokens[1].length () > 0)
+          {
+            int
+              port = config.getInt ("SpectatorFeedPort",
+                                    intToStr (GameConstants::
+                                              serverSpectatorPort).c_str ());
+            vector < string > paramPartTokens2;
+            Tokenize (paramPartTokens[1], paramPartTokens2, ":");
+            string
+              spectateServer = paramPartTokens2[0];
+            if (paramPartTokens2.size () >= 2
+                && paramPartTokens2[1].length () > 0)
+            {
+              port = strToInt (paramPartTokens2[1]);
+            }
+
+            printf ("Spectating host [%s] using port: %d\n",
+                    spectateServer.c_str (), port);
+            program->initSpectator (mainWindow, spectateServer, port);
+            gameInitialized = true;
+          }
+          else
+          {
+            printf
+              ("\nInvalid host specified on commandline [%s]\n\n",
+               (foundParamIndIndex >= 0 ? argv[foundParamIndIndex] : ""));
+            printParameterHelp (argv[0], foundInvalidArgs);
+            delete
+              mainWindow;
+            mainWindow = NULL;
+            return 1;
+          }
+        }
+
         else
           if (hasCommandArgument
               (argc, argv, string (GAME_ARGS[GAME_ARG_CONNECT])) == true)
@@ -8905,6 +9305,7 @@ namespace
         {
           if (GlobalStaticFlags::getIsNonGraphicalModeEnabled () == true)
           {
+            reapProcessSessions (headlessServerSessionPids, false);
 
             if (disableheadless_console == false)
             {
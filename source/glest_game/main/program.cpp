@@ -344,6 +344,18 @@ namespace Glest
       Game::loadGame (saveGameFile, this, masterserverMode);
     }
 
+    void
+    Program::initSpectator (WindowGl * window, const string & serverIp,
+                            int portNumber)
+    {
+      init (window);
+      MainMenu *
+        mainMenu = new MainMenu (this);
+      setState (mainMenu);
+
+      Game::loadSpectatorFeed (serverIp, portNumber, this);
+    }
+
     void
     Program::initServer (WindowGl * window, bool autostart,
                          bool openNetworkSlots, bool masterserverMode)
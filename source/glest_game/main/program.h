@@ -400,6 +400,9 @@ namespace Glest
       initSavedGame (WindowGl * window, bool masterserverMode =
                      false, string saveGameFile = "");
       void
+      initSpectator (WindowGl * window, const string & serverIp,
+                     int portNumber);
+      void
       initClient (WindowGl * window, const Ip & serverIp, int portNumber =
                   -1);
       void
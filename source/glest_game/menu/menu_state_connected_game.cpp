@@ -838,6 +838,12 @@ namespace Glest
                                                fileArchiveExtractCommandParameters,
                                                fileArchiveExtractCommandSuccessResult,
                                                tempFilePath);
+        if (config.getBool ("EnableContentTransfer", "true") == true)
+          {
+            ftpClientThread->setContentTransferPort
+              (ContentTransferServerThread::getDefaultPort
+               (portNumber, GameConstants::maxPlayers));
+          }
         ftpClientThread->start ();
       }
 // Start http meta data thread
@@ -2213,6 +2219,12 @@ namespace Glest
                                                  fileArchiveExtractCommandParameters,
                                                  fileArchiveExtractCommandSuccessResult,
                                                  tempFilePath);
+          if (config.getBool ("EnableContentTransfer", "true") == true)
+            {
+              ftpClientThread->setContentTransferPort
+                (ContentTransferServerThread::getDefaultPort
+                 (portNumber, GameConstants::maxPlayers));
+            }
           ftpClientThread->start ();
 
           Lang & lang = Lang::getInstance ();
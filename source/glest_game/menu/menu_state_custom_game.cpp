@@ -161,10 +161,23 @@ namespace Glest
 
         publishToMasterserverThread = NULL;
         publishToClientsThread = NULL;
+        contentCatalogThread = NULL;
+        lastContentCatalogChangeSerial = 0;
+        contentChecksumsPending = false;
+        lastReloadedFactionsTechtreeName = "";
 
         Lang & lang = Lang::getInstance ();
         NetworkManager & networkManager = NetworkManager::getInstance ();
         Config & config = Config::getInstance ();
+        if (config.getBool ("DisableLobbyContentCatalog", "false") == false)
+        {
+          static string mutexOwnerIdCatalog =
+            string (extractFileFromDirectoryPath (__FILE__).c_str ()) +
+            string ("_") + intToStr (__LINE__);
+          contentCatalogThread = new ContentCatalogThread ();
+          contentCatalogThread->setUniqueID (mutexOwnerIdCatalog);
+          contentCatalogThread->start ();
+        }
         defaultPlayerName =
           config.getString ("NetPlayerName", Socket::getHostName ().c_str ());
         enableFactionTexturePreview =
@@ -942,6 +955,8 @@ namespace Glest
         publishToMasterserverThread->start ();
         publishToClientsThread->start ();
 
+        prefetchContentChecksums ();
+
         if (openNetworkSlots == true)
         {
           string data_path =
@@ -1378,6 +1393,7 @@ namespace Glest
 //printf("LINE: %d\n",__LINE__);
         cleanupThread (&publishToClientsThread);
       }
+      cleanupContentCatalogThread ();
 
 //printf("LINE: %d\n",__LINE__);
 
@@ -2867,7 +2883,7 @@ namespace Glest
       safeMutex.ReleaseLock (true);
       safeMutexCLI.ReleaseLock (true);
       GameSettings gameSettings;
-      loadGameSettings (&gameSettings, true);
+      loadGameSettings (&gameSettings, true, true);
 
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugSystem).enabled)
@@ -3781,6 +3797,46 @@ namespace Glest
 
       try
       {
+        if (contentCatalogThread != NULL &&
+            contentCatalogThread->getChangeSerial () !=
+            lastContentCatalogChangeSerial)
+        {
+// A checksum finished or its files changed on disk, republish
+// the settings if they were waiting on it or it is selected
+          lastContentCatalogChangeSerial =
+            contentCatalogThread->getChangeSerial ();
+          Config & config = Config::getInstance ();
+          bool contentChanged = contentChecksumsPending;
+          uint32 checksum = 0;
+          if (contentChanged == false && lastCheckedCRCTilesetName != ""
+              && contentCatalogThread->findChecksum (config.getPathListForType
+                                                     (ptTilesets, ""),
+                                                     "/" +
+                                                     lastCheckedCRCTilesetName
+                                                     + "/*", ".xml",
+                                                     checksum) == true)
+          {
+            contentChanged = (checksum != lastCheckedCRCTilesetValue);
+          }
+          if (contentChanged == false && lastCheckedCRCTechtreeName != ""
+              && contentCatalogThread->findChecksum (config.getPathListForType
+                                                     (ptTechs, ""),
+                                                     "/" +
+                                                     lastCheckedCRCTechtreeName
+                                                     + "/*", ".xml",
+                                                     checksum) == true)
+          {
+            contentChanged = (checksum != lastCheckedCRCTechtreeValue);
+          }
+          if (contentChanged == true)
+          {
+            lastCheckedCRCTilesetName = "";
+            lastCheckedCRCTechtreeName = "";
+            lastReloadedFactionsTechtreeName = "";
+            needToBroadcastServerSettings = true;
+          }
+        }
+
         if (serverInitError == true)
         {
           if (SystemFlags::
@@ -5343,7 +5399,10 @@ namespace Glest
               lastMasterServerSettingsUpdateCount =
                 serverInterface->getGameSettingsUpdateCount ();
 
-              if (hasClientConnection == true)
+// Don't show clients placeholder checksums, update() broadcasts
+// again once the content catalog has them
+              if (hasClientConnection == true
+                  && contentChecksumsPending == false)
               {
                 if (SystemFlags::getSystemSettingType
                     (SystemFlags::debugSystem).enabled)
@@ -5439,7 +5498,8 @@ namespace Glest
     }
 
     void MenuStateCustomGame::loadGameSettings (GameSettings * gameSettings,
-                                                bool forceCloseUnusedSlots)
+                                                bool forceCloseUnusedSlots,
+                                                bool waitForContentChecksums)
     {
       if (SystemFlags::
           getSystemSettingType (SystemFlags::debugSystem).enabled)
@@ -5954,6 +6014,7 @@ namespace Glest
         setNetworkFramePeriod (config.getInt ("NetworkSendFrameCount", "20"));
       gameSettings->setNetworkPauseGameForLaggedClients (((checkBoxNetworkPauseGameForLaggedClients.getValue () == true)));
 
+      contentChecksumsPending = false;
       if (gameSettings->getTileset () != "")
       {
 // Check if client has different data, if so force a CRC refresh
@@ -5969,22 +6030,24 @@ namespace Glest
         if (lastCheckedCRCTilesetName != gameSettings->getTileset ())
         {
 //console.addLine("Checking tileset CRC [" + gameSettings->getTileset() + "]");
-          lastCheckedCRCTilesetValue =
-            getFolderTreeContentsCheckSumRecursively
-            (config.getPathListForType (ptTilesets, ""),
-             string ("/") + gameSettings->getTileset () + string ("/*"),
-             ".xml", NULL, forceRefresh);
-          if (lastCheckedCRCTilesetValue == 0)
+          uint32 tilesetCRC = 0;
+          if (getContentChecksum (config.getPathListForType (ptTilesets, ""),
+                                  string ("/") + gameSettings->getTileset () +
+                                  string ("/*"), forceRefresh,
+                                  waitForContentChecksums,
+                                  tilesetCRC) == true)
           {
-            lastCheckedCRCTilesetValue =
-              getFolderTreeContentsCheckSumRecursively
-              (config.getPathListForType (ptTilesets, ""),
-               string ("/") + gameSettings->getTileset () + string ("/*"),
-               ".xml", NULL, true);
+            lastCheckedCRCTilesetValue = tilesetCRC;
+            lastCheckedCRCTilesetName = gameSettings->getTileset ();
+          }
+          else
+          {
+            contentChecksumsPending = true;
           }
-          lastCheckedCRCTilesetName = gameSettings->getTileset ();
         }
-        gameSettings->setTilesetCRC (lastCheckedCRCTilesetValue);
+        gameSettings->setTilesetCRC (lastCheckedCRCTilesetName ==
+                                     gameSettings->getTileset ()?
+                                     lastCheckedCRCTilesetValue : 0);
       }
 
       if (config.getBool ("DisableServerLobbyTechtreeCRCCheck", "false") ==
@@ -6005,25 +6068,26 @@ namespace Glest
           if (lastCheckedCRCTechtreeName != gameSettings->getTech ())
           {
 //console.addLine("Checking techtree CRC [" + gameSettings->getTech() + "]");
-            lastCheckedCRCTechtreeValue =
-              getFolderTreeContentsCheckSumRecursively
-              (config.getPathListForType (ptTechs, ""),
-               "/" + gameSettings->getTech () + "/*", ".xml", NULL,
-               forceRefresh);
-            if (lastCheckedCRCTechtreeValue == 0)
+            uint32 techCRC = 0;
+            bool techReady =
+              getContentChecksum (config.getPathListForType (ptTechs, ""),
+                                  "/" + gameSettings->getTech () + "/*",
+                                  forceRefresh, waitForContentChecksums,
+                                  techCRC);
+
+            if (lastReloadedFactionsTechtreeName != gameSettings->getTech ()
+                || forceRefresh == true)
             {
-              lastCheckedCRCTechtreeValue =
-                getFolderTreeContentsCheckSumRecursively
-                (config.getPathListForType (ptTechs, ""),
-                 "/" + gameSettings->getTech () + "/*", ".xml", NULL, true);
+              reloadFactions (true,
+                              (checkBoxScenario.getValue () ==
+                               true ?
+                               scenarioFiles
+                               [listBoxScenario.getSelectedItemIndex ()] :
+                               ""));
+              lastReloadedFactionsTechtreeName = gameSettings->getTech ();
             }
-
-            reloadFactions (true,
-                            (checkBoxScenario.getValue () ==
-                             true ?
-                             scenarioFiles
-                             [listBoxScenario.getSelectedItemIndex ()] : ""));
-            factionCRCList.clear ();
+            vector < pair < string, uint32 > >techFactionCRCList;
+            bool factionsReady = true;
             for (unsigned int factionIdx = 0;
                  factionIdx < factionFiles.size (); ++factionIdx)
             {
@@ -6032,33 +6096,42 @@ namespace Glest
                   && factionName != GameConstants::OBSERVER_SLOTNAME)
               {
 //factionCRC   = getFolderTreeContentsCheckSumRecursively(config.getPathListForType(ptTechs,""), "/" + gameSettings->getTech() + "/factions/" + factionName + "/*", ".xml", NULL, true);
-                uint32 factionCRC =
-                  getFolderTreeContentsCheckSumRecursively
-                  (config.getPathListForType (ptTechs,
-                                              ""),
-                   "/" +
-                   gameSettings->getTech
-                   () + "/factions/" + factionName + "/*",
-                   ".xml",
-                   NULL);
-                if (factionCRC == 0)
+                uint32 factionCRC = 0;
+                if (getContentChecksum (config.getPathListForType (ptTechs,
+                                                                   ""),
+                                        "/" + gameSettings->getTech () +
+                                        "/factions/" + factionName + "/*",
+                                        false, waitForContentChecksums,
+                                        factionCRC) == false)
                 {
-                  factionCRC =
-                    getFolderTreeContentsCheckSumRecursively
-                    (config.getPathListForType (ptTechs, ""),
-                     "/" + gameSettings->getTech () +
-                     "/factions/" + factionName + "/*", ".xml", NULL, true);
+                  factionsReady = false;
                 }
-                factionCRCList.push_back (make_pair
-                                          (factionName, factionCRC));
+                techFactionCRCList.push_back (make_pair
+                                              (factionName, factionCRC));
               }
             }
+            if (techReady == true && factionsReady == true)
+            {
 //console.addLine("Found factions: " + intToStr(factionCRCList.size()));
-            lastCheckedCRCTechtreeName = gameSettings->getTech ();
+              lastCheckedCRCTechtreeValue = techCRC;
+              factionCRCList = techFactionCRCList;
+              lastCheckedCRCTechtreeName = gameSettings->getTech ();
+            }
+            else
+            {
+              contentChecksumsPending = true;
+            }
           }
 
-          gameSettings->setFactionCRCList (factionCRCList);
-          gameSettings->setTechCRC (lastCheckedCRCTechtreeValue);
+          if (lastCheckedCRCTechtreeName == gameSettings->getTech ())
+          {
+            gameSettings->setFactionCRCList (factionCRCList);
+            gameSettings->setTechCRC (lastCheckedCRCTechtreeValue);
+          }
+          else
+          {
+            gameSettings->setTechCRC (0);
+          }
         }
       }
 
@@ -8070,6 +8143,98 @@ namespace Glest
       return initialTechSelection;
     }
 
+    bool MenuStateCustomGame::getContentChecksum (const vector < string >
+                                                  &paths,
+                                                  const string &
+                                                  pathSearchString,
+                                                  bool forceRefresh,
+                                                  bool waitForResult,
+                                                  uint32 & checksum)
+    {
+      if (contentCatalogThread != NULL)
+      {
+        if (forceRefresh == true)
+        {
+          contentCatalogThread->prefetchChecksum (paths, pathSearchString,
+                                                  ".xml", true);
+        }
+        if (contentCatalogThread->findChecksum (paths, pathSearchString,
+                                                ".xml", checksum) == true)
+        {
+          return true;
+        }
+        if (waitForResult == false)
+        {
+          return false;
+        }
+      }
+
+      checksum =
+        getFolderTreeContentsCheckSumRecursively (paths, pathSearchString,
+                                                  ".xml", NULL, forceRefresh);
+      if (checksum == 0)
+      {
+        checksum =
+          getFolderTreeContentsCheckSumRecursively (paths, pathSearchString,
+                                                    ".xml", NULL, true);
+      }
+      return true;
+    }
+
+    void MenuStateCustomGame::prefetchContentChecksums ()
+    {
+      if (contentCatalogThread == NULL)
+      {
+        return;
+      }
+
+// The selected items were looked up first, warm up the rest so
+// switching between them doesn't wait on a folder scan
+      Config & config = Config::getInstance ();
+      vector < string > tilesetPaths =
+        config.getPathListForType (ptTilesets, "");
+      for (unsigned int index = 0; index < tilesetFiles.size (); ++index)
+      {
+        contentCatalogThread->prefetchChecksum (tilesetPaths,
+                                                "/" + tilesetFiles[index] +
+                                                "/*", ".xml");
+      }
+      if (config.getBool ("DisableServerLobbyTechtreeCRCCheck", "false") ==
+          false)
+      {
+        vector < string > techPaths = config.getPathListForType (ptTechs, "");
+        for (unsigned int index = 0; index < techTreeFiles.size (); ++index)
+        {
+          contentCatalogThread->prefetchChecksum (techPaths,
+                                                  "/" + techTreeFiles[index] +
+                                                  "/*", ".xml");
+        }
+      }
+    }
+
+    void MenuStateCustomGame::cleanupContentCatalogThread ()
+    {
+      if (contentCatalogThread == NULL)
+      {
+        return;
+      }
+
+      contentCatalogThread->signalQuit ();
+// While a scan is running canShutdown() leaves it to delete itself
+      if (contentCatalogThread->canShutdown (true) == true)
+      {
+        if (contentCatalogThread->shutdownAndWait () == true)
+        {
+          delete contentCatalogThread;
+        }
+        else
+        {
+          contentCatalogThread->setDeleteSelfOnExecutionDone (true);
+        }
+      }
+      contentCatalogThread = NULL;
+    }
+
     void MenuStateCustomGame::reloadFactions (bool keepExistingSelectedItem,
                                               string scenario)
     {
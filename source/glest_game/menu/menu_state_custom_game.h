@@ -170,6 +170,11 @@ namespace Glest
         publishToMasterserverThread;
       SimpleTaskThread *
         publishToClientsThread;
+      ContentCatalogThread *
+        contentCatalogThread;
+      unsigned int
+        lastContentCatalogChangeSerial;
+      bool contentChecksumsPending;
 
       ParentMenuState parentMenuState;
       int
@@ -240,6 +245,7 @@ namespace Glest
       uint32 lastCheckedCRCTechtreeValue;
       uint32 lastCheckedCRCMapValue;
       vector < pair < string, uint32 > >factionCRCList;
+      string lastReloadedFactionsTechtreeName;
 
       bool forceWaitForShutdown;
       bool headlessServerMode;
@@ -304,7 +310,17 @@ namespace Glest
       bool hasNetworkGameSettings ();
       void
       loadGameSettings (GameSettings * gameSettings,
-                        bool forceCloseUnusedSlots = false);
+                        bool forceCloseUnusedSlots = false,
+                        bool waitForContentChecksums = false);
+      bool
+        getContentChecksum (const vector < string > &paths,
+                            const string & pathSearchString,
+                            bool forceRefresh, bool waitForResult,
+                            uint32 & checksum);
+      void
+      prefetchContentChecksums ();
+      void
+      cleanupContentCatalogThread ();
       void
       loadMapInfo (string file, MapInfo * mapInfo, bool loadMapPreview);
       void
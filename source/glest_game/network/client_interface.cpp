@@ -550,6 +550,18 @@ void ClientInterface::updateLobby() {
         case nmtInvalid:
             break;
 
+        case nmtIntroWithoutFeatures:
+        {
+            string sErr = "Server and client binary mismatch!\nThe server uses an older network protocol, you have to use the exactly same binaries!\n\nClient: " + getNetworkVersionGITString();
+            printf("%s\n",sErr.c_str());
+            DisplayErrorMessage(sErr);
+            sleep(1);
+
+            setQuit(true);
+            close();
+            return;
+        }
+
         case nmtIntro:
         {
             NetworkMessageIntro networkMessageIntro;
@@ -565,6 +577,7 @@ void ClientInterface::updateLobby() {
 				serverUUID 		= networkMessageIntro.getPlayerUUID();
 				serverPlatform 	= networkMessageIntro.getPlayerPlatform();
 				serverFTPPort 	= networkMessageIntro.getFtpPort();
+				setPeerNetworkFeatures(networkMessageIntro.getNetworkFeatures() & NetworkMessage::getLocalNetworkFeatures());
 
 				if(playerIndex < 0 || playerIndex >= GameConstants::maxPlayers) {
 					throw megaglest_runtime_error("playerIndex < 0 || playerIndex >= GameConstants::maxPlayers");
@@ -643,7 +656,8 @@ void ClientInterface::updateLobby() {
 							lang.getLanguage(),
 							networkMessageIntro.getGameInProgress(),
 							Config::getInstance().getString("PlayerId",""),
-							getPlatformNameString());
+							getPlatformNameString(),
+							NetworkMessage::getLocalNetworkFeatures());
 					sendMessage(&sendNetworkMessageIntro);
 
 					//printf("Got intro sending client details to server\n");
@@ -702,6 +716,7 @@ void ClientInterface::updateLobby() {
 
 				if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 				this->setLastPingInfo(networkMessagePing);
+				this->processPingEcho(networkMessagePing);
 			}
 		}
 		break;
@@ -1022,12 +1037,13 @@ void ClientInterface::updateLobby() {
 		break;
 
 		case nmtCommandList:
+		case nmtCommandListCompact:
 			{
 
 			//make sure we read the message
 			//time_t receiveTimeElapsed = time(NULL);
 			NetworkMessageCommandList networkMessageCommandList;
-			bool gotCmd = receiveMessage(&networkMessageCommandList);
+			bool gotCmd = receiveMessage(&networkMessageCommandList, networkMessageType);
 			if(gotCmd == false) {
 				throw megaglest_runtime_error("error retrieving nmtCommandList returned false!");
 			}
@@ -1132,12 +1148,13 @@ void ClientInterface::updateFrame(int *checkFrame) {
 			switch(networkMessageType)
 			{
 				case nmtCommandList:
+				case nmtCommandListCompact:
 					{
 
 					//make sure we read the message
 					//time_t receiveTimeElapsed = time(NULL);
 					NetworkMessageCommandList networkMessageCommandList;
-					bool gotCmd = receiveMessage(&networkMessageCommandList);
+					bool gotCmd = receiveMessage(&networkMessageCommandList, networkMessageType);
 					if(gotCmd == false) {
 						SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] error retrieving nmtCommandList returned false!\n",__FILE__,__FUNCTION__,__LINE__);
 						if(isConnected() == false) {
@@ -1222,6 +1239,7 @@ void ClientInterface::updateFrame(int *checkFrame) {
 					if(receiveMessage(&networkMessagePing)) {
 						if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 						this->setLastPingInfo(networkMessagePing);
+						this->processPingEcho(networkMessagePing);
 					}
 				}
 				break;
@@ -1628,10 +1646,11 @@ void ClientInterface::waitUntilReady(Checksum* checksum) {
 
 				}
 			}
-			else if(networkMessageType == nmtCommandList) {
+			else if(networkMessageType == nmtCommandList ||
+					networkMessageType == nmtCommandListCompact) {
 				//make sure we read the message
 				NetworkMessageCommandList networkMessageCommandList;
-				bool gotCmd = receiveMessage(&networkMessageCommandList);
+				bool gotCmd = receiveMessage(&networkMessageCommandList, networkMessageType);
 				if(gotCmd == false) {
 					throw megaglest_runtime_error("error retrieving nmtCommandList returned false!");
 				}
@@ -2145,6 +2164,7 @@ bool ClientInterface::shouldDiscardNetworkMessage(NetworkMessageType networkMess
 			NetworkMessagePing msg = NetworkMessagePing();
 			this->receiveMessage(&msg);
 			this->setLastPingInfo(msg);
+			this->processPingEcho(msg);
 			}
 			break;
 		case nmtLaunch:
@@ -35,6 +35,8 @@ ConnectionSlotThread::ConnectionSlotThread(int slotIndex) : BaseThread() {
 	this->triggerIdMutex 	= new Mutex(CODE_AT_LINE);
 	this->slotIndex 		= slotIndex;
 	this->slotInterface 	= NULL;
+	this->useSocketReadReactor = Config::getInstance().getBool("NetworkSocketReadReactor","true");
+	this->socketReadPending	= true;
 	uniqueID 				= "ConnectionSlotThread";
 	eventList.clear();
 	eventList.reserve(1000);
@@ -48,6 +50,8 @@ ConnectionSlotThread::ConnectionSlotThread(ConnectionSlotCallbackInterface *slot
 	this->triggerIdMutex 	= new Mutex(CODE_AT_LINE);
 	this->slotIndex 		= slotIndex;
 	this->slotInterface 	= slotInterface;
+	this->useSocketReadReactor = Config::getInstance().getBool("NetworkSocketReadReactor","true");
+	this->socketReadPending	= true;
 	uniqueID 				= "ConnectionSlotThread";
 	eventList.clear();
 
@@ -56,6 +60,8 @@ ConnectionSlotThread::ConnectionSlotThread(ConnectionSlotCallbackInterface *slot
 }
 
 ConnectionSlotThread::~ConnectionSlotThread() {
+	SocketReadReactor::unwatchSocket(&semSocketReadReady);
+
 	delete triggerIdMutex;
 	triggerIdMutex = NULL;
 
@@ -69,6 +75,7 @@ void ConnectionSlotThread::setQuitStatus(bool value) {
 	BaseThread::setQuitStatus(value);
 	if(value == true) {
 		signalUpdate(NULL);
+		semSocketReadReady.signal();
 	}
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s] Line: %d\n",__FILE__,__FUNCTION__,__LINE__);
@@ -244,11 +251,32 @@ void ConnectionSlotThread::execute() {
 					}
 
 					PLATFORM_SOCKET socketId = socket->getSocketId();
+					// Only adds the socket the first time, the socket
+					// removes itself when it is closed
+					bool watchingSocket = (useSocketReadReactor == true &&
+							SocketReadReactor::watchSocket(&semSocketReadReady,socket) == true);
 					safeMutex.ReleaseLock();
 
 					// Avoid mutex locking
 					//bool socketHasReadData = Socket::hasDataToRead(socket->getSocketId());
-					bool socketHasReadData = Socket::hasDataToReadWithWait(socketId,150000);
+					bool socketHasReadData = false;
+					if(watchingSocket == true) {
+						// Read events are edge triggered, so after an update
+						// that read data look for anything it left unread
+						// before sleeping on the next event
+						if(socketReadPending == true) {
+							for(;semSocketReadReady.tryDecrement() == true;) {
+							}
+							socketHasReadData = Socket::hasDataToRead(socketId);
+						}
+						if(socketHasReadData == false) {
+							socketHasReadData = (semSocketReadReady.waitTillSignalled(150) == 0);
+						}
+						socketReadPending = socketHasReadData;
+					}
+					else {
+						socketHasReadData = Socket::hasDataToReadWithWait(socketId,150000);
+					}
 
 					if(getQuitStatus() == true) {
 						if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
@@ -624,7 +652,8 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 								"",
 								serverInterface->getGameHasBeenInitiated(),
 								Config::getInstance().getString("PlayerId",""),
-								getPlatformNameString());
+								getPlatformNameString(),
+								NetworkMessage::getLocalNetworkFeatures());
 						sendMessage(&networkMessageIntro);
 
 						if(this->serverInterface->getGameHasBeenInitiated() == true) {
@@ -679,6 +708,7 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 							if(receiveMessage(&networkMessagePing)) {
 								if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 								lastPingInfo = networkMessagePing;
+								processPingEcho(networkMessagePing);
 							}
 							else {
 								if(SystemFlags::getSystemSettingType(SystemFlags::debugError).enabled) SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d]\nInvalid message type before intro handshake [%d]\nDisconnecting socket for slot: %d [%s].\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,networkMessageType,this->playerIndex,this->getIpAddress().c_str());
@@ -806,13 +836,14 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 						break;
 
 						//command list
-						case nmtCommandList: {
+						case nmtCommandList:
+						case nmtCommandListCompact: {
 
 							if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] got nmtCommandList gotIntro = %d\n",__FILE__,__FUNCTION__,__LINE__,gotIntro);
 
 							if(gotIntro == true) {
 								NetworkMessageCommandList networkMessageCommandList;
-								if(receiveMessage(&networkMessageCommandList)) {
+								if(receiveMessage(&networkMessageCommandList, networkMessageType)) {
 									currentFrameCount = networkMessageCommandList.getFrameCount();
 									lastReceiveCommandListTime = time(NULL);
 
@@ -856,6 +887,7 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 								this->playerLanguage = networkMessageIntro.getPlayerLanguage();
 								this->playerUUID	  = networkMessageIntro.getPlayerUUID();
 								this->platform		  = networkMessageIntro.getPlayerPlatform();
+								setPeerNetworkFeatures(networkMessageIntro.getNetworkFeatures() & NetworkMessage::getLocalNetworkFeatures());
 
 								//printf("Got uuid from client [%s]\n",this->playerUUID.c_str());
 								if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s] got name [%s] versionString [%s], msgSessionId = %d\n",__FILE__,__FUNCTION__,name.c_str(),versionString.c_str(),msgSessionId);
@@ -1386,7 +1418,8 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 								difftime((long int)time(NULL),this->getConnectedTime()) >= LAG_CHECK_GRACE_PERIOD) {
 							if(this->isConnected() == true && this->gotIntro == true && this->skipLagCheck == false) {
 								double clientLag = this->serverInterface->getCurrentFrameCount() - this->getCurrentFrameCount();
-								double clientLagCount = (gameSettings.getNetworkFramePeriod() > 0 ? (clientLag / gameSettings.getNetworkFramePeriod()) : 0);
+								int networkFramePeriod = this->serverInterface->gameSettings.getNetworkFramePeriod();
+								double clientLagCount = (networkFramePeriod > 0 ? (clientLag / networkFramePeriod) : 0);
 								double clientLagTime = difftime((long int)time(NULL),this->getLastReceiveCommandListTime());
 
 								double maxFrameCountLagAllowed 		= 10;
@@ -82,6 +82,10 @@ protected:
 
 	ConnectionSlotCallbackInterface *slotInterface;
 	Semaphore semTaskSignalled;
+	// signalled by SocketReadReactor when the slot socket has new data
+	Semaphore semSocketReadReady;
+	bool useSocketReadReactor;
+	bool socketReadPending;
 	Mutex *triggerIdMutex;
 	vector<ConnectionSlotEvent> eventList;
 	int slotIndex;
@@ -13,6 +13,7 @@
 
 #include <exception>
 #include <cassert>
+#include <algorithm>
 
 #include "data_types.h"
 #include "conversion.h"
@@ -33,6 +34,7 @@ namespace Glest{ namespace Game{
 // =====================================================
 
 const int NetworkInterface::readyWaitTimeout= 99000;	// 99 seconds to 0 looks good on the screen
+const int NetworkInterface::maxPingRoundTripSamples= 32;
 
 bool NetworkInterface::allowGameDataSynchCheck  = false;
 bool NetworkInterface::allowDownloadDataSynch   = false;
@@ -52,6 +54,7 @@ NetworkInterface::NetworkInterface() {
 	for(unsigned int index = 0; index < (unsigned int)GameConstants::maxPlayers; ++index) {
 		networkPlayerFactionCRC[index] = 0;
 	}
+	peerNetworkFeatures = 0;
 }
 
 void NetworkInterface::init() {
@@ -68,6 +71,7 @@ void NetworkInterface::init() {
 	for(unsigned int index = 0; index < (unsigned int)GameConstants::maxPlayers; ++index) {
 		networkPlayerFactionCRC[index] = 0;
 	}
+	peerNetworkFeatures = 0;
 }
 
 NetworkInterface::~NetworkInterface() {
@@ -114,6 +118,12 @@ void NetworkInterface::addUnMarkedCell(const UnMarkedCell &msg) {
 void NetworkInterface::sendMessage(NetworkMessage* networkMessage){
 	Socket* socket= getSocket(false);
 
+	// The same command list is broadcast to every slot, pick the encoding per peer
+	NetworkMessageCommandList *commandListMsg = dynamic_cast<NetworkMessageCommandList *>(networkMessage);
+	if(commandListMsg != NULL) {
+		commandListMsg->setCompact((peerNetworkFeatures & nftCompactCommandList) != 0);
+	}
+
 	networkMessage->send(socket);
 }
 
@@ -250,6 +260,54 @@ double NetworkInterface::getLastPingLag() {
 	return difftime((long int)time(NULL),lastPingInfo.getPingReceivedLocalTime());
 }
 
+// Answers a ping echo request or records the round trip of a reply,
+// returns false for the plain pings sent from the lobby
+bool NetworkInterface::processPingEcho(const NetworkMessagePing &ping) {
+	if(ping.getPingFrequency() == NetworkMessagePing::pingEchoRequest) {
+		NetworkMessagePing networkMessagePing(NetworkMessagePing::pingEchoReply,ping.getPingTime());
+		sendMessage(&networkMessagePing);
+		return true;
+	}
+	else if(ping.getPingFrequency() == NetworkMessagePing::pingEchoReply) {
+		int64 roundTrip = Chrono::getCurMillis() - ping.getPingTime();
+		if(roundTrip < 0) {
+			return true;
+		}
+
+		static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+		MutexSafeWrapper safeMutex(networkAccessMutex,mutexOwnerId);
+
+		pingRoundTripMillis.push_back(roundTrip);
+		while((int)pingRoundTripMillis.size() > maxPingRoundTripSamples) {
+			pingRoundTripMillis.pop_front();
+		}
+		return true;
+	}
+	return false;
+}
+
+void NetworkInterface::sendPingEchoRequest() {
+	NetworkMessagePing networkMessagePing(NetworkMessagePing::pingEchoRequest,Chrono::getCurMillis());
+	sendMessage(&networkMessagePing);
+}
+
+// Returns -1 until at least minSamples round trips were measured
+int64 NetworkInterface::getPingRoundTripPercentile(int percentile, int minSamples) {
+	static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(networkAccessMutex,mutexOwnerId);
+
+	if(pingRoundTripMillis.empty() == true ||
+		(int)pingRoundTripMillis.size() < minSamples) {
+		return -1;
+	}
+	std::vector<int64> samples(pingRoundTripMillis.begin(),pingRoundTripMillis.end());
+	safeMutex.ReleaseLock();
+
+	std::sort(samples.begin(),samples.end());
+	int index = (int)(((int64)samples.size() - 1) * max(0,min(percentile,100)) / 100);
+	return samples[index];
+}
+
 void NetworkInterface::DisplayErrorMessage(string sErr, bool closeSocket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] sErr [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,sErr.c_str());
 	//SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] sErr [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,sErr.c_str());
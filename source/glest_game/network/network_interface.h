@@ -19,6 +19,7 @@
 
 #include <string>
 #include <vector>
+#include <deque>
 #include "checksum.h"
 #include "network_message.h"
 #include "network_types.h"
@@ -202,6 +203,12 @@ protected:
 	Mutex *networkPlayerFactionCRCMutex;
 	uint32 networkPlayerFactionCRC[GameConstants::maxPlayers];
 
+	// NetworkFeatureType flags the other side sent in its intro
+	uint32 peerNetworkFeatures;
+
+	// most recent ping echo round trip times in milliseconds
+	std::deque<int64> pingRoundTripMillis;
+
 public:
 	static const int readyWaitTimeout;
 	GameSettings gameSettings;
@@ -222,6 +229,9 @@ public:
 	uint32 getNetworkPlayerFactionCRC(int index);
 	void setNetworkPlayerFactionCRC(int index, uint32 crc);
 
+	uint32 getPeerNetworkFeatures() const			{ return peerNetworkFeatures; }
+	void setPeerNetworkFeatures(uint32 features)	{ peerNetworkFeatures = features; }
+
 	virtual Socket* getSocket(bool mutexLock=true)= 0;
 
 	virtual void close()= 0;
@@ -282,6 +292,11 @@ public:
 	NetworkMessagePing getLastPingInfo();
 	double getLastPingLag();
 
+	static const int maxPingRoundTripSamples;
+	bool processPingEcho(const NetworkMessagePing &ping);
+	void sendPingEchoRequest();
+	int64 getPingRoundTripPercentile(int percentile, int minSamples);
+
 	float getThreadedPingMS(std::string host);
 
 	string getNetworkGameDataSynchCheckTechMismatchReport() const {return networkGameDataSynchCheckTechMismatchReport;}
@@ -28,7 +28,7 @@
 #include "checksum.h"
 #include "platform_util.h"
 #include "config.h"
-#include "network_protocol.h"
+#include "network_wire.h"
 #include "compression_utils.h"
 #include <algorithm>
 #include <cassert>
@@ -162,6 +162,39 @@ void NetworkMessage::send(Socket* socket, const void* data, int dataSize, int8 m
 	}
 }
 
+bool NetworkMessage::receivePacked(Socket* socket) {
+	const unsigned int packedSize = getPackedSize();
+
+	unsigned char stackBuf[maxPackedStackSize];
+	std::vector<unsigned char> heapBuf;
+	unsigned char *buf = stackBuf;
+	if(packedSize > maxPackedStackSize) {
+		heapBuf.resize(packedSize);
+		buf = &heapBuf[0];
+	}
+
+	bool result = NetworkMessage::receive(socket, buf, packedSize, true);
+	if(result == true) {
+		unpackMessage(buf, packedSize);
+	}
+	return result;
+}
+
+void NetworkMessage::sendPacked(Socket* socket) {
+	const unsigned int packedSize = getPackedSize();
+
+	unsigned char stackBuf[maxPackedStackSize];
+	std::vector<unsigned char> heapBuf;
+	unsigned char *buf = stackBuf;
+	if(packedSize > maxPackedStackSize) {
+		heapBuf.resize(packedSize);
+		buf = &heapBuf[0];
+	}
+
+	packMessage(buf);
+	NetworkMessage::send(socket, buf, packedSize);
+}
+
 void NetworkMessage::resetNetworkPacketStats() {
 	NetworkMessage::statsTimer.stop();
 	NetworkMessage::lastSend.stop();
@@ -195,11 +228,45 @@ string  NetworkMessage::getNetworkPacketStats() {
 				result += "recv avg size: " + intToStr(iterMap->second) + "\n";
 				break;
 
+			case netmsgstCommandListRawBytes:
+				result += "cmdlist raw bytes: " + intToStr(iterMap->second) + "\n";
+				break;
+			case netmsgstCommandListSentBytes:
+				result += "cmdlist compact bytes: " + intToStr(iterMap->second) + "\n";
+				break;
+
+			default:
+				break;
+
 		}
 	}
+
+	std::map<NetworkMessageStatisticType,int64>::iterator iterRaw = mapMessageStats.find(netmsgstCommandListRawBytes);
+	std::map<NetworkMessageStatisticType,int64>::iterator iterSent = mapMessageStats.find(netmsgstCommandListSentBytes);
+	if(iterRaw != mapMessageStats.end() && iterSent != mapMessageStats.end() && iterRaw->second > 0) {
+		result += "cmdlist bytes saved: " + intToStr(iterRaw->second - iterSent->second) +
+				  " (" + intToStr((iterRaw->second - iterSent->second) * 100 / iterRaw->second) + "%)\n";
+	}
 	return result;
 }
 
+void NetworkMessage::addCommandListStats(int64 rawBytes, int64 sentBytes) {
+	MutexSafeWrapper safeMutex(NetworkMessage::mutexMessageStats.get());
+	NetworkMessage::mapMessageStats[netmsgstCommandListRawBytes] += rawBytes;
+	NetworkMessage::mapMessageStats[netmsgstCommandListSentBytes] += sentBytes;
+}
+
+uint32 NetworkMessage::getLocalNetworkFeatures() {
+	uint32 features = 0;
+	if(Config::getInstance().getBool("NetworkCompactCommandList","true") == true) {
+		features |= nftCompactCommandList;
+	}
+	if(Config::getInstance().getBool("NetworkAdaptiveFramePeriod","true") == true) {
+		features |= nftAdaptiveFramePeriod;
+	}
+	return features;
+}
+
 void NetworkMessage::dump_packet(string label, const void* data, int dataSize, bool isSend) {
 	Config &config = Config::getInstance();
 	if( config.getBool("DebugNetworkPacketStats","false") == true) {
@@ -329,6 +396,7 @@ NetworkMessageIntro::NetworkMessageIntro() {
 	data.externalIp = 0;
 	data.ftpPort = 0;
 	data.gameInProgress = 0;
+	data.networkFeatures = 0;
 }
 
 NetworkMessageIntro::NetworkMessageIntro(int32 sessionId,const string &versionString,
@@ -338,7 +406,8 @@ NetworkMessageIntro::NetworkMessageIntro(int32 sessionId,const string &versionSt
 										uint32 ftpPort,
 										const string &playerLanguage,
 										int gameInProgress, const string &playerUUID,
-										const string &platform) {
+										const string &platform,
+										uint32 networkFeatures) {
 	messageType	= nmtIntro;
 	data.sessionId		= sessionId;
 	data.versionString	= versionString;
@@ -351,78 +420,38 @@ NetworkMessageIntro::NetworkMessageIntro(int32 sessionId,const string &versionSt
 	data.gameInProgress = gameInProgress;
 	data.playerUUID		= playerUUID;
 	data.platform		= platform;
+	data.networkFeatures = networkFeatures;
 }
 
-const char * NetworkMessageIntro::getPackedMessageFormat() const {
-	return "cl128s32shcLL60sc60s60s";
+template<class Wire> void NetworkMessageIntro::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.sessionId);
+	wire.field(data.versionString);
+	wire.field(data.name);
+	wire.field(data.playerIndex);
+	wire.field(data.gameState);
+	wire.field(data.externalIp);
+	wire.field(data.ftpPort);
+	wire.field(data.language);
+	wire.field(data.gameInProgress);
+	wire.field(data.playerUUID);
+	wire.field(data.platform);
+	wire.field(data.networkFeatures);
 }
 
 unsigned int NetworkMessageIntro::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		packedData.externalIp = 0;
-		packedData.ftpPort = 0;
-		packedData.gameInProgress = 0;
-		packedData.gameState = 0;
-		messageType = nmtIntro;
-		packedData.playerIndex = 0;
-		packedData.sessionId = 0;
-
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.sessionId,
-				packedData.versionString.getBuffer(),
-				packedData.name.getBuffer(),
-				packedData.playerIndex,
-				packedData.gameState,
-				packedData.externalIp,
-				packedData.ftpPort,
-				packedData.language.getBuffer(),
-				data.gameInProgress,
-				packedData.playerUUID.getBuffer(),
-				packedData.platform.getBuffer());
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageIntro::unpackMessage(unsigned char *buf) {
-	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("\nIn [%s] about to unpack...\n",__FUNCTION__);
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			&data.sessionId,
-			data.versionString.getBuffer(),
-			data.name.getBuffer(),
-			&data.playerIndex,
-			&data.gameState,
-			&data.externalIp,
-			&data.ftpPort,
-			data.language.getBuffer(),
-			&data.gameInProgress,
-			data.playerUUID.getBuffer(),
-			data.platform.getBuffer());
-	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s] unpacked data:\n%s\n",__FUNCTION__,this->toString().c_str());
-}
-
-unsigned char * NetworkMessageIntro::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-
-	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("\nIn [%s] about to pack...\n",__FUNCTION__);
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.sessionId,
-			data.versionString.getBuffer(),
-			data.name.getBuffer(),
-			data.playerIndex,
-			data.gameState,
-			data.externalIp,
-			data.ftpPort,
-			data.language.getBuffer(),
-			data.gameInProgress,
-			data.playerUUID.getBuffer(),
-			data.platform.getBuffer());
-	return buf;
+void NetworkMessageIntro::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
+}
+
+void NetworkMessageIntro::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 string NetworkMessageIntro::toString() const {
@@ -438,6 +467,7 @@ string NetworkMessageIntro::toString() const {
 	result += " gameInProgress = " + uIntToStr(data.gameInProgress);
 	result += " playerUUID = " + data.playerUUID.getString();
 	result += " platform = " + data.platform.getString();
+	result += " networkFeatures = " + uIntToStr(data.networkFeatures);
 
 	return result;
 }
@@ -449,15 +479,11 @@ bool NetworkMessageIntro::receive(Socket* socket) {
 		if(result == true) {
 			messageType = this->getNetworkMessageType();
 		}
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	data.name.nullTerminate();
 	data.versionString.nullTerminate();
@@ -472,45 +498,29 @@ bool NetworkMessageIntro::receive(Socket* socket) {
 void NetworkMessageIntro::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] sending nmtIntro, data.playerIndex = %d, data.sessionId = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,data.playerIndex,data.sessionId);
 	assert(messageType == nmtIntro);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data),messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		//NetworkMessage::send(socket, &data, sizeof(data));
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageIntro::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.sessionId = Shared::PlatformByteOrder::toCommonEndian(data.sessionId);
-		data.playerIndex = Shared::PlatformByteOrder::toCommonEndian(data.playerIndex);
-		data.gameState = Shared::PlatformByteOrder::toCommonEndian(data.gameState);
-		data.externalIp = Shared::PlatformByteOrder::toCommonEndian(data.externalIp);
-		data.ftpPort = Shared::PlatformByteOrder::toCommonEndian(data.ftpPort);
-
-		data.gameInProgress = Shared::PlatformByteOrder::toCommonEndian(data.gameInProgress);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessageIntro::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.sessionId = Shared::PlatformByteOrder::fromCommonEndian(data.sessionId);
-		data.playerIndex = Shared::PlatformByteOrder::fromCommonEndian(data.playerIndex);
-		data.gameState = Shared::PlatformByteOrder::fromCommonEndian(data.gameState);
-		data.externalIp = Shared::PlatformByteOrder::fromCommonEndian(data.externalIp);
-		data.ftpPort = Shared::PlatformByteOrder::fromCommonEndian(data.ftpPort);
-
-		data.gameInProgress = Shared::PlatformByteOrder::fromCommonEndian(data.gameInProgress);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -532,40 +542,25 @@ NetworkMessagePing::NetworkMessagePing(int32 pingFrequency, int64 pingTime){
 	pingReceivedLocalTime=0;
 }
 
-const char * NetworkMessagePing::getPackedMessageFormat() const {
-	return "clq";
+template<class Wire> void NetworkMessagePing::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.pingFrequency);
+	wire.field(data.pingTime);
 }
 
 unsigned int NetworkMessagePing::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		messageType = 0;
-		packedData.pingFrequency = 0;
-		packedData.pingTime = 0;
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.pingFrequency,
-				packedData.pingTime);
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessagePing::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			&data.pingFrequency,
-			&data.pingTime);
+void NetworkMessagePing::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessagePing::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.pingFrequency,
-			data.pingTime);
-	return buf;
+void NetworkMessagePing::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessagePing::receive(Socket* socket){
@@ -575,15 +570,11 @@ bool NetworkMessagePing::receive(Socket* socket){
 		if(result == true) {
 			messageType = this->getNetworkMessageType();
 		}
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	pingReceivedLocalTime = time(NULL);
 	return result;
@@ -592,35 +583,29 @@ bool NetworkMessagePing::receive(Socket* socket){
 void NetworkMessagePing::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtPing\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 	assert(messageType == nmtPing);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		//NetworkMessage::send(socket, &data, sizeof(data));
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessagePing::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.pingFrequency = Shared::PlatformByteOrder::toCommonEndian(data.pingFrequency);
-		data.pingTime = Shared::PlatformByteOrder::toCommonEndian(data.pingTime);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessagePing::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.pingFrequency = Shared::PlatformByteOrder::fromCommonEndian(data.pingFrequency);
-		data.pingTime = Shared::PlatformByteOrder::fromCommonEndian(data.pingTime);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -638,36 +623,24 @@ NetworkMessageReady::NetworkMessageReady(uint32 checksum) {
 	data.checksum= checksum;
 }
 
-const char * NetworkMessageReady::getPackedMessageFormat() const {
-	return "cL";
+template<class Wire> void NetworkMessageReady::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.checksum);
 }
 
 unsigned int NetworkMessageReady::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		packedData.checksum = 0;
-		messageType = 0;
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.checksum);
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageReady::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			&data.checksum);
+void NetworkMessageReady::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessageReady::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.checksum);
-	return buf;
+void NetworkMessageReady::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageReady::receive(Socket* socket){
@@ -677,48 +650,40 @@ bool NetworkMessageReady::receive(Socket* socket){
 		if(result == true) {
 			messageType = this->getNetworkMessageType();
 		}
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		//bool result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
-	}
-	fromEndian();
+		result = receivePacked(socket);
+	}
 	return result;
 }
 
 void NetworkMessageReady::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtReady\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 	assert(messageType == nmtReady);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageReady::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.checksum = Shared::PlatformByteOrder::toCommonEndian(data.checksum);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessageReady::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.checksum = Shared::PlatformByteOrder::fromCommonEndian(data.checksum);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -877,512 +842,23 @@ vector<pair<string,uint32> > NetworkMessageLaunch::getFactionCRCList() const {
 	return factionCRCList;
 }
 
-const char * NetworkMessageLaunch::getPackedMessageFormat() const {
-	return "c256s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60sllllllll60s60s60s60s60s60s60s60sLLL60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60s60sLLLLLLLLLLLLLLLLLLLLcccccccccccccccccccccccccccccccccccccccccCccLccll256s60s60s60s60s60s60s60s60sc60s";
+template<class Wire> void NetworkMessageLaunch::wireFields(Wire &wire) {
+	wireData(wire, messageType, data);
 }
 
 unsigned int NetworkMessageLaunch::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		packedData.aiAcceptSwitchTeamPercentChance = 0;
-		packedData.allowObservers = 0;
-		packedData.cpuReplacementMultiplier = 0;
-		packedData.defaultResources = 0;
-		packedData.defaultUnits = 0;
-		packedData.defaultVictoryConditions = 0;
-		packedData.enableObserverModeAtEndGame = 0;
-		packedData.enableServerControlledAI = 0;
-		for(unsigned int index =0; index < (unsigned int)maxFactionCRCCount; ++index) {
-			packedData.factionCRCList[index] = 0;
-		}
-		for(unsigned int index =0; index < (unsigned int)GameConstants::maxPlayers; ++index) {
-			packedData.factionControls[index] = 0;
-			packedData.networkPlayerStatuses[index] = 0;
-			packedData.resourceMultiplierIndex[index] = 0;
-			packedData.startLocationIndex[index] = 0;
-			packedData.teams[index] = 0;
-		}
-		packedData.factionCount = 0;
-		packedData.flagTypes1 = 0;
-		packedData.fogOfWar = 0;
-		packedData.mapCRC = 0;
-		packedData.mapFilter = 0;
-		packedData.masterserver_admin = 0;
-		packedData.masterserver_admin_factionIndex = 0;
-		messageType = 0;
-		packedData.networkAllowNativeLanguageTechtree = 0;
-		packedData.networkFramePeriod = 0;
-		packedData.networkPauseGameForLaggedClients = 0;
-		packedData.pathFinderType = 0;
-		packedData.techCRC = 0;
-		packedData.thisFactionIndex = 0;
-		packedData.tilesetCRC = 0;
-
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.description.getBuffer(),
-				packedData.map.getBuffer(),
-				packedData.tileset.getBuffer(),
-				packedData.tech.getBuffer(),
-				packedData.factionTypeNames[0].getBuffer(),
-				packedData.factionTypeNames[1].getBuffer(),
-				packedData.factionTypeNames[2].getBuffer(),
-				packedData.factionTypeNames[3].getBuffer(),
-				packedData.factionTypeNames[4].getBuffer(),
-				packedData.factionTypeNames[5].getBuffer(),
-				packedData.factionTypeNames[6].getBuffer(),
-				packedData.factionTypeNames[7].getBuffer(),
-				packedData.networkPlayerNames[0].getBuffer(),
-				packedData.networkPlayerNames[1].getBuffer(),
-				packedData.networkPlayerNames[2].getBuffer(),
-				packedData.networkPlayerNames[3].getBuffer(),
-				packedData.networkPlayerNames[4].getBuffer(),
-				packedData.networkPlayerNames[5].getBuffer(),
-				packedData.networkPlayerNames[6].getBuffer(),
-				packedData.networkPlayerNames[7].getBuffer(),
-				packedData.networkPlayerPlatform[0].getBuffer(),
-				packedData.networkPlayerPlatform[1].getBuffer(),
-				packedData.networkPlayerPlatform[2].getBuffer(),
-				packedData.networkPlayerPlatform[3].getBuffer(),
-				packedData.networkPlayerPlatform[4].getBuffer(),
-				packedData.networkPlayerPlatform[5].getBuffer(),
-				packedData.networkPlayerPlatform[6].getBuffer(),
-				packedData.networkPlayerPlatform[7].getBuffer(),
-				packedData.networkPlayerStatuses[0],
-				packedData.networkPlayerStatuses[1],
-				packedData.networkPlayerStatuses[2],
-				packedData.networkPlayerStatuses[3],
-				packedData.networkPlayerStatuses[4],
-				packedData.networkPlayerStatuses[5],
-				packedData.networkPlayerStatuses[6],
-				packedData.networkPlayerStatuses[7],
-				packedData.networkPlayerLanguages[0].getBuffer(),
-				packedData.networkPlayerLanguages[1].getBuffer(),
-				packedData.networkPlayerLanguages[2].getBuffer(),
-				packedData.networkPlayerLanguages[3].getBuffer(),
-				packedData.networkPlayerLanguages[4].getBuffer(),
-				packedData.networkPlayerLanguages[5].getBuffer(),
-				packedData.networkPlayerLanguages[6].getBuffer(),
-				packedData.networkPlayerLanguages[7].getBuffer(),
-				packedData.mapCRC,
-				packedData.mapFilter,
-				packedData.tilesetCRC,
-				packedData.techCRC,
-				packedData.factionNameList[0].getBuffer(),
-				packedData.factionNameList[1].getBuffer(),
-				packedData.factionNameList[2].getBuffer(),
-				packedData.factionNameList[3].getBuffer(),
-				packedData.factionNameList[4].getBuffer(),
-				packedData.factionNameList[5].getBuffer(),
-				packedData.factionNameList[6].getBuffer(),
-				packedData.factionNameList[7].getBuffer(),
-				packedData.factionNameList[8].getBuffer(),
-				packedData.factionNameList[9].getBuffer(),
-				packedData.factionNameList[10].getBuffer(),
-				packedData.factionNameList[11].getBuffer(),
-				packedData.factionNameList[12].getBuffer(),
-				packedData.factionNameList[13].getBuffer(),
-				packedData.factionNameList[14].getBuffer(),
-				packedData.factionNameList[15].getBuffer(),
-				packedData.factionNameList[16].getBuffer(),
-				packedData.factionNameList[17].getBuffer(),
-				packedData.factionNameList[18].getBuffer(),
-				packedData.factionNameList[19].getBuffer(),
-				packedData.factionCRCList[0],
-				packedData.factionCRCList[1],
-				packedData.factionCRCList[2],
-				packedData.factionCRCList[3],
-				packedData.factionCRCList[4],
-				packedData.factionCRCList[5],
-				packedData.factionCRCList[6],
-				packedData.factionCRCList[7],
-				packedData.factionCRCList[8],
-				packedData.factionCRCList[9],
-				packedData.factionCRCList[10],
-				packedData.factionCRCList[11],
-				packedData.factionCRCList[12],
-				packedData.factionCRCList[13],
-				packedData.factionCRCList[14],
-				packedData.factionCRCList[15],
-				packedData.factionCRCList[16],
-				packedData.factionCRCList[17],
-				packedData.factionCRCList[18],
-				packedData.factionCRCList[19],
-				packedData.factionControls[0],
-				packedData.factionControls[1],
-				packedData.factionControls[2],
-				packedData.factionControls[3],
-				packedData.factionControls[4],
-				packedData.factionControls[5],
-				packedData.factionControls[6],
-				packedData.factionControls[7],
-				packedData.resourceMultiplierIndex[0],
-				packedData.resourceMultiplierIndex[1],
-				packedData.resourceMultiplierIndex[2],
-				packedData.resourceMultiplierIndex[3],
-				packedData.resourceMultiplierIndex[4],
-				packedData.resourceMultiplierIndex[5],
-				packedData.resourceMultiplierIndex[6],
-				packedData.resourceMultiplierIndex[7],
-				packedData.thisFactionIndex,
-				packedData.factionCount,
-				packedData.teams[0],
-				packedData.teams[1],
-				packedData.teams[2],
-				packedData.teams[3],
-				packedData.teams[4],
-				packedData.teams[5],
-				packedData.teams[6],
-				packedData.teams[7],
-				packedData.startLocationIndex[0],
-				packedData.startLocationIndex[1],
-				packedData.startLocationIndex[2],
-				packedData.startLocationIndex[3],
-				packedData.startLocationIndex[4],
-				packedData.startLocationIndex[5],
-				packedData.startLocationIndex[6],
-				packedData.startLocationIndex[7],
-				packedData.defaultResources,
-				packedData.defaultUnits,
-				packedData.defaultVictoryConditions,
-				packedData.fogOfWar,
-				packedData.allowObservers,
-				packedData.enableObserverModeAtEndGame,
-				packedData.enableServerControlledAI,
-				packedData.networkFramePeriod,
-				packedData.networkPauseGameForLaggedClients,
-				packedData.pathFinderType,
-				packedData.flagTypes1,
-				packedData.aiAcceptSwitchTeamPercentChance,
-				packedData.cpuReplacementMultiplier,
-				packedData.masterserver_admin,
-				packedData.masterserver_admin_factionIndex,
-				packedData.scenario.getBuffer(),
-				packedData.networkPlayerUUID[0].getBuffer(),
-				packedData.networkPlayerUUID[1].getBuffer(),
-				packedData.networkPlayerUUID[2].getBuffer(),
-				packedData.networkPlayerUUID[3].getBuffer(),
-				packedData.networkPlayerUUID[4].getBuffer(),
-				packedData.networkPlayerUUID[5].getBuffer(),
-				packedData.networkPlayerUUID[6].getBuffer(),
-				packedData.networkPlayerUUID[7].getBuffer(),
-				packedData.networkAllowNativeLanguageTechtree,
-				packedData.gameUUID.getBuffer()
-		);
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageLaunch::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			data.description.getBuffer(),
-			data.map.getBuffer(),
-			data.tileset.getBuffer(),
-			data.tech.getBuffer(),
-			data.factionTypeNames[0].getBuffer(),
-			data.factionTypeNames[1].getBuffer(),
-			data.factionTypeNames[2].getBuffer(),
-			data.factionTypeNames[3].getBuffer(),
-			data.factionTypeNames[4].getBuffer(),
-			data.factionTypeNames[5].getBuffer(),
-			data.factionTypeNames[6].getBuffer(),
-			data.factionTypeNames[7].getBuffer(),
-			data.networkPlayerNames[0].getBuffer(),
-			data.networkPlayerNames[1].getBuffer(),
-			data.networkPlayerNames[2].getBuffer(),
-			data.networkPlayerNames[3].getBuffer(),
-			data.networkPlayerNames[4].getBuffer(),
-			data.networkPlayerNames[5].getBuffer(),
-			data.networkPlayerNames[6].getBuffer(),
-			data.networkPlayerNames[7].getBuffer(),
-			data.networkPlayerPlatform[0].getBuffer(),
-			data.networkPlayerPlatform[1].getBuffer(),
-			data.networkPlayerPlatform[2].getBuffer(),
-			data.networkPlayerPlatform[3].getBuffer(),
-			data.networkPlayerPlatform[4].getBuffer(),
-			data.networkPlayerPlatform[5].getBuffer(),
-			data.networkPlayerPlatform[6].getBuffer(),
-			data.networkPlayerPlatform[7].getBuffer(),
-			&data.networkPlayerStatuses[0],
-			&data.networkPlayerStatuses[1],
-			&data.networkPlayerStatuses[2],
-			&data.networkPlayerStatuses[3],
-			&data.networkPlayerStatuses[4],
-			&data.networkPlayerStatuses[5],
-			&data.networkPlayerStatuses[6],
-			&data.networkPlayerStatuses[7],
-			data.networkPlayerLanguages[0].getBuffer(),
-			data.networkPlayerLanguages[1].getBuffer(),
-			data.networkPlayerLanguages[2].getBuffer(),
-			data.networkPlayerLanguages[3].getBuffer(),
-			data.networkPlayerLanguages[4].getBuffer(),
-			data.networkPlayerLanguages[5].getBuffer(),
-			data.networkPlayerLanguages[6].getBuffer(),
-			data.networkPlayerLanguages[7].getBuffer(),
-			&data.mapFilter,
-			&data.mapCRC,
-			&data.tilesetCRC,
-			&data.techCRC,
-			data.factionNameList[0].getBuffer(),
-			data.factionNameList[1].getBuffer(),
-			data.factionNameList[2].getBuffer(),
-			data.factionNameList[3].getBuffer(),
-			data.factionNameList[4].getBuffer(),
-			data.factionNameList[5].getBuffer(),
-			data.factionNameList[6].getBuffer(),
-			data.factionNameList[7].getBuffer(),
-			data.factionNameList[8].getBuffer(),
-			data.factionNameList[9].getBuffer(),
-			data.factionNameList[10].getBuffer(),
-			data.factionNameList[11].getBuffer(),
-			data.factionNameList[12].getBuffer(),
-			data.factionNameList[13].getBuffer(),
-			data.factionNameList[14].getBuffer(),
-			data.factionNameList[15].getBuffer(),
-			data.factionNameList[16].getBuffer(),
-			data.factionNameList[17].getBuffer(),
-			data.factionNameList[18].getBuffer(),
-			data.factionNameList[19].getBuffer(),
-			&data.factionCRCList[0],
-			&data.factionCRCList[1],
-			&data.factionCRCList[2],
-			&data.factionCRCList[3],
-			&data.factionCRCList[4],
-			&data.factionCRCList[5],
-			&data.factionCRCList[6],
-			&data.factionCRCList[7],
-			&data.factionCRCList[8],
-			&data.factionCRCList[9],
-			&data.factionCRCList[10],
-			&data.factionCRCList[11],
-			&data.factionCRCList[12],
-			&data.factionCRCList[13],
-			&data.factionCRCList[14],
-			&data.factionCRCList[15],
-			&data.factionCRCList[16],
-			&data.factionCRCList[17],
-			&data.factionCRCList[18],
-			&data.factionCRCList[19],
-			&data.factionControls[0],
-			&data.factionControls[1],
-			&data.factionControls[2],
-			&data.factionControls[3],
-			&data.factionControls[4],
-			&data.factionControls[5],
-			&data.factionControls[6],
-			&data.factionControls[7],
-			&data.resourceMultiplierIndex[0],
-			&data.resourceMultiplierIndex[1],
-			&data.resourceMultiplierIndex[2],
-			&data.resourceMultiplierIndex[3],
-			&data.resourceMultiplierIndex[4],
-			&data.resourceMultiplierIndex[5],
-			&data.resourceMultiplierIndex[6],
-			&data.resourceMultiplierIndex[7],
-			&data.thisFactionIndex,
-			&data.factionCount,
-			&data.teams[0],
-			&data.teams[1],
-			&data.teams[2],
-			&data.teams[3],
-			&data.teams[4],
-			&data.teams[5],
-			&data.teams[6],
-			&data.teams[7],
-			&data.startLocationIndex[0],
-			&data.startLocationIndex[1],
-			&data.startLocationIndex[2],
-			&data.startLocationIndex[3],
-			&data.startLocationIndex[4],
-			&data.startLocationIndex[5],
-			&data.startLocationIndex[6],
-			&data.startLocationIndex[7],
-			&data.defaultResources,
-			&data.defaultUnits,
-			&data.defaultVictoryConditions,
-			&data.fogOfWar,
-			&data.allowObservers,
-			&data.enableObserverModeAtEndGame,
-			&data.enableServerControlledAI,
-			&data.networkFramePeriod,
-			&data.networkPauseGameForLaggedClients,
-			&data.pathFinderType,
-			&data.flagTypes1,
-			&data.aiAcceptSwitchTeamPercentChance,
-			&data.cpuReplacementMultiplier,
-			&data.masterserver_admin,
-			&data.masterserver_admin_factionIndex,
-			data.scenario.getBuffer(),
-			data.networkPlayerUUID[0].getBuffer(),
-			data.networkPlayerUUID[1].getBuffer(),
-			data.networkPlayerUUID[2].getBuffer(),
-			data.networkPlayerUUID[3].getBuffer(),
-			data.networkPlayerUUID[4].getBuffer(),
-			data.networkPlayerUUID[5].getBuffer(),
-			data.networkPlayerUUID[6].getBuffer(),
-			data.networkPlayerUUID[7].getBuffer(),
-			&data.networkAllowNativeLanguageTechtree,
-			data.gameUUID.getBuffer()
-	);
-}
-
-unsigned char * NetworkMessageLaunch::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.description.getBuffer(),
-			data.map.getBuffer(),
-			data.tileset.getBuffer(),
-			data.tech.getBuffer(),
-			data.factionTypeNames[0].getBuffer(),
-			data.factionTypeNames[1].getBuffer(),
-			data.factionTypeNames[2].getBuffer(),
-			data.factionTypeNames[3].getBuffer(),
-			data.factionTypeNames[4].getBuffer(),
-			data.factionTypeNames[5].getBuffer(),
-			data.factionTypeNames[6].getBuffer(),
-			data.factionTypeNames[7].getBuffer(),
-			data.networkPlayerNames[0].getBuffer(),
-			data.networkPlayerNames[1].getBuffer(),
-			data.networkPlayerNames[2].getBuffer(),
-			data.networkPlayerNames[3].getBuffer(),
-			data.networkPlayerNames[4].getBuffer(),
-			data.networkPlayerNames[5].getBuffer(),
-			data.networkPlayerNames[6].getBuffer(),
-			data.networkPlayerNames[7].getBuffer(),
-			data.networkPlayerPlatform[0].getBuffer(),
-			data.networkPlayerPlatform[1].getBuffer(),
-			data.networkPlayerPlatform[2].getBuffer(),
-			data.networkPlayerPlatform[3].getBuffer(),
-			data.networkPlayerPlatform[4].getBuffer(),
-			data.networkPlayerPlatform[5].getBuffer(),
-			data.networkPlayerPlatform[6].getBuffer(),
-			data.networkPlayerPlatform[7].getBuffer(),
-			data.networkPlayerStatuses[0],
-			data.networkPlayerStatuses[1],
-			data.networkPlayerStatuses[2],
-			data.networkPlayerStatuses[3],
-			data.networkPlayerStatuses[4],
-			data.networkPlayerStatuses[5],
-			data.networkPlayerStatuses[6],
-			data.networkPlayerStatuses[7],
-			data.networkPlayerLanguages[0].getBuffer(),
-			data.networkPlayerLanguages[1].getBuffer(),
-			data.networkPlayerLanguages[2].getBuffer(),
-			data.networkPlayerLanguages[3].getBuffer(),
-			data.networkPlayerLanguages[4].getBuffer(),
-			data.networkPlayerLanguages[5].getBuffer(),
-			data.networkPlayerLanguages[6].getBuffer(),
-			data.networkPlayerLanguages[7].getBuffer(),
-			data.mapFilter,
-			data.mapCRC,
-			data.tilesetCRC,
-			data.techCRC,
-			data.factionNameList[0].getBuffer(),
-			data.factionNameList[1].getBuffer(),
-			data.factionNameList[2].getBuffer(),
-			data.factionNameList[3].getBuffer(),
-			data.factionNameList[4].getBuffer(),
-			data.factionNameList[5].getBuffer(),
-			data.factionNameList[6].getBuffer(),
-			data.factionNameList[7].getBuffer(),
-			data.factionNameList[8].getBuffer(),
-			data.factionNameList[9].getBuffer(),
-			data.factionNameList[10].getBuffer(),
-			data.factionNameList[11].getBuffer(),
-			data.factionNameList[12].getBuffer(),
-			data.factionNameList[13].getBuffer(),
-			data.factionNameList[14].getBuffer(),
-			data.factionNameList[15].getBuffer(),
-			data.factionNameList[16].getBuffer(),
-			data.factionNameList[17].getBuffer(),
-			data.factionNameList[18].getBuffer(),
-			data.factionNameList[19].getBuffer(),
-			data.factionCRCList[0],
-			data.factionCRCList[1],
-			data.factionCRCList[2],
-			data.factionCRCList[3],
-			data.factionCRCList[4],
-			data.factionCRCList[5],
-			data.factionCRCList[6],
-			data.factionCRCList[7],
-			data.factionCRCList[8],
-			data.factionCRCList[9],
-			data.factionCRCList[10],
-			data.factionCRCList[11],
-			data.factionCRCList[12],
-			data.factionCRCList[13],
-			data.factionCRCList[14],
-			data.factionCRCList[15],
-			data.factionCRCList[16],
-			data.factionCRCList[17],
-			data.factionCRCList[18],
-			data.factionCRCList[19],
-			data.factionControls[0],
-			data.factionControls[1],
-			data.factionControls[2],
-			data.factionControls[3],
-			data.factionControls[4],
-			data.factionControls[5],
-			data.factionControls[6],
-			data.factionControls[7],
-			data.resourceMultiplierIndex[0],
-			data.resourceMultiplierIndex[1],
-			data.resourceMultiplierIndex[2],
-			data.resourceMultiplierIndex[3],
-			data.resourceMultiplierIndex[4],
-			data.resourceMultiplierIndex[5],
-			data.resourceMultiplierIndex[6],
-			data.resourceMultiplierIndex[7],
-			data.thisFactionIndex,
-			data.factionCount,
-			data.teams[0],
-			data.teams[1],
-			data.teams[2],
-			data.teams[3],
-			data.teams[4],
-			data.teams[5],
-			data.teams[6],
-			data.teams[7],
-			data.startLocationIndex[0],
-			data.startLocationIndex[1],
-			data.startLocationIndex[2],
-			data.startLocationIndex[3],
-			data.startLocationIndex[4],
-			data.startLocationIndex[5],
-			data.startLocationIndex[6],
-			data.startLocationIndex[7],
-			data.defaultResources,
-			data.defaultUnits,
-			data.defaultVictoryConditions,
-			data.fogOfWar,
-			data.allowObservers,
-			data.enableObserverModeAtEndGame,
-			data.enableServerControlledAI,
-			data.networkFramePeriod,
-			data.networkPauseGameForLaggedClients,
-			data.pathFinderType,
-			data.flagTypes1,
-			data.aiAcceptSwitchTeamPercentChance,
-			data.cpuReplacementMultiplier,
-			data.masterserver_admin,
-			data.masterserver_admin_factionIndex,
-			data.scenario.getBuffer(),
-			data.networkPlayerUUID[0].getBuffer(),
-			data.networkPlayerUUID[1].getBuffer(),
-			data.networkPlayerUUID[2].getBuffer(),
-			data.networkPlayerUUID[3].getBuffer(),
-			data.networkPlayerUUID[4].getBuffer(),
-			data.networkPlayerUUID[5].getBuffer(),
-			data.networkPlayerUUID[6].getBuffer(),
-			data.networkPlayerUUID[7].getBuffer(),
-			data.networkAllowNativeLanguageTechtree,
-			data.gameUUID.getBuffer()
-			);
-	return buf;
+void NetworkMessageLaunch::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
+}
+
+void NetworkMessageLaunch::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageLaunch::receive(Socket* socket, NetworkMessageType type) {
@@ -1463,15 +939,11 @@ bool NetworkMessageLaunch::receive(Socket* socket) {
         	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
         	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) chrono.start();
 		}
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) chrono.start();
@@ -1532,9 +1004,9 @@ void NetworkMessageLaunch::send(Socket* socket) {
 	else {
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] messageType = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,messageType);
 	}
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		////NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		//NetworkMessage::send(socket, &data, sizeof(data), messageType);
 
@@ -1566,90 +1038,23 @@ void NetworkMessageLaunch::send(Socket* socket) {
 		//printf("Compressed launch packet SENT\n");
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageLaunch::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		for(int i= 0; i < GameConstants::maxPlayers; ++i){
-			data.networkPlayerStatuses[i] = Shared::PlatformByteOrder::toCommonEndian(data.networkPlayerStatuses[i]);
-			data.factionCRCList[i] = Shared::PlatformByteOrder::toCommonEndian(data.factionCRCList[i]);
-			data.factionControls[i] = Shared::PlatformByteOrder::toCommonEndian(data.factionControls[i]);
-			data.resourceMultiplierIndex[i] = Shared::PlatformByteOrder::toCommonEndian(data.resourceMultiplierIndex[i]);
-			data.teams[i] = Shared::PlatformByteOrder::toCommonEndian(data.teams[i]);
-			data.startLocationIndex[i] = Shared::PlatformByteOrder::toCommonEndian(data.startLocationIndex[i]);
-		}
-		data.mapFilter = Shared::PlatformByteOrder::toCommonEndian(data.mapFilter);
-		data.mapCRC = Shared::PlatformByteOrder::toCommonEndian(data.mapCRC);
-		data.tilesetCRC = Shared::PlatformByteOrder::toCommonEndian(data.tilesetCRC);
-		data.techCRC = Shared::PlatformByteOrder::toCommonEndian(data.techCRC);
-		data.thisFactionIndex = Shared::PlatformByteOrder::toCommonEndian(data.thisFactionIndex);
-		data.factionCount = Shared::PlatformByteOrder::toCommonEndian(data.factionCount);
-		data.defaultResources = Shared::PlatformByteOrder::toCommonEndian(data.defaultResources);
-		data.defaultUnits = Shared::PlatformByteOrder::toCommonEndian(data.defaultUnits);
-
-		data.defaultVictoryConditions = Shared::PlatformByteOrder::toCommonEndian(data.defaultVictoryConditions);
-		data.fogOfWar = Shared::PlatformByteOrder::toCommonEndian(data.fogOfWar);
-		data.allowObservers = Shared::PlatformByteOrder::toCommonEndian(data.allowObservers);
-		data.enableObserverModeAtEndGame = Shared::PlatformByteOrder::toCommonEndian(data.enableObserverModeAtEndGame);
-		data.enableServerControlledAI = Shared::PlatformByteOrder::toCommonEndian(data.enableServerControlledAI);
-		data.networkFramePeriod = Shared::PlatformByteOrder::toCommonEndian(data.networkFramePeriod);
-		data.networkPauseGameForLaggedClients = Shared::PlatformByteOrder::toCommonEndian(data.networkPauseGameForLaggedClients);
-		data.pathFinderType = Shared::PlatformByteOrder::toCommonEndian(data.pathFinderType);
-		data.flagTypes1 = Shared::PlatformByteOrder::toCommonEndian(data.flagTypes1);
-
-		data.aiAcceptSwitchTeamPercentChance = Shared::PlatformByteOrder::toCommonEndian(data.aiAcceptSwitchTeamPercentChance);
-		data.cpuReplacementMultiplier = Shared::PlatformByteOrder::toCommonEndian(data.cpuReplacementMultiplier);
-		data.masterserver_admin = Shared::PlatformByteOrder::toCommonEndian(data.masterserver_admin);
-		data.masterserver_admin_factionIndex = Shared::PlatformByteOrder::toCommonEndian(data.masterserver_admin_factionIndex);
-
-		data.networkAllowNativeLanguageTechtree = Shared::PlatformByteOrder::toCommonEndian(data.networkAllowNativeLanguageTechtree);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 
 void NetworkMessageLaunch::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		for(int i= 0; i < GameConstants::maxPlayers; ++i){
-			data.networkPlayerStatuses[i] = Shared::PlatformByteOrder::fromCommonEndian(data.networkPlayerStatuses[i]);
-			data.factionCRCList[i] = Shared::PlatformByteOrder::fromCommonEndian(data.factionCRCList[i]);
-			data.factionControls[i] = Shared::PlatformByteOrder::fromCommonEndian(data.factionControls[i]);
-			data.resourceMultiplierIndex[i] = Shared::PlatformByteOrder::fromCommonEndian(data.resourceMultiplierIndex[i]);
-			data.teams[i] = Shared::PlatformByteOrder::fromCommonEndian(data.teams[i]);
-			data.startLocationIndex[i] = Shared::PlatformByteOrder::fromCommonEndian(data.startLocationIndex[i]);
-		}
-		data.mapFilter = Shared::PlatformByteOrder::fromCommonEndian(data.mapFilter);
-		data.mapCRC = Shared::PlatformByteOrder::fromCommonEndian(data.mapCRC);
-		data.tilesetCRC = Shared::PlatformByteOrder::fromCommonEndian(data.tilesetCRC);
-		data.techCRC = Shared::PlatformByteOrder::fromCommonEndian(data.techCRC);
-		data.thisFactionIndex = Shared::PlatformByteOrder::fromCommonEndian(data.thisFactionIndex);
-		data.factionCount = Shared::PlatformByteOrder::fromCommonEndian(data.factionCount);
-		data.defaultResources = Shared::PlatformByteOrder::fromCommonEndian(data.defaultResources);
-		data.defaultUnits = Shared::PlatformByteOrder::fromCommonEndian(data.defaultUnits);
-
-		data.defaultVictoryConditions = Shared::PlatformByteOrder::fromCommonEndian(data.defaultVictoryConditions);
-		data.fogOfWar = Shared::PlatformByteOrder::fromCommonEndian(data.fogOfWar);
-		data.allowObservers = Shared::PlatformByteOrder::fromCommonEndian(data.allowObservers);
-		data.enableObserverModeAtEndGame = Shared::PlatformByteOrder::fromCommonEndian(data.enableObserverModeAtEndGame);
-		data.enableServerControlledAI = Shared::PlatformByteOrder::fromCommonEndian(data.enableServerControlledAI);
-		data.networkFramePeriod = Shared::PlatformByteOrder::fromCommonEndian(data.networkFramePeriod);
-		data.networkPauseGameForLaggedClients = Shared::PlatformByteOrder::fromCommonEndian(data.networkPauseGameForLaggedClients);
-		data.pathFinderType = Shared::PlatformByteOrder::fromCommonEndian(data.pathFinderType);
-		data.flagTypes1 = Shared::PlatformByteOrder::fromCommonEndian(data.flagTypes1);
-
-		data.aiAcceptSwitchTeamPercentChance = Shared::PlatformByteOrder::fromCommonEndian(data.aiAcceptSwitchTeamPercentChance);
-		data.cpuReplacementMultiplier = Shared::PlatformByteOrder::fromCommonEndian(data.cpuReplacementMultiplier);
-		data.masterserver_admin = Shared::PlatformByteOrder::fromCommonEndian(data.masterserver_admin);
-		data.masterserver_admin_factionIndex = Shared::PlatformByteOrder::fromCommonEndian(data.masterserver_admin_factionIndex);
-
-		data.networkAllowNativeLanguageTechtree = Shared::PlatformByteOrder::fromCommonEndian(data.networkAllowNativeLanguageTechtree);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -1664,6 +1069,7 @@ NetworkMessageCommandList::NetworkMessageCommandList(int32 frameCount) {
 	for(int index = 0; index < GameConstants::maxPlayers; ++index) {
 		data.header.networkPlayerFactionCRC[index]=0;
 	}
+	compact = false;
 }
 
 bool NetworkMessageCommandList::addCommand(const NetworkCommand* networkCommand){
@@ -1672,170 +1078,337 @@ bool NetworkMessageCommandList::addCommand(const NetworkCommand* networkCommand)
 	return true;
 }
 
-const char * NetworkMessageCommandList::getPackedMessageFormatHeader() const {
-	return "cHlLLLLLLLL";
+template<class Wire> void NetworkMessageCommandList::wireFieldsHeader(Wire &wire) {
+	wire.field(data.messageType);
+	wire.field(data.header.commandCount);
+	wire.field(data.header.frameCount);
+	wireFieldArray(wire, data.header.networkPlayerFactionCRC);
 }
 
 unsigned int NetworkMessageCommandList::getPackedSizeHeader() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		init(packedData);
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormatHeader(),
-				packedData.messageType,
-				packedData.header.commandCount,
-				packedData.header.frameCount,
-				packedData.header.networkPlayerFactionCRC[0],
-				packedData.header.networkPlayerFactionCRC[1],
-				packedData.header.networkPlayerFactionCRC[2],
-				packedData.header.networkPlayerFactionCRC[3],
-				packedData.header.networkPlayerFactionCRC[4],
-				packedData.header.networkPlayerFactionCRC[5],
-				packedData.header.networkPlayerFactionCRC[6],
-				packedData.header.networkPlayerFactionCRC[7]);
-		delete [] buf;
+	NetworkWireSize wire;
+	wireFieldsHeader(wire);
+	return wire.getSize();
+}
+
+unsigned int NetworkMessageCommandList::getPackedSizeCommand() {
+	NetworkWireSize wire;
+	NetworkCommand command;
+	command.wireFields(wire);
+	return wire.getSize();
+}
+
+bool NetworkMessageCommandList::receivePackedHeader(Socket* socket) {
+	unsigned char buf[maxPackedStackSize];
+	const unsigned int packedSize = getPackedSizeHeader();
+	bool result = NetworkMessage::receive(socket, buf, packedSize, true);
+	if(result == true) {
+		NetworkWireReader wire(buf, packedSize);
+		wireFieldsHeader(wire);
 	}
 	return result;
 }
-void NetworkMessageCommandList::unpackMessageHeader(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormatHeader(),
-			&data.messageType,
-			&data.header.commandCount,
-			&data.header.frameCount,
-			&data.header.networkPlayerFactionCRC[0],
-			&data.header.networkPlayerFactionCRC[1],
-			&data.header.networkPlayerFactionCRC[2],
-			&data.header.networkPlayerFactionCRC[3],
-			&data.header.networkPlayerFactionCRC[4],
-			&data.header.networkPlayerFactionCRC[5],
-			&data.header.networkPlayerFactionCRC[6],
-			&data.header.networkPlayerFactionCRC[7]);
-}
-
-unsigned char * NetworkMessageCommandList::packMessageHeader() {
-	unsigned char *buf = new unsigned char[getPackedSizeHeader()+1];
-	pack(buf, getPackedMessageFormatHeader(),
-			data.messageType,
-			data.header.commandCount,
-			data.header.frameCount,
-			data.header.networkPlayerFactionCRC[0],
-			data.header.networkPlayerFactionCRC[1],
-			data.header.networkPlayerFactionCRC[2],
-			data.header.networkPlayerFactionCRC[3],
-			data.header.networkPlayerFactionCRC[4],
-			data.header.networkPlayerFactionCRC[5],
-			data.header.networkPlayerFactionCRC[6],
-			data.header.networkPlayerFactionCRC[7]);
-	return buf;
-}
-
-const char * NetworkMessageCommandList::getPackedMessageFormatDetail() const {
-	return "hlhhhhlccHccll";
-}
-
-unsigned int NetworkMessageCommandList::getPackedSizeDetail(int count) {
-	unsigned int result = 0;
-	//if(result == 0) {
-		for(unsigned int i = 0; i < (unsigned int)count; ++i) {
-			NetworkCommand packedData;
-			unsigned char *buf = new unsigned char[sizeof(NetworkCommand)*3];
-			result += pack(buf, getPackedMessageFormatDetail(),
-					packedData.networkCommandType,
-					packedData.unitId,
-					packedData.unitTypeId,
-					packedData.commandTypeId,
-					packedData.positionX,
-					packedData.positionY,
-					packedData.targetId,
-					packedData.wantQueue,
-					packedData.fromFactionIndex,
-					packedData.unitFactionUnitCount,
-					packedData.unitFactionIndex,
-					packedData.commandStateType,
-					packedData.commandStateValue,
-					packedData.unitCommandGroupId);
-			delete [] buf;
+
+void NetworkMessageCommandList::sendPackedHeader(Socket* socket) {
+	unsigned char buf[maxPackedStackSize];
+	NetworkWireWriter wire(buf);
+	wireFieldsHeader(wire);
+	NetworkMessage::send(socket, buf, wire.getSize());
+}
+
+bool NetworkMessageCommandList::receivePackedDetail(Socket* socket, uint16 totalCommand) {
+	// commands are read in chunks that fit the stack buffer
+	unsigned char buf[maxPackedStackSize];
+	const unsigned int commandSize = getPackedSizeCommand();
+	const unsigned int chunkCommands = maxPackedStackSize / commandSize;
+
+	bool result = true;
+	for(unsigned int index = 0; result == true && index < totalCommand; ) {
+		unsigned int count = min(chunkCommands, (unsigned int)totalCommand - index);
+		result = NetworkMessage::receive(socket, buf, count * commandSize, true);
+		if(result == true) {
+			NetworkWireReader wire(buf, count * commandSize);
+			for(unsigned int end = index + count; index < end; ++index) {
+				data.commands[index].wireFields(wire);
+			}
 		}
-	//}
+	}
 	return result;
 }
-void NetworkMessageCommandList::unpackMessageDetail(unsigned char *buf,int count) {
+
+void NetworkMessageCommandList::sendPackedDetail(Socket* socket, uint16 totalCommand) {
+	unsigned char buf[maxPackedStackSize];
+	const unsigned int commandSize = getPackedSizeCommand();
+	const unsigned int chunkCommands = maxPackedStackSize / commandSize;
+
+	for(unsigned int index = 0; index < totalCommand; ) {
+		NetworkWireWriter wire(buf);
+		for(unsigned int end = index + min(chunkCommands, (unsigned int)totalCommand - index);
+			index < end; ++index) {
+			data.commands[index].wireFields(wire);
+		}
+		NetworkMessage::send(socket, buf, wire.getSize());
+	}
+}
+
+// Compact command list (nmtCommandListCompact):
+//
+//	varint payload size, then the payload:
+//	zigzag frameCount, varint commandCount, varint mask of the non zero
+//	faction CRCs followed by those CRCs, then one record per run of
+//	commands that give the same order to several units:
+//		varint field mask (ccf* below), the masked fields as zigzag
+//		varints (positions as a delta to the previous record),
+//		varint unit count and per unit the zigzag delta to the
+//		previous unit id (plus its unit count for ccfUnitCountPerUnit)
+static const uint32 ccfCommandType			= 0x0001;
+static const uint32 ccfUnitTypeId			= 0x0002;
+static const uint32 ccfCommandTypeId		= 0x0004;
+static const uint32 ccfPositionX			= 0x0008;
+static const uint32 ccfPositionY			= 0x0010;
+static const uint32 ccfTargetId				= 0x0020;
+static const uint32 ccfWantQueue			= 0x0040;
+static const uint32 ccfFromFactionIndex		= 0x0080;
+static const uint32 ccfUnitFactionIndex		= 0x0100;
+static const uint32 ccfCommandStateType		= 0x0200;
+static const uint32 ccfCommandStateValue	= 0x0400;
+static const uint32 ccfUnitCommandGroupId	= 0x0800;
+static const uint32 ccfUnitCount			= 0x1000;
+static const uint32 ccfUnitCountPerUnit		= 0x2000;
+
+static const uint32 maxCompactCommandListSize = 1 << 22;
+
+static bool isSameOrderForAnotherUnit(const NetworkCommand &first, const NetworkCommand &other) {
+	return	first.networkCommandType == other.networkCommandType &&
+			first.unitTypeId == other.unitTypeId &&
+			first.commandTypeId == other.commandTypeId &&
+			first.positionX == other.positionX &&
+			first.positionY == other.positionY &&
+			first.targetId == other.targetId &&
+			first.wantQueue == other.wantQueue &&
+			first.fromFactionIndex == other.fromFactionIndex &&
+			first.unitFactionIndex == other.unitFactionIndex &&
+			first.commandStateType == other.commandStateType &&
+			first.commandStateValue == other.commandStateValue &&
+			first.unitCommandGroupId == other.unitCommandGroupId;
+}
+
+void NetworkMessageCommandList::encodeCompact(std::vector<unsigned char> &buf) const {
+	NetworkVarintWriter wire(buf);
+
+	const unsigned int totalCommand = data.header.commandCount;
+	wire.putSigned(data.header.frameCount);
+	wire.putUnsigned(totalCommand);
+
+	uint32 crcMask = 0;
+	for(int index = 0; index < GameConstants::maxPlayers; ++index) {
+		if(data.header.networkPlayerFactionCRC[index] != 0) {
+			crcMask |= (1u << index);
+		}
+	}
+	wire.putUnsigned(crcMask);
+	for(int index = 0; index < GameConstants::maxPlayers; ++index) {
+		if((crcMask & (1u << index)) != 0) {
+			wire.putFixed32(data.header.networkPlayerFactionCRC[index]);
+		}
+	}
+
+	int32 lastUnitId = 0;
+	int32 lastPositionX = 0;
+	int32 lastPositionY = 0;
+	for(unsigned int index = 0; index < totalCommand; ) {
+		const NetworkCommand &cmd = data.commands[index];
+
+		unsigned int groupEnd = index + 1;
+		bool sameUnitCount = true;
+		for(; groupEnd < totalCommand && isSameOrderForAnotherUnit(cmd, data.commands[groupEnd]); ++groupEnd) {
+			if(data.commands[groupEnd].unitFactionUnitCount != cmd.unitFactionUnitCount) {
+				sameUnitCount = false;
+			}
+		}
+
+		int32 deltaX = cmd.positionX - lastPositionX;
+		int32 deltaY = cmd.positionY - lastPositionY;
+		lastPositionX = cmd.positionX;
+		lastPositionY = cmd.positionY;
+
+		uint32 fields = 0;
+		if(cmd.networkCommandType != 0)		fields |= ccfCommandType;
+		if(cmd.unitTypeId != 0)				fields |= ccfUnitTypeId;
+		if(cmd.commandTypeId != 0)			fields |= ccfCommandTypeId;
+		if(deltaX != 0)						fields |= ccfPositionX;
+		if(deltaY != 0)						fields |= ccfPositionY;
+		if(cmd.targetId != 0)				fields |= ccfTargetId;
+		if(cmd.wantQueue != 0)				fields |= ccfWantQueue;
+		if(cmd.fromFactionIndex != 0)		fields |= ccfFromFactionIndex;
+		if(cmd.unitFactionIndex != 0)		fields |= ccfUnitFactionIndex;
+		if(cmd.commandStateType != 0)		fields |= ccfCommandStateType;
+		if(cmd.commandStateValue != 0)		fields |= ccfCommandStateValue;
+		if(cmd.unitCommandGroupId != 0)		fields |= ccfUnitCommandGroupId;
+		if(sameUnitCount == false)			fields |= ccfUnitCountPerUnit;
+		else if(cmd.unitFactionUnitCount != 0) fields |= ccfUnitCount;
+
+		wire.putUnsigned(fields);
+		if(fields & ccfCommandType)			wire.putSigned(cmd.networkCommandType);
+		if(fields & ccfUnitTypeId)			wire.putSigned(cmd.unitTypeId);
+		if(fields & ccfCommandTypeId)		wire.putSigned(cmd.commandTypeId);
+		if(fields & ccfPositionX)			wire.putSigned(deltaX);
+		if(fields & ccfPositionY)			wire.putSigned(deltaY);
+		if(fields & ccfTargetId)			wire.putSigned(cmd.targetId);
+		if(fields & ccfWantQueue)			wire.putSigned(cmd.wantQueue);
+		if(fields & ccfFromFactionIndex)	wire.putSigned(cmd.fromFactionIndex);
+		if(fields & ccfUnitFactionIndex)	wire.putSigned(cmd.unitFactionIndex);
+		if(fields & ccfCommandStateType)	wire.putSigned(cmd.commandStateType);
+		if(fields & ccfCommandStateValue)	wire.putSigned(cmd.commandStateValue);
+		if(fields & ccfUnitCommandGroupId)	wire.putSigned(cmd.unitCommandGroupId);
+		if(fields & ccfUnitCount)			wire.putUnsigned(cmd.unitFactionUnitCount);
+
+		wire.putUnsigned(groupEnd - index);
+		for(; index < groupEnd; ++index) {
+			const NetworkCommand &unitCmd = data.commands[index];
+			wire.putSigned(static_cast<int32>(static_cast<uint32>(unitCmd.unitId) - static_cast<uint32>(lastUnitId)));
+			lastUnitId = unitCmd.unitId;
+			if(fields & ccfUnitCountPerUnit) {
+				wire.putUnsigned(unitCmd.unitFactionUnitCount);
+			}
+		}
+	}
+}
+
+bool NetworkMessageCommandList::decodeCompact(const unsigned char *buf, unsigned int size) {
+	NetworkVarintReader wire(buf, size);
+
+	data.messageType = nmtCommandList;
+	data.header.frameCount = wire.getSigned();
+	uint32 totalCommand = wire.getUnsigned();
+	if(totalCommand > 0xFFFF) {
+		return false;
+	}
+	data.header.commandCount = static_cast<uint16>(totalCommand);
+
+	uint32 crcMask = wire.getUnsigned();
+	for(int index = 0; index < GameConstants::maxPlayers; ++index) {
+		data.header.networkPlayerFactionCRC[index] =
+				((crcMask & (1u << index)) != 0 ? wire.getFixed32() : 0);
+	}
+
 	data.commands.clear();
-	data.commands.resize(count);
-	//unsigned int bytes_processed_total = 0;
-	unsigned char *bufMove = buf;
-	for(unsigned int i = 0; i < (unsigned int)count; ++i) {
-		unsigned int bytes_processed = unpack(bufMove, getPackedMessageFormatDetail(),
-				&data.commands[i].networkCommandType,
-				&data.commands[i].unitId,
-				&data.commands[i].unitTypeId,
-				&data.commands[i].commandTypeId,
-				&data.commands[i].positionX,
-				&data.commands[i].positionY,
-				&data.commands[i].targetId,
-				&data.commands[i].wantQueue,
-				&data.commands[i].fromFactionIndex,
-				&data.commands[i].unitFactionUnitCount,
-				&data.commands[i].unitFactionIndex,
-				&data.commands[i].commandStateType,
-				&data.commands[i].commandStateValue,
-				&data.commands[i].unitCommandGroupId);
-		bufMove += bytes_processed;
-		//bytes_processed_total += bytes_processed;
-	}
-	//printf("\nUnPacked detail size = %u\n",bytes_processed_total);
-}
-
-unsigned char * NetworkMessageCommandList::packMessageDetail(uint16 totalCommand) {
-	int packetSize = getPackedSizeDetail(totalCommand) +1;
-	unsigned char *buf = new unsigned char[packetSize];
-	unsigned char *bufMove = buf;
-	//unsigned int bytes_processed_total = 0;
-	for(unsigned int i = 0; i < totalCommand; ++i) {
-		unsigned int bytes_processed = pack(bufMove, getPackedMessageFormatDetail(),
-				data.commands[i].networkCommandType,
-				data.commands[i].unitId,
-				data.commands[i].unitTypeId,
-				data.commands[i].commandTypeId,
-				data.commands[i].positionX,
-				data.commands[i].positionY,
-				data.commands[i].targetId,
-				data.commands[i].wantQueue,
-				data.commands[i].fromFactionIndex,
-				data.commands[i].unitFactionUnitCount,
-				data.commands[i].unitFactionIndex,
-				data.commands[i].commandStateType,
-				data.commands[i].commandStateValue,
-				data.commands[i].unitCommandGroupId);
-		bufMove += bytes_processed;
-		//bytes_processed_total += bytes_processed;
-	}
-	//printf("\nPacked detail size = %u, allocated = %d\n",bytes_processed_total,packetSize);
-	return buf;
+	data.commands.reserve(totalCommand);
+
+	int32 lastUnitId = 0;
+	int32 lastPositionX = 0;
+	int32 lastPositionY = 0;
+	while(wire.hasOverrun() == false && data.commands.size() < totalCommand) {
+		NetworkCommand cmd;
+		uint32 fields = wire.getUnsigned();
+		if(fields & ccfCommandType)			cmd.networkCommandType = static_cast<int16>(wire.getSigned());
+		if(fields & ccfUnitTypeId)			cmd.unitTypeId = static_cast<int16>(wire.getSigned());
+		if(fields & ccfCommandTypeId)		cmd.commandTypeId = static_cast<int16>(wire.getSigned());
+		if(fields & ccfPositionX)			lastPositionX += wire.getSigned();
+		if(fields & ccfPositionY)			lastPositionY += wire.getSigned();
+		if(fields & ccfTargetId)			cmd.targetId = wire.getSigned();
+		if(fields & ccfWantQueue)			cmd.wantQueue = static_cast<int8>(wire.getSigned());
+		if(fields & ccfFromFactionIndex)	cmd.fromFactionIndex = static_cast<int8>(wire.getSigned());
+		if(fields & ccfUnitFactionIndex)	cmd.unitFactionIndex = static_cast<int8>(wire.getSigned());
+		if(fields & ccfCommandStateType)	cmd.commandStateType = static_cast<int8>(wire.getSigned());
+		if(fields & ccfCommandStateValue)	cmd.commandStateValue = wire.getSigned();
+		if(fields & ccfUnitCommandGroupId)	cmd.unitCommandGroupId = wire.getSigned();
+		if(fields & ccfUnitCount)			cmd.unitFactionUnitCount = static_cast<uint16>(wire.getUnsigned());
+		cmd.positionX = static_cast<int16>(lastPositionX);
+		cmd.positionY = static_cast<int16>(lastPositionY);
+
+		uint32 unitCount = wire.getUnsigned();
+		if(unitCount == 0 || unitCount > totalCommand - data.commands.size()) {
+			return false;
+		}
+		for(uint32 unitIndex = 0; unitIndex < unitCount; ++unitIndex) {
+			lastUnitId = static_cast<int32>(static_cast<uint32>(lastUnitId) + static_cast<uint32>(wire.getSigned()));
+			cmd.unitId = lastUnitId;
+			if(fields & ccfUnitCountPerUnit) {
+				cmd.unitFactionUnitCount = static_cast<uint16>(wire.getUnsigned());
+			}
+			data.commands.push_back(cmd);
+		}
+	}
+	return (wire.hasOverrun() == false && wire.atEnd() == true &&
+			data.commands.size() == totalCommand);
+}
+
+bool NetworkMessageCommandList::receiveCompact(Socket* socket) {
+	uint32 payloadSize = 0;
+	for(int shift = 0; ; shift += 7) {
+		unsigned char byte = 0;
+		if(NetworkMessage::receive(socket, &byte, sizeof(byte), true) == false) {
+			return false;
+		}
+		payloadSize |= static_cast<uint32>(byte & 0x7F) << shift;
+		if((byte & 0x80) == 0) {
+			break;
+		}
+		if(shift >= 28) {
+			throw megaglest_runtime_error("Invalid compact command list size");
+		}
+	}
+	if(payloadSize > maxCompactCommandListSize) {
+		throw megaglest_runtime_error("Invalid compact command list size: " + uIntToStr(payloadSize));
+	}
+
+	unsigned char stackBuf[maxPackedStackSize];
+	std::vector<unsigned char> heapBuf;
+	unsigned char *buf = stackBuf;
+	if(payloadSize > maxPackedStackSize) {
+		heapBuf.resize(payloadSize);
+		buf = &heapBuf[0];
+	}
+
+	bool result = NetworkMessage::receive(socket, buf, payloadSize, true);
+	if(result == true && decodeCompact(buf, payloadSize) == false) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] ERROR invalid compact command list, payloadSize = %u\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,payloadSize);
+		result = false;
+	}
+	return result;
+}
+
+void NetworkMessageCommandList::sendCompact(Socket* socket) {
+	std::vector<unsigned char> payload;
+	payload.reserve(16 + data.header.commandCount * 8);
+	encodeCompact(payload);
+
+	std::vector<unsigned char> packet;
+	packet.reserve(payload.size() + 5);
+	NetworkVarintWriter wire(packet);
+	wire.putUnsigned(static_cast<uint32>(payload.size()));
+	packet.insert(packet.end(), payload.begin(), payload.end());
+
+	NetworkMessage::send(socket, &packet[0], (int)packet.size(), nmtCommandListCompact);
+
+	addCommandListStats(sizeof(data.messageType) + commandListHeaderSize + sizeof(NetworkCommand) * data.header.commandCount,
+						sizeof(data.messageType) + packet.size());
+}
+
+bool NetworkMessageCommandList::receive(Socket* socket, NetworkMessageType type) {
+	if(type == nmtCommandListCompact) {
+		return receiveCompact(socket);
+	}
+	return receive(socket);
 }
 
 bool NetworkMessageCommandList::receive(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
-	unsigned char *buf = NULL;
 	bool result = false;
 	if(useOldProtocol == true) {
 		result = NetworkMessage::receive(socket, &data.header, commandListHeaderSize, true);
 		if(result == true) {
 			data.messageType = this->getNetworkMessageType();
 		}
+		fromEndianHeader();
 
 		//printf("!!! =====> IN Network hdr cmd get frame: %d data.header.commandCount: %u\n",data.header.frameCount,data.header.commandCount);
 	}
 	else {
-		buf = new unsigned char[getPackedSizeHeader()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSizeHeader(), true);
-		unpackMessageHeader(buf);
-		//if(data.header.commandCount) printf("\n\nGot packet size = %u data.messageType = %d\n%s\ncommandcount [%u] framecount [%d]\n",getPackedSizeHeader(),data.header.messageType,buf,data.header.commandCount,data.header.frameCount);
-		delete [] buf;
+		result = receivePackedHeader(socket);
 	}
-	fromEndianHeader();
 
 	if(result == true) {
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] got header, messageType = %d, commandCount = %u, frameCount = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,data.messageType,data.header.commandCount,data.header.frameCount);
@@ -1848,21 +1421,15 @@ bool NetworkMessageCommandList::receive(Socket* socket) {
 			if(useOldProtocol == true) {
 				int totalMsgSize = (sizeof(NetworkCommand) * data.header.commandCount);
 				result = NetworkMessage::receive(socket, &data.commands[0], totalMsgSize, true);
+				fromEndianDetail();
 
 //				if(data.commands[0].getNetworkCommandType() == nctPauseResume) {
 //					printf("=====> IN Network cmd type: %d [%d] frame: %d\n",data.commands[0].getNetworkCommandType(),nctPauseResume,data.header.frameCount);
 //				}
 			}
 			else {
-				//int totalMsgSize = (sizeof(NetworkCommand) * data.header.commandCount);
-				//result = NetworkMessage::receive(socket, &data.commands[0], totalMsgSize, true);
-				buf = new unsigned char[getPackedSizeDetail(data.header.commandCount)+1];
-				result = NetworkMessage::receive(socket, buf, getPackedSizeDetail(data.header.commandCount), true);
-				unpackMessageDetail(buf,data.header.commandCount);
-				//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-				delete [] buf;
+				result = receivePackedDetail(socket, data.header.commandCount);
 			}
-			fromEndianDetail();
 
 //	        for(int idx = 0 ; idx < data.header.commandCount; ++idx) {
 //	            const NetworkCommand &cmd = data.commands[idx];
@@ -1909,12 +1476,15 @@ void NetworkMessageCommandList::send(Socket* socket) {
 
 	assert(data.messageType == nmtCommandList);
 	uint16 totalCommand = data.header.commandCount;
-	toEndianHeader();
-	toEndianDetail(totalCommand);
 
-	unsigned char *buf = NULL;
 	//bool result = false;
-	if(useOldProtocol == true) {
+	if(useOldProtocol == true && compact == true) {
+		sendCompact(socket);
+	}
+	else if(useOldProtocol == true) {
+		toEndianHeader();
+		toEndianDetail(totalCommand);
+
 		//printf("<===== OUT Network hdr cmd type: frame: %d totalCommand: %u [%u]\n",data.header.frameCount,totalCommand,data.header.commandCount);
 		//NetworkMessage::send(socket, &data.messageType, sizeof(data.messageType));
 
@@ -1928,11 +1498,7 @@ void NetworkMessageCommandList::send(Socket* socket) {
 		delete [] send_buffer;
 	}
 	else {
-		//NetworkMessage::send(socket, &data.header, commandListHeaderSize);
-		buf = packMessageHeader();
-		//if(totalCommand) printf("\n\nSend packet size = %u data.messageType = %d\n%s\ncommandcount [%u] framecount [%d]\n",getPackedSizeHeader(),data.header.messageType,buf,totalCommand,data.header.frameCount);
-		NetworkMessage::send(socket, buf, getPackedSizeHeader());
-		delete [] buf;
+		sendPackedHeader(socket);
 	}
 
 	if(totalCommand > 0) {
@@ -1948,13 +1514,7 @@ void NetworkMessageCommandList::send(Socket* socket) {
 			//NetworkMessage::send(socket, &data.commands[0], (sizeof(NetworkCommand) * totalCommand));
 		}
 		else {
-			buf = packMessageDetail(totalCommand);
-			//printf("\n#4 Send packet commandcount [%u] framecount [%d]\n",totalCommand,data.header.frameCount);
-			//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-			NetworkMessage::send(socket, buf, getPackedSizeDetail(totalCommand));
-			//printf("\n#5 Send packet commandcount [%u] framecount [%d]\n",totalCommand,data.header.frameCount);
-			delete [] buf;
-			//printf("\n#6 Send packet commandcount [%u] framecount [%d]\n",totalCommand,data.header.frameCount);
+			sendPackedDetail(socket, totalCommand);
 
 	//        for(int idx = 0 ; idx < totalCommand; ++idx) {
 	//            const NetworkCommand &cmd = data.commands[idx];
@@ -1983,23 +1543,15 @@ void NetworkMessageCommandList::send(Socket* socket) {
 void NetworkMessageCommandList::toEndianHeader() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		data.messageType = Shared::PlatformByteOrder::toCommonEndian(data.messageType);
-		data.header.commandCount = Shared::PlatformByteOrder::toCommonEndian(data.header.commandCount);
-		data.header.frameCount = Shared::PlatformByteOrder::toCommonEndian(data.header.frameCount);
-		for(int index = 0; index < GameConstants::maxPlayers; ++index) {
-			data.header.networkPlayerFactionCRC[index] = Shared::PlatformByteOrder::toCommonEndian(data.header.networkPlayerFactionCRC[index]);
-		}
+		NetworkWireToEndian wire;
+		wireFieldsHeader(wire);
 	}
 }
 void NetworkMessageCommandList::fromEndianHeader() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		data.messageType = Shared::PlatformByteOrder::fromCommonEndian(data.messageType);
-		data.header.commandCount = Shared::PlatformByteOrder::fromCommonEndian(data.header.commandCount);
-		data.header.frameCount = Shared::PlatformByteOrder::fromCommonEndian(data.header.frameCount);
-		for(int index = 0; index < GameConstants::maxPlayers; ++index) {
-			data.header.networkPlayerFactionCRC[index] = Shared::PlatformByteOrder::fromCommonEndian(data.header.networkPlayerFactionCRC[index]);
-		}
+		NetworkWireFromEndian wire;
+		wireFieldsHeader(wire);
 	}
 }
 
@@ -2053,46 +1605,27 @@ NetworkMessageText * NetworkMessageText::getCopy() const {
 	return copy;
 }
 
-const char * NetworkMessageText::getPackedMessageFormat() const {
-	return "c500scc60s";
+template<class Wire> void NetworkMessageText::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.text);
+	wire.field(data.teamIndex);
+	wire.field(data.playerIndex);
+	wire.field(data.targetLanguage);
 }
 
 unsigned int NetworkMessageText::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		messageType = nmtText;
-		packedData.playerIndex = 0;
-		packedData.teamIndex = 0;
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.text.getBuffer(),
-				packedData.teamIndex,
-				packedData.playerIndex,
-				packedData.targetLanguage.getBuffer());
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageText::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			data.text.getBuffer(),
-			&data.teamIndex,
-			&data.playerIndex,
-			data.targetLanguage.getBuffer());
+void NetworkMessageText::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessageText::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.text.getBuffer(),
-			data.teamIndex,
-			data.playerIndex,
-			data.targetLanguage.getBuffer());
-	return buf;
+void NetworkMessageText::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageText::receive(Socket* socket) {
@@ -2102,15 +1635,11 @@ bool NetworkMessageText::receive(Socket* socket) {
 		if(result == true) {
 			messageType = this->getNetworkMessageType();
 		}
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	data.text.nullTerminate();
 	data.targetLanguage.nullTerminate();
@@ -2122,34 +1651,29 @@ void NetworkMessageText::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtText\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	assert(messageType == nmtText);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageText::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.teamIndex = Shared::PlatformByteOrder::toCommonEndian(data.teamIndex);
-		data.playerIndex = Shared::PlatformByteOrder::toCommonEndian(data.playerIndex);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessageText::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.teamIndex = Shared::PlatformByteOrder::fromCommonEndian(data.teamIndex);
-		data.playerIndex = Shared::PlatformByteOrder::fromCommonEndian(data.playerIndex);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -2161,48 +1685,33 @@ NetworkMessageQuit::NetworkMessageQuit(){
 	messageType = nmtQuit;
 }
 
-const char * NetworkMessageQuit::getPackedMessageFormat() const {
-	return "c";
+template<class Wire> void NetworkMessageQuit::wireFields(Wire &wire) {
+	wire.field(messageType);
 }
 
 unsigned int NetworkMessageQuit::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		//Data packedData;
-		messageType = 0;
-		unsigned char *buf = new unsigned char[sizeof(messageType)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType);
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageQuit::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType);
+void NetworkMessageQuit::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessageQuit::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType);
-	return buf;
+void NetworkMessageQuit::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageQuit::receive(Socket* socket) {
 	bool result = false;
 	if(useOldProtocol == true) {
-		result = NetworkMessage::receive(socket, &messageType, sizeof(messageType),true);
+		result = NetworkMessage::receive(socket, &messageType, sizeof(messageType),true);		fromEndian();
 	}
 	else {
-		//fromEndian();
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	return result;
 }
@@ -2211,29 +1720,28 @@ void NetworkMessageQuit::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtQuit\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	assert(messageType == nmtQuit);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		NetworkMessage::send(socket, &messageType, sizeof(messageType));
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageQuit::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessageQuit::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -2352,111 +1860,17 @@ string NetworkMessageSynchNetworkGameData::getTechCRCFileMismatchReport(vector<s
 	return result;
 }
 
-const char * NetworkMessageSynchNetworkGameData::getPackedMessageFormatHeader() const {
-	return "c255s255s255sLLLL";
+template<class Wire> void NetworkMessageSynchNetworkGameData::wireFieldsHeader(Wire &wire) {
+	wire.field(data.messageType);
+	wire.field(data.header.map);
+	wire.field(data.header.tileset);
+	wire.field(data.header.tech);
+	wire.field(data.header.mapCRC);
+	wire.field(data.header.tilesetCRC);
+	wire.field(data.header.techCRC);
+	wire.field(data.header.techCRCFileCount);
 }
 
-unsigned int NetworkMessageSynchNetworkGameData::getPackedSizeHeader() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		packedData.messageType=0;
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormatHeader(),
-				packedData.messageType,
-				packedData.header.map.getBuffer(),
-				packedData.header.tileset.getBuffer(),
-				packedData.header.tech.getBuffer(),
-				packedData.header.mapCRC,
-				packedData.header.tilesetCRC,
-				packedData.header.techCRC,
-				packedData.header.techCRCFileCount);
-		delete [] buf;
-	}
-	return result;
-}
-void NetworkMessageSynchNetworkGameData::unpackMessageHeader(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormatHeader(),
-			&data.messageType,
-			data.header.map.getBuffer(),
-			data.header.tileset.getBuffer(),
-			data.header.tech.getBuffer(),
-			&data.header.mapCRC,
-			&data.header.tilesetCRC,
-			&data.header.techCRC,
-			&data.header.techCRCFileCount);
-}
-
-unsigned char * NetworkMessageSynchNetworkGameData::packMessageHeader() {
-	unsigned char *buf = new unsigned char[getPackedSizeHeader()+1];
-	pack(buf, getPackedMessageFormatHeader(),
-			data.messageType,
-			data.header.map.getBuffer(),
-			data.header.tileset.getBuffer(),
-			data.header.tech.getBuffer(),
-			data.header.mapCRC,
-			data.header.tilesetCRC,
-			data.header.techCRC,
-			data.header.techCRCFileCount);
-
-	return buf;
-}
-
-unsigned int NetworkMessageSynchNetworkGameData::getPackedSizeDetail() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		DataDetail packedData;
-		for(unsigned int index = 0; index < (unsigned int)maxFileCRCCount; ++index) {
-			packedData.techCRCFileCRCList[index] = 0;
-		}
-		unsigned char *buf = new unsigned char[sizeof(DataDetail)*3];
-
-		for(unsigned int i = 0; i < (unsigned int)maxFileCRCCount; ++i) {
-			result += pack(buf, "255s",
-					packedData.techCRCFileList[i].getBuffer());
-			buf += result;
-		}
-		for(unsigned int i = 0; i < (unsigned int)maxFileCRCCount; ++i) {
-			result += pack(buf, "L",
-					packedData.techCRCFileCRCList[i]);
-			buf += result;
-		}
-
-		delete [] buf;
-	}
-	return result;
-}
-void NetworkMessageSynchNetworkGameData::unpackMessageDetail(unsigned char *buf) {
-	for(unsigned int i = 0; i < (unsigned int)maxFileCRCCount; ++i) {
-		unsigned int bytes_processed = unpack(buf, "255s",
-				data.detail.techCRCFileList[i].getBuffer());
-		buf += bytes_processed;
-	}
-	for(unsigned int i = 0; i < (unsigned int)maxFileCRCCount; ++i) {
-		unsigned int bytes_processed = unpack(buf, "L",
-				&data.detail.techCRCFileCRCList[i]);
-		buf += bytes_processed;
-	}
-}
-
-unsigned char * NetworkMessageSynchNetworkGameData::packMessageDetail() {
-	unsigned char *buf = new unsigned char[sizeof(DataDetail)*3 +1];
-	unsigned char *bufMove = buf;
-	for(unsigned int i = 0; i < (unsigned int)maxFileCRCCount; ++i) {
-		unsigned int bytes_processed = pack(bufMove, "255s",
-				data.detail.techCRCFileList[i].getBuffer());
-		bufMove += bytes_processed;
-	}
-	for(unsigned int i = 0; i < (unsigned int)maxFileCRCCount; ++i) {
-		unsigned int bytes_processed = pack(bufMove, "L",
-				data.detail.techCRCFileCRCList[i]);
-		bufMove += bytes_processed;
-	}
-
-	return buf;
-}
-
-
 bool NetworkMessageSynchNetworkGameData::receive(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] about to get nmtSynchNetworkGameData\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
@@ -2548,21 +1962,15 @@ void NetworkMessageSynchNetworkGameData::send(Socket* socket) {
 void NetworkMessageSynchNetworkGameData::toEndianHeader() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		data.messageType = Shared::PlatformByteOrder::toCommonEndian(data.messageType);
-		data.header.mapCRC = Shared::PlatformByteOrder::toCommonEndian(data.header.mapCRC);
-		data.header.tilesetCRC = Shared::PlatformByteOrder::toCommonEndian(data.header.tilesetCRC);
-		data.header.techCRC = Shared::PlatformByteOrder::toCommonEndian(data.header.techCRC);
-		data.header.techCRCFileCount = Shared::PlatformByteOrder::toCommonEndian(data.header.techCRCFileCount);
+		NetworkWireToEndian wire;
+		wireFieldsHeader(wire);
 	}
 }
 void NetworkMessageSynchNetworkGameData::fromEndianHeader() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		data.messageType = Shared::PlatformByteOrder::fromCommonEndian(data.messageType);
-		data.header.mapCRC = Shared::PlatformByteOrder::fromCommonEndian(data.header.mapCRC);
-		data.header.tilesetCRC = Shared::PlatformByteOrder::fromCommonEndian(data.header.tilesetCRC);
-		data.header.techCRC = Shared::PlatformByteOrder::fromCommonEndian(data.header.techCRC);
-		data.header.techCRCFileCount = Shared::PlatformByteOrder::fromCommonEndian(data.header.techCRCFileCount);
+		NetworkWireFromEndian wire;
+		wireFieldsHeader(wire);
 	}
 }
 
@@ -2660,6 +2068,14 @@ string NetworkMessageSynchNetworkGameDataStatus::getTechCRCFileMismatchReport(st
 	return result;
 }
 
+template<class Wire> void NetworkMessageSynchNetworkGameDataStatus::wireFieldsHeader(Wire &wire) {
+	wire.field(data.messageType);
+	wire.field(data.header.mapCRC);
+	wire.field(data.header.tilesetCRC);
+	wire.field(data.header.techCRC);
+	wire.field(data.header.techCRCFileCount);
+}
+
 bool NetworkMessageSynchNetworkGameDataStatus::receive(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] about to get nmtSynchNetworkGameDataStatus\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
@@ -2742,22 +2158,16 @@ void NetworkMessageSynchNetworkGameDataStatus::send(Socket* socket) {
 void NetworkMessageSynchNetworkGameDataStatus::toEndianHeader() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		data.messageType = Shared::PlatformByteOrder::toCommonEndian(data.messageType);
-		data.header.mapCRC = Shared::PlatformByteOrder::toCommonEndian(data.header.mapCRC);
-		data.header.tilesetCRC = Shared::PlatformByteOrder::toCommonEndian(data.header.tilesetCRC);
-		data.header.techCRC = Shared::PlatformByteOrder::toCommonEndian(data.header.techCRC);
-		data.header.techCRCFileCount = Shared::PlatformByteOrder::toCommonEndian(data.header.techCRCFileCount);
+		NetworkWireToEndian wire;
+		wireFieldsHeader(wire);
 	}
 }
 
 void NetworkMessageSynchNetworkGameDataStatus::fromEndianHeader() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		data.messageType = Shared::PlatformByteOrder::fromCommonEndian(data.messageType);
-		data.header.mapCRC = Shared::PlatformByteOrder::fromCommonEndian(data.header.mapCRC);
-		data.header.tilesetCRC = Shared::PlatformByteOrder::fromCommonEndian(data.header.tilesetCRC);
-		data.header.techCRC = Shared::PlatformByteOrder::fromCommonEndian(data.header.techCRC);
-		data.header.techCRCFileCount = Shared::PlatformByteOrder::fromCommonEndian(data.header.techCRCFileCount);
+		NetworkWireFromEndian wire;
+		wireFieldsHeader(wire);
 	}
 }
 
@@ -2797,63 +2207,38 @@ NetworkMessageSynchNetworkGameDataFileCRCCheck::NetworkMessageSynchNetworkGameDa
     data.fileName       = fileName;
 }
 
-const char * NetworkMessageSynchNetworkGameDataFileCRCCheck::getPackedMessageFormat() const {
-	return "cLLL256s";
+template<class Wire> void NetworkMessageSynchNetworkGameDataFileCRCCheck::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.totalFileCount);
+	wire.field(data.fileIndex);
+	wire.field(data.fileCRC);
+	wire.field(data.fileName);
 }
 
 unsigned int NetworkMessageSynchNetworkGameDataFileCRCCheck::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		packedData.fileCRC = 0;
-		packedData.fileIndex = 0;
-		messageType = nmtSynchNetworkGameDataFileCRCCheck;
-		packedData.totalFileCount = 0;
-
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.totalFileCount,
-				packedData.fileIndex,
-				packedData.fileCRC,
-				packedData.fileName.getBuffer());
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageSynchNetworkGameDataFileCRCCheck::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			&data.totalFileCount,
-			&data.fileIndex,
-			&data.fileCRC,
-			data.fileName.getBuffer());
+void NetworkMessageSynchNetworkGameDataFileCRCCheck::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessageSynchNetworkGameDataFileCRCCheck::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.totalFileCount,
-			data.fileIndex,
-			data.fileCRC,
-			data.fileName.getBuffer());
-	return buf;
+void NetworkMessageSynchNetworkGameDataFileCRCCheck::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageSynchNetworkGameDataFileCRCCheck::receive(Socket* socket) {
 	bool result = false;
 	if(useOldProtocol == true) {
 		result = NetworkMessage::receive(socket, &data, sizeof(data),true);
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 	data.fileName.nullTerminate();
 
 	return result;
@@ -2863,37 +2248,30 @@ void NetworkMessageSynchNetworkGameDataFileCRCCheck::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtSynchNetworkGameDataFileCRCCheck\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	assert(messageType == nmtSynchNetworkGameDataFileCRCCheck);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageSynchNetworkGameDataFileCRCCheck::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.totalFileCount = Shared::PlatformByteOrder::toCommonEndian(data.totalFileCount);
-		data.fileIndex = Shared::PlatformByteOrder::toCommonEndian(data.fileIndex);
-		data.fileCRC = Shared::PlatformByteOrder::toCommonEndian(data.fileCRC);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 
 void NetworkMessageSynchNetworkGameDataFileCRCCheck::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.totalFileCount = Shared::PlatformByteOrder::fromCommonEndian(data.totalFileCount);
-		data.fileIndex = Shared::PlatformByteOrder::fromCommonEndian(data.fileIndex);
-		data.fileCRC = Shared::PlatformByteOrder::fromCommonEndian(data.fileCRC);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 // =====================================================
@@ -2907,50 +2285,35 @@ NetworkMessageSynchNetworkGameDataFileGet::NetworkMessageSynchNetworkGameDataFil
     data.fileName       = fileName;
 }
 
-const char * NetworkMessageSynchNetworkGameDataFileGet::getPackedMessageFormat() const {
-	return "c256s";
+template<class Wire> void NetworkMessageSynchNetworkGameDataFileGet::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.fileName);
 }
 
 unsigned int NetworkMessageSynchNetworkGameDataFileGet::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		messageType = nmtSynchNetworkGameDataFileGet;
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.fileName.getBuffer());
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageSynchNetworkGameDataFileGet::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			data.fileName.getBuffer());
+void NetworkMessageSynchNetworkGameDataFileGet::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessageSynchNetworkGameDataFileGet::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.fileName.getBuffer());
-	return buf;
+void NetworkMessageSynchNetworkGameDataFileGet::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageSynchNetworkGameDataFileGet::receive(Socket* socket) {
 	bool result = false;
 	if(useOldProtocol == true) {
 		result = NetworkMessage::receive(socket, &data, sizeof(data),true);
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 	data.fileName.nullTerminate();
 
 	return result;
@@ -2960,29 +2323,29 @@ void NetworkMessageSynchNetworkGameDataFileGet::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtSynchNetworkGameDataFileGet\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	assert(messageType == nmtSynchNetworkGameDataFileGet);
-	toEndian();
+
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageSynchNetworkGameDataFileGet::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessageSynchNetworkGameDataFileGet::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -3018,62 +2381,31 @@ SwitchSetupRequest::SwitchSetupRequest(string selectedFactionName, int8 currentF
     data.language = language;
 }
 
-const char * SwitchSetupRequest::getPackedMessageFormat() const {
-	return "c256sccc80scc60s";
+template<class Wire> void SwitchSetupRequest::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.selectedFactionName);
+	wire.field(data.currentSlotIndex);
+	wire.field(data.toSlotIndex);
+	wire.field(data.toTeam);
+	wire.field(data.networkPlayerName);
+	wire.field(data.networkPlayerStatus);
+	wire.field(data.switchFlags);
+	wire.field(data.language);
 }
 
 unsigned int SwitchSetupRequest::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		packedData.currentSlotIndex = 0;
-		messageType = nmtSwitchSetupRequest;
-		packedData.networkPlayerStatus = 0;
-		packedData.switchFlags = 0;
-		packedData.toSlotIndex = 0;
-		packedData.toTeam = 0;
-
-		unsigned char *buf = new unsigned char[sizeof(Data)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.selectedFactionName.getBuffer(),
-				packedData.currentSlotIndex,
-				packedData.toSlotIndex,
-				packedData.toTeam,
-				packedData.networkPlayerName.getBuffer(),
-				packedData.networkPlayerStatus,
-				packedData.switchFlags,
-				packedData.language.getBuffer());
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void SwitchSetupRequest::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			data.selectedFactionName.getBuffer(),
-			&data.currentSlotIndex,
-			&data.toSlotIndex,
-			&data.toTeam,
-			data.networkPlayerName.getBuffer(),
-			&data.networkPlayerStatus,
-			&data.switchFlags,
-			data.language.getBuffer());
-}
-
-unsigned char * SwitchSetupRequest::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.selectedFactionName.getBuffer(),
-			data.currentSlotIndex,
-			data.toSlotIndex,
-			data.toTeam,
-			data.networkPlayerName.getBuffer(),
-			data.networkPlayerStatus,
-			data.switchFlags,
-			data.language.getBuffer());
-	return buf;
+void SwitchSetupRequest::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
+}
+
+void SwitchSetupRequest::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool SwitchSetupRequest::receive(Socket* socket) {
@@ -3084,17 +2416,11 @@ bool SwitchSetupRequest::receive(Socket* socket) {
 		if(result == true) {
 			messageType = nmtSwitchSetupRequest;
 		}
-
+		fromEndian();
 	}
 	else {
-		//fromEndian();
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\nTeam = %d faction [%s] currentFactionIndex = %d toFactionIndex = %d\n",getPackedSize(),data.messageType,buf,data.toTeam,data.selectedFactionName.getBuffer(),data.currentFactionIndex,data.toFactionIndex);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	data.selectedFactionName.nullTerminate();
 	data.networkPlayerName.nullTerminate();
@@ -3109,40 +2435,29 @@ void SwitchSetupRequest::send(Socket* socket) {
 	assert(messageType == nmtSwitchSetupRequest);
 
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line %d] data.networkPlayerName [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,data.networkPlayerName.getString().c_str());
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n%s\nTeam = %d faction [%s] currentFactionIndex = %d toFactionIndex = %d\n",getPackedSize(),data.messageType,buf,data.toTeam,data.selectedFactionName.getBuffer(),data.currentFactionIndex,data.toFactionIndex);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void SwitchSetupRequest::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.currentSlotIndex = Shared::PlatformByteOrder::toCommonEndian(data.currentSlotIndex);
-		data.toSlotIndex = Shared::PlatformByteOrder::toCommonEndian(data.toSlotIndex);
-		data.toTeam = Shared::PlatformByteOrder::toCommonEndian(data.toTeam);
-		data.networkPlayerStatus = Shared::PlatformByteOrder::toCommonEndian(data.networkPlayerStatus);
-		data.switchFlags = Shared::PlatformByteOrder::toCommonEndian(data.switchFlags);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void SwitchSetupRequest::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.currentSlotIndex = Shared::PlatformByteOrder::fromCommonEndian(data.currentSlotIndex);
-		data.toSlotIndex = Shared::PlatformByteOrder::fromCommonEndian(data.toSlotIndex);
-		data.toTeam = Shared::PlatformByteOrder::fromCommonEndian(data.toTeam);
-		data.networkPlayerStatus = Shared::PlatformByteOrder::fromCommonEndian(data.networkPlayerStatus);
-		data.switchFlags = Shared::PlatformByteOrder::fromCommonEndian(data.switchFlags);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -3154,36 +2469,24 @@ PlayerIndexMessage::PlayerIndexMessage(int16 playerIndex) {
 	data.playerIndex=playerIndex;
 }
 
-const char * PlayerIndexMessage::getPackedMessageFormat() const {
-	return "ch";
+template<class Wire> void PlayerIndexMessage::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.playerIndex);
 }
 
 unsigned int PlayerIndexMessage::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		messageType = 0;
-		packedData.playerIndex = 0;
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.playerIndex);
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void PlayerIndexMessage::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			&data.playerIndex);
+void PlayerIndexMessage::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * PlayerIndexMessage::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.playerIndex);
-	return buf;
+void PlayerIndexMessage::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool PlayerIndexMessage::receive(Socket* socket) {
@@ -3193,50 +2496,40 @@ bool PlayerIndexMessage::receive(Socket* socket) {
 		if(result == true) {
 			messageType = nmtPlayerIndexMessage;
 		}
-
+		fromEndian();
 	}
 	else {
-		//fromEndian();
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	return result;
 }
 
 void PlayerIndexMessage::send(Socket* socket) {
 	assert(messageType == nmtPlayerIndexMessage);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		//NetworkMessage::send(socket, &data, sizeof(data));
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void PlayerIndexMessage::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.playerIndex = Shared::PlatformByteOrder::toCommonEndian(data.playerIndex);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void PlayerIndexMessage::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.playerIndex = Shared::PlatformByteOrder::fromCommonEndian(data.playerIndex);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -3249,36 +2542,24 @@ NetworkMessageLoadingStatus::NetworkMessageLoadingStatus(uint32 status)
 	data.status=status;
 }
 
-const char * NetworkMessageLoadingStatus::getPackedMessageFormat() const {
-	return "cL";
+template<class Wire> void NetworkMessageLoadingStatus::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.status);
 }
 
 unsigned int NetworkMessageLoadingStatus::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		messageType = 0;
-		packedData.status = 0;
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.status);
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageLoadingStatus::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			&data.status);
+void NetworkMessageLoadingStatus::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessageLoadingStatus::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.status);
-	return buf;
+void NetworkMessageLoadingStatus::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageLoadingStatus::receive(Socket* socket) {
@@ -3287,49 +2568,40 @@ bool NetworkMessageLoadingStatus::receive(Socket* socket) {
 		result = NetworkMessage::receive(socket, &data, sizeof(data), true);
 		if(result == true) {
 			messageType = nmtLoadingStatusMessage;
-		}
+		}		fromEndian();
 	}
 	else {
-		//fromEndian();
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	return result;
 }
 
 void NetworkMessageLoadingStatus::send(Socket* socket) {
 	assert(messageType == nmtLoadingStatusMessage);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageLoadingStatus::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.status = Shared::PlatformByteOrder::toCommonEndian(data.status);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessageLoadingStatus::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.status = Shared::PlatformByteOrder::fromCommonEndian(data.status);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -3359,54 +2631,28 @@ NetworkMessageMarkCell * NetworkMessageMarkCell::getCopy() const {
 	return copy;
 }
 
-const char * NetworkMessageMarkCell::getPackedMessageFormat() const {
-	return "chhcc500s";
+template<class Wire> void NetworkMessageMarkCell::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.targetX);
+	wire.field(data.targetY);
+	wire.field(data.factionIndex);
+	wire.field(data.playerIndex);
+	wire.field(data.text);
 }
 
 unsigned int NetworkMessageMarkCell::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		packedData.factionIndex = 0;
-		messageType = nmtMarkCell;
-		packedData.playerIndex = 0;
-		packedData.targetX = 0;
-		packedData.targetY = 0;
-
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.targetX,
-				packedData.targetY,
-				packedData.factionIndex,
-				packedData.playerIndex,
-				packedData.text.getBuffer());
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageMarkCell::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			&data.targetX,
-			&data.targetY,
-			&data.factionIndex,
-			&data.playerIndex,
-			data.text.getBuffer());
-
+void NetworkMessageMarkCell::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessageMarkCell::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.targetX,
-			data.targetY,
-			data.factionIndex,
-			data.playerIndex,
-			data.text.getBuffer());
-
-	return buf;
+void NetworkMessageMarkCell::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageMarkCell::receive(Socket* socket){
@@ -3416,15 +2662,11 @@ bool NetworkMessageMarkCell::receive(Socket* socket){
 		if(result == true) {
 			messageType = nmtMarkCell;
 		}
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	data.text.nullTerminate();
 	return result;
@@ -3434,38 +2676,29 @@ void NetworkMessageMarkCell::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtMarkCell\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	assert(messageType == nmtMarkCell);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageMarkCell::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.targetX = Shared::PlatformByteOrder::toCommonEndian(data.targetX);
-		data.targetY = Shared::PlatformByteOrder::toCommonEndian(data.targetY);
-		data.factionIndex = Shared::PlatformByteOrder::toCommonEndian(data.factionIndex);
-		data.playerIndex = Shared::PlatformByteOrder::toCommonEndian(data.playerIndex);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessageMarkCell::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.targetX = Shared::PlatformByteOrder::fromCommonEndian(data.targetX);
-		data.targetY = Shared::PlatformByteOrder::fromCommonEndian(data.targetY);
-		data.factionIndex = Shared::PlatformByteOrder::fromCommonEndian(data.factionIndex);
-		data.playerIndex = Shared::PlatformByteOrder::fromCommonEndian(data.playerIndex);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -3493,46 +2726,26 @@ NetworkMessageUnMarkCell * NetworkMessageUnMarkCell::getCopy() const {
 	return copy;
 }
 
-const char * NetworkMessageUnMarkCell::getPackedMessageFormat() const {
-	return "chhc";
+template<class Wire> void NetworkMessageUnMarkCell::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.targetX);
+	wire.field(data.targetY);
+	wire.field(data.factionIndex);
 }
 
 unsigned int NetworkMessageUnMarkCell::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		packedData.factionIndex = 0;
-		messageType = 0;
-		packedData.targetX = 0;
-		packedData.targetY = 0;
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.targetX,
-				packedData.targetY,
-				packedData.factionIndex);
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageUnMarkCell::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			&data.targetX,
-			&data.targetY,
-			&data.factionIndex);
-
+void NetworkMessageUnMarkCell::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessageUnMarkCell::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.targetX,
-			data.targetY,
-			data.factionIndex);
-
-	return buf;
+void NetworkMessageUnMarkCell::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageUnMarkCell::receive(Socket* socket){
@@ -3542,15 +2755,11 @@ bool NetworkMessageUnMarkCell::receive(Socket* socket){
 		if(result == true) {
 			messageType = nmtUnMarkCell;
 		}
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 
 	return result;
 }
@@ -3559,36 +2768,29 @@ void NetworkMessageUnMarkCell::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtUnMarkCell\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	assert(messageType == nmtUnMarkCell);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageUnMarkCell::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.targetX = Shared::PlatformByteOrder::toCommonEndian(data.targetX);
-		data.targetY = Shared::PlatformByteOrder::toCommonEndian(data.targetY);
-		data.factionIndex = Shared::PlatformByteOrder::toCommonEndian(data.factionIndex);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessageUnMarkCell::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.targetX = Shared::PlatformByteOrder::fromCommonEndian(data.targetX);
-		data.targetY = Shared::PlatformByteOrder::fromCommonEndian(data.targetY);
-		data.factionIndex = Shared::PlatformByteOrder::fromCommonEndian(data.factionIndex);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
@@ -3610,46 +2812,26 @@ NetworkMessageHighlightCell::NetworkMessageHighlightCell(Vec2i target, int facti
 	data.factionIndex 	= factionIndex;
 }
 
-const char * NetworkMessageHighlightCell::getPackedMessageFormat() const {
-	return "chhc";
+template<class Wire> void NetworkMessageHighlightCell::wireFields(Wire &wire) {
+	wire.field(messageType);
+	wire.field(data.targetX);
+	wire.field(data.targetY);
+	wire.field(data.factionIndex);
 }
 
 unsigned int NetworkMessageHighlightCell::getPackedSize() {
-	static unsigned int result = 0;
-	if(result == 0) {
-		Data packedData;
-		packedData.factionIndex = 0;
-		messageType = 0;
-		packedData.targetX = 0;
-		packedData.targetY = 0;
-		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
-		result = pack(buf, getPackedMessageFormat(),
-				messageType,
-				packedData.targetX,
-				packedData.targetY,
-				packedData.factionIndex);
-		delete [] buf;
-	}
-	return result;
+	NetworkWireSize wire;
+	wireFields(wire);
+	return wire.getSize();
 }
-void NetworkMessageHighlightCell::unpackMessage(unsigned char *buf) {
-	unpack(buf, getPackedMessageFormat(),
-			&messageType,
-			&data.targetX,
-			&data.targetY,
-			&data.factionIndex);
-
+void NetworkMessageHighlightCell::unpackMessage(const unsigned char *buf, unsigned int size) {
+	NetworkWireReader wire(buf, size);
+	wireFields(wire);
 }
 
-unsigned char * NetworkMessageHighlightCell::packMessage() {
-	unsigned char *buf = new unsigned char[getPackedSize()+1];
-	pack(buf, getPackedMessageFormat(),
-			messageType,
-			data.targetX,
-			data.targetY,
-			data.factionIndex);
-
-	return buf;
+void NetworkMessageHighlightCell::packMessage(unsigned char *buf) {
+	NetworkWireWriter wire(buf);
+	wireFields(wire);
 }
 
 bool NetworkMessageHighlightCell::receive(Socket* socket) {
@@ -3659,15 +2841,11 @@ bool NetworkMessageHighlightCell::receive(Socket* socket) {
 		if(result == true) {
 			messageType = nmtHighlightCell;
 		}
+		fromEndian();
 	}
 	else {
-		unsigned char *buf = new unsigned char[getPackedSize()+1];
-		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
-		unpackMessage(buf);
-		//printf("Got packet size = %u data.messageType = %d\n%s\n",getPackedSize(),data.messageType,buf);
-		delete [] buf;
+		result = receivePacked(socket);
 	}
-	fromEndian();
 	return result;
 }
 
@@ -3675,36 +2853,29 @@ void NetworkMessageHighlightCell::send(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtMarkCell\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	assert(messageType == nmtHighlightCell);
-	toEndian();
 
 	if(useOldProtocol == true) {
+		toEndian();
 		//NetworkMessage::send(socket, &messageType, sizeof(messageType));
 		NetworkMessage::send(socket, &data, sizeof(data), messageType);
 	}
 	else {
-		unsigned char *buf = packMessage();
-		//printf("Send packet size = %u data.messageType = %d\n[%s]\n",getPackedSize(),data.messageType,buf);
-		NetworkMessage::send(socket, buf, getPackedSize());
-		delete [] buf;
+		sendPacked(socket);
 	}
 }
 
 void NetworkMessageHighlightCell::toEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
-		data.targetX = Shared::PlatformByteOrder::toCommonEndian(data.targetX);
-		data.targetY = Shared::PlatformByteOrder::toCommonEndian(data.targetY);
-		data.factionIndex = Shared::PlatformByteOrder::toCommonEndian(data.factionIndex);
+		NetworkWireToEndian wire;
+		wireFields(wire);
 	}
 }
 void NetworkMessageHighlightCell::fromEndian() {
 	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
 	if(bigEndianSystem == true) {
-		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
-		data.targetX = Shared::PlatformByteOrder::fromCommonEndian(data.targetX);
-		data.targetY = Shared::PlatformByteOrder::fromCommonEndian(data.targetY);
-		data.factionIndex = Shared::PlatformByteOrder::fromCommonEndian(data.factionIndex);
+		NetworkWireFromEndian wire;
+		wireFields(wire);
 	}
 }
 
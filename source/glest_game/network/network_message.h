@@ -26,6 +26,7 @@
 #include "socket.h"
 #include "game_constants.h"
 #include "network_types.h"
+#include "network_wire.h"
 #include "byte_order.h"
 #include <map>
 #include "common_scoped_ptr.h"
@@ -42,7 +43,9 @@ class GameSettings;
 
 enum NetworkMessageType {
 	nmtInvalid,
-	nmtIntro,
+	// intro of builds from before network features, its shorter
+	// structure is not read, the peer is told to upgrade instead
+	nmtIntroWithoutFeatures,
 	nmtPing,
 	nmtReady,
 	nmtLaunch,
@@ -60,6 +63,8 @@ enum NetworkMessageType {
 	nmtMarkCell,
 	nmtUnMarkCell,
 	nmtHighlightCell,
+	nmtCommandListCompact,
+	nmtIntro,
 //	nmtCompressedPacket,
 
 	nmtCount
@@ -73,6 +78,13 @@ enum NetworkGameStateType {
 	nmgstCount
 };
 
+// Optional protocol features, exchanged in the intro message
+enum NetworkFeatureType {
+	nftCompactCommandList	= 0x01,
+	// answers ping echo requests and follows nctSetNetworkFramePeriod
+	nftAdaptiveFramePeriod	= 0x02
+};
+
 static const int maxLanguageStringSize= 60;
 static const int maxNetworkMessageSize= 20000;
 
@@ -102,6 +114,10 @@ enum NetworkMessageStatisticType {
 
 	netmsgstAverageRecvSize,
 
+	// ---------------------------------------------
+	netmsgstCommandListRawBytes,
+	netmsgstCommandListSentBytes,
+
 	netmsgstLastEvent
 
 };
@@ -118,6 +134,9 @@ private:
 public:
 	static void resetNetworkPacketStats();
 	static string getNetworkPacketStats();
+	static void addCommandListStats(int64 rawBytes, int64 sentBytes);
+
+	static uint32 getLocalNetworkFeatures();
 
 	static bool useOldProtocol;
 	virtual ~NetworkMessage(){}
@@ -139,10 +158,15 @@ protected:
 	void send(Socket* socket, const void* data, int dataSize, int8 messageType);
 	void send(Socket* socket, const void* data, int dataSize, int8 messageType, uint32 compressedLength);
 
-	virtual const char * getPackedMessageFormat() const = 0;
+	// largest packed message encoded on the stack, bigger ones use a heap buffer
+	static const unsigned int maxPackedStackSize = maxNetworkMessageSize;
+
+	bool receivePacked(Socket* socket);
+	void sendPacked(Socket* socket);
+
 	virtual unsigned int getPackedSize() = 0;
-	virtual void unpackMessage(unsigned char *buf) = 0;
-	virtual unsigned char * packMessage() = 0;
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size) = 0;
+	virtual void packMessage(unsigned char *buf) = 0;
 };
 
 // =====================================================
@@ -173,6 +197,7 @@ private:
 		int8 gameInProgress;
 		NetworkString<maxSmallStringSize> playerUUID;
 		NetworkString<maxSmallStringSize> platform;
+		uint32 networkFeatures;
 	};
 
 	void toEndian();
@@ -188,13 +213,14 @@ public:
 	NetworkMessageIntro(int32 sessionId, const string &versionString,
 			const string &name, int playerIndex, NetworkGameStateType gameState,
 			uint32 externalIp, uint32 ftpPort, const string &playerLanguage,
-			int gameInProgress, const string &playerUUID, const string &platform);
+			int gameInProgress, const string &playerUUID, const string &platform,
+			uint32 networkFeatures);
 
 
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 	virtual size_t getDataSize() const { return sizeof(Data); }
 
@@ -214,6 +240,7 @@ public:
 
 	string getPlayerUUID() const				{ return data.playerUUID.getString();}
 	string getPlayerPlatform() const			{ return data.platform.getString();}
+	uint32 getNetworkFeatures() const			{ return data.networkFeatures; }
 
 	virtual bool receive(Socket* socket);
 	virtual void send(Socket* socket);
@@ -244,10 +271,10 @@ private:
 	int64 pingReceivedLocalTime;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	NetworkMessagePing();
@@ -259,6 +286,11 @@ public:
 		return nmtPing;
 	}
 
+	// pingFrequency values of the round trip probes sent during a game,
+	// a reply carries the pingTime of the request back unchanged
+	static const int32 pingEchoRequest	= -1;
+	static const int32 pingEchoReply	= -2;
+
 	int32 getPingFrequency() const	{return data.pingFrequency;}
 	int64 getPingTime() const	{return data.pingTime;}
 	int64 getPingReceivedLocalTime() const { return pingReceivedLocalTime; }
@@ -289,10 +321,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	NetworkMessageReady();
@@ -329,6 +361,8 @@ private:
 
 	int8 messageType;
 	uint32 compressedLength;
+
+public:
 	struct Data {
 		NetworkString<maxStringSize> description;
 		NetworkString<maxSmallStringSize> map;
@@ -379,17 +413,23 @@ private:
 		int8 networkAllowNativeLanguageTechtree;
 		NetworkString<maxSmallStringSize> gameUUID;
 	};
+
+	// The packed field order, kept in the header so the unit tests
+	// can check it against the old pack() layout
+	template<class Wire> static void wireData(Wire &wire, int8 &messageType, Data &data);
+
+private:
 	void toEndian();
 	void fromEndian();
 	std::pair<unsigned char *,unsigned long> getCompressedMessage();
-private:
+
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	NetworkMessageLaunch();
@@ -417,6 +457,50 @@ public:
 };
 #pragma pack(pop)
 
+template<class Wire> void NetworkMessageLaunch::wireData(Wire &wire, int8 &messageType, Data &data) {
+	wire.field(messageType);
+	wire.field(data.description);
+	wire.field(data.map);
+	wire.field(data.tileset);
+	wire.field(data.tech);
+	wireFieldArray(wire, data.factionTypeNames);
+	wireFieldArray(wire, data.networkPlayerNames);
+	wireFieldArray(wire, data.networkPlayerPlatform);
+	wireFieldArray(wire, data.networkPlayerStatuses);
+	wireFieldArray(wire, data.networkPlayerLanguages);
+	wire.field(data.mapCRC);
+	wire.field(data.mapFilter);
+	wire.field(data.tilesetCRC);
+	wire.field(data.techCRC);
+	wireFieldArray(wire, data.factionNameList);
+	wireFieldArray(wire, data.factionCRCList);
+	wireFieldArray(wire, data.factionControls);
+	wireFieldArray(wire, data.resourceMultiplierIndex);
+	wire.field(data.thisFactionIndex);
+	wire.field(data.factionCount);
+	wireFieldArray(wire, data.teams);
+	wireFieldArray(wire, data.startLocationIndex);
+	wire.field(data.defaultResources);
+	wire.field(data.defaultUnits);
+	wire.field(data.defaultVictoryConditions);
+	wire.field(data.fogOfWar);
+	wire.field(data.allowObservers);
+	wire.field(data.enableObserverModeAtEndGame);
+	wire.field(data.enableServerControlledAI);
+	wire.field(data.networkFramePeriod);
+	wire.field(data.networkPauseGameForLaggedClients);
+	wire.field(data.pathFinderType);
+	wire.field(data.flagTypes1);
+	wire.field(data.aiAcceptSwitchTeamPercentChance);
+	wire.field(data.cpuReplacementMultiplier);
+	wire.field(data.masterserver_admin);
+	wire.field(data.masterserver_admin_factionIndex);
+	wire.field(data.scenario);
+	wireFieldArray(wire, data.networkPlayerUUID);
+	wire.field(data.networkAllowNativeLanguageTechtree);
+	wire.field(data.gameUUID);
+}
+
 // =====================================================
 //	class CommandList
 //
@@ -457,22 +541,24 @@ private:
 
 private:
 	Data data;
+	bool compact;
+
+	bool receiveCompact(Socket* socket);
+	void sendCompact(Socket* socket);
 
 protected:
-	virtual const char * getPackedMessageFormat() const { return NULL; }
 	virtual unsigned int getPackedSize() { return 0; }
-	virtual void unpackMessage(unsigned char *buf) { };
-	virtual unsigned char * packMessage() { return NULL; }
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size) { };
+	virtual void packMessage(unsigned char *buf) { }
 
-	const char * getPackedMessageFormatHeader() const;
+	template<class Wire> void wireFieldsHeader(Wire &wire);
 	unsigned int getPackedSizeHeader();
-	void unpackMessageHeader(unsigned char *buf);
-	unsigned char * packMessageHeader();
+	unsigned int getPackedSizeCommand();
 
-	const char * getPackedMessageFormatDetail() const;
-	unsigned int getPackedSizeDetail(int count);
-	void unpackMessageDetail(unsigned char *buf,int count);
-	unsigned char * packMessageDetail(uint16 totalCommand);
+	bool receivePackedHeader(Socket* socket);
+	void sendPackedHeader(Socket* socket);
+	bool receivePackedDetail(Socket* socket, uint16 totalCommand);
+	void sendPackedDetail(Socket* socket, uint16 totalCommand);
 
 public:
 	explicit NetworkMessageCommandList(int32 frameCount= -1);
@@ -494,7 +580,16 @@ public:
 
 	const NetworkCommand* getCommand(int i) const	{return &data.commands[i];}
 
+	// send as nmtCommandListCompact, only when the peer announced nftCompactCommandList
+	void setCompact(bool value)						{ compact = value; }
+	bool getCompact() const							{ return compact; }
+
+	// the compact body on its own, also used for the spectator feed
+	void encodeCompact(std::vector<unsigned char> &buf) const;
+	bool decodeCompact(const unsigned char *buf, unsigned int size);
+
 	virtual bool receive(Socket* socket);
+	virtual bool receive(Socket* socket, NetworkMessageType type);
 	virtual void send(Socket* socket);
 };
 #pragma pack(pop)
@@ -526,10 +621,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	NetworkMessageText();
@@ -574,10 +669,10 @@ private:
 	//Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	NetworkMessageQuit();
@@ -638,6 +733,7 @@ private:
 		DataHeader header;
 		DataDetail detail;
 	};
+	template<class Wire> void wireFieldsHeader(Wire &wire);
 	void toEndianHeader();
 	void fromEndianHeader();
 	void toEndianDetail(uint32 totalFileCount);
@@ -647,19 +743,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const { return NULL; }
 	virtual unsigned int getPackedSize() { return 0; }
-	virtual void unpackMessage(unsigned char *buf) { };
-	virtual unsigned char * packMessage() { return NULL; }
-
-	const char * getPackedMessageFormatHeader() const;
-	unsigned int getPackedSizeHeader();
-	void unpackMessageHeader(unsigned char *buf);
-	unsigned char * packMessageHeader();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size) { };
+	virtual void packMessage(unsigned char *buf) { }
 
-	unsigned int getPackedSizeDetail();
-	void unpackMessageDetail(unsigned char *buf);
-	unsigned char * packMessageDetail();
 
 public:
     NetworkMessageSynchNetworkGameData() {};
@@ -729,6 +816,7 @@ private:
 		DataHeader header;
 		DataDetail detail;
 	};
+	template<class Wire> void wireFieldsHeader(Wire &wire);
 	void toEndianHeader();
 	void fromEndianHeader();
 	void toEndianDetail(uint32 totalFileCount);
@@ -738,10 +826,9 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const { return NULL; }
 	virtual unsigned int getPackedSize() { return 0; }
-	virtual void unpackMessage(unsigned char *buf) { };
-	virtual unsigned char * packMessage() { return NULL; }
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size) { };
+	virtual void packMessage(unsigned char *buf) { }
 
 public:
     NetworkMessageSynchNetworkGameDataStatus() {};
@@ -799,10 +886,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
     NetworkMessageSynchNetworkGameDataFileCRCCheck();
@@ -851,10 +938,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
     NetworkMessageSynchNetworkGameDataFileGet();
@@ -918,10 +1005,10 @@ private:
 	Data data;
 
 public:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	SwitchSetupRequest();
@@ -977,10 +1064,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	explicit PlayerIndexMessage( int16 playerIndex);
@@ -1046,10 +1133,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	NetworkMessageLoadingStatus();
@@ -1099,10 +1186,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	NetworkMessageMarkCell();
@@ -1151,10 +1238,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	NetworkMessageUnMarkCell();
@@ -1203,10 +1290,10 @@ private:
 	Data data;
 
 protected:
-	virtual const char * getPackedMessageFormat() const;
+	template<class Wire> void wireFields(Wire &wire);
 	virtual unsigned int getPackedSize();
-	virtual void unpackMessage(unsigned char *buf);
-	virtual unsigned char * packMessage();
+	virtual void unpackMessage(const unsigned char *buf, unsigned int size);
+	virtual void packMessage(unsigned char *buf);
 
 public:
 	NetworkMessageHighlightCell();
@@ -78,7 +78,8 @@ enum NetworkCommandType {
 	nctSwitchTeamVote,
 	nctPauseResume,
 	nctPlayerStatusChange,
-	nctDisconnectNetworkPlayer
+	nctDisconnectNetworkPlayer,
+	nctSetNetworkFramePeriod
 	//nctNetworkCommand
 };
 
@@ -155,6 +156,24 @@ public:
     void preprocessNetworkCommand(World *world);
 	string toString() const;
 
+	// wire schema, see network_wire.h
+	template<class Wire> void wireFields(Wire &wire) {
+		wire.field(networkCommandType);
+		wire.field(unitId);
+		wire.field(unitTypeId);
+		wire.field(commandTypeId);
+		wire.field(positionX);
+		wire.field(positionY);
+		wire.field(targetId);
+		wire.field(wantQueue);
+		wire.field(fromFactionIndex);
+		wire.field(unitFactionUnitCount);
+		wire.field(unitFactionIndex);
+		wire.field(commandStateType);
+		wire.field(commandStateValue);
+		wire.field(unitCommandGroupId);
+	}
+
 	void toEndian();
 	void fromEndian();
 
@@ -0,0 +1,314 @@
+//
+//	network_wire.h:
+//
+//	This file is part of ZetaGlest <https://github.com/ZetaGlest>
+//
+//	Copyright (C) 2018  The ZetaGlest team
+//
+//	ZetaGlest is a fork of MegaGlest <https://megaglest.org>
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>
+
+#ifndef _GLEST_GAME_NETWORKWIRE_H_
+#define _GLEST_GAME_NETWORKWIRE_H_
+
+#include <cstring>
+#include <vector>
+#include "data_types.h"
+#include "byte_order.h"
+#include "network_types.h"
+#include "leak_dumper.h"
+
+using Shared::Platform::int8;
+using Shared::Platform::uint8;
+using Shared::Platform::int16;
+using Shared::Platform::uint16;
+using Shared::Platform::int32;
+using Shared::Platform::uint32;
+using Shared::Platform::int64;
+using Shared::Platform::uint64;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+//	Network wire schema
+//
+//	Every message lists its fields once in a member
+//	template:
+//
+//		template<class Wire> void wireFields(Wire &wire) {
+//			wire.field(messageType);
+//			wire.field(data.text);
+//			...
+//		}
+//
+//	and runs it with one of the visitors below to get the
+//	packed size, to pack into or unpack from a caller
+//	provided buffer, or to convert the raw structure to and
+//	from the common byte order. The field type picks the
+//	encoding, which matches what pack() / unpack() produce:
+//	integers in network byte order and NetworkString<S> as
+//	a 16 bit length followed by S-1 bytes of the buffer.
+// =====================================================
+
+template<class Wire, typename T, int N>
+inline void wireFieldArray(Wire &wire, T (&values)[N]) {
+	for(int index = 0; index < N; ++index) {
+		wire.field(values[index]);
+	}
+}
+
+// =====================================================
+//	class NetworkWireSize
+// =====================================================
+
+class NetworkWireSize {
+private:
+	unsigned int size;
+
+public:
+	NetworkWireSize() : size(0) {}
+
+	void field(const int8 &)	{ size += 1; }
+	void field(const uint8 &)	{ size += 1; }
+	void field(const int16 &)	{ size += 2; }
+	void field(const uint16 &)	{ size += 2; }
+	void field(const int32 &)	{ size += 4; }
+	void field(const uint32 &)	{ size += 4; }
+	void field(const int64 &)	{ size += 8; }
+	void field(const uint64 &)	{ size += 8; }
+	template<int S> void field(const NetworkString<S> &) { size += 2 + (S - 1); }
+
+	unsigned int getSize() const { return size; }
+};
+
+// =====================================================
+//	class NetworkWireWriter
+// =====================================================
+
+class NetworkWireWriter {
+private:
+	unsigned char *buf;
+	unsigned char *bufStart;
+
+	void put16(uint16 value) {
+		buf[0] = static_cast<unsigned char>(value >> 8);
+		buf[1] = static_cast<unsigned char>(value);
+		buf += 2;
+	}
+	void put32(uint32 value) {
+		buf[0] = static_cast<unsigned char>(value >> 24);
+		buf[1] = static_cast<unsigned char>(value >> 16);
+		buf[2] = static_cast<unsigned char>(value >> 8);
+		buf[3] = static_cast<unsigned char>(value);
+		buf += 4;
+	}
+	void put64(uint64 value) {
+		put32(static_cast<uint32>(value >> 32));
+		put32(static_cast<uint32>(value));
+	}
+
+public:
+	explicit NetworkWireWriter(unsigned char *buf) : buf(buf), bufStart(buf) {}
+
+	void field(const int8 &value)	{ *buf++ = static_cast<unsigned char>(value); }
+	void field(const uint8 &value)	{ *buf++ = value; }
+	void field(const int16 &value)	{ put16(static_cast<uint16>(value)); }
+	void field(const uint16 &value)	{ put16(value); }
+	void field(const int32 &value)	{ put32(static_cast<uint32>(value)); }
+	void field(const uint32 &value)	{ put32(value); }
+	void field(const int64 &value)	{ put64(static_cast<uint64>(value)); }
+	void field(const uint64 &value)	{ put64(value); }
+	template<int S> void field(NetworkString<S> &value) {
+		// pack() always sends the full buffer minus the last byte
+		put16(S - 1);
+		memcpy(buf, value.getBuffer(), S - 1);
+		buf += S - 1;
+	}
+
+	unsigned int getSize() const { return static_cast<unsigned int>(buf - bufStart); }
+};
+
+// =====================================================
+//	class NetworkWireReader
+// =====================================================
+
+class NetworkWireReader {
+private:
+	const unsigned char *buf;
+	const unsigned char *bufEnd;
+	bool overrun;
+
+	bool available(unsigned int count) {
+		if(overrun == true || static_cast<unsigned int>(bufEnd - buf) < count) {
+			overrun = true;
+			return false;
+		}
+		return true;
+	}
+	uint16 get16() {
+		uint16 value = static_cast<uint16>((buf[0] << 8) | buf[1]);
+		buf += 2;
+		return value;
+	}
+	uint32 get32() {
+		uint32 value = (static_cast<uint32>(buf[0]) << 24) |
+		               (static_cast<uint32>(buf[1]) << 16) |
+		               (static_cast<uint32>(buf[2]) << 8)  |
+		                static_cast<uint32>(buf[3]);
+		buf += 4;
+		return value;
+	}
+	uint64 get64() {
+		uint64 high = get32();
+		return (high << 32) | get32();
+	}
+
+public:
+	NetworkWireReader(const unsigned char *buf, unsigned int size) :
+		buf(buf), bufEnd(buf + size), overrun(false) {}
+
+	void field(int8 &value)		{ if(available(1)) value = static_cast<int8>(*buf++); }
+	void field(uint8 &value)	{ if(available(1)) value = *buf++; }
+	void field(int16 &value)	{ if(available(2)) value = static_cast<int16>(get16()); }
+	void field(uint16 &value)	{ if(available(2)) value = get16(); }
+	void field(int32 &value)	{ if(available(4)) value = static_cast<int32>(get32()); }
+	void field(uint32 &value)	{ if(available(4)) value = get32(); }
+	void field(int64 &value)	{ if(available(8)) value = static_cast<int64>(get64()); }
+	void field(uint64 &value)	{ if(available(8)) value = get64(); }
+	template<int S> void field(NetworkString<S> &value) {
+		if(available(2) == false) {
+			return;
+		}
+		uint16 len = get16();
+		if(available(len) == false) {
+			return;
+		}
+		uint16 count = (len >= S ? S - 1 : len);
+		memcpy(value.getBuffer(), buf, count);
+		value.getBuffer()[count] = '\0';
+		buf += len;
+	}
+
+	// true when the buffer was shorter than the fields read from it
+	bool hasOverrun() const { return overrun; }
+};
+
+// =====================================================
+//	class NetworkWireToEndian / NetworkWireFromEndian
+//
+//	Convert the fields of the raw structures sent by the
+//	old protocol to and from the common byte order
+// =====================================================
+
+class NetworkWireToEndian {
+public:
+	template<typename T> void field(T &value) {
+		value = ::Shared::PlatformByteOrder::toCommonEndian(value);
+	}
+	template<int S> void field(NetworkString<S> &) {}
+};
+
+class NetworkWireFromEndian {
+public:
+	template<typename T> void field(T &value) {
+		value = ::Shared::PlatformByteOrder::fromCommonEndian(value);
+	}
+	template<int S> void field(NetworkString<S> &) {}
+};
+
+// =====================================================
+//	class NetworkVarintWriter / NetworkVarintReader
+//
+//	Variable length integers for the compact messages:
+//	7 bits per byte, low bits first, signed values are
+//	zigzag encoded so small negatives stay small
+// =====================================================
+
+class NetworkVarintWriter {
+private:
+	std::vector<unsigned char> &buf;
+
+public:
+	explicit NetworkVarintWriter(std::vector<unsigned char> &buf) : buf(buf) {}
+
+	void putUnsigned(uint32 value) {
+		while(value >= 0x80) {
+			buf.push_back(static_cast<unsigned char>(value | 0x80));
+			value >>= 7;
+		}
+		buf.push_back(static_cast<unsigned char>(value));
+	}
+	void putSigned(int32 value) {
+		uint32 sign = (value < 0 ? 0xFFFFFFFFu : 0);
+		putUnsigned((static_cast<uint32>(value) << 1) ^ sign);
+	}
+	void putFixed32(uint32 value) {
+		buf.push_back(static_cast<unsigned char>(value));
+		buf.push_back(static_cast<unsigned char>(value >> 8));
+		buf.push_back(static_cast<unsigned char>(value >> 16));
+		buf.push_back(static_cast<unsigned char>(value >> 24));
+	}
+};
+
+class NetworkVarintReader {
+private:
+	const unsigned char *buf;
+	const unsigned char *bufEnd;
+	bool overrun;
+
+public:
+	NetworkVarintReader(const unsigned char *buf, unsigned int size) :
+		buf(buf), bufEnd(buf + size), overrun(false) {}
+
+	uint32 getUnsigned() {
+		uint32 value = 0;
+		for(int shift = 0; shift < 35; shift += 7) {
+			if(buf >= bufEnd) {
+				break;
+			}
+			unsigned char byte = *buf++;
+			value |= static_cast<uint32>(byte & 0x7F) << shift;
+			if((byte & 0x80) == 0) {
+				return value;
+			}
+		}
+		overrun = true;
+		return 0;
+	}
+	int32 getSigned() {
+		uint32 value = getUnsigned();
+		return static_cast<int32>((value >> 1) ^ (0u - (value & 1)));
+	}
+	uint32 getFixed32() {
+		if(bufEnd - buf < 4) {
+			overrun = true;
+			buf = bufEnd;
+			return 0;
+		}
+		uint32 value = static_cast<uint32>(buf[0]) |
+		              (static_cast<uint32>(buf[1]) << 8) |
+		              (static_cast<uint32>(buf[2]) << 16) |
+		              (static_cast<uint32>(buf[3]) << 24);
+		buf += 4;
+		return value;
+	}
+
+	bool hasOverrun() const { return overrun; }
+	bool atEnd() const		{ return buf == bufEnd; }
+};
+
+}}//end namespace
+
+#endif
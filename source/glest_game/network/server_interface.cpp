@@ -34,6 +34,8 @@
 #include "util.h"
 #include "game_util.h"
 #include "miniftpserver.h"
+#include "content_transfer.h"
+#include "spectator_feed.h"
 #include "map_preview.h"
 #include "stats.h"
 #include <time.h>
@@ -71,6 +73,7 @@ ServerInterface::ServerInterface(bool publishEnabled, ClientLagCallbackInterface
 
 	this->clientLagCallbackInterface	= clientLagCallbackInterface;
 	this->clientsAutoPausedDueToLag     = false;
+	this->adaptiveFramePeriodHoldFrame	= 0;
 
 	allowInGameConnections 				= false;
 	gameLaunched 						= false;
@@ -98,6 +101,8 @@ ServerInterface::ServerInterface(bool publishEnabled, ClientLagCallbackInterface
 	lastMasterserverHeartbeatTime 	= 0;
 	needToRepublishToMasterserver 	= false;
 	ftpServer 						= NULL;
+	contentTransferServer			= NULL;
+	spectatorFeed					= NULL;
 	inBroadcastMessage				= false;
 	lastGlobalLagCheckTime			= 0;
 	masterserverAdminRequestLaunch	= false;
@@ -248,6 +253,13 @@ ServerInterface::ServerInterface(bool publishEnabled, ClientLagCallbackInterface
 				allowInternetTechtreeFileTransfers,portNumber,GameConstants::maxPlayers,
 				this,tempFilePath);
 		ftpServer->start();
+
+		if(Config::getInstance().getBool("EnableContentTransfer","true") == true) {
+			int contentTransferPort = ContentTransferServerThread::getDefaultPort(portNumber,GameConstants::maxPlayers);
+			contentTransferServer = new ContentTransferServerThread(mapsPath,tilesetsPath,techtreesPath,
+					contentTransferPort,this);
+			contentTransferServer->start();
+		}
 	}
 
 	if(publishToMasterserverThread == NULL) {
@@ -309,6 +321,7 @@ ServerInterface::~ServerInterface() {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 	close();
 	shutdownFTPServer();
+	shutdownSpectatorFeed();
 	shutdownMasterserverPublishThread();
 
 	lastMasterserverHeartbeatTime = 0;
@@ -1490,6 +1503,102 @@ void ServerInterface::checkForAutoResumeForLaggingClients() {
 	}
 }
 
+void ServerInterface::sendPingEchoRequests() {
+	if(gameHasBeenInitiated == false ||
+		Config::getInstance().getBool("NetworkAdaptiveFramePeriod","true") == false) {
+		return;
+	}
+
+	int pingEchoMillis = Config::getInstance().getInt("NetworkAdaptiveFramePeriodPingMillis","500");
+	if(pingEchoTimer.isStarted() == true && pingEchoTimer.getMillis() < pingEchoMillis) {
+		return;
+	}
+	pingEchoTimer.stop();
+	pingEchoTimer.reset();
+	pingEchoTimer.start();
+
+	for(int index = 0; exitServer == false && index < GameConstants::maxPlayers; ++index) {
+		MutexSafeWrapper safeMutexSlot(slotAccessorMutexes[index],CODE_AT_LINE_X(index));
+		ConnectionSlot *connectionSlot = slots[index];
+		if(connectionSlot != NULL && connectionSlot->isConnected() == true &&
+			(connectionSlot->getPeerNetworkFeatures() & nftAdaptiveFramePeriod) != 0) {
+			connectionSlot->sendPingEchoRequest();
+		}
+	}
+}
+
+// Picks the network frame period from the measured ping round trips of
+// the slowest client. The period only moves one step at a time, doubling
+// or halving, so the old and new period always share the switch frame.
+// The change is sent as a command and takes effect on every peer at the
+// same frame, see nctSetNetworkFramePeriod in Commander.
+void ServerInterface::updateAdaptiveNetworkFramePeriod(int frameCount) {
+	const int minPingRoundTripSamples = 5;
+
+	Config &config = Config::getInstance();
+	if(gameHasBeenInitiated == false || frameCount < adaptiveFramePeriodHoldFrame ||
+		config.getBool("NetworkAdaptiveFramePeriod","true") == false) {
+		return;
+	}
+
+	int currentPeriod	= gameSettings.getNetworkFramePeriod();
+	int minPeriod		= config.getInt("NetworkAdaptiveFramePeriodMin","5");
+	// sent as one byte in the launch message
+	int maxPeriod		= min(config.getInt("NetworkAdaptiveFramePeriodMax","80"),255);
+	int percentile		= config.getInt("NetworkAdaptiveFramePeriodPercentile","90");
+	int leadFrames		= config.getInt("NetworkAdaptiveFramePeriodLeadFrames","40");
+	if(currentPeriod <= 0) {
+		return;
+	}
+
+	int64 roundTripMillis = -1;
+	for(int index = 0; exitServer == false && index < GameConstants::maxPlayers; ++index) {
+		MutexSafeWrapper safeMutexSlot(slotAccessorMutexes[index],CODE_AT_LINE_X(index));
+		ConnectionSlot *connectionSlot = slots[index];
+		if(connectionSlot != NULL && connectionSlot->isConnected() == true) {
+			// a client that can not follow a change keeps the period fixed
+			if((connectionSlot->getPeerNetworkFeatures() & nftAdaptiveFramePeriod) == 0) {
+				return;
+			}
+			int64 slotRoundTripMillis = connectionSlot->getPingRoundTripPercentile(percentile,minPingRoundTripSamples);
+			if(slotRoundTripMillis < 0) {
+				return;
+			}
+			roundTripMillis = max(roundTripMillis,slotRoundTripMillis);
+		}
+	}
+	if(roundTripMillis < 0) {
+		return;
+	}
+
+	// Grow when a round trip no longer fits in one period, shrink only
+	// when it fits twice in the smaller period to avoid flapping
+	int roundTripFrames = (int)((roundTripMillis * GameConstants::updateFps + 999) / 1000);
+	int newPeriod = currentPeriod;
+	if(roundTripFrames > currentPeriod && currentPeriod * 2 <= maxPeriod) {
+		newPeriod = currentPeriod * 2;
+	}
+	else if(currentPeriod % 2 == 0 && currentPeriod / 2 >= minPeriod &&
+			roundTripFrames * 2 <= currentPeriod / 2) {
+		newPeriod = currentPeriod / 2;
+	}
+	if(newPeriod == currentPeriod) {
+		return;
+	}
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] frame: %d round trip: %lld msecs (%d frames) network frame period %d -> %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,frameCount,(long long int)roundTripMillis,roundTripFrames,currentPeriod,newPeriod);
+
+	NetworkCommand networkCommand;
+	networkCommand.networkCommandType	= nctSetNetworkFramePeriod;
+	networkCommand.unitId				= newPeriod;
+	networkCommand.targetId				= leadFrames;
+	networkCommand.fromFactionIndex		= gameSettings.getThisFactionIndex();
+	requestCommand(&networkCommand);
+
+	// wait for the switch and a few periods of fresh samples
+	adaptiveFramePeriodHoldFrame = frameCount + leadFrames + 2 * max(currentPeriod,newPeriod);
+}
+
 void ServerInterface::update() {
 	//printf("\nServerInterface::update -- A\n");
 
@@ -1505,6 +1614,7 @@ void ServerInterface::update() {
 		processBroadCastMessageQueue();
 
 		checkForAutoResumeForLaggingClients();
+		sendPingEchoRequests();
 
 		//printf("\nServerInterface::update -- C\n");
 
@@ -1685,6 +1795,8 @@ void ServerInterface::update() {
 
 void ServerInterface::updateKeyframe(int frameCount) {
 	currentFrameCount = frameCount;
+	updateAdaptiveNetworkFramePeriod(frameCount);
+
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] currentFrameCount = %d, requestedCommands.size() = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,currentFrameCount,requestedCommands.size());
 
 	NetworkMessageCommandList networkMessageCommandList(frameCount);
@@ -1704,6 +1816,10 @@ void ServerInterface::updateKeyframe(int frameCount) {
 		}
 	}
 
+	if(spectatorFeed != NULL) {
+		publishSpectatorFrame(networkMessageCommandList);
+	}
+
 	try {
 		// Possible cause of out of synch since we have more commands that need
 		// to be sent in this frame
@@ -1776,6 +1892,7 @@ bool ServerInterface::shouldDiscardNetworkMessage(NetworkMessageType networkMess
 				NetworkMessagePing msg = NetworkMessagePing();
 				connectionSlot->receiveMessage(&msg);
 				lastPingInfo = msg;
+				connectionSlot->processPingEcho(msg);
 				}
 				break;
 
@@ -2295,6 +2412,10 @@ void ServerInterface::quitGame(bool userManuallyQuit) {
 	NetworkMessageQuit networkMessageQuit;
 	broadcastMessage(&networkMessageQuit);
 
+	if(spectatorFeed != NULL) {
+		spectatorFeed->endFeed();
+	}
+
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s] Line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 }
 
@@ -2401,6 +2522,7 @@ bool ServerInterface::launchGame(const GameSettings *gameSettings) {
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] needToRepublishToMasterserver = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,needToRepublishToMasterserver);
 
 		this->gameSettings = *gameSettings;
+		startSpectatorFeed();
 		//printf("#1 Data synch: lmap %u ltile: %d ltech: %u\n",gameSettings->getMapCRC(),gameSettings->getTilesetCRC(),gameSettings->getTechCRC());
 
 		NetworkMessageLaunch networkMessageLaunch(gameSettings,nmtLaunch);
@@ -2457,6 +2579,100 @@ void ServerInterface::shutdownFTPServer() {
 		delete ftpServer;
 		ftpServer = NULL;
 	}
+	if(contentTransferServer != NULL) {
+		contentTransferServer->shutdownAndWait();
+		delete contentTransferServer;
+		contentTransferServer = NULL;
+	}
+}
+
+// A snapshot is a replay of the game so far: the settings and every
+// command, so joining doesn't pause the game for a save. It is built
+// on the spectator feed thread, from the frames the game publishes.
+class SpectatorSnapshotWriter : public SpectatorSnapshotBuilderInterface {
+protected:
+	XmlTree xmlTree;
+	XmlNode *gameNode;
+
+public:
+	explicit SpectatorSnapshotWriter(const GameSettings &gameSettings) : xmlTree(XML_RAPIDXML_ENGINE) {
+		std::map<string,string> mapTagReplacements;
+		xmlTree.init("megaglest-saved-game");
+		XmlNode *rootNode = xmlTree.getRootNode();
+		rootNode->addAttribute("version",glestVersionString, mapTagReplacements);
+
+		gameNode = rootNode->addChild("Game");
+		gameSettings.saveGame(gameNode);
+		gameNode->addAttribute("LastWorldFrameCount",intToStr(0), mapTagReplacements);
+	}
+
+	virtual void SpectatorFeed_AddFrame(int32 frame, const vector<unsigned char> &payload) {
+		NetworkMessageCommandList networkMessageCommandList;
+		if(payload.empty() == true ||
+			networkMessageCommandList.decodeCompact(&payload[0],(unsigned int)payload.size()) == false) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] invalid spectator frame %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,frame);
+			return;
+		}
+
+		std::map<string,string> mapTagReplacements;
+		for(int index = 0; index < networkMessageCommandList.getCommandCount(); ++index) {
+			NetworkCommand command = *networkMessageCommandList.getCommand(index);
+			XmlNode *networkCommandNode = command.saveGame(gameNode);
+			networkCommandNode->addAttribute("worldFrameCount",intToStr(frame), mapTagReplacements);
+		}
+	}
+
+	virtual bool SpectatorFeed_BuildSnapshot(int32 frame, string &data) {
+		try {
+			gameNode->getAttribute("LastWorldFrameCount")->setValue(intToStr(frame));
+			xmlTree.saveToString(data);
+		}
+		catch(const exception &ex) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+			return false;
+		}
+		return true;
+	}
+};
+
+void ServerInterface::startSpectatorFeed() {
+	Config &config = Config::getInstance();
+	if(spectatorFeed != NULL || config.getBool("EnableSpectatorFeed","false") == false) {
+		return;
+	}
+
+	int portNumber		= config.getInt("SpectatorFeedPort",intToStr(GameConstants::serverSpectatorPort).c_str());
+	int delaySeconds	= config.getInt("SpectatorFeedDelaySeconds","0");
+	int maxSpectators	= config.getInt("SpectatorFeedMaxSpectators","16");
+	int snapshotSeconds	= config.getInt("SpectatorFeedSnapshotSeconds","60");
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Starting spectator feed on port %d, delay %d seconds\n",portNumber,delaySeconds);
+
+	// Spectators joining right away start from the launch settings
+	spectatorFeed = new SpectatorFeedServerThread(portNumber,delaySeconds,maxSpectators);
+	spectatorFeed->setSnapshotBuilder(new SpectatorSnapshotWriter(gameSettings),snapshotSeconds);
+	spectatorFeed->start();
+}
+
+void ServerInterface::publishSpectatorFrame(const NetworkMessageCommandList &networkMessageCommandList) {
+	vector<unsigned char> buf;
+	networkMessageCommandList.encodeCompact(buf);
+	spectatorFeed->addRecord(srt_Frame,networkMessageCommandList.getFrameCount(),buf);
+}
+
+void ServerInterface::shutdownSpectatorFeed() {
+	if(spectatorFeed != NULL) {
+		spectatorFeed->endFeed();
+		// Let the delayed end of the game still reach the spectators
+		if(spectatorFeed->getSpectatorCount() > 0 && spectatorFeed->getRunningStatus() == true) {
+			spectatorFeed->setDeleteSelfOnExecutionDone(true);
+		}
+		else {
+			spectatorFeed->shutdownAndWait();
+			delete spectatorFeed;
+		}
+		spectatorFeed = NULL;
+	}
 }
 
 void ServerInterface::checkListenerSlots() {
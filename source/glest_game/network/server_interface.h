@@ -38,7 +38,7 @@
 using std::vector;
 using Shared::Platform::ServerSocket;
 
-namespace Shared {  namespace PlatformCommon {  class FTPServerThread;  }}
+namespace Shared {  namespace PlatformCommon {  class FTPServerThread;  class ContentTransferServerThread;  class SpectatorFeedServerThread;  }}
 
 namespace Glest{ namespace Game{
 
@@ -83,6 +83,10 @@ private:
 	bool needToRepublishToMasterserver;
 
     ::Shared::PlatformCommon::FTPServerThread *ftpServer;
+    ::Shared::PlatformCommon::ContentTransferServerThread *contentTransferServer;
+
+    // read-only spectators, fed outside of the player slots
+    ::Shared::PlatformCommon::SpectatorFeedServerThread *spectatorFeed;
     bool exitServer;
     int64 nextEventId;
 
@@ -124,6 +128,10 @@ private:
 	Chrono lastBroadcastCommandsTimer;
 	ClientLagCallbackInterface *clientLagCallbackInterface;
 
+	// adaptive network frame period
+	Chrono pingEchoTimer;
+	int adaptiveFramePeriodHoldFrame;
+
 public:
 	ServerInterface(bool publishEnabled, ClientLagCallbackInterface *clientLagCallbackInterface);
 	virtual ~ServerInterface();
@@ -145,6 +153,7 @@ public:
 	bool getUnPauseForInGameConnection();
 
 	void shutdownFTPServer();
+	void shutdownSpectatorFeed();
 
     virtual void close();
     virtual void update();
@@ -273,6 +282,8 @@ private:
 
     int64 getNextEventId();
     void processTextMessageQueue();
+    void startSpectatorFeed();
+    void publishSpectatorFrame(const NetworkMessageCommandList &networkMessageCommandList);
     void processBroadCastMessageQueue();
     void checkListenerSlots();
 	void checkForCompletedClientsUsingThreadManager(
@@ -285,6 +296,8 @@ private:
 	void checkForAutoPauseForLaggingClient(int index,
 			ConnectionSlot* connectionSlot);
 	void checkForAutoResumeForLaggingClients();
+	void sendPingEchoRequests();
+	void updateAdaptiveNetworkFramePeriod(int frameCount);
 
 protected:
     void signalClientsToRecieveData(std::map<PLATFORM_SOCKET,bool> & socketTriggeredList, std::map<int,ConnectionSlotEvent> & eventList, std::map<int,bool> & mapSlotSignalledList);
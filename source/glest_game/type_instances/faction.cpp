@@ -770,18 +770,22 @@ void Faction::init(
 // ================== get ==================
 
 bool Faction::hasUnitTypeWithResourceCostInCache(const ResourceType *rt) const {
-	std::string resourceTypeName = rt->getName(false);
-	std::map<std::string, bool>::const_iterator iterFind = resourceTypeCostCache.find(resourceTypeName);
-	if(iterFind != resourceTypeCostCache.end()) {
-		return iterFind->second;
+	int resourceIndex = techTree->getResourceTypeIndex(rt);
+	if(resourceIndex >= 0 && resourceIndex < (int)resourceTypeCostCache.size()) {
+		return (resourceTypeCostCache[resourceIndex] == 1);
 	}
 	return false;
 }
 void Faction::updateUnitTypeWithResourceCostCache(const ResourceType *rt) {
-	std::string resourceTypeName = rt->getName(false);
-
-	if(resourceTypeCostCache.find(resourceTypeName) == resourceTypeCostCache.end()) {
-		resourceTypeCostCache[resourceTypeName] = hasUnitTypeWithResouceCost(rt);
+	int resourceIndex = techTree->getResourceTypeIndex(rt);
+	if(resourceIndex < 0) {
+		return;
+	}
+	if(resourceIndex >= (int)resourceTypeCostCache.size()) {
+		resourceTypeCostCache.resize(techTree->getResourceTypeCount(), -1);
+	}
+	if(resourceTypeCostCache[resourceIndex] < 0) {
+		resourceTypeCostCache[resourceIndex] = (hasUnitTypeWithResouceCost(rt) ? 1 : 0);
 	}
 }
 
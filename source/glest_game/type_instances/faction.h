@@ -187,7 +187,8 @@ private:
 	std::map<int,const Unit *> mobileUnitListCache;
 	std::map<int,const Unit *> beingBuiltUnitListCache;
 
-	std::map<std::string, bool> resourceTypeCostCache;
+	// indexed by tech tree resource type, -1 until computed
+	std::vector<int> resourceTypeCostCache;
 
 public:
 	Faction();
@@ -44,6 +44,7 @@ FactionType::FactionType() {
 	healthbarTexture=NULL;
 	healthbarBackgroundTexture=NULL;
 	flatParticlePositions=false;
+	symbolTable=NULL;
 }
 
 //load a faction, given a directory
@@ -895,12 +896,24 @@ std::vector<std::string> FactionType::validateFactionTypeUpgradeTypes() {
 
 // ==================== get ====================
 
-const UnitType *FactionType::getUnitType(const string &name) const{
+const UnitType *FactionType::findUnitType(const string &name) const{
+	if(symbolTable != NULL) {
+		int index = unitTypeIndex.get(symbolTable->find(name));
+		return (index >= 0 ? &unitTypes[index] : NULL);
+	}
     for(int i=0; i < (int)unitTypes.size();i++){
 		if(unitTypes[i].getName(false)==name){
             return &unitTypes[i];
 		}
     }
+    return NULL;
+}
+
+const UnitType *FactionType::getUnitType(const string &name) const{
+	const UnitType *unitType = findUnitType(name);
+	if(unitType != NULL) {
+		return unitType;
+	}
 
     printf("In [%s::%s Line: %d] scanning [%s] size = " MG_SIZE_T_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,name.c_str(),unitTypes.size());
     for(int i=0; i < (int)unitTypes.size();i++){
@@ -935,12 +948,24 @@ const UnitType *FactionType::getUnitType(const string &name) const{
 //	throw megaglest_runtime_error("Unit type not found: [" + intToStr(id) + "] in faction type [" + this->name + "]",true);
 //}
 
-const UpgradeType *FactionType::getUpgradeType(const string &name) const{
+const UpgradeType *FactionType::findUpgradeType(const string &name) const{
+	if(symbolTable != NULL) {
+		int index = upgradeTypeIndex.get(symbolTable->find(name));
+		return (index >= 0 ? &upgradeTypes[index] : NULL);
+	}
     for(int i=0; i < (int)upgradeTypes.size();i++){
 		if(upgradeTypes[i].getName()==name){
             return &upgradeTypes[i];
 		}
     }
+    return NULL;
+}
+
+const UpgradeType *FactionType::getUpgradeType(const string &name) const{
+	const UpgradeType *upgradeType = findUpgradeType(name);
+	if(upgradeType != NULL) {
+		return upgradeType;
+	}
 
     printf("In [%s::%s Line: %d] scanning [%s] size = " MG_SIZE_T_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,name.c_str(),unitTypes.size());
     for(int i=0; i < (int)upgradeTypes.size();i++){
@@ -955,6 +980,19 @@ const UpgradeType *FactionType::getUpgradeType(const string &name) const{
 	throw megaglest_runtime_error("Upgrade type not found: [" + name + "] in faction type [" + this->name + "]",true);
 }
 
+void FactionType::buildSymbolIndex(SymbolTable &symbols) {
+	unitTypeIndex.clear();
+	for(int i=0; i < (int)unitTypes.size(); ++i){
+		unitTypeIndex.set(symbols.intern(unitTypes[i].getName(false)), i);
+		unitTypes[i].buildSymbolIndex(symbols);
+	}
+	upgradeTypeIndex.clear();
+	for(int i=0; i < (int)upgradeTypes.size(); ++i){
+		upgradeTypeIndex.set(symbols.intern(upgradeTypes[i].getName()), i);
+	}
+	symbolTable = &symbols;
+}
+
 int FactionType::getStartingResourceAmount(const ResourceType *resourceType) const{
 	for(int i=0; i < (int)startingResources.size(); ++i){
 		if(startingResources[i].getType()==resourceType){
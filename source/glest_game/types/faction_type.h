@@ -19,6 +19,7 @@
 
 #include "unit_type.h"
 #include "upgrade_type.h"
+#include "symbol_table.h"
 #include "sound.h"
 #include <map>
 #include <string>
@@ -106,6 +107,11 @@ private:
 	Texture2D *healthbarBackgroundTexture;
 	bool flatParticlePositions;
 
+	//OPTIMIZATION: name lookups, filled once the tech tree symbols are built
+	const SymbolTable *symbolTable;
+	SymbolIndex unitTypeIndex;
+	SymbolIndex upgradeTypeIndex;
+
 public:
 	//init
 	FactionType();
@@ -144,6 +150,9 @@ public:
 	const UnitType *getUnitType(const string &name) const;
 	//const UnitType *getUnitTypeById(int id) const;
 	const UpgradeType *getUpgradeType(const string &name) const;
+	const UnitType *findUnitType(const string &name) const;
+	const UpgradeType *findUpgradeType(const string &name) const;
+	void buildSymbolIndex(SymbolTable &symbols);
 	int getStartingResourceAmount(const ResourceType *resourceType) const;
 
 	FactionPersonalityType getPersonalityType() const { return personalityType;}
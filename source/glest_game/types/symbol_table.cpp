@@ -0,0 +1,73 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "symbol_table.h"
+#include "conversion.h"
+#include "platform_util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	class SymbolTable
+// =====================================================
+
+int SymbolTable::intern(const string &name) {
+	std::map<string,int>::const_iterator iterFind = symbolIds.find(name);
+	if(iterFind != symbolIds.end()) {
+		return iterFind->second;
+	}
+	int symbol = (int)symbolNames.size();
+	symbolIds[name] = symbol;
+	symbolNames.push_back(name);
+	return symbol;
+}
+
+int SymbolTable::find(const string &name) const {
+	std::map<string,int>::const_iterator iterFind = symbolIds.find(name);
+	if(iterFind != symbolIds.end()) {
+		return iterFind->second;
+	}
+	return invalidSymbol;
+}
+
+const string &SymbolTable::getName(int symbol) const {
+	if(symbol < 0 || symbol >= (int)symbolNames.size()) {
+		throw megaglest_runtime_error("Invalid symbol id: " + intToStr(symbol));
+	}
+	return symbolNames[symbol];
+}
+
+void SymbolTable::clear() {
+	symbolIds.clear();
+	symbolNames.clear();
+}
+
+// =====================================================
+// 	class SymbolIndex
+// =====================================================
+
+void SymbolIndex::set(int symbol, int index) {
+	if(symbol < 0) {
+		return;
+	}
+	if(symbol >= (int)indexes.size()) {
+		indexes.resize(symbol + 1, -1);
+	}
+	// keep the first type registered under a name, like the linear scans did
+	if(indexes[symbol] < 0) {
+		indexes[symbol] = index;
+	}
+}
+
+}}//end namespace
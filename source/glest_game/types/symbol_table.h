@@ -0,0 +1,79 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_SYMBOLTABLE_H_
+#define _GLEST_GAME_SYMBOLTABLE_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <map>
+#include <string>
+#include <vector>
+#include "leak_dumper.h"
+
+using std::string;
+using std::vector;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	class SymbolTable
+//
+///	Interns the names used by a tech tree into dense ids,
+/// built once when the tech tree is loaded so name based
+/// lookups resolve the string once and index afterwards
+// =====================================================
+
+class SymbolTable {
+public:
+	static const int invalidSymbol= -1;
+
+private:
+	std::map<string,int> symbolIds;
+	vector<string> symbolNames;
+
+public:
+	int intern(const string &name);
+	int find(const string &name) const;
+	const string &getName(int symbol) const;
+	int getCount() const			{return (int)symbolNames.size();}
+	void clear();
+};
+
+// =====================================================
+// 	class SymbolIndex
+//
+///	Maps symbol ids to positions in one of the type
+/// vectors (unit types of a faction, skills of a unit...)
+// =====================================================
+
+class SymbolIndex {
+private:
+	vector<int> indexes;
+
+public:
+	void set(int symbol, int index);
+	int get(int symbol) const {
+		if(symbol < 0 || symbol >= (int)indexes.size()) {
+			return -1;
+		}
+		return indexes[symbol];
+	}
+	bool isEmpty() const			{return indexes.empty();}
+	void clear()					{indexes.clear();}
+};
+
+}}//end namespace
+
+#endif
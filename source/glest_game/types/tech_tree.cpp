@@ -21,14 +21,78 @@
 #include "platform_util.h"
 #include "game_util.h"
 #include "window.h"
+#include "config.h"
+#include "simple_threads.h"
 #include "common_scoped_ptr.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Util;
 using namespace Shared::Xml;
+using namespace Shared::PlatformCommon;
 
 namespace Glest{ namespace Game{
 
+// Starts background threads that decode the faction images into the
+// PixmapPreloadCache, the main thread still loads everything in the same
+// order so checksums and type ids are not affected
+static void startPixmapPreloadThreads(const string &techPath, const set<string> &factions,
+		vector<PixmapPreloadThread *> &workerList) {
+	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
+		return;
+	}
+	Config &config = Config::getInstance();
+	unsigned int workerCount = config.getInt("PixmapPreloadThreads","3");
+	if(workerCount == 0) {
+		return;
+	}
+
+	vector<string> fileList;
+	for(set<string>::const_iterator it = factions.begin(); it != factions.end(); ++it) {
+		string factionPath = techPath + "factions/" + *it + "/*";
+		vector<string> factionFiles = getFolderTreeContentsListRecursively(factionPath, "");
+		for(unsigned int index = 0; index < factionFiles.size(); ++index) {
+			if(PixmapPreloadThread::isPreloadableFile(factionFiles[index]) == true) {
+				fileList.push_back(factionFiles[index]);
+			}
+		}
+	}
+	if(fileList.empty() == true) {
+		return;
+	}
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Preloading %d faction images using %u threads\n",(int)fileList.size(),workerCount);
+
+	PixmapPreloadCache::clear();
+	PixmapPreloadCache::setEnabled(true);
+	unsigned int maxDecodedPending = config.getInt("PixmapPreloadMaxPending","64");
+	for(unsigned int workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+		PixmapPreloadThread *workerThread = new PixmapPreloadThread(fileList,
+				workerIndex, workerCount, maxDecodedPending);
+		workerThread->setUniqueID("PixmapPreloadThread_" + intToStr(workerIndex));
+		workerList.push_back(workerThread);
+		workerThread->start();
+	}
+}
+
+static void stopPixmapPreloadThreads(vector<PixmapPreloadThread *> &workerList) {
+	for(unsigned int index = 0; index < workerList.size(); ++index) {
+		workerList[index]->signalQuit();
+	}
+	for(unsigned int index = 0; index < workerList.size(); ++index) {
+		PixmapPreloadThread *workerThread = workerList[index];
+		if(workerThread->shutdownAndWait() == true) {
+			delete workerThread;
+		}
+		else {
+			workerThread->setDeleteSelfOnExecutionDone(true);
+		}
+	}
+	if(workerList.empty() == false) {
+		workerList.clear();
+		PixmapPreloadCache::clear();
+	}
+}
+
 // =====================================================
 // 	class TechTree
 // =====================================================
@@ -336,7 +400,11 @@ void TechTree::load(const string &dir, set<string> &factions, Checksum* checksum
 	//SDL_PumpEvents();
 
 	//load factions
+	vector<PixmapPreloadThread *> pixmapPreloadWorkers;
     try{
+		if(validationMode == false) {
+			startPixmapPreloadThreads(currentPath, factions, pixmapPreloadWorkers);
+		}
 		factionTypes.resize(factions.size());
 
 		int i=0;
@@ -361,16 +429,21 @@ void TechTree::load(const string &dir, set<string> &factions, Checksum* checksum
 		    Window::handleEvent();
 			SDL_PumpEvents();
         }
+		stopPixmapPreloadThreads(pixmapPreloadWorkers);
     }
     catch(megaglest_runtime_error& ex) {
+		stopPixmapPreloadThreads(pixmapPreloadWorkers);
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
 		throw megaglest_runtime_error("Error loading Faction Types: "+ currentPath + "\nMessage: " + ex.what(),!ex.wantStackTrace() || isValidationModeEnabled);
     }
 	catch(const exception &e){
+		stopPixmapPreloadThreads(pixmapPreloadWorkers);
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,e.what());
 		throw megaglest_runtime_error("Error loading Faction Types: "+ currentPath + "\nMessage: " + e.what(),isValidationModeEnabled);
     }
 
+    buildSymbolTable();
+
     if(techtreeChecksum != NULL) {
         *techtreeChecksum = checksumValue;
     }
@@ -378,6 +451,26 @@ void TechTree::load(const string &dir, set<string> &factions, Checksum* checksum
     if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 }
 
+// intern every name the game looks types up by so the lookups after
+// loading resolve the string once and index the type vectors directly
+void TechTree::buildSymbolTable() {
+	symbols.clear();
+
+	resourceTypeIndex.clear();
+	for(int i = 0; i < (int)resourceTypes.size(); ++i) {
+		resourceTypeIndex.set(symbols.intern(resourceTypes[i].getName()), i);
+	}
+	factionTypeIndex.clear();
+	for(int i = 0; i < (int)factionTypes.size(); ++i) {
+		factionTypeIndex.set(symbols.intern(factionTypes[i].getName(false)), i);
+	}
+	for(int i = 0; i < (int)factionTypes.size(); ++i) {
+		factionTypes[i].buildSymbolIndex(symbols);
+	}
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Techtree [%s] interned %d symbols\n",name.c_str(),symbols.getCount());
+}
+
 TechTree::~TechTree() {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 	Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameUnLoadingTechtree","",true), true);
@@ -448,6 +541,10 @@ std::vector<std::string> TechTree::validateResourceTypes() {
 // ==================== get ====================
 
 FactionType *TechTree::getTypeByName(const string &name) {
+	int index = factionTypeIndex.get(symbols.find(name));
+	if(index >= 0) {
+		return &factionTypes[index];
+	}
     for(int i=0; i < (int)factionTypes.size(); ++i) {
           if(factionTypes[i].getName(false) == name) {
                return &factionTypes[i];
@@ -458,6 +555,10 @@ FactionType *TechTree::getTypeByName(const string &name) {
 }
 
 const FactionType *TechTree::getType(const string &name) const {
+	int index = factionTypeIndex.get(symbols.find(name));
+	if(index >= 0) {
+		return &factionTypes[index];
+	}
     for(int i=0; i < (int)factionTypes.size(); ++i) {
           if(factionTypes[i].getName(false) == name) {
                return &factionTypes[i];
@@ -495,6 +596,10 @@ const ResourceType *TechTree::getFirstTechResourceType() const{
 }
 
 const ResourceType *TechTree::getResourceType(const string &name) const{
+	int index = resourceTypeIndex.get(symbols.find(name));
+	if(index >= 0) {
+		return &resourceTypes[index];
+	}
 
 	for(int i=0; i < (int)resourceTypes.size(); ++i){
 		if(resourceTypes[i].getName()==name){
@@ -505,6 +610,17 @@ const ResourceType *TechTree::getResourceType(const string &name) const{
 	throw megaglest_runtime_error("Resource Type not found: " + name,true);
 }
 
+int TechTree::getResourceTypeIndex(const ResourceType *rt) const {
+	if(rt == NULL || resourceTypes.empty() == true) {
+		return -1;
+	}
+	int index = (int)(rt - &resourceTypes[0]);
+	if(index < 0 || index >= (int)resourceTypes.size()) {
+		return -1;
+	}
+	return index;
+}
+
 const ArmorType *TechTree::getArmorType(const string &name) const{
 	for(int i=0; i < (int)armorTypes.size(); ++i){
 		if(armorTypes[i].getName(false)==name){
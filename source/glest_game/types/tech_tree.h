@@ -22,6 +22,7 @@
 #include "resource_type.h"
 #include "faction_type.h"
 #include "damage_multiplier.h"
+#include "symbol_table.h"
 #include "leak_dumper.h"
 
 namespace Glest{ namespace Game{
@@ -58,6 +59,13 @@ private:
 	std::map<string,std::map<string,string> > translatedTechFactionNames;
 	bool isValidationModeEnabled;
 
+	//OPTIMIZATION: names interned once at load, see buildSymbolTable()
+	SymbolTable symbols;
+	SymbolIndex resourceTypeIndex;
+	SymbolIndex factionTypeIndex;
+
+	void buildSymbolTable();
+
 public:
     Checksum loadTech(const string &techName,
     		set<string> &factions, Checksum* checksum,
@@ -81,6 +89,8 @@ public:
 	int getTypeCount() const									{return (int)factionTypes.size();}
 	const FactionType *getType(int i) const						{return &factionTypes[i];}
 	const ResourceType *getResourceType(int i) const			{return &resourceTypes[i];}
+	int getResourceTypeIndex(const ResourceType *rt) const;
+	const SymbolTable &getSymbolTable() const					{return symbols;}
 	string getName(bool translatedValue=false);
 	string getNameUntranslated() const;
 
@@ -101,6 +101,7 @@ UnitType::UnitType() : ProducibleType() {
 	field = fLand;
 	id = 0;
 	meetingPoint = false;
+	symbolTable = NULL;
 	rotationAllowed = false;
 
 	countUnitDeathInStats=false;
@@ -1105,7 +1106,17 @@ int UnitType::getStore(const ResourceType *rt) const{
 }
 
 const SkillType *UnitType::getSkillType(const string &skillName, SkillClass skillClass) const{
-	for(int i=0; i < (int)skillTypes.size(); ++i){
+	// once the tech tree symbols exist only the matching skill has to be checked
+	int first = 0;
+	int last = (int)skillTypes.size();
+	if(symbolTable != NULL) {
+		first = skillTypeIndex.get(symbolTable->find(skillName));
+		last = first + 1;
+		if(first < 0) {
+			first = last = 0;
+		}
+	}
+	for(int i=first; i < last; ++i){
 		if(skillTypes[i]->getName()==skillName){
 			if(skillTypes[i]->getClass()==skillClass){
 				return skillTypes[i];
@@ -1241,6 +1252,12 @@ const CommandType* UnitType::findCommandTypeById(int id) const{
 		return result;
 	}
 
+	// command type ids are their position in the unit type
+	if(id >= 0 && id < getCommandTypeCount() &&
+		commandTypes[id] != NULL && commandTypes[id]->getId() == id) {
+		return commandTypes[id];
+	}
+
 	for(int i=0; i < getCommandTypeCount(); ++i) {
 		const CommandType *commandType= getCommandType(i);
 		if(commandType->getId() == id){
@@ -1250,6 +1267,21 @@ const CommandType* UnitType::findCommandTypeById(int id) const{
 	return NULL;
 }
 
+void UnitType::buildSymbolIndex(SymbolTable &symbols) {
+	skillTypeIndex.clear();
+	for(int i=0; i < (int)skillTypes.size(); ++i){
+		if(skillTypes[i] != NULL) {
+			skillTypeIndex.set(symbols.intern(skillTypes[i]->getName()), i);
+		}
+	}
+	for(int i=0; i < (int)commandTypes.size(); ++i){
+		if(commandTypes[i] != NULL) {
+			symbols.intern(commandTypes[i]->getName(false));
+		}
+	}
+	symbolTable = &symbols;
+}
+
 const CommandType *UnitType::getCommandType(int i) const {
 	if(i >= (int)commandTypes.size()) {
 		char szBuf[8096]="";
@@ -25,6 +25,7 @@
 #include "game_constants.h"
 #include "platform_common.h"
 #include "common_scoped_ptr.h"
+#include "symbol_table.h"
 #include "leak_dumper.h"
 
 namespace Glest{ namespace Game{
@@ -236,6 +237,10 @@ private:
 
     UnitCountsInVictoryConditions countInVictoryConditions;
 
+	//OPTIMIZATION: skill lookups by name, filled once the tech tree symbols are built
+	const SymbolTable *symbolTable;
+	SymbolIndex skillTypeIndex;
+
     static auto_ptr<CommandType> ctHarvestEmergencyReturnCommandType;
 
 public:
@@ -348,6 +353,7 @@ public:
 
 	//find
 	const CommandType* findCommandTypeById(int id) const;
+	void buildSymbolIndex(SymbolTable &symbols);
 	string getCommandTypeListDesc() const;
 
 	inline float getRotatedBuildPos() { return rotatedBuildPos; }
@@ -1120,6 +1120,49 @@ TotalUpgrade::TotalUpgrade() {
 	reset();
 }
 
+void TotalUpgrade::copyDataFrom(UpgradeTypeBase *source) {
+	UpgradeTypeBase::copyDataFrom(source);
+	updateTotals();
+}
+
+template<class T> void TotalUpgrade::addToTotals(const T &upgrade) {
+	totalMaxHp				+= upgrade.maxHp;
+	totalMaxHpRegeneration	+= upgrade.maxHpRegeneration;
+	totalSight				+= upgrade.sight;
+	totalMaxEp				+= upgrade.maxEp;
+	totalMaxEpRegeneration	+= upgrade.maxEpRegeneration;
+	totalArmor				+= upgrade.armor;
+
+	totalAttackStrength.add(upgrade.attackStrength, upgrade.attackStrengthIsMultiplier, upgrade.attackStrengthMultiplierValueList);
+	totalAttackRange.add(upgrade.attackRange, upgrade.attackRangeIsMultiplier, upgrade.attackRangeMultiplierValueList);
+	totalMoveSpeed.add(upgrade.moveSpeed, upgrade.moveSpeedIsMultiplier, upgrade.moveSpeedIsMultiplierValueList);
+	totalProdSpeedProduce.add(upgrade.prodSpeed, upgrade.prodSpeedIsMultiplier, upgrade.prodSpeedProduceIsMultiplierValueList);
+	totalProdSpeedUpgrade.add(upgrade.prodSpeed, upgrade.prodSpeedIsMultiplier, upgrade.prodSpeedUpgradeIsMultiplierValueList);
+	totalProdSpeedMorph.add(upgrade.prodSpeed, upgrade.prodSpeedIsMultiplier, upgrade.prodSpeedMorphIsMultiplierValueList);
+	totalAttackSpeed.add(upgrade.attackSpeed, upgrade.attackSpeedIsMultiplier, upgrade.attackSpeedIsMultiplierValueList);
+}
+
+void TotalUpgrade::updateTotals() {
+	totalMaxHp = 0;
+	totalMaxHpRegeneration = 0;
+	totalSight = 0;
+	totalMaxEp = 0;
+	totalMaxEpRegeneration = 0;
+	totalArmor = 0;
+	totalAttackStrength.reset();
+	totalAttackRange.reset();
+	totalMoveSpeed.reset();
+	totalProdSpeedProduce.reset();
+	totalProdSpeedUpgrade.reset();
+	totalProdSpeedMorph.reset();
+	totalAttackSpeed.reset();
+
+	addToTotals(*this);
+	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
+		addToTotals(boostUpgrades[index]);
+	}
+}
+
 void TotalUpgrade::reset() {
     maxHp= 0;
     maxHpIsMultiplier=false;
@@ -1150,9 +1193,7 @@ void TotalUpgrade::reset() {
 	attackSpeed=0;
 	attackSpeedIsMultiplier=false;
 
-	boostUpgradeBase = NULL;
-	boostUpgradeSourceUnit = -1;
-	boostUpgradeDestUnit = -1;
+	updateTotals();
 }
 
 void TotalUpgrade::sum(const UpgradeTypeBase *ut, const Unit *unit, bool boostMode) {
@@ -1428,20 +1469,23 @@ void TotalUpgrade::sum(const UpgradeTypeBase *ut, const Unit *unit, bool boostMo
 			attackSpeed += newValue;
 		}
 	}
+
+	updateTotals();
 }
 
 void TotalUpgrade::apply(int sourceUnitId, const UpgradeTypeBase *ut, const Unit *unit) {
 	//sum(ut, unit);
 
 	//printf("====> About to apply boost: %s\nTo unit: %d\n\n",ut->toString().c_str(),unit->getId());
-	TotalUpgrade *boostUpgrade = new TotalUpgrade();
-	boostUpgrade->copyDataFrom(this);
-	boostUpgrade->boostUpgradeBase = ut;
-	boostUpgrade->boostUpgradeSourceUnit = sourceUnitId;
-	boostUpgrade->boostUpgradeDestUnit = unit->getId();
-
-	boostUpgrade->sum(ut,unit, true);
-	boostUpgrades.push_back(boostUpgrade);
+	// the boost starts from the current values like before and only keeps its own stats
+	TotalUpgrade boostUpgrade;
+	boostUpgrade.copyDataFrom(this);
+	boostUpgrade.sum(ut,unit, true);
+
+	boostUpgrades.push_back(TotalUpgradeBoost(ut, sourceUnitId, unit->getId()));
+	boostUpgrades.back().copyDataFrom(&boostUpgrade);
+
+	updateTotals();
 }
 
 void TotalUpgrade::deapply(int sourceUnitId, const UpgradeTypeBase *ut,int destUnitId) {
@@ -1449,13 +1493,12 @@ void TotalUpgrade::deapply(int sourceUnitId, const UpgradeTypeBase *ut,int destU
 
 	bool removedBoost = false;
 	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		if(boost->boostUpgradeSourceUnit == sourceUnitId &&
-			boost->boostUpgradeBase->getUpgradeName() == ut->getUpgradeName() &&
-			boost->boostUpgradeDestUnit == destUnitId) {
+		const TotalUpgradeBoost &boost = boostUpgrades[index];
+		if(boost.boostUpgradeSourceUnit == sourceUnitId &&
+			boost.boostUpgradeBase->getUpgradeName() == ut->getUpgradeName() &&
+			boost.boostUpgradeDestUnit == destUnitId) {
 
 			boostUpgrades.erase(boostUpgrades.begin() + index);
-			delete boost;
 			removedBoost = true;
 
 			//printf("de-apply boost FOUND!\n");
@@ -1466,139 +1509,113 @@ void TotalUpgrade::deapply(int sourceUnitId, const UpgradeTypeBase *ut,int destU
 		printf("\n\n!!!!!! de-apply boost NOT FOUND for sourceUnitId = %d, destUnitId = %d\n%s\n\nCurrent Boosts:\n",
 				sourceUnitId,destUnitId,ut->toString().c_str());
 		for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-			TotalUpgrade *boost = boostUpgrades[index];
-			printf("\nBoost #%u\n%s\n",index,boost->toString().c_str());
+			printf("\nBoost #%u\n%s\n",index,boostUpgrades[index].toString().c_str());
 		}
 	}
+	else {
+		updateTotals();
+	}
 }
 
 int TotalUpgrade::getMaxHp() const {
-	return maxHp + getMaxHpFromBoosts();
+	return totalMaxHp;
 }
 int TotalUpgrade::getMaxHpFromBoosts() const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getMaxHp();
-	}
-	return result;
+	return totalMaxHp - maxHp;
 }
 int TotalUpgrade::getMaxHpRegeneration() const {
-	return maxHpRegeneration + getMaxHpRegenerationFromBoosts();
+	return totalMaxHpRegeneration;
 }
 int TotalUpgrade::getMaxHpRegenerationFromBoosts() const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getMaxHpRegeneration();
-	}
-	return result;
+	return totalMaxHpRegeneration - maxHpRegeneration;
 }
 int TotalUpgrade::getSight() const {
-	return sight + getSightFromBoosts();
+	return totalSight;
 }
 int TotalUpgrade::getSightFromBoosts() const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getSight();
-	}
-	return result;
+	return totalSight - sight;
 }
 int TotalUpgrade::getMaxEp() const {
-	return maxEp + getMaxEpFromBoosts();
+	return totalMaxEp;
 }
 int TotalUpgrade::getMaxEpFromBoosts() const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getMaxEp();
-	}
-	return result;
+	return totalMaxEp - maxEp;
 }
 
 int TotalUpgrade::getMaxEpRegeneration() const {
-	return maxEpRegeneration + getMaxEpRegenerationFromBoosts();
+	return totalMaxEpRegeneration;
 }
 int TotalUpgrade::getMaxEpRegenerationFromBoosts() const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getMaxEpRegeneration();
-	}
-	return result;
+	return totalMaxEpRegeneration - maxEpRegeneration;
 }
 
 int TotalUpgrade::getArmor() const {
-	return armor + getArmorFromBoosts();
+	return totalArmor;
 }
 int TotalUpgrade::getArmorFromBoosts() const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getArmor();
-	}
-	return result;
+	return totalArmor - armor;
 }
 
 int TotalUpgrade::getAttackStrength(const AttackSkillType *st) const {
-	return UpgradeTypeBase::getAttackStrength(st) + getAttackStrengthFromBoosts(st);
+	if(st == NULL) {
+		return totalAttackStrength.getTotal();
+	}
+	return totalAttackStrength.get(st->getName());
 }
 int TotalUpgrade::getAttackStrengthFromBoosts(const AttackSkillType *st) const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getAttackStrength(st);
-	}
-	return result;
+	return getAttackStrength(st) - UpgradeTypeBase::getAttackStrength(st);
 }
 
 int TotalUpgrade::getAttackRange(const AttackSkillType *st) const {
-	return UpgradeTypeBase::getAttackRange(st) + getAttackRangeFromBoosts(st);
+	if(st == NULL) {
+		return totalAttackRange.getTotal();
+	}
+	return totalAttackRange.get(st->getName());
 }
 int TotalUpgrade::getAttackRangeFromBoosts(const AttackSkillType *st) const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getAttackRange(st);
-	}
-	return result;
+	return getAttackRange(st) - UpgradeTypeBase::getAttackRange(st);
 }
 
 int TotalUpgrade::getMoveSpeed(const MoveSkillType *st) const {
-	return UpgradeTypeBase::getMoveSpeed(st) + getMoveSpeedFromBoosts(st);
+	if(st == NULL) {
+		return totalMoveSpeed.getTotal();
+	}
+	return totalMoveSpeed.get(st->getName());
 }
 int TotalUpgrade::getMoveSpeedFromBoosts(const MoveSkillType *st) const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getMoveSpeed(st);
-	}
-	return result;
+	return getMoveSpeed(st) - UpgradeTypeBase::getMoveSpeed(st);
 }
 
 int TotalUpgrade::getProdSpeed(const SkillType *st) const {
-	return UpgradeTypeBase::getProdSpeed(st) + getProdSpeedFromBoosts(st);
+	if(st == NULL) {
+		return totalProdSpeedProduce.getTotal();
+	}
+	if(totalProdSpeedProduce.getHasMultiplier() == false) {
+		return totalProdSpeedProduce.get(st->getName());
+	}
+	if(dynamic_cast<const ProduceSkillType *>(st) != NULL) {
+		return totalProdSpeedProduce.get(st->getName());
+	}
+	else if(dynamic_cast<const UpgradeSkillType *>(st) != NULL) {
+		return totalProdSpeedUpgrade.get(st->getName());
+	}
+	else if(dynamic_cast<const MorphSkillType *>(st) != NULL) {
+		return totalProdSpeedMorph.get(st->getName());
+	}
+	throw megaglest_runtime_error("Unsupported skilltype in getProdSpeed!");
 }
 int TotalUpgrade::getProdSpeedFromBoosts(const SkillType *st) const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getProdSpeed(st);
-	}
-	return result;
+	return getProdSpeed(st) - UpgradeTypeBase::getProdSpeed(st);
 }
 
 int TotalUpgrade::getAttackSpeed(const AttackSkillType *st) const {
-	return UpgradeTypeBase::getAttackSpeed(st) + getAttackSpeedFromBoosts(st);
+	if(st == NULL) {
+		return totalAttackSpeed.getTotal();
+	}
+	return totalAttackSpeed.get(st->getName());
 }
 int TotalUpgrade::getAttackSpeedFromBoosts(const AttackSkillType *st) const {
-	int result = 0;
-	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		result += boost->getAttackSpeed(st);
-	}
-	return result;
+	return getAttackSpeed(st) - UpgradeTypeBase::getAttackSpeed(st);
 }
 
 void TotalUpgrade::incLevel(const UnitType *ut) {
@@ -1608,9 +1625,9 @@ void TotalUpgrade::incLevel(const UnitType *ut) {
 	armor += ut->getArmor()*50/100;
 
 	for(unsigned int index = 0; index < boostUpgrades.size(); ++index) {
-		TotalUpgrade *boost = boostUpgrades[index];
-		boost->copyDataFrom(this);
+		boostUpgrades[index].copyDataFrom(this);
 	}
+	updateTotals();
 }
 
 void TotalUpgrade::saveGame(XmlNode *rootNode) const {
@@ -1873,6 +1890,7 @@ void TotalUpgrade::loadGame(const XmlNode *rootNode) {
 //		//apply(const UpgradeTypeBase *ut, unit);
 //	}
 
+	updateTotals();
 }
 
 
@@ -343,6 +343,81 @@ public:
 	//virtual void loadGame(const XmlNode *rootNode);
 };
 
+/**
+ * The stat changes of one attack boost applied to a unit, along with the boost and units it came
+ * from so it can be removed again when it wears off.
+ */
+class TotalUpgradeBoost: public UpgradeTypeBase {
+	friend class TotalUpgrade;
+
+private:
+	const UpgradeTypeBase *boostUpgradeBase;
+	int boostUpgradeSourceUnit;
+	int boostUpgradeDestUnit;
+
+public:
+	TotalUpgradeBoost(const UpgradeTypeBase *boostUpgradeBase, int sourceUnitId, int destUnitId) {
+		this->boostUpgradeBase = boostUpgradeBase;
+		this->boostUpgradeSourceUnit = sourceUnitId;
+		this->boostUpgradeDestUnit = destUnitId;
+	}
+};
+
+/**
+ * The effective value of a stat that can depend on the skill it is read for (attack strength,
+ * move speed, ...), summed over an upgrade and its boosts.
+ */
+class TotalUpgradeSkillValue {
+private:
+	int total;			/**< Value when no skill is given. */
+	int flat;			/**< Part coming from upgrades that are not multipliers. */
+	bool hasMultiplier;	/**< True when perSkill has to be consulted. */
+	std::map<string,int> perSkill;
+
+public:
+	TotalUpgradeSkillValue() {
+		reset();
+	}
+
+	void reset() {
+		total = 0;
+		flat = 0;
+		hasMultiplier = false;
+		perSkill.clear();
+	}
+
+	/**
+	 * Adds the contribution of one upgrade.
+	 * @param value The plain value of the upgrade.
+	 * @param isMultiplier If the upgrade is a multiplier its per skill values are used instead.
+	 * @param values The per skill values of a multiplier upgrade.
+	 */
+	void add(int value, bool isMultiplier, const std::map<string,int> &values) {
+		total += value;
+		if(isMultiplier == false) {
+			flat += value;
+		}
+		else {
+			hasMultiplier = true;
+			for(std::map<string,int>::const_iterator iterMap = values.begin();
+				iterMap != values.end(); ++iterMap) {
+				perSkill[iterMap->first] += iterMap->second;
+			}
+		}
+	}
+
+	int getTotal() const			{return total;}
+	bool getHasMultiplier() const	{return hasMultiplier;}
+
+	int get(const string &skillName) const {
+		if(hasMultiplier == false) {
+			return flat;
+		}
+		std::map<string,int>::const_iterator iterFind = perSkill.find(skillName);
+		return flat + (iterFind != perSkill.end() ? iterFind->second : 0);
+	}
+};
+
 /**
  * Keeps track of the cumulative effects of upgrades on units. This allows us to apply multiple
  * upgrades to a unit with the effects stacking.
@@ -351,16 +426,37 @@ class TotalUpgrade: public UpgradeTypeBase {
 
 private:
 
-	// List of boosts
-	const UpgradeTypeBase *boostUpgradeBase;
-	int boostUpgradeSourceUnit;
-	int boostUpgradeDestUnit;
-	std::vector<TotalUpgrade *> boostUpgrades;
+	// List of boosts, kept inline since most units only ever carry a few
+	std::vector<TotalUpgradeBoost> boostUpgrades;
+
+	/**
+	 * The effective stats (own values plus all boosts). Recomputed by updateTotals() whenever an
+	 * upgrade or boost is applied or removed, so the getters used by combat and regeneration each
+	 * frame only read these fields.
+	 */
+	int totalMaxHp;
+	int totalMaxHpRegeneration;
+	int totalSight;
+	int totalMaxEp;
+	int totalMaxEpRegeneration;
+	int totalArmor;
+	TotalUpgradeSkillValue totalAttackStrength;
+	TotalUpgradeSkillValue totalAttackRange;
+	TotalUpgradeSkillValue totalMoveSpeed;
+	TotalUpgradeSkillValue totalProdSpeedProduce;
+	TotalUpgradeSkillValue totalProdSpeedUpgrade;
+	TotalUpgradeSkillValue totalProdSpeedMorph;
+	TotalUpgradeSkillValue totalAttackSpeed;
+
+	void updateTotals();
+	template<class T> void addToTotals(const T &upgrade);
 
 public:
 	TotalUpgrade();
 	virtual ~TotalUpgrade() {}
 
+	virtual void copyDataFrom(UpgradeTypeBase *source);
+
 	/**
 	 * Resets all stat boosts (so there's effectively no upgrade).
 	 */
@@ -23,6 +23,7 @@
 #include "map.h"
 
 #include <cassert>
+#include <algorithm>
 
 #include "tileset.h"
 #include "unit.h"
@@ -339,6 +340,161 @@ void SurfaceCell::loadGame(const XmlNode *rootNode, int index, World *world) {
 //		}
 	}
 }
+// =====================================================
+// 	class ResourceSpatialIndex
+// =====================================================
+
+const int ResourceSpatialIndex::bucketSize= 8;
+
+ResourceSpatialIndex::ResourceSpatialIndex() {
+	bucketW= 0;
+	bucketH= 0;
+}
+
+void ResourceSpatialIndex::init(int surfaceW, int surfaceH) {
+	resourceBuckets.clear();
+	bucketW= (surfaceW + bucketSize - 1) / bucketSize;
+	bucketH= (surfaceH + bucketSize - 1) / bucketSize;
+}
+
+void ResourceSpatialIndex::clear() {
+	resourceBuckets.clear();
+}
+
+int ResourceSpatialIndex::getBucketIndex(const Vec2i &surfPos) const {
+	return (surfPos.y / bucketSize) * bucketW + (surfPos.x / bucketSize);
+}
+
+void ResourceSpatialIndex::addResource(const ResourceType *rt, const Vec2i &surfPos) {
+	if(rt == NULL || bucketW <= 0 || bucketH <= 0) {
+		return;
+	}
+	vector<ResourceBucket> &buckets= resourceBuckets[rt];
+	if(buckets.empty() == true) {
+		buckets.resize(bucketW * bucketH);
+	}
+	ResourceBucket &bucket= buckets[getBucketIndex(surfPos)];
+	if(std::find(bucket.begin(), bucket.end(), surfPos) == bucket.end()) {
+		bucket.push_back(surfPos);
+	}
+}
+
+void ResourceSpatialIndex::removeResource(const ResourceType *rt, const Vec2i &surfPos) {
+	ResourceTypeBucketMap::iterator iterFind= resourceBuckets.find(rt);
+	if(iterFind == resourceBuckets.end()) {
+		return;
+	}
+	ResourceBucket &bucket= iterFind->second[getBucketIndex(surfPos)];
+	ResourceBucket::iterator iterPos= std::find(bucket.begin(), bucket.end(), surfPos);
+	if(iterPos != bucket.end()) {
+		*iterPos= bucket.back();
+		bucket.pop_back();
+	}
+}
+
+//searches bucket rings outward from pos (in cell coords), the result is the
+//same cell a full map scan in x then y order would pick
+bool ResourceSpatialIndex::findNearestExplored(const Map *map, const ResourceType *rt,
+		const Vec2i &pos, int teamIndex, Vec2i &resultPos) const {
+	ResourceTypeBucketMap::const_iterator iterFind= resourceBuckets.find(rt);
+	if(iterFind == resourceBuckets.end()) {
+		return false;
+	}
+	const vector<ResourceBucket> &buckets= iterFind->second;
+
+	const int bucketCellSize= bucketSize * Map::cellScale;
+	const int centerX= clamp(pos.x / bucketCellSize, 0, bucketW - 1);
+	const int centerY= clamp(pos.y / bucketCellSize, 0, bucketH - 1);
+	const int maxRing= max(max(centerX, bucketW - 1 - centerX), max(centerY, bucketH - 1 - centerY));
+
+	bool found= false;
+	float nearestDist= infinity;
+
+	for(int ring= 0; ring <= maxRing; ++ring) {
+		//every cell in this ring is further away than what we already have
+		if(found == true && (ring - 1) * bucketCellSize > nearestDist) {
+			break;
+		}
+
+		for(int by= centerY - ring; by <= centerY + ring; ++by) {
+			if(by < 0 || by >= bucketH) {
+				continue;
+			}
+			const bool edgeRow= (by == centerY - ring || by == centerY + ring);
+			const int stepX= (edgeRow == true || ring == 0 ? 1 : ring * 2);
+
+			for(int bx= centerX - ring; bx <= centerX + ring; bx += stepX) {
+				if(bx < 0 || bx >= bucketW) {
+					continue;
+				}
+				const ResourceBucket &bucket= buckets[by * bucketW + bx];
+				for(unsigned int k= 0; k < bucket.size(); ++k) {
+					const Vec2i &surfPos= bucket[k];
+					const SurfaceCell *sc= map->getSurfaceCell(surfPos);
+					if(sc->isExplored(teamIndex) == false) {
+						continue;
+					}
+					const Resource *r= sc->getResource();
+					if(r == NULL || r->getType() != rt) {
+						continue;
+					}
+
+					for(int dx= 0; dx < Map::cellScale; ++dx) {
+						for(int dy= 0; dy < Map::cellScale; ++dy) {
+							const Vec2i resPos= Vec2i(surfPos.x * Map::cellScale + dx, surfPos.y * Map::cellScale + dy);
+							if(map->isInside(resPos) == false) {
+								continue;
+							}
+							float tmpDist= pos.dist(resPos);
+							if(found == false || tmpDist < nearestDist ||
+								(tmpDist == nearestDist && (resPos.x < resultPos.x ||
+									(resPos.x == resultPos.x && resPos.y < resultPos.y)))) {
+								found= true;
+								nearestDist= tmpDist;
+								resultPos= resPos;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return found;
+}
+
+bool ResourceSpatialIndex::hasResourceInArea(const Map *map, const ResourceType *rt,
+		const Vec2i &topLeft, const Vec2i &bottomRight) const {
+	ResourceTypeBucketMap::const_iterator iterFind= resourceBuckets.find(rt);
+	if(iterFind == resourceBuckets.end()) {
+		return false;
+	}
+	const vector<ResourceBucket> &buckets= iterFind->second;
+
+	const Vec2i surfTopLeft= Map::toSurfCoords(Vec2i(
+		clamp(topLeft.x, 0, map->getW() - 1), clamp(topLeft.y, 0, map->getH() - 1)));
+	const Vec2i surfBottomRight= Map::toSurfCoords(Vec2i(
+		clamp(bottomRight.x, 0, map->getW() - 1), clamp(bottomRight.y, 0, map->getH() - 1)));
+
+	for(int by= surfTopLeft.y / bucketSize; by <= surfBottomRight.y / bucketSize; ++by) {
+		for(int bx= surfTopLeft.x / bucketSize; bx <= surfBottomRight.x / bucketSize; ++bx) {
+			const ResourceBucket &bucket= buckets[by * bucketW + bx];
+			for(unsigned int k= 0; k < bucket.size(); ++k) {
+				const Vec2i &surfPos= bucket[k];
+				if(surfPos.x < surfTopLeft.x || surfPos.x > surfBottomRight.x ||
+					surfPos.y < surfTopLeft.y || surfPos.y > surfBottomRight.y) {
+					continue;
+				}
+				const Resource *r= map->getSurfaceCell(surfPos)->getResource();
+				if(r != NULL && r->getType() == rt) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
 // =====================================================
 // 	class Map
 // =====================================================
@@ -347,6 +503,7 @@ void SurfaceCell::loadGame(const XmlNode *rootNode, int index, World *world) {
 
 const int Map::cellScale= 2;
 const int Map::mapScale= 2;
+const int Map::surfaceChunkSize= 16;
 
 Map::Map() {
 	cells= NULL;
@@ -365,6 +522,8 @@ Map::Map() {
 	surfaceSize=(surfaceW * surfaceH);
 	maxPlayers=0;
 	maxMapHeight=0;
+	surfaceChunksW=0;
+	surfaceChunksH=0;
 }
 
 Map::~Map() {
@@ -597,6 +756,47 @@ void Map::init(Tileset *tileset) {
 	computeInterpolatedHeights();
 	computeNearSubmerged();
 	computeCellColors();
+	buildResourceIndex();
+
+	surfaceChunksW= (max(surfaceW - 1, 1) + surfaceChunkSize - 1) / surfaceChunkSize;
+	surfaceChunksH= (max(surfaceH - 1, 1) + surfaceChunkSize - 1) / surfaceChunkSize;
+	surfaceChunkVersions.assign(surfaceChunksW * surfaceChunksH, 0);
+}
+
+// ==================== resources ====================
+
+void Map::buildResourceIndex() {
+	resourceIndex.init(surfaceW, surfaceH);
+	for(int j = 0; j < surfaceH; ++j) {
+		for(int i = 0; i < surfaceW; ++i) {
+			const Resource *r= getSurfaceCell(i, j)->getResource();
+			if(r != NULL) {
+				resourceIndex.addResource(r->getType(), Vec2i(i, j));
+			}
+		}
+	}
+}
+
+void Map::deleteResource(const Vec2i &surfPos) {
+	SurfaceCell *sc= getSurfaceCell(surfPos);
+	const Resource *r= sc->getResource();
+	if(r != NULL) {
+		resourceIndex.removeResource(r->getType(), surfPos);
+	}
+	sc->deleteResource();
+}
+
+bool Map::findNearestExploredResource(const ResourceType *rt, const Vec2i &pos, int teamIndex, Vec2i &resultPos) const {
+	return resourceIndex.findNearestExplored(this, rt, pos, teamIndex, resultPos);
+}
+
+bool Map::hasHarvestableResourceInArea(const HarvestCommandType *hct, const Vec2i &topLeft, const Vec2i &bottomRight) const {
+	for(int i = 0; i < hct->getHarvestedResourceCount(); ++i) {
+		if(resourceIndex.hasResourceInArea(this, hct->getHarvestedResource(i), topLeft, bottomRight) == true) {
+			return true;
+		}
+	}
+	return false;
 }
 
 
@@ -1644,12 +1844,30 @@ void Map::flatternTerrain(const Unit *unit){
 				//we change height if pos is inside world, if its free or ocupied by the currenty building
 				if(sc->getObject() == NULL && (c->getUnit(fLand)==NULL || c->getUnit(fLand)==unit)) {
 					sc->setHeight(refHeight,true);
+					markSurfaceChanged(toSurfCoords(pos));
 				}
             }
         }
     }
 }
 
+// A surface vertex is shared by the quads left and above it and its height
+// feeds the normals of its neighbours, so quads two cells away change too
+void Map::markSurfaceChanged(const Vec2i &surfPos) {
+	if(surfaceChunkVersions.empty() == true) {
+		return;
+	}
+	const int quadXStart= max(0, surfPos.x - 2) / surfaceChunkSize;
+	const int quadYStart= max(0, surfPos.y - 2) / surfaceChunkSize;
+	const int quadXEnd= min(surfaceChunksW * surfaceChunkSize - 1, surfPos.x + 1) / surfaceChunkSize;
+	const int quadYEnd= min(surfaceChunksH * surfaceChunkSize - 1, surfPos.y + 1) / surfaceChunkSize;
+	for(int cy = quadYStart; cy <= quadYEnd; ++cy) {
+		for(int cx = quadXStart; cx <= quadXEnd; ++cx) {
+			surfaceChunkVersions[cy * surfaceChunksW + cx]++;
+		}
+	}
+}
+
 //compute normals
 void Map::computeNormals(){
     //compute center normals
@@ -1921,6 +2139,7 @@ void Map::loadGame(const XmlNode *rootNode, World *world) {
 		SurfaceCell &surfaceCell = surfaceCells[i];
 		surfaceCell.loadGame(mapNode,i,world);
 	}
+	buildResourceIndex();
 
 	int surfaceCellIndexExplored = 0;
 	int surfaceCellIndexVisible = 0;
@@ -2047,29 +2266,70 @@ PosQuadIterator::PosQuadIterator(const Map *map,const Quad2i &quad, int step) {
 	this->quad= quad;
 	this->boundingRect= quad.computeBoundingRect();
 	this->step= step;
-	pos= boundingRect.p[0];
-	--pos.x;
-	pos.x= (pos.x/step)*step;
-	pos.y= (pos.y/step)*step;
+	pos.y= (boundingRect.p[0].y / step) * step - step;
+	//start on an empty row so next() computes the first span
+	pos.x= 0;
+	rowEndX= -step;
 	//map->clampPos(pos);
 }
 
-bool PosQuadIterator::next() {
+static int floorDiv(int numerator, int denominator) {
+	int result= numerator / denominator;
+	if((numerator % denominator != 0) && ((numerator < 0) != (denominator < 0))) {
+		--result;
+	}
+	return result;
+}
 
-	do {
-		pos.x += step;
-		if(pos.x > boundingRect.p[1].x) {
-			pos.x = (boundingRect.p[0].x / step) * step;
-			pos.y += step;
+// Intersects the current row with the four edge half planes of the quad, the
+// positions in the span are exactly the ones Quad2i::isInside accepts
+void PosQuadIterator::computeRowSpan() {
+	int minX= boundingRect.p[0].x;
+	int maxX= boundingRect.p[1].x - 1;
+	if(pos.y < boundingRect.p[0].y) {
+		maxX= minX - 1;
+	}
+
+	static const int edges[4][2]= { {0, 1}, {1, 3}, {3, 2}, {2, 0} };
+	for(int i = 0; i < 4 && minX <= maxX; ++i) {
+		const Vec2i &a= quad.p[edges[i][0]];
+		const Vec2i &b= quad.p[edges[i][1]];
+
+		//inside when x * dy > c
+		int dy= b.y - a.y;
+		int c= (pos.y - a.y) * (b.x - a.x) + a.x * dy;
+		if(dy == 0) {
+			if(c >= 0) {
+				maxX= minX - 1;
+			}
 		}
-		if(pos.y > boundingRect.p[1].y) {
-			return false;
+		else if(dy > 0) {
+			minX= max(minX, floorDiv(c, dy) + 1);
 		}
+		else {
+			maxX= min(maxX, floorDiv(-c - 1, -dy));
+		}
+	}
 
-		//printf("pos [%s] boundingRect.p[0] [%s] boundingRect.p[1] [%s]\n",pos.getString().c_str(),boundingRect.p[0].getString().c_str(),boundingRect.p[1].getString().c_str());
+	int firstX= (boundingRect.p[0].x / step) * step;
+	if(firstX < minX) {
+		firstX+= ((minX - firstX + step - 1) / step) * step;
+	}
+	pos.x= firstX;
+	rowEndX= maxX;
+}
+
+bool PosQuadIterator::next() {
+	pos.x += step;
+	while(pos.x > rowEndX) {
+		pos.y += step;
+		if(pos.y >= boundingRect.p[1].y) {
+			return false;
+		}
+		computeRowSpan();
 	}
-	while(!quad.isInside(pos));
 
+	//printf("pos [%s] boundingRect.p[0] [%s] boundingRect.p[1] [%s]\n",pos.getString().c_str(),boundingRect.p[0].getString().c_str(),boundingRect.p[1].getString().c_str());
 	return true;
 }
 
@@ -58,6 +58,9 @@ class Resource;
 class TechTree;
 class GameSettings;
 class World;
+class Map;
+class ResourceType;
+class HarvestCommandType;
 
 // =====================================================
 // 	class Cell
@@ -204,6 +207,40 @@ public:
 };
 
 
+// =====================================================
+// 	class ResourceSpatialIndex
+//
+///	Surface cells holding resources, bucketed per resource type
+// =====================================================
+
+class ResourceSpatialIndex {
+public:
+	static const int bucketSize;	//surface cells per bucket side
+
+private:
+	typedef vector<Vec2i> ResourceBucket;
+	typedef std::map<const ResourceType *, vector<ResourceBucket> > ResourceTypeBucketMap;
+
+	ResourceTypeBucketMap resourceBuckets;
+	int bucketW;
+	int bucketH;
+
+	int getBucketIndex(const Vec2i &surfPos) const;
+
+public:
+	ResourceSpatialIndex();
+
+	void init(int surfaceW, int surfaceH);
+	void clear();
+	void addResource(const ResourceType *rt, const Vec2i &surfPos);
+	void removeResource(const ResourceType *rt, const Vec2i &surfPos);
+
+	bool findNearestExplored(const Map *map, const ResourceType *rt, const Vec2i &pos,
+							int teamIndex, Vec2i &resultPos) const;
+	bool hasResourceInArea(const Map *map, const ResourceType *rt,
+							const Vec2i &topLeft, const Vec2i &bottomRight) const;
+};
+
 // =====================================================
 // 	class Map
 //
@@ -223,6 +260,7 @@ class Map {
 public:
 	static const int cellScale;	//number of cells per surfaceCell
 	static const int mapScale;	//horizontal scale of surface
+	static const int surfaceChunkSize;	//surface quads per terrain chunk side
 
 private:
 	string title;
@@ -244,6 +282,10 @@ private:
 	Checksum checksumValue;
 	float maxMapHeight;
 	string mapFile;
+	ResourceSpatialIndex resourceIndex;
+	int surfaceChunksW;
+	int surfaceChunksH;
+	vector<uint32> surfaceChunkVersions;
 
 private:
 	Map(Map&);
@@ -336,6 +378,12 @@ public:
 	}
 	bool isResourceNear(int frameIndex,const Vec2i &pos, const ResourceType *rt, Vec2i &resourcePos, int size, Unit *unit=NULL,bool fallbackToPeersHarvestingSameResource=false,Vec2i *resourceClickPos=NULL) const;
 
+	//resources
+	void buildResourceIndex();
+	void deleteResource(const Vec2i &surfPos);
+	bool findNearestExploredResource(const ResourceType *rt, const Vec2i &pos, int teamIndex, Vec2i &resultPos) const;
+	bool hasHarvestableResourceInArea(const HarvestCommandType *hct, const Vec2i &topLeft, const Vec2i &bottomRight) const;
+
 	//free cells
 	bool isFreeCell(const Vec2i &pos, Field field) const;
 	bool isFreeCellOrHasUnit(const Vec2i &pos, Field field, const Unit *unit) const;
@@ -373,6 +421,12 @@ public:
 	void computeNormals();
 	void computeInterpolatedHeights();
 
+	//terrain chunks, bumped whenever surface heights inside them change
+	inline int getSurfaceChunksW() const						{return surfaceChunksW;}
+	inline int getSurfaceChunksH() const						{return surfaceChunksH;}
+	inline uint32 getSurfaceChunkVersion(int cx, int cy) const	{return surfaceChunkVersions[cy * surfaceChunksW + cx];}
+	void markSurfaceChanged(const Vec2i &surfPos);
+
 	//static
 	inline static Vec2i toSurfCoords(const Vec2i &unitPos)		{return unitPos / cellScale;}
 	inline static Vec2i toUnitCoords(const Vec2i &surfPos)		{return surfPos * cellScale;}
@@ -666,9 +720,12 @@ private:
 	Quad2i quad;
 	Rect2i boundingRect;
 	Vec2i pos;
+	int rowEndX;
 	int step;
 	const Map *map;
 
+	void computeRowSpan();
+
 public:
 	PosQuadIterator(const Map *map,const Quad2i &quad, int step=1);
 	bool next();
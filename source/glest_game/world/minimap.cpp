@@ -12,6 +12,7 @@
 #include "minimap.h"
 
 #include <cassert>
+#include <cstring>
 
 #include "world.h"
 #include "vec.h"
@@ -42,6 +43,10 @@ Minimap::Minimap() {
 	gameSettings= NULL;
 	tex=NULL;
 	fowTex=NULL;
+	fowBlendMin= Vec2i(0, 0);
+	fowBlendMax= Vec2i(-1, -1);
+	fowTexDirtyMin= Vec2i(0, 0);
+	fowTexDirtyMax= Vec2i(-1, -1);
 }
 
 void Minimap::init(int w, int h, const World *world, bool fogOfWar) {
@@ -113,6 +118,9 @@ void Minimap::init(int w, int h, const World *world, bool fogOfWar) {
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
+	setFowBlendAll();
+	addFowTexDirtyRect(0, 0, potW - 1, potH - 1);
+
 	computeTexture(world);
 }
 
@@ -141,6 +149,7 @@ void Minimap::incFowTextureAlphaSurface(const Vec2i sPos, float alpha,
 
 		if(fowPixmap1->getPixelf(sPos.x, sPos.y) < alpha){
 			fowPixmap1->setPixel(sPos.x, sPos.y, alpha);
+			addFowBlendCell(sPos.x, sPos.y);
 		}
 
 		if(fowPixmap1Copy != NULL && isIncrementalUpdate == true) {
@@ -166,6 +175,7 @@ void Minimap::restoreFowTexAlphaSurface() {
 	if(fowPixmap1Copy != NULL && fowPixmap1Copy_default != NULL) {
 		fowPixmap1Copy->copy(fowPixmap1Copy_default);
 	}
+	setFowBlendAll();
 }
 
 void Minimap::setFogOfWar(bool value) {
@@ -188,6 +198,7 @@ void Minimap::restoreFowTex() {
 	if(fowPixmap1 != NULL && fowPixmap1Copy != NULL) {
 		fowPixmap1->copy(fowPixmap1Copy);
 	}
+	setFowBlendAll();
 }
 
 void Minimap::resetFowTex() {
@@ -199,69 +210,153 @@ void Minimap::resetFowTex() {
 		// Could turn off ONLY fog of war by setting below to false
 		bool overridefogOfWarValue = fogOfWar;
 
-		for(int indexPixelWidth = 0;
-				indexPixelWidth < fowTex->getPixmap()->getW();
-				++indexPixelWidth){
-			for(int indexPixelHeight = 0;
-					indexPixelHeight < fowTex->getPixmap()->getH();
-					++indexPixelHeight){
-				if ((fogOfWar == false && overridefogOfWarValue == false)) {
-					//(gameSettings->getFlagTypes1() & ft1_show_map_resources) != ft1_show_map_resources) {
-					//printf("Line: %d\n",__LINE__);
-
-					float p0 = fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-					float p1 = fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-					if (p0 > p1) {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p0);
-					}
-					else {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p1);
-					}
+		// The pixmaps are single component so walk them as flat byte buffers,
+		// comparing bytes gives the same result as comparing getPixelf values
+		const std::size_t pixelCount = fowPixmap1->getPixelByteCount();
+		const uint8 *pixels0 = fowPixmap0->getPixels();
+		uint8 *pixels1 = fowPixmap1->getPixels();
+
+		if ((fogOfWar == false && overridefogOfWarValue == false)) {
+			//(gameSettings->getFlagTypes1() & ft1_show_map_resources) != ft1_show_map_resources) {
+			for(std::size_t index = 0; index < pixelCount; ++index) {
+				if(pixels0[index] > pixels1[index]) {
+					pixels1[index] = pixels0[index];
 				}
-				else if((fogOfWar && overridefogOfWarValue) ||
-					(gameSettings->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources) {
-					//printf("Line: %d\n",__LINE__);
-
-					float p0= fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-					float p1= fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-
-					if(p1 > exploredAlpha) {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, exploredAlpha);
-					}
-					if(p0 > p1) {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p0);
-					}
+			}
+		}
+		else if((fogOfWar && overridefogOfWarValue) ||
+			(gameSettings->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources) {
+			const uint8 exploredValue = static_cast<uint8>(exploredAlpha * 255.f);
+			for(std::size_t index = 0; index < pixelCount; ++index) {
+				uint8 p1 = pixels1[index];
+				if(p1 > exploredValue) {
+					p1 = exploredValue;
 				}
-				else {
-					//printf("Line: %d\n",__LINE__);
-					fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, 1.f);
+				if(pixels0[index] > p1) {
+					p1 = pixels0[index];
 				}
+				pixels1[index] = p1;
 			}
 		}
+		else {
+			memset(pixels1, 255, pixelCount);
+		}
+
+		setFowBlendAll();
 	}
 }
 
 void Minimap::updateFowTex(float t) {
 	if(fowTex && fowPixmap0 && fowPixmap1) {
-		for(int indexPixelWidth = 0;
-				indexPixelWidth < fowPixmap0->getW();
-				++indexPixelWidth){
-			for(int indexPixelHeight = 0;
-					indexPixelHeight < fowPixmap0->getH();
-					++indexPixelHeight){
-				float p1 = fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-				float p2 = fowTex->getPixmap()->getPixelf(indexPixelWidth, indexPixelHeight);
-				if(p1 != p2) {
-					float p0 = fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-					fowTex->getPixmap()->setPixel(indexPixelWidth, indexPixelHeight, p0+(t*(p1-p0)));
-				}
+		if(fowBlendMax.x < fowBlendMin.x || fowBlendMax.y < fowBlendMin.y) {
+			return;
+		}
+
+		const int w = fowPixmap0->getW();
+		const uint8 *pixels0 = fowPixmap0->getPixels();
+		const uint8 *pixels1 = fowPixmap1->getPixels();
+		uint8 *texPixels = fowTex->getPixmap()->getPixels();
+
+		// blend factor in 8.8 fixed point so the row loop below has no
+		// branches or float conversions and can be vectorized by the compiler
+		const int blend = static_cast<int>(clamp(t, 0.f, 1.f) * 256.f);
+
+		int changedMinY = fowBlendMax.y + 1;
+		int changedMaxY = fowBlendMin.y - 1;
+		int pendingMinY = fowBlendMax.y + 1;
+		int pendingMaxY = fowBlendMin.y - 1;
+
+		for(int y = fowBlendMin.y; y <= fowBlendMax.y; ++y) {
+			const uint8 *row0 = pixels0 + y * w;
+			const uint8 *row1 = pixels1 + y * w;
+			uint8 *rowTex = texPixels + y * w;
+
+			int changed = 0;
+			int pending = 0;
+			for(int x = fowBlendMin.x; x <= fowBlendMax.x; ++x) {
+				const int p0 = row0[x];
+				const int p1 = row1[x];
+				const int p2 = rowTex[x];
+				const int value = (p1 != p2 ? p0 + ((p1 - p0) * blend) / 256 : p2);
+				changed |= value ^ p2;
+				pending |= value ^ p1;
+				rowTex[x] = static_cast<uint8>(value);
+			}
+
+			if(changed != 0) {
+				changedMinY = min(changedMinY, y);
+				changedMaxY = max(changedMaxY, y);
+			}
+			if(pending != 0) {
+				pendingMinY = min(pendingMinY, y);
+				pendingMaxY = max(pendingMaxY, y);
 			}
 		}
+
+		if(changedMinY <= changedMaxY) {
+			addFowTexDirtyRect(fowBlendMin.x, changedMinY, fowBlendMax.x, changedMaxY);
+		}
+
+		// rows which reached their target no longer need blending
+		if(pendingMinY <= pendingMaxY) {
+			fowBlendMin.y = pendingMinY;
+			fowBlendMax.y = pendingMaxY;
+		}
+		else {
+			fowBlendMin = Vec2i(0, 0);
+			fowBlendMax = Vec2i(-1, -1);
+		}
+	}
+}
+
+bool Minimap::getFowTexDirtyRect(Vec2i &pos, Vec2i &size) const {
+	if(fowTexDirtyMax.x < fowTexDirtyMin.x || fowTexDirtyMax.y < fowTexDirtyMin.y) {
+		return false;
 	}
+	pos = fowTexDirtyMin;
+	size = fowTexDirtyMax - fowTexDirtyMin + Vec2i(1, 1);
+	return true;
+}
+
+void Minimap::clearFowTexDirtyRect() const {
+	fowTexDirtyMin = Vec2i(0, 0);
+	fowTexDirtyMax = Vec2i(-1, -1);
 }
 
 // ==================== PRIVATE ====================
 
+void Minimap::setFowBlendAll() {
+	fowBlendMin = Vec2i(0, 0);
+	if(fowPixmap1 != NULL) {
+		fowBlendMax = Vec2i(fowPixmap1->getW() - 1, fowPixmap1->getH() - 1);
+	}
+	else {
+		fowBlendMax = Vec2i(-1, -1);
+	}
+}
+
+void Minimap::addFowBlendCell(int x, int y) {
+	if(fowBlendMax.x < fowBlendMin.x || fowBlendMax.y < fowBlendMin.y) {
+		fowBlendMin = Vec2i(x, y);
+		fowBlendMax = Vec2i(x, y);
+	}
+	else {
+		fowBlendMin = Vec2i(min(fowBlendMin.x, x), min(fowBlendMin.y, y));
+		fowBlendMax = Vec2i(max(fowBlendMax.x, x), max(fowBlendMax.y, y));
+	}
+}
+
+void Minimap::addFowTexDirtyRect(int minX, int minY, int maxX, int maxY) {
+	if(fowTexDirtyMax.x < fowTexDirtyMin.x || fowTexDirtyMax.y < fowTexDirtyMin.y) {
+		fowTexDirtyMin = Vec2i(minX, minY);
+		fowTexDirtyMax = Vec2i(maxX, maxY);
+	}
+	else {
+		fowTexDirtyMin = Vec2i(min(fowTexDirtyMin.x, minX), min(fowTexDirtyMin.y, minY));
+		fowTexDirtyMax = Vec2i(max(fowTexDirtyMax.x, maxX), max(fowTexDirtyMax.y, maxY));
+	}
+}
+
 void Minimap::computeTexture(const World *world) {
 
 	Vec3f color;
@@ -322,6 +417,7 @@ void Minimap::loadGame(const XmlNode *rootNode) {
 			int pixelIndex = fowPixmap1Node->getAttribute("index")->getIntValue();
 			fowPixmap1->getPixels()[pixelIndex] = fowPixmap1Node->getAttribute("pixel")->getIntValue();
 		}
+		setFowBlendAll();
 	}
 }
 
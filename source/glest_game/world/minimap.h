@@ -60,6 +60,14 @@ private:
 	bool fogOfWar;
 	const GameSettings *gameSettings;
 
+	// cells where fowPixmap1 may still differ from the fow texture, only this
+	// area is blended by updateFowTex (empty when max < min)
+	Vec2i fowBlendMin;
+	Vec2i fowBlendMax;
+	// area of the fow texture changed since the renderer last uploaded it
+	mutable Vec2i fowTexDirtyMin;
+	mutable Vec2i fowTexDirtyMax;
+
 private:
 	static const float exploredAlpha;
 
@@ -70,6 +78,8 @@ public:
 
 	const Texture2D *getFowTexture() const	{return fowTex;}
 	const Texture2D *getTexture() const		{return tex;}
+	bool getFowTexDirtyRect(Vec2i &pos, Vec2i &size) const;
+	void clearFowTexDirtyRect() const;
 
 	void incFowTextureAlphaSurface(const Vec2i sPos, float alpha, bool isIncrementalUpdate=false);
 	void resetFowTex();
@@ -87,6 +97,10 @@ public:
 
 private:
 	void computeTexture(const World *world);
+
+	void setFowBlendAll();
+	void addFowBlendCell(int x, int y);
+	void addFowTexDirtyRect(int minX, int minY, int maxX, int maxY);
 };
 
 }}//end namespace
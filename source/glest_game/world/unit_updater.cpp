@@ -1829,7 +1829,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 							//if resource exausted, then delete it and stop
 							if (sc->decAmount(1)) {
 								//const ResourceType *rt = r->getType();
-								sc->deleteResource();
+								map->deleteResource(Map::toSurfCoords(unitTargetPos));
 								world->removeResourceTargetFromCache(unitTargetPos);
 
 								switch(this->game->getGameSettings()->getPathFinderType()) {
@@ -2807,9 +2807,19 @@ void UnitUpdater::startAttackParticleSystem(Unit *unit, float lastAnimProgress,
 bool UnitUpdater::searchForResource(Unit *unit, const HarvestCommandType *hct) {
     Vec2i pos= unit->getCurrCommand()->getPos();
 
+    //nothing harvestable anywhere in the search square
+    if(map->hasHarvestableResourceInArea(hct,
+    		pos - Vec2i(maxResSearchRadius - 1), pos + Vec2i(maxResSearchRadius - 1)) == false) {
+    	return false;
+    }
+
     for(int radius= 0; radius < maxResSearchRadius; radius++) {
         for(int i = pos.x - radius; i <= pos.x + radius; ++i) {
-            for(int j=pos.y - radius; j <= pos.y + radius; ++j) {
+        	//inner cells were already checked by the smaller radii
+        	const bool edgeColumn= (i == pos.x - radius || i == pos.x + radius);
+        	const int stepY= (edgeColumn == true || radius == 0 ? 1 : radius * 2);
+
+            for(int j=pos.y - radius; j <= pos.y + radius; j += stepY) {
 				if(map->isInside(i, j)) {
 					Resource *r= map->getSurfaceCell(Map::toSurfCoords(Vec2i(i, j)))->getResource();
                     if(r != NULL) {
@@ -1109,6 +1109,11 @@ const UnitType* World::findUnitTypeById(const FactionType* factionType, int id)
 	if(factionType == NULL) {
 		throw megaglest_runtime_error("factionType == NULL");
 	}
+	// unit type ids are their position in the faction type
+	if(id >= 0 && id < factionType->getUnitTypeCount() &&
+		factionType->getUnitType(id)->getId() == id) {
+		return factionType->getUnitType(id);
+	}
 	for(int i= 0; i < factionType->getUnitTypeCount(); ++i) {
 		const UnitType *unitType = factionType->getUnitType(i);
 		if(unitType != NULL && unitType->getId() == id) {
@@ -1575,16 +1580,17 @@ void World::giveProductionCommand(int unitId, const string &producedName) {
 		//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
 
 		const UnitType *ut= unit->getType();
+		// resolve the name once, the commands are then matched by type
+		const UnitType *producedType= unit->getFaction()->getType()->findUnitType(producedName);
 
 		//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
 
 		//Search for a command that can produce the unit
-		for(int i= 0; i< ut->getCommandTypeCount(); ++i) {
+		for(int i= 0; producedType != NULL && i< ut->getCommandTypeCount(); ++i) {
 			const CommandType* ct= ut->getCommandType(i);
 			if(ct != NULL && ct->getClass() == ccProduce) {
 				const ProduceCommandType *pct= dynamic_cast<const ProduceCommandType*>(ct);
-				if(pct != NULL && pct->getProducedUnit() != NULL &&
-					pct->getProducedUnit()->getName(false) == producedName) {
+				if(pct != NULL && pct->getProducedUnit() == producedType) {
 					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 					//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
@@ -1766,13 +1772,14 @@ void World::giveUpgradeCommand(int unitId, const string &upgradeName) {
 	Unit *unit= findUnitById(unitId);
 	if(unit != NULL) {
 		const UnitType *ut= unit->getType();
+		const UpgradeType *upgradeType= unit->getFaction()->getType()->findUpgradeType(upgradeName);
 
 		//Search for a command that can produce the unit
-		for(int i= 0; i < ut->getCommandTypeCount(); ++i) {
+		for(int i= 0; upgradeType != NULL && i < ut->getCommandTypeCount(); ++i) {
 			const CommandType* ct= ut->getCommandType(i);
 			if(ct != NULL && ct->getClass() == ccUpgrade) {
 				const UpgradeCommandType *uct= static_cast<const UpgradeCommandType*>(ct);
-				if(uct != NULL && uct->getProducedUpgrade()->getName() == upgradeName) {
+				if(uct != NULL && uct->getProducedUpgrade() == upgradeType) {
 					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 					unit->giveCommand(new Command(uct));
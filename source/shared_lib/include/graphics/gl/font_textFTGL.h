@@ -15,6 +15,7 @@
 #ifdef USE_FTGL
 
 #include <FTGL/ftgl.h>
+#include <map>
 
 #include "font_text.h"
 
@@ -47,10 +48,24 @@ public:
 	virtual float LineHeight(const wchar_t* = L" ", const int = -1);
 
 private:
+	// Cap on the number of distinct strings we keep layout and render lists
+	// for; console, labels and unit titles only ever show a few hundred
+	static const size_t maxCachedStrings = 1024;
+
 	FTFont *ftFont;
 	const char* fontFile;
 
+	// The same strings are measured and drawn every frame, so we keep their
+	// advance, the shared line height and (for texture fonts) a compiled
+	// display list of the glyph quads, keyed by the already bidi converted text
+	std::map<string,float> advanceCache;
+	float lineHeightCache;
+	string lineHeightCacheText;
+	std::map<string,unsigned int> renderListCache;
+	std::map<string,int> renderSeenCache;
+
 	void cleanupFont();
+	void clearCaches();
 };
 
 }}}//end namespace
@@ -24,6 +24,8 @@
 #include "model_gl.h"
 #include "texture_gl.h"
 #include "font_gl.h"
+#include "shader_gl.h"
+#include "shader_manager.h"
 #include "leak_dumper.h"
 
 namespace Shared{ namespace Graphics{ namespace Gl{
@@ -59,6 +61,12 @@ public:
 	//particles
 	virtual ParticleManager *newParticleManager()	{return new ParticleManager();}
 	virtual ParticleRenderer *newParticleRenderer()	{return new ParticleRendererGl();}
+
+	//shaders
+	virtual ShaderManager *newShaderManager()		{return new ShaderManager();}
+	virtual ShaderProgram *newShaderProgram()		{return new ShaderProgramGl();}
+	virtual VertexShader *newVertexShader()			{return new VertexShaderGl();}
+	virtual FragmentShader *newFragmentShader()		{return new FragmentShaderGl();}
 };
 
 }}}//end namespace
@@ -14,9 +14,16 @@
 
 #include "model_renderer.h"
 #include "model.h"
+#include "matrix.h"
 #include "opengl.h"
+#include <vector>
 #include "leak_dumper.h"
 
+namespace Shared { namespace Graphics {
+	class ShaderManager;
+	class ShaderProgram;
+}}
+
 namespace Shared { namespace Graphics { namespace Gl {
 
 // =====================================================
@@ -25,25 +32,72 @@ namespace Shared { namespace Graphics { namespace Gl {
 
 class ModelRendererGl: public ModelRenderer {
 private:
+	enum BlendProgramState {
+		bpsNotInitialized,
+		bpsUnavailable,
+		bpsReady
+	};
+
+	static const int nextVertexAttribute= 6;
+	static const int nextNormalAttribute= 7;
+	// the per instance model matrix takes four consecutive attributes
+	static const int instanceMatrixAttribute= 8;
+
+	static bool enableGpuInterpolation;
+	static bool enableInstancing;
+
 	bool rendering;
 	bool duplicateTexCoords;
 	int secondaryTexCoordUnit;
 	GLuint lastTexture;
 
+	// vertex program blending two key frames straight from the mesh VBOs
+	ShaderManager *blendShaderManager;
+	ShaderProgram *blendProgram;
+	BlendProgramState blendProgramState;
+	int blendLightCount;
+
+	// same vertex program with a per instance model matrix, drawn with ARB_draw_instanced
+	ShaderManager *instanceShaderManager;
+	ShaderProgram *instanceProgram;
+	BlendProgramState instanceProgramState;
+	GLuint instanceVBO;
+	int instanceCount;
+
 public:
 	ModelRendererGl();
+	virtual ~ModelRendererGl();
+
+	static void setEnableGpuInterpolation(bool enabled)	{enableGpuInterpolation= enabled;}
+	static bool getEnableGpuInterpolation()				{return enableGpuInterpolation;}
+	static void setEnableInstancing(bool enabled)		{enableInstancing= enabled;}
+	static bool getEnableInstancing()					{return enableInstancing;}
+
 	virtual void begin(bool renderNormals, bool renderTextures, bool renderColors, bool colorPickingMode, MeshCallback *meshCallback);
 	virtual void end();
 	virtual void render(Model *model,int renderMode=rmNormal);
 	virtual void renderNormalsOnly(Model *model);
+	// renders the model once per column major model matrix, all instances share
+	// the current interpolation state and mesh callback
+	void renderInstances(Model *model, const std::vector<Matrix4f> &transforms, int renderMode=rmNormal);
 
 	void setDuplicateTexCoords(bool duplicateTexCoords)			{this->duplicateTexCoords= duplicateTexCoords;}
 	void setSecondaryTexCoordUnit(int secondaryTexCoordUnit)	{this->secondaryTexCoordUnit= secondaryTexCoordUnit;}
 
 private:
 	
-	void renderMesh(Mesh *mesh,int renderMode=rmNormal);
+	void renderMesh(Mesh *mesh,int renderMode=rmNormal,const std::vector<Matrix4f> *transforms=NULL);
 	void renderMeshNormals(Mesh *mesh);
+
+	void initBlendProgram();
+	void endBlendProgram();
+	bool canBlendOnGpu(const Mesh *mesh) const;
+	void activateBlendProgram(const Mesh *mesh);
+
+	void initInstanceProgram();
+	void endInstanceProgram();
+	bool canInstanceOnGpu(const Mesh *mesh) const;
+	void activateInstanceProgram(const Mesh *mesh);
 };
 
 }}}//end namespace
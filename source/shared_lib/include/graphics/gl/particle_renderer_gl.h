@@ -12,7 +12,10 @@
 #ifndef _SHARED_GRAPHICS_GL_PARTICLERENDERERGL_H_
 #define _SHARED_GRAPHICS_GL_PARTICLERENDERERGL_H_
 
+#include <map>
+#include <vector>
 #include "particle_renderer.h"
+#include "opengl.h"
 #include "leak_dumper.h"
 
 namespace Shared{ namespace Graphics{ namespace Gl{
@@ -26,11 +29,30 @@ public:
 	static const int bufferSize = 1024;
 
 private:
+	// Billboards of all systems sharing a texture and blend mode, drawn with one call
+	class QuadBatch {
+	public:
+		std::vector<Vec3f> vertices;
+		std::vector<Vec4f> colors;
+	};
+	typedef std::map<GLuint, QuadBatch> QuadBatchMap;
+
 	bool rendering;
 	Vec3f vertexBuffer[bufferSize];
 	Vec2f texCoordBuffer[bufferSize];
 	Vec4f colorBuffer[bufferSize];
 
+	// Additive quads can be drawn in any order so they are grouped per texture,
+	// alpha blended quads are only merged while consecutive systems share a texture.
+	// Only one of the two is pending at a time so the draw order is preserved.
+	QuadBatchMap additiveQuadBatches;
+	QuadBatch blendQuadBatch;
+	GLuint blendQuadBatchTexture;
+	std::vector<Vec2f> quadTexCoords;
+
+	Vec3f rightVector;
+	Vec3f upVector;
+
 public:
 	//particles
 	ParticleRendererGl();
@@ -44,6 +66,9 @@ protected:
 	void renderBufferQuads(int quadCount);
 	void renderBufferLines(int lineCount);
 	void setBlendMode(ParticleSystem::BlendMode blendMode);
+
+	void flushQuadBatches();
+	void renderQuadBatch(QuadBatch &batch, GLuint textureHandle, ParticleSystem::BlendMode blendMode);
 };
 
 }}}//end namespace
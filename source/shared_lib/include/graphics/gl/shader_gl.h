@@ -84,6 +84,7 @@ public:
 	GLhandleARB getHandle() const			{return handle;}
 
 	virtual void load(const string &path);
+	virtual void loadCode(const string &pathInfo, const string &code);
 	virtual bool compile(string &messages);
 	virtual void end();
 };
@@ -29,6 +29,7 @@ protected:
 	GLuint frameBufferId;
 
 	static bool enableATIHacks;
+	static string compressedTextureCachePath;
 
 	void initRenderBuffer();
 	void initFrameBuffer();
@@ -40,6 +41,9 @@ public:
 
 	static void setEnableATIHacks(bool value) 	{ enableATIHacks = value; }
 	static bool getEnableATIHacks() 			{ return enableATIHacks; }
+	// folder holding driver compressed mip chains, empty disables the cache
+	static void setCompressedTextureCachePath(const string &value) 	{ compressedTextureCachePath = value; }
+	static string getCompressedTextureCachePath() 					{ return compressedTextureCachePath; }
 
 	GLuint getHandle() const				{return handle;}
 	GLuint getRenderBufferHandle() const	{return renderBufferId;}
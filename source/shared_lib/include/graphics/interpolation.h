@@ -25,29 +25,73 @@ namespace Shared{ namespace Graphics{
 
 class InterpolationData{
 private:
+	// Identifies the frame pair and blend factor last written into an
+	// interpolated buffer. Models are shared by every unit of a type, so
+	// units in the same animation phase can reuse the previous result.
+	class InterpolationKey {
+	public:
+		bool valid;
+		uint32 prevFrame;
+		uint32 nextFrame;
+		float localT;
+
+		InterpolationKey() : valid(false), prevFrame(0), nextFrame(0), localT(0.f) {}
+		bool matches(uint32 prevFrame, uint32 nextFrame, float localT) const {
+			return valid == true && this->prevFrame == prevFrame &&
+					this->nextFrame == nextFrame && this->localT == localT;
+		}
+	};
+
 	const Mesh *mesh;
 
 	Vec3f *vertices;
 	Vec3f *normals;
 
+	InterpolationKey verticesKey;
+	InterpolationKey normalsKey;
+
 	int raw_frame_ofs;
 
+	// Frame pair selected by the last update, used when the blend is done on the GPU
+	uint32 blendPrevFrame;
+	uint32 blendNextFrame;
+	float blendT;
+
+	// Set when only the frame state was updated and the cpu buffers are stale
+	bool verticesPending;
+	bool normalsPending;
+	float pendingT;
+	bool pendingCycle;
+
 	static bool enableInterpolation;
+	static int interpolationSteps;
 	
-	void update(const Vec3f* src, Vec3f* &dest, float t, bool cycle);
+	void setBlendState(uint32 prevFrame, uint32 nextFrame, float localT);
+	bool computeFrames(float t, bool cycle, uint32 &prevFrame, uint32 &nextFrame, float &localT) const;
+	void update(const Vec3f* src, Vec3f* &dest, InterpolationKey &key, float t, bool cycle);
 
 public:
+	static void lerpStream(const float *prev, const float *next, float *dest, uint32 floatCount, float t);
 	InterpolationData(const Mesh *mesh);
 	~InterpolationData();
 
 	static void setEnableInterpolation(bool enabled) { enableInterpolation = enabled; }
+	// Number of discrete blend positions between two key frames, 0 means exact
+	static void setInterpolationSteps(int steps) { interpolationSteps = (steps < 0 ? 0 : steps); }
+	static int getInterpolationSteps() { return interpolationSteps; }
 
 	const Vec3f *getVertices() const	{return !vertices || !enableInterpolation? mesh->getVertices()+raw_frame_ofs: vertices;}
 	const Vec3f *getNormals() const		{return !normals || !enableInterpolation? mesh->getNormals()+raw_frame_ofs: normals;}
 	
+	uint32 getBlendPrevFrame() const	{return blendPrevFrame;}
+	uint32 getBlendNextFrame() const	{return blendNextFrame;}
+	float getBlendT() const				{return blendT;}
+
 	void update(float t, bool cycle);
 	void updateVertices(float t, bool cycle);
 	void updateNormals(float t, bool cycle);
+	void updateFrameState(float t, bool cycle);
+	void resolvePendingUpdate();
 };
 
 }}//end namespace
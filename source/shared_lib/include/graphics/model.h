@@ -36,6 +36,31 @@ class ShadowVolumeData;
 class InterpolationData;
 class TextureManager;
 
+// =====================================================
+//	class ModelFileBuffer
+//
+//	A g3d file read into memory with a single read,
+//	meshes are parsed from it with fread/fseek like calls
+// =====================================================
+
+class ModelFileBuffer {
+private:
+	uint8 *data;
+	std::size_t size;
+	std::size_t position;
+
+public:
+	ModelFileBuffer();
+	~ModelFileBuffer();
+
+	bool loadFile(const string &path);
+	std::size_t read(void *dest, std::size_t itemSize, std::size_t itemCount);
+	int seek(long offset);
+
+	std::size_t getSize() const		{return size;}
+	std::size_t getPosition() const	{return position;}
+};
+
 // =====================================================
 //	class Mesh
 //
@@ -149,6 +174,7 @@ public:
 
 	void updateInterpolationData(float t, bool cycle);
 	void updateInterpolationVertices(float t, bool cycle);
+	void resolveInterpolationData();
 
 	Texture2D *loadMeshTexture(int meshIndex, int textureIndex, TextureManager *textureManager, string textureFile,
 								int textureChannelCount, bool &textureOwned,
@@ -156,11 +182,11 @@ public:
 								string sourceLoader="",string modelFile="");
 
 	//load
-	void loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
+	void loadV2(int meshIndex, const string &dir, ModelFileBuffer *f, TextureManager *textureManager,
 			bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList=NULL,string sourceLoader="",string modelFile="");
-	void loadV3(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
+	void loadV3(int meshIndex, const string &dir, ModelFileBuffer *f, TextureManager *textureManager,
 			bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList=NULL,string sourceLoader="",string modelFile="");
-	void load(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList=NULL,string sourceLoader="",string modelFile="");
+	void load(int meshIndex, const string &dir, ModelFileBuffer *f, TextureManager *textureManager,bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList=NULL,string sourceLoader="",string modelFile="");
 	void save(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
 			string convertTextureToFormat, std::map<string,int> &textureDeleteList,
 			bool keepsmallest,string modelFile);
@@ -252,6 +252,30 @@ protected:
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
 	virtual bool deathTest(Particle *p);
+	virtual void updateParticles();
+
+	// Updates every alive particle and compacts the dead ones away. Concrete
+	// systems instantiate it with their own type so updateParticle() and
+	// deathTest() are bound statically and inlined into one loop per type
+	// instead of two virtual calls per particle.
+	template<typename SystemType>
+	void updateAliveParticles(SystemType *system) {
+		for(int i= 0; i < aliveParticleCount; ++i) {
+			Particle *p= &particles[i];
+			system->SystemType::updateParticle(p);
+
+			if(system->SystemType::deathTest(p)) {
+
+				//kill the particle
+				killParticle(p);
+
+				//maintain alive particles at front of the array
+				if(aliveParticleCount > 0) {
+					particles[i]= particles[aliveParticleCount];
+				}
+			}
+		}
+	}
 };
 
 // =====================================================
@@ -271,6 +295,7 @@ public:
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
+	virtual void updateParticles()	{updateAliveParticles(this);}
 
 	//set params
 	void setRadius(float radius);
@@ -405,6 +430,7 @@ public:
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
+	virtual void updateParticles()	{updateAliveParticles(this);}
 	virtual void update();
 	virtual bool getVisible() const;
 	virtual void fade();
@@ -474,6 +500,7 @@ public:
 
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual bool deathTest(Particle *p);
+	virtual void updateParticles()	{updateAliveParticles(this);}
 
 	void setRadius(float radius);
 	void setWind(float windAngle, float windSpeed);
@@ -499,6 +526,7 @@ public:
 
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual bool deathTest(Particle *p);
+	virtual void updateParticles()	{updateAliveParticles(this);}
 
 	void setRadius(float radius);
 	void setWind(float windAngle, float windSpeed);
@@ -584,6 +612,7 @@ public:
 	virtual void update();
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
+	virtual void updateParticles()	{updateAliveParticles(this);}
 	
 	void setTrajectory(Trajectory trajectory)				{this->trajectory= trajectory;}
 	void setTrajectorySpeed(float trajectorySpeed)			{this->trajectorySpeed= trajectorySpeed;}
@@ -628,6 +657,7 @@ public:
 	virtual void update();
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
+	virtual void updateParticles()	{updateAliveParticles(this);}
 	
 	virtual void initParticleSystem();
 
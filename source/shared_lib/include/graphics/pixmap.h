@@ -293,6 +293,7 @@ public:
 	void copy(const Pixmap2D *sourcePixmap);
 	void subCopy(int x, int y, const Pixmap2D *sourcePixmap);
 	void copyImagePart(int x, int y, const Pixmap2D *sourcePixmap);
+	void transferPixels(Pixmap2D *sourcePixmap);
 	string getPath() const		{ return path;}
 	std::size_t getPixelByteCount() const;
 
@@ -57,6 +57,7 @@ public:
 	virtual void end()= 0;
 
 	virtual void load(const string &path)= 0;
+	virtual void loadCode(const string &pathInfo, const string &code)= 0;
 	virtual bool compile(string &messages)= 0;
 };
 
@@ -80,6 +81,7 @@ public:
 	const string &getCode() const		{return code;}
 
 	void load(const string &path);
+	void loadCode(const string &pathInfo, const string &code);
 };
 
 }}//end namespace
@@ -15,6 +15,8 @@
 #include "data_types.h"
 #include "pixmap.h"
 #include <string>
+#include <map>
+#include <set>
 #include "leak_dumper.h"
 
 using std::string;
@@ -148,6 +150,39 @@ public:
 	std::pair<SDL_Surface*,unsigned char*> CreateSDLSurface(bool newPixelData) const;
 };
 
+// =====================================================
+//	class PixmapPreloadCache
+//
+/// Holds 2D pixmaps decoded ahead of time by background
+/// loader threads until Texture2D::load asks for them
+// =====================================================
+
+class PixmapPreloadCache {
+private:
+	struct DecodedPixmap {
+		Pixmap2D *pixmap;
+		int64 decodedMillis;
+	};
+
+	static bool enabled;
+	static std::map<string,DecodedPixmap> decodedList;
+	static std::set<string> decodingList;
+	static std::set<string> claimedList;
+
+	static string getKey(const string &path);
+
+public:
+	static void setEnabled(bool value);
+	static bool getEnabled();
+
+	static bool beginDecode(const string &path);
+	static void endDecode(const string &path, Pixmap2D *pixmap);
+	static std::size_t evictDecoded(std::size_t maxDecoded, int64 minAgeMillis);
+
+	static Pixmap2D * take(const string &path, int components);
+	static void clear();
+};
+
 // =====================================================
 //	class Texture3D
 // =====================================================
@@ -303,6 +303,19 @@ string getFullFileArchiveCompressCommand(const string &fileArchiveCompressComman
 		string fileArchiveCompressCommandParameters, const string &archivename, const string &archivefiles);
 
 bool executeShellCommand(string cmd,int expectedResult=IGNORE_CMD_RESULT_VALUE,ShellCommandOutputCallbackInterface *cb=NULL);
+
+// Forks sessionCount - 1 more processes that carry on from the caller with a
+// copy-on-write view of everything loaded so far. Only the calling thread
+// survives in the forked processes, so call it while no other thread runs.
+// Returns 0 in the calling process, which gets the others in sessionPids,
+// and the session index in each forked process. Not supported on Windows.
+int forkProcessSessions(int sessionCount, vector<int> &sessionPids);
+// Forgets sessions that have ended, or stops all of them and waits
+void reapProcessSessions(vector<int> &sessionPids, bool stopSessions);
+// Each session listens on its own copy of sessionPorts moved up by
+// sessionIndex times the returned stride, the smallest one for which no
+// two of sessionCount sessions share a port
+int getSessionPortStride(const vector<int> &sessionPorts, int sessionCount);
 string executable_path(const string &exeName,bool includeExeNameInPath=false);
 
 void saveDataToFile(string filename, const string &data);
@@ -14,6 +14,9 @@
 #include "base_thread.h"
 #include <vector>
 #include <string>
+#include <map>
+#include <set>
+#include <deque>
 #include "util.h"
 #include "texture.h"
 #include "leak_dumper.h"
@@ -67,6 +70,106 @@ public:
 	bool getPauseForGame();
 };
 
+// =====================================================
+//	class PixmapPreloadThread
+//
+/// Decodes image files into the PixmapPreloadCache while
+/// the main thread is busy loading xml, models and sounds.
+/// Worker N of M handles files N, N+M, N+2M... so that files
+/// early in the list are ready first.
+// =====================================================
+
+class PixmapPreloadThread : public BaseThread
+{
+protected:
+	vector<string> fileList;
+	unsigned int workerIndex;
+	unsigned int workerCount;
+	unsigned int maxDecodedPending;
+
+public:
+	PixmapPreloadThread(const vector<string> &fileList, unsigned int workerIndex,
+			unsigned int workerCount, unsigned int maxDecodedPending);
+	virtual ~PixmapPreloadThread();
+
+	virtual void execute();
+	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
+
+	static bool isPreloadableFile(const string &file);
+};
+
+// =====================================================
+//	class ContentCatalogThread
+//
+//	Computes folder tree checksums in the background so the
+//	lobby can look them up without blocking the UI. Lookups
+//	that miss are queued ahead of prefetched entries. On Linux
+//	the folders of every computed entry are watched with
+//	inotify and recomputed when their files change.
+//	getChangeSerial() moves whenever a checksum becomes ready
+//	or changes value, callers poll it to refresh what they
+//	have published.
+// =====================================================
+
+class ContentCatalogThread : public BaseThread
+{
+protected:
+	class CatalogEntry {
+	public:
+		vector<string> paths;
+		string pathSearchString;
+		string filterFileExt;
+		uint32 checksum;
+		bool ready;
+		bool queued;
+		bool forceNoCache;
+		bool watched;
+		// Moves with every forced refresh, a scan that overlaps
+		// one is stale and its result is dropped
+		unsigned int refreshGeneration;
+
+		CatalogEntry() : checksum(0), ready(false), queued(false),
+						forceNoCache(false), watched(false), refreshGeneration(0) {}
+	};
+
+	Mutex *mutexCatalog;
+	Semaphore semaphoreWork;
+	std::map<string,CatalogEntry> entries;
+	std::deque<string> pendingKeys;
+	unsigned int changeSerial;
+
+	// Only touched by the worker thread
+	int watchHandle;
+	std::map<int,std::set<string> > watchKeys;
+	std::map<int,string> watchPaths;
+
+	static string getEntryKey(const vector<string> &paths, const string &pathSearchString, const string &filterFileExt);
+	void queueEntry(const string &key, const vector<string> &paths, const string &pathSearchString,
+					const string &filterFileExt, bool forceNoCache, bool urgent);
+	bool processNextEntry();
+	void addWatches(const string &key, const CatalogEntry &entry);
+	void addWatchesRecursively(const string &path, const string &key);
+	void checkForChanges();
+
+public:
+	ContentCatalogThread();
+	virtual ~ContentCatalogThread();
+
+	virtual void execute();
+	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
+	virtual void signalQuit();
+
+	// Returns true with the checksum when it is ready, otherwise
+	// queues it ahead of the prefetched entries and returns false
+	bool findChecksum(const vector<string> &paths, const string &pathSearchString,
+					const string &filterFileExt, uint32 &checksum);
+	// Queues a checksum behind the pending lookups; forceNoCache
+	// drops the current value and bypasses the CRC caches
+	void prefetchChecksum(const vector<string> &paths, const string &pathSearchString,
+					const string &filterFileExt, bool forceNoCache=false);
+	unsigned int getChangeSerial();
+};
+
 // =====================================================
 //	class SimpleTaskThread
 // =====================================================
@@ -0,0 +1,175 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_PLATFORMCOMMON_CONTENTTRANSFER_H_
+#define _SHARED_PLATFORMCOMMON_CONTENTTRANSFER_H_
+
+#include "base_thread.h"
+#include <vector>
+#include <string>
+#include <map>
+#include "data_types.h"
+#include "socket.h"
+
+#include "leak_dumper.h"
+
+using namespace std;
+
+namespace Shared { namespace PlatformCommon {
+
+// =====================================================
+//	Content transfer
+//
+//	Sends maps, tilesets and techtrees from a game server
+//	to its clients without archiving whole folders. The
+//	client asks for the manifest of an item (every file with
+//	its size and CRC), compares it with its own copy and only
+//	fetches the files that are missing or differ. Files come
+//	in compressed chunks and are written to a .part file, so
+//	a broken connection resumes where it stopped.
+// =====================================================
+
+enum ContentTransferType {
+	ctt_Map			= 0,
+	ctt_Tileset		= 1,
+	ctt_Techtree	= 2
+};
+
+enum ContentTransferStatus {
+	cts_Ok			= 0,
+	cts_NotFound	= 1,
+	cts_Denied		= 2,
+	cts_Changed		= 3
+};
+
+class ContentManifestEntry {
+public:
+	string path;	// relative to the item folder, '/' separated
+	uint32 size;
+	uint32 crc;
+
+	ContentManifestEntry() : size(0), crc(0) {}
+	ContentManifestEntry(const string &path, uint32 size, uint32 crc) :
+		path(path), size(size), crc(crc) {}
+};
+
+// =====================================================
+//	class ContentManifest
+// =====================================================
+
+class ContentManifest {
+protected:
+	vector<ContentManifestEntry> entries;
+
+public:
+	// useCachedCRCs reuses the CRC lists kept for the lobby,
+	// the receiving side always rescans what it has on disk
+	static ContentManifest buildFromFolder(const string &rootFolder, bool useCachedCRCs);
+	static ContentManifest buildFromFile(const string &file, bool useCachedCRCs);
+	static bool isSafePath(const string &path);
+
+	void addEntry(const ContentManifestEntry &entry) { entries.push_back(entry); }
+	const vector<ContentManifestEntry> & getEntries() const { return entries; }
+	const ContentManifestEntry * findEntry(const string &path) const;
+
+	// Entries of this manifest that local is missing or has with another CRC
+	vector<ContentManifestEntry> getChangedEntries(const ContentManifest &local) const;
+	// Files of local that this manifest doesn't have
+	vector<string> getExtraFiles(const ContentManifest &local) const;
+
+	void encode(vector<unsigned char> &buf) const;
+	bool decode(const unsigned char *buf, unsigned int size);
+};
+
+// =====================================================
+//	class ContentTransferServerThread
+//
+//	Serves manifests and chunks to the clients accepted by
+//	the validation interface. One thread answers every
+//	connection in turn, each request is at most one chunk.
+//	A request is only read once all of it has arrived, and
+//	a client that leaves one unfinished for too long is
+//	dropped.
+// =====================================================
+
+class ContentTransferServerThread : public BaseThread
+{
+protected:
+	std::pair<string,string> mapsPath;
+	std::pair<string,string> tilesetsPath;
+	std::pair<string,string> techtreesPath;
+	int portNumber;
+	FTPClientValidationInterface *validationIntf;
+
+	ServerSocket *serverSocket;
+	vector<Socket *> clientSockets;
+	// When the unfinished request of each client started to arrive
+	std::map<Socket *,time_t> partialRequestTimes;
+
+	string getItemPath(ContentTransferType type, const string &name) const;
+	bool isClientAllowed(Socket *socket);
+	bool isRequestComplete(Socket *socket);
+	bool processRequest(Socket *socket);
+
+public:
+	ContentTransferServerThread(std::pair<string,string> mapsPath,
+			std::pair<string,string> tilesetsPath, std::pair<string,string> techtreesPath,
+			int portNumber, FTPClientValidationInterface *validationIntf);
+	virtual ~ContentTransferServerThread();
+
+	virtual void execute();
+	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
+
+	// Port to use next to the embedded FTP server and its data ports
+	static int getDefaultPort(int ftpServerPort, int maxPlayers) { return ftpServerPort + maxPlayers + 1; }
+};
+
+// =====================================================
+//	class ContentTransferClient
+// =====================================================
+
+class ContentTransferProgressInterface {
+public:
+	virtual ~ContentTransferProgressInterface() {}
+	// Return false to abort the transfer
+	virtual bool ContentTransfer_Progress(const string &itemName, double bytesDone, double bytesTotal) = 0;
+};
+
+class ContentTransferClient {
+protected:
+	string serverIp;
+	int portNumber;
+	int maxConnectAttempts;
+	ContentTransferProgressInterface *progressIntf;
+	ClientSocket *socket;
+
+	bool connect();
+	void disconnect();
+	bool exchange(const vector<unsigned char> &request, vector<unsigned char> &response);
+	bool fetchFile(ContentTransferType type, const string &name, const string &destFolder,
+					const ContentManifestEntry &entry, double &bytesDone, double bytesTotal,
+					string &error);
+
+public:
+	static const uint32 chunkSize = 65536;
+
+	ContentTransferClient(const string &serverIp, int portNumber,
+						ContentTransferProgressInterface *progressIntf=NULL);
+	virtual ~ContentTransferClient();
+
+	void setMaxConnectAttempts(int value) { maxConnectAttempts = value; }
+
+	// Brings destFolder (or, for maps, the destFolder/name file
+	// the server reports) in line with the server's copy
+	bool fetch(ContentTransferType type, const string &name, const string &destFolder, string &error);
+};
+
+}}//end namespace
+
+#endif
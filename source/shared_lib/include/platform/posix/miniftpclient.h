@@ -16,6 +16,7 @@
 #include <vector>
 #include <string>
 #include "platform_common.h"
+#include "content_transfer.h"
 #include "leak_dumper.h"
 
 using namespace std;
@@ -63,10 +64,12 @@ public:
     										 void *userdata) = 0;
 };
 
-class FTPClientThread : public BaseThread, public ShellCommandOutputCallbackInterface
+class FTPClientThread : public BaseThread, public ShellCommandOutputCallbackInterface,
+                        public ContentTransferProgressInterface
 {
 protected:
     int portNumber;
+    int contentTransferPort;
     string serverUrl;
     FTPClientCallbackInterface *pCBObject;
     std::pair<string,string> mapsPath;
@@ -127,6 +130,12 @@ protected:
     virtual void * getShellCommandOutput_UserData(string cmd);
     virtual void ShellCommandOutput_CallbackEvent(string cmd,char *output,void *userdata);
 
+    // Game server downloads try the content transfer port before the archives
+    pair<FTP_Client_ResultType,string> getContentFromServer(ContentTransferType contentType,
+    		FTP_Client_CallbackType downloadType, string itemName, string destFolder);
+    FTP_Client_CallbackType contentTransferDownloadType;
+    virtual bool ContentTransfer_Progress(const string &itemName, double bytesDone, double bytesTotal);
+
 public:
 
     FTPClientThread(int portNumber,string serverUrl,
@@ -151,6 +160,9 @@ public:
     void addFileToRequests(string fileName,string URL="");
     void addTempFileToRequests(string fileName,string URL="");
 
+    // 0 turns the content transfer off
+    void setContentTransferPort(int value) { contentTransferPort = value; }
+
     FTPClientCallbackInterface * getCallBackObject();
     void setCallBackObject(FTPClientCallbackInterface *value);
 
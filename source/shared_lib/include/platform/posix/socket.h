@@ -42,6 +42,8 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #include <map>
+#include <set>
+#include <deque>
 #include <vector>
 #include "base_thread.h"
 #include "simple_threads.h"
@@ -126,6 +128,8 @@ public:
 };
 #endif
 
+class SimulatedLatencySocketThread;
+
 class Socket {
 
 protected:
@@ -155,6 +159,17 @@ protected:
 	static string host_name;
 	static std::vector<string> intfTypes;
 
+	// Data held back by the simulated latency shim, oldest first,
+	// paired with the time in milliseconds it may go out
+	std::deque<std::pair<int64,std::vector<char> > > simulatedLatencyQueue;
+
+	static int simulatedLatencyMillis;
+	static Mutex simulatedLatencySynchAccessor;
+	static std::set<Socket *> simulatedLatencySockets;
+	static SimulatedLatencySocketThread *simulatedLatencyThread;
+
+	int sendImmediate(const void *data, int dataSize);
+
 public:
 	Socket(PLATFORM_SOCKET sock);
 	Socket();
@@ -173,6 +188,13 @@ public:
 	static void setBroadCastPort(int value) { broadcast_portno = value; }
 	static std::vector<std::string> getLocalIPAddressList();
 
+	// Test aid: when > 0 every send is held back this many milliseconds
+	// before it goes on the wire, to try lag handling over loopback
+	static void setSimulatedLatencyMillis(int value);
+	static int getSimulatedLatencyMillis() { return simulatedLatencyMillis; }
+	static void flushSimulatedLatencyQueues();
+	static void stopSimulatedLatencyThread();
+
     // Int lookup is socket fd while bool result is whether or not that socket was signalled for reading
     static bool hasDataToRead(std::map<PLATFORM_SOCKET,bool> &socketTriggeredList);
     static bool hasDataToRead(PLATFORM_SOCKET socket);
@@ -187,6 +209,9 @@ public:
 
 	int getDataToRead(bool wantImmediateReply=false);
 	int send(const void *data, int dataSize);
+	// Sends only what the socket takes right away, returns the bytes
+	// sent (0 while its buffer is full) or -1 on error
+	int sendWithoutWait(const void *data, int dataSize);
 	int receive(void *data, int dataSize, bool tryReceiveUntilDataSizeMet);
 	int peek(void *data, int dataSize, bool mustGetData=true,int *pLastSocketError=NULL);
 
@@ -227,6 +252,60 @@ public:
 	void Restore();
 };
 
+class SimulatedLatencySocketThread : public BaseThread
+{
+public:
+	SimulatedLatencySocketThread();
+    virtual void execute();
+};
+
+// =====================================================
+//	class SocketReadReactor
+//
+//	Waits for read readiness of the watched sockets with
+//	edge triggered epoll and signals the semaphore each
+//	socket was watched with. A socket is added to epoll
+//	once and leaves it when it is closed. Only built on
+//	Linux, elsewhere watchSocket() returns false and callers
+//	keep using hasDataToReadWithWait().
+// =====================================================
+
+class SocketReadReactor : public BaseThread
+{
+private:
+	static Mutex reactorAccessor;
+	static SocketReadReactor *reactor;
+
+	class Listener {
+	public:
+		Socket *socket;
+		PLATFORM_SOCKET socketId;
+
+		Listener() : socket(NULL), socketId(0) {}
+	};
+
+	int epollFd;
+	std::map<Semaphore *,Listener> listeners;
+
+	SocketReadReactor();
+	void removeListener(Semaphore *readySignal);
+	void removeSocketId(PLATFORM_SOCKET socketId);
+
+public:
+	virtual ~SocketReadReactor();
+    virtual void execute();
+
+	static bool isAvailable();
+	// Signal readySignal whenever new data arrives on socket, watching
+	// another socket with the same semaphore replaces the old one.
+	// Watching the same socket again does nothing.
+	static bool watchSocket(Semaphore *readySignal, Socket *socket);
+	static void unwatchSocket(Semaphore *readySignal);
+	// Called by the socket before it closes its descriptor
+	static void unwatchSocket(Socket *socket);
+	static void shutdownReactor();
+};
+
 class BroadCastClientSocketThread : public BaseThread
 {
 private:
@@ -325,6 +404,12 @@ public:
 	static void setFTPServerPort(int port) { ftpServerPort = port; }
 	static int getFTPServerPort() { return ftpServerPort; }
 
+	// Every port a hosted game listens on: the game port, the FTP port with
+	// one passive data port per player after it, the content transfer port
+	// and the admin and spectator ports
+	static vector<int> getHostedGamePorts(int gamePort, int ftpPort, int maxPlayers,
+	                                      int adminPort, int spectatorPort);
+
 	virtual void disconnectSocket();
 
     void NETdiscoverUPnPDevices();
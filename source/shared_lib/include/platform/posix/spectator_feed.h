@@ -0,0 +1,193 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_PLATFORMCOMMON_SPECTATORFEED_H_
+#define _SHARED_PLATFORMCOMMON_SPECTATORFEED_H_
+
+#include "base_thread.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include "data_types.h"
+#include "socket.h"
+
+#include "leak_dumper.h"
+
+using namespace std;
+
+namespace Shared { namespace PlatformCommon {
+
+// =====================================================
+//	Spectator feed
+//
+//	Streams a running game to read-only spectators. The
+//	game publishes records: a snapshot a spectator can start
+//	from and, for every network frame, the commands the
+//	players gave. The feed holds every record back for the
+//	configured delay. A new spectator gets the newest snapshot
+//	that is old enough and then every frame after it. A relay
+//	is a spectator that also gets the later snapshots and
+//	serves its own spectators from them, so one game can fan
+//	out to more viewers than one server could feed.
+//
+//	Snapshots can be built by the feed thread itself from
+//	the frames it gets, so the game never waits for one.
+//	Such a snapshot comes after frames the game published
+//	while it was built; a spectator starting from it gets
+//	every frame past the snapshot's frame.
+//
+//	Each spectator gets what its connection takes without
+//	waiting, the rest stays in its backlog. One that falls too
+//	far behind is dropped rather than slowing the others down.
+// =====================================================
+
+enum SpectatorRecordType {
+	srt_Snapshot	= 1,
+	srt_Frame		= 2,
+	srt_End			= 3
+};
+
+enum SpectatorRole {
+	sr_Viewer		= 'V',
+	sr_Relay		= 'R'
+};
+
+class SpectatorRecord {
+public:
+	uint8 type;
+	int32 frame;
+	vector<unsigned char> payload;
+	int64 publishedMillis;	// local time, the delay counts from here
+
+	SpectatorRecord() : type(0), frame(0), publishedMillis(0) {}
+
+	// Snapshots carry compressed data
+	bool setPayloadData(const string &data);
+	bool getPayloadData(string &data) const;
+	bool loadPayloadFromFile(const string &file);
+	bool savePayloadToFile(const string &file) const;
+};
+
+// Builds snapshots on the feed thread, from the frames the game published
+class SpectatorSnapshotBuilderInterface {
+public:
+	virtual ~SpectatorSnapshotBuilderInterface() {}
+
+	virtual void SpectatorFeed_AddFrame(int32 frame, const vector<unsigned char> &payload) = 0;
+	virtual bool SpectatorFeed_BuildSnapshot(int32 frame, string &data) = 0;
+};
+
+class SpectatorFeedClient;
+
+// =====================================================
+//	class SpectatorFeedServerThread
+// =====================================================
+
+class SpectatorFeedServerThread : public BaseThread
+{
+protected:
+	class Spectator {
+	public:
+		Socket *socket;
+		SpectatorRole role;
+		bool helloReceived;
+		bool joined;
+		int64 nextSerial;
+		int32 snapshotFrame;	// of the newest snapshot sent
+		time_t connectedTime;
+		vector<unsigned char> backlog;	// records not yet taken by the socket
+
+		Spectator() : socket(NULL), role(sr_Viewer), helloReceived(false),
+			joined(false), nextSerial(0), snapshotFrame(0), connectedTime(0) {}
+	};
+
+	int portNumber;
+	int delaySeconds;
+	int maxSpectators;
+
+	string upstreamIp;
+	int upstreamPort;
+	SpectatorFeedClient *upstream;
+	time_t lastUpstreamAttempt;
+
+	SpectatorSnapshotBuilderInterface *snapshotBuilder;
+	int snapshotSeconds;
+	int64 builderSerial;	// next record to hand to the builder
+	int32 builderFrame;
+	bool builderHasNewFrames;
+	time_t lastSnapshotTime;
+
+	Mutex mutexRecords;
+	deque<SpectatorRecord> records;
+	int64 firstSerial;	// serial of records.front()
+	bool ended;
+	int64 endedMillis;
+	int spectatorCount;
+
+	ServerSocket *serverSocket;
+	vector<Spectator> spectators;
+
+	void acceptSpectators(bool wait);
+	bool receiveHello(Spectator &spectator);
+	void queueRecord(Spectator &spectator, const SpectatorRecord &record);
+	bool sendBacklog(Spectator &spectator);
+	int64 findFirstRecordAfter(int32 frame);
+	bool updateSpectator(Spectator &spectator, int64 releaseMillis);
+	void pruneRecords(int64 releaseMillis);
+	bool isDelivered(int64 releaseMillis);
+	void updateUpstream();
+	void updateSnapshot();
+
+public:
+	SpectatorFeedServerThread(int portNumber, int delaySeconds, int maxSpectators);
+	virtual ~SpectatorFeedServerThread();
+
+	// Serve the records of another feed instead of a local game
+	void setUpstream(const string &ip, int port);
+	// Build a snapshot every snapshotSeconds, and one right away.
+	// The feed deletes the builder.
+	void setSnapshotBuilder(SpectatorSnapshotBuilderInterface *builder, int snapshotSeconds);
+
+	void addRecord(SpectatorRecordType type, int32 frame, const vector<unsigned char> &payload);
+	// Once ended the thread stops by itself after the delayed
+	// records have gone out to the spectators
+	void endFeed();
+	bool isEnded();
+	int getSpectatorCount();
+
+	virtual void execute();
+	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
+};
+
+// =====================================================
+//	class SpectatorFeedClient
+// =====================================================
+
+class SpectatorFeedClient {
+protected:
+	string serverIp;
+	int portNumber;
+	SpectatorRole role;
+	ClientSocket *socket;
+
+public:
+	SpectatorFeedClient(const string &serverIp, int portNumber, SpectatorRole role=sr_Viewer);
+	virtual ~SpectatorFeedClient();
+
+	bool connect();
+	void disconnect();
+	bool isConnected();
+
+	// Reads the next record if it arrives within waitMillis
+	bool receiveRecord(SpectatorRecord &record, int waitMillis);
+};
+
+}}//end namespace
+
+#endif
@@ -33,8 +33,11 @@ const char  *GAME_ARGS[] = {
 	"--starthost",
 	"--headless-server-mode",
 	"--headless-server-status",
+	"--headless-server-sessions",
 	"--server-title",
 	"--use-ports",
+	"--spectate-game",
+	"--spectator-relay",
 
 	"--load-scenario",
 	"--load-mod",
@@ -117,8 +120,11 @@ enum GAME_ARG_TYPE {
 	GAME_ARG_SERVER,
 	GAME_ARG_MASTERSERVER_MODE,
 	GAME_ARG_MASTERSERVER_STATUS,
+	GAME_ARG_MASTERSERVER_SESSIONS,
 	GAME_ARG_SERVER_TITLE,
 	GAME_ARG_USE_PORTS,
+	GAME_ARG_SPECTATE_GAME,
+	GAME_ARG_SPECTATOR_RELAY,
 
 	GAME_ARG_LOADSCENARIO,
 	GAME_ARG_MOD,
@@ -247,6 +253,18 @@ void printParameterHelp(const char *argv0, bool foundInvalidArgs) {
 	printf("\n\n%s  ",GAME_ARGS[GAME_ARG_MASTERSERVER_STATUS]);
 	printf("\n\n                     \tCheck the current status of a headless server.");
 
+	printf("\n\n%s=x  ",GAME_ARGS[GAME_ARG_MASTERSERVER_SESSIONS]);
+	printf("\n\n                     \tUsed with %s, host x independent games from this",GAME_ARGS[GAME_ARG_MASTERSERVER_MODE]);
+	printf("\n\n                     \t    one invocation. The checksums of all tech trees,");
+	printf("\n\n                     \t    tilesets and maps are computed once, then each game");
+	printf("\n\n                     \t    runs in its own process forked from this one and");
+	printf("\n\n                     \t    listens on the ports of the first game moved up by");
+	printf("\n\n                     \t    the smallest step that keeps the games apart: 15 per");
+	printf("\n\n                     \t    game with the default game, FTP, content transfer,");
+	printf("\n\n                     \t    status and spectator ports.");
+	printf("\n\n                     \t    Only the first game reads from the local console and");
+	printf("\n\n                     \t    quitting it stops the other games.");
+
 	printf("\n\n%s=x,y,z  \tForce hosted games to listen internally on port",GAME_ARGS[GAME_ARG_USE_PORTS]);
 	printf("\n\n                     \t    x, externally on port y and for game status on port z.");
 	printf("\n\n                     \tWhere x is the internal port # on the local machine to");
@@ -258,6 +276,16 @@ void printParameterHelp(const char *argv0, bool foundInvalidArgs) {
 	printf("\n\n                     \t*NOTE: If enabled the FTP Server port #'s will be set");
 	printf("\n\n                     \t    to x+1 to x+9.");
 
+	printf("\n\n%s=x:y  \tWatch the game hosted at IP or hostname x through its",GAME_ARGS[GAME_ARG_SPECTATE_GAME]);
+	printf("\n\n                     \t    spectator feed on port y. Spectators don't take a");
+	printf("\n\n                     \t    player slot and can't give commands.");
+	printf("\n\n                     \t*NOTE: the host needs EnableSpectatorFeed=true.");
+
+	printf("\n\n%s=x:y  ",GAME_ARGS[GAME_ARG_SPECTATOR_RELAY]);
+	printf("\n\n                     \tRelay the spectator feed at IP or hostname x, port y,");
+	printf("\n\n                     \t    to more spectators on the SpectatorFeedPort of this");
+	printf("\n\n                     \t    machine. Runs without graphics until the game ends.");
+
 	printf("\n\n%s=x  \tSet server title.",GAME_ARGS[GAME_ARG_SERVER_TITLE]);
 
 	printf("\n\n%s=x  \tAuto load a scenario by scenario name.",GAME_ARGS[GAME_ARG_LOADSCENARIO]);
@@ -638,7 +666,8 @@ int mainSetup(int argc, char **argv) {
 	   hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_VERSION])) == true ||
 	   hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_SHOW_INI_SETTINGS])) == true ||
 	   hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_MASTERSERVER_MODE])) == true ||
-	   hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_MASTERSERVER_STATUS]))) {
+	   hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_MASTERSERVER_STATUS])) == true ||
+	   hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_SPECTATOR_RELAY]))) {
 	     // Use this for masterserver mode for timers like Chrono
 		 if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
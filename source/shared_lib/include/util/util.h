@@ -186,6 +186,8 @@ public:
 	static void globalCleanupHTTP();
 
     static bool getThreadedLoggerRunning();
+    // Stops the log writer thread, the next init() starts a new one
+    static void stopThreadedLogger();
     static std::size_t getLogEntryBufferCount();
 
 	// Let the macro call into this when require.. NEVER call it automatically.
@@ -126,6 +126,8 @@ public:
 
 	XmlNode *load(const string &path, const std::map<string,string> &mapTagReplacementValues,bool noValidation=false,bool skipStackTrace=false,bool skipUpdatePathClimbingParts=false);
 	void save(const string &path, const XmlNode *node);
+	void saveToString(string &xml, const XmlNode *node);
+	XmlNode *loadFromString(const string &xml, const std::map<string,string> &mapTagReplacementValues,bool skipUpdatePathClimbingParts=false);
 };
 
 // =====================================================
@@ -152,6 +154,8 @@ public:
 	void init(const string &name);
 	void load(const string &path, const std::map<string,string> &mapTagReplacementValues, bool noValidation=false,bool skipStackCheck=false,bool skipStackTrace=false);
 	void save(const string &path);
+	void saveToString(string &xml);
+	void loadFromString(const string &xml, const std::map<string,string> &mapTagReplacementValues);
 
 	XmlNode *getRootNode() const	{return rootNode;}
 };
@@ -34,7 +34,7 @@ string TextFTGL::langHeightText = "yW";
 int TextFTGL::faceResolution 	= 72;
 
 //====================================================================
-TextFTGL::TextFTGL(FontTextHandlerType type) : Text(type) {
+TextFTGL::TextFTGL(FontTextHandlerType type) : Text(type), lineHeightCache(-1) {
 
 	//throw megaglest_runtime_error("FTGL!");
 	//setenv("MEGAGLEST_FONT","/usr/share/fonts/truetype/wqy/wqy-zenhei.ttc",0);
@@ -112,7 +112,21 @@ TextFTGL::~TextFTGL() {
 	cleanupFont();
 }
 
+void TextFTGL::clearCaches() {
+	advanceCache.clear();
+	lineHeightCache = -1;
+
+	for(std::map<string,unsigned int>::iterator iterMap = renderListCache.begin();
+		iterMap != renderListCache.end(); ++iterMap) {
+		glDeleteLists(iterMap->second, 1);
+	}
+	renderListCache.clear();
+	renderSeenCache.clear();
+}
+
 void TextFTGL::cleanupFont() {
+	clearCaches();
+
 	delete ftFont;
 	ftFont = NULL;
 
@@ -209,6 +223,10 @@ void TextFTGL::init(string fontName, string fontFamilyName, int fontSize) {
 }
 
 void TextFTGL::SetFaceSize(int value) {
+	// Glyphs are rebuilt for a new size so cached metrics and lists are stale
+	if(ftFont->FaceSize() != (unsigned int)value) {
+		clearCaches();
+	}
 	ftFont->FaceSize(value,TextFTGL::faceResolution);
 
 	GLenum error = glGetError();
@@ -239,7 +257,40 @@ void TextFTGL::Render(const char* str, const int len) {
 		//printf("FTGL Render [%s] facesize = %d\n",str,ftFont->FaceSize());
 		assertGl();
 
-		ftFont->Render(str, len);
+		// Texture font glyphs live in FTGL's texture atlases, so once a string
+		// has been drawn once all of its glyphs exist and the quads can be
+		// recorded into a display list. Pixmap fonts bake the current raster
+		// colour into the pixel transfer state so they are never cached.
+		bool renderedFromCache = false;
+		if(type == ftht_3D && len < 0) {
+			string key = str;
+			std::map<string,unsigned int>::iterator iterFind = renderListCache.find(key);
+			if(iterFind != renderListCache.end()) {
+				glCallList(iterFind->second);
+				renderedFromCache = true;
+			}
+			else if(renderSeenCache[key]++ > 0) {
+				if(renderListCache.size() >= maxCachedStrings) {
+					clearCaches();
+				}
+				GLuint list = glGenLists(1);
+				if(list != 0) {
+					glNewList(list, GL_COMPILE_AND_EXECUTE);
+					ftFont->Render(str, len);
+					glEndList();
+
+					renderListCache[key] = list;
+					renderedFromCache = true;
+				}
+			}
+			else if(renderSeenCache.size() > maxCachedStrings) {
+				renderSeenCache.clear();
+			}
+		}
+
+		if(renderedFromCache == false) {
+			ftFont->Render(str, len);
+		}
 		//assertGl();
 		GLenum error = glGetError();
 		if(error != GL_NO_ERROR) {
@@ -256,6 +307,15 @@ void TextFTGL::Render(const char* str, const int len) {
 }
 
 float TextFTGL::Advance(const char* str, const int len) {
+	string key;
+	if(len < 0) {
+		key = str;
+		std::map<string,float>::iterator iterFind = advanceCache.find(key);
+		if(iterFind != advanceCache.end()) {
+			return iterFind->second;
+		}
+	}
+
 	float result = ftFont->Advance(str, len);
 
 	GLenum error = glGetError();
@@ -269,6 +329,13 @@ float TextFTGL::Advance(const char* str, const int len) {
 		snprintf(szBuf,8096,"FTGL: error trying to advance(b), #%d",ftFont->Error());
 		throw megaglest_runtime_error(szBuf);
 	}
+
+	if(len < 0) {
+		if(advanceCache.size() >= maxCachedStrings) {
+			advanceCache.clear();
+		}
+		advanceCache[key] = result;
+	}
 	return result;
 
 	//FTBBox box = ftFont->BBox(str);
@@ -304,6 +371,11 @@ float TextFTGL::LineHeight(const char* str, const int len) {
 	//return ftFont->Ascender() + ftFont->Descender()*-1 - ftFont->LineHeight();
 	//return ftFont->LineHeight();
 
+	// The height is always measured from langHeightText, not str
+	if(lineHeightCache >= 0 && lineHeightCacheText == TextFTGL::langHeightText) {
+		return lineHeightCache;
+	}
+
 	//static float result = -1000;
 	float result = -1000;
 	//if(result == -1000) {
@@ -355,6 +427,8 @@ float TextFTGL::LineHeight(const char* str, const int len) {
 		throw megaglest_runtime_error(szBuf);
 	}
 
+	lineHeightCache = result;
+	lineHeightCacheText = TextFTGL::langHeightText;
 	return result;
 //	printf("For str [%s] LineHeight = %f, result = %f\n",str, ftFont->LineHeight(),result);
 //	return result;
@@ -15,16 +15,115 @@
 #include "gl_wrap.h"
 #include "texture_gl.h"
 #include "interpolation.h"
+#include "shader_gl.h"
+#include "shader_manager.h"
+#include "graphics_interface.h"
+#include "graphics_factory.h"
+#include "util.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Platform;
+using namespace Shared::Util;
 
 namespace Shared { namespace Graphics { namespace Gl {
 
+// Blends the two key frames selected by InterpolationData and reproduces the
+// fixed function transform, lighting (color material, directional and
+// attenuated point lights), fog coordinate, team color coordinates and the
+// eye linear texgen used by shadow mapping. There is no fragment shader so
+// texturing and fog stay fixed function. With INSTANCED defined the vertex
+// is first moved by a per instance model matrix.
+static const char *keyframeBlendVertexShader=
+	"uniform float blendT;\n"
+	"uniform int lightCount;\n"
+	"uniform int lightingEnabled;\n"
+	"uniform int colorMaterialEnabled;\n"
+	"attribute vec3 nextVertex;\n"
+	"attribute vec3 nextNormal;\n"
+	"#ifdef INSTANCED\n"
+	"attribute vec4 instanceMatrix0;\n"
+	"attribute vec4 instanceMatrix1;\n"
+	"attribute vec4 instanceMatrix2;\n"
+	"attribute vec4 instanceMatrix3;\n"
+	"#endif\n"
+	"\n"
+	"void main() {\n"
+	"	vec4 vertex= vec4(mix(gl_Vertex.xyz, nextVertex, blendT), 1.0);\n"
+	"	vec3 objectNormal= mix(gl_Normal, nextNormal, blendT);\n"
+	"#ifdef INSTANCED\n"
+	"	vertex= mat4(instanceMatrix0, instanceMatrix1, instanceMatrix2, instanceMatrix3) * vertex;\n"
+	"	objectNormal= mat3(instanceMatrix0.xyz, instanceMatrix1.xyz, instanceMatrix2.xyz) * objectNormal;\n"
+	"#endif\n"
+	"	vec3 normal= normalize(gl_NormalMatrix * objectNormal);\n"
+	"	vec4 eyeVertex= gl_ModelViewMatrix * vertex;\n"
+	"\n"
+	"	gl_Position= gl_ProjectionMatrix * eyeVertex;\n"
+	"	gl_FogFragCoord= abs(eyeVertex.z);\n"
+	"	gl_TexCoord[0]= gl_TextureMatrix[0] * gl_MultiTexCoord0;\n"
+	"	gl_TexCoord[1]= gl_TextureMatrix[1] * gl_MultiTexCoord1;\n"
+	"	gl_TexCoord[2]= gl_TextureMatrix[2] * vec4(dot(eyeVertex, gl_EyePlaneS[2]), dot(eyeVertex, gl_EyePlaneT[2]),\n"
+	"										dot(eyeVertex, gl_EyePlaneR[2]), dot(eyeVertex, gl_EyePlaneQ[2]));\n"
+	"\n"
+	"	if(lightingEnabled == 0) {\n"
+	"		gl_FrontColor= gl_Color;\n"
+	"		gl_BackColor= gl_Color;\n"
+	"		return;\n"
+	"	}\n"
+	"\n"
+	"	vec4 ambient= (colorMaterialEnabled != 0 ? gl_Color : gl_FrontMaterial.ambient);\n"
+	"	vec4 diffuse= (colorMaterialEnabled != 0 ? gl_Color : gl_FrontMaterial.diffuse);\n"
+	"	vec4 color= gl_FrontMaterial.emission + ambient * gl_LightModel.ambient;\n"
+	"	for(int i= 0; i < 8; ++i) {\n"
+	"		if(i >= lightCount) {\n"
+	"			break;\n"
+	"		}\n"
+	"		vec3 lightDir= gl_LightSource[i].position.xyz;\n"
+	"		float attenuation= 1.0;\n"
+	"		if(gl_LightSource[i].position.w != 0.0) {\n"
+	"			lightDir= gl_LightSource[i].position.xyz - eyeVertex.xyz;\n"
+	"			float dist= length(lightDir);\n"
+	"			attenuation= 1.0 / (gl_LightSource[i].constantAttenuation +\n"
+	"								gl_LightSource[i].linearAttenuation * dist +\n"
+	"								gl_LightSource[i].quadraticAttenuation * dist * dist);\n"
+	"		}\n"
+	"		lightDir= normalize(lightDir);\n"
+	"		float nDotL= max(dot(normal, lightDir), 0.0);\n"
+	"		vec4 lit= ambient * gl_LightSource[i].ambient + diffuse * gl_LightSource[i].diffuse * nDotL;\n"
+	"		if(nDotL > 0.0) {\n"
+	"			float nDotH= max(dot(normal, normalize(lightDir + vec3(0.0, 0.0, 1.0))), 0.0);\n"
+	"			lit+= gl_FrontMaterial.specular * gl_LightSource[i].specular * pow(nDotH, gl_FrontMaterial.shininess);\n"
+	"		}\n"
+	"		color+= lit * attenuation;\n"
+	"	}\n"
+	"	color.a= diffuse.a;\n"
+	"	gl_FrontColor= clamp(color, 0.0, 1.0);\n"
+	"	gl_BackColor= gl_FrontColor;\n"
+	"}\n";
+
 // =====================================================
-//	class MyClass
+//	class ModelRendererGl
 // =====================================================
 
+bool ModelRendererGl::enableGpuInterpolation= false;
+bool ModelRendererGl::enableInstancing= false;
+
+// Draws the bound mesh once, or once per model matrix when instancing is not available
+static void drawMeshElements(uint32 vertexCount, uint32 indexCount, const void *indices,
+		const std::vector<Matrix4f> *transforms) {
+	if(transforms == NULL) {
+		glDrawRangeElements(GL_TRIANGLES, 0, vertexCount-1, indexCount, GL_UNSIGNED_INT, indices);
+		return;
+	}
+
+	glMatrixMode(GL_MODELVIEW);
+	for(unsigned int i = 0; i < transforms->size(); ++i) {
+		glPushMatrix();
+		glMultMatrixf((*transforms)[i].ptr());
+		glDrawRangeElements(GL_TRIANGLES, 0, vertexCount-1, indexCount, GL_UNSIGNED_INT, indices);
+		glPopMatrix();
+	}
+}
+
 // ===================== PUBLIC ========================
 
 ModelRendererGl::ModelRendererGl() {
@@ -32,6 +131,22 @@ ModelRendererGl::ModelRendererGl() {
 	duplicateTexCoords= false;
 	secondaryTexCoordUnit= 1;
 	lastTexture=0;
+
+	blendShaderManager= NULL;
+	blendProgram= NULL;
+	blendProgramState= bpsNotInitialized;
+	blendLightCount= 0;
+
+	instanceShaderManager= NULL;
+	instanceProgram= NULL;
+	instanceProgramState= bpsNotInitialized;
+	instanceVBO= 0;
+	instanceCount= 0;
+}
+
+ModelRendererGl::~ModelRendererGl() {
+	endBlendProgram();
+	endInstanceProgram();
 }
 
 void ModelRendererGl::begin(bool renderNormals, bool renderTextures, bool renderColors,
@@ -79,6 +194,24 @@ void ModelRendererGl::begin(bool renderNormals, bool renderTextures, bool render
 		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	}
 
+	if(blendProgramState == bpsNotInitialized) {
+		initBlendProgram();
+	}
+	if(instanceProgramState == bpsNotInitialized) {
+		initInstanceProgram();
+	}
+	if(blendProgramState == bpsReady || instanceProgramState == bpsReady) {
+		// the renderer enables its lights from GL_LIGHT0 upwards
+		GLint maxLights= 0;
+		glGetIntegerv(GL_MAX_LIGHTS, &maxLights);
+		blendLightCount= 0;
+		for(int i = 0; i < maxLights && i < 8; ++i) {
+			if(glIsEnabled(GL_LIGHT0 + i) == GL_TRUE) {
+				blendLightCount= i + 1;
+			}
+		}
+	}
+
 /*
 	glHint( GL_LINE_SMOOTH_HINT, GL_FASTEST );
 	glHint( GL_FRAGMENT_SHADER_DERIVATIVE_HINT, GL_FASTEST );
@@ -139,6 +272,36 @@ void ModelRendererGl::render(Model *model,int renderMode) {
 	assertGl();
 }
 
+void ModelRendererGl::renderInstances(Model *model, const std::vector<Matrix4f> &transforms, int renderMode) {
+	//assertions
+	assert(rendering);
+	assertGl();
+
+	if(transforms.empty() == true) {
+		return;
+	}
+
+	// the matrices are uploaded once and shared by every mesh of the model
+	instanceCount= 0;
+	if(instanceProgramState == bpsReady && colorPickingMode == false && renderNormals == true) {
+		if(instanceVBO == 0) {
+			glGenBuffersARB(1, &instanceVBO);
+		}
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, instanceVBO);
+		glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(float) * 16 * transforms.size(), transforms[0].ptr(), GL_STREAM_DRAW_ARB);
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+		instanceCount= (int)transforms.size();
+	}
+
+	for(uint32 i = 0;  i < model->getMeshCount(); ++i) {
+		renderMesh(model->getMeshPtr(i),renderMode,&transforms);
+	}
+	instanceCount= 0;
+
+	//assertions
+	assertGl();
+}
+
 void ModelRendererGl::renderNormalsOnly(Model *model) {
 	//assertions
 	assert(rendering);
@@ -157,7 +320,7 @@ void ModelRendererGl::renderNormalsOnly(Model *model) {
 
 // ===================== PRIVATE =======================
 
-void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode) {
+void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode,const std::vector<Matrix4f> *transforms) {
 
 	if(renderMode==rmSelection && mesh->getNoSelect()==true)
 	{// don't render this and do nothing
@@ -221,22 +384,46 @@ void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode) {
 	//assertions
 	assertGl();
 
-	if(getVBOSupported() == true && mesh->getFrameCount() == 1) {
+	bool instanceOnGpu= (transforms != NULL && canInstanceOnGpu(mesh));
+	// the instance program blends the key frames itself
+	bool blendOnGpu= (instanceOnGpu == false && canBlendOnGpu(mesh));
+	bool framesOnGpu= (blendOnGpu == true || (instanceOnGpu == true && mesh->getFrameCount() > 1));
+	bool useVBOs= (getVBOSupported() == true && (mesh->getFrameCount() == 1 || framesOnGpu == true));
+
+	if(useVBOs == true) {
 		if(mesh->hasBuiltVBOEntities() == false) {
 			mesh->BuildVBOs();
 		}
 		//printf("Rendering Mesh with VBO's\n");
 
+		// all frames are packed one after the other in the vertex and normal buffers
+		char *prevFrameOffset= (char *) NULL;
+		char *nextFrameOffset= (char *) NULL;
+		if(framesOnGpu == true) {
+			const InterpolationData *interpolationData= mesh->getInterpolationData();
+			size_t frameSize= sizeof(Vec3f) * vertexCount;
+			prevFrameOffset+= frameSize * interpolationData->getBlendPrevFrame();
+			nextFrameOffset+= frameSize * interpolationData->getBlendNextFrame();
+		}
+
 		//vertices
 		glBindBufferARB( GL_ARRAY_BUFFER_ARB, mesh->getVBOVertices() );
-		glVertexPointer( 3, GL_FLOAT, 0, (char *) NULL );		// Set The Vertex Pointer To The Vertex Buffer
+		glVertexPointer( 3, GL_FLOAT, 0, prevFrameOffset );		// Set The Vertex Pointer To The Vertex Buffer
+		if(blendOnGpu == true || instanceOnGpu == true) {
+			glEnableVertexAttribArrayARB(nextVertexAttribute);
+			glVertexAttribPointerARB(nextVertexAttribute, 3, GL_FLOAT, GL_FALSE, 0, nextFrameOffset);
+		}
 		//glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
 
 		//normals
 		if(renderNormals) {
 			glBindBufferARB( GL_ARRAY_BUFFER_ARB, mesh->getVBONormals() );
 			glEnableClientState(GL_NORMAL_ARRAY);
-			glNormalPointer(GL_FLOAT, 0, (char *) NULL);
+			glNormalPointer(GL_FLOAT, 0, prevFrameOffset);
+			if(blendOnGpu == true || instanceOnGpu == true) {
+				glEnableVertexAttribArrayARB(nextNormalAttribute);
+				glVertexAttribPointerARB(nextNormalAttribute, 3, GL_FLOAT, GL_FALSE, 0, nextFrameOffset);
+			}
 			//glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
 		}
 		else{
@@ -274,6 +461,7 @@ void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode) {
 	}
 	else {
 		//printf("Rendering Mesh WITHOUT VBO's\n");
+		mesh->resolveInterpolationData();
 
 		//vertices
 		glVertexPointer(3, GL_FLOAT, 0, mesh->getInterpolationData()->getVertices());
@@ -311,14 +499,49 @@ void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode) {
 		}
 	}
 
-	if(getVBOSupported() == true && mesh->getFrameCount() == 1) {
+	if(useVBOs == true) {
 		assertGl();
 
+		if(blendOnGpu == true) {
+			activateBlendProgram(mesh);
+		}
+		else if(instanceOnGpu == true) {
+			activateInstanceProgram(mesh);
+
+			glBindBufferARB( GL_ARRAY_BUFFER_ARB, instanceVBO );
+			for(int i = 0; i < 4; ++i) {
+				glEnableVertexAttribArrayARB(instanceMatrixAttribute + i);
+				glVertexAttribPointerARB(instanceMatrixAttribute + i, 4, GL_FLOAT, GL_FALSE,
+						sizeof(float) * 16, (char *) NULL + sizeof(float) * 4 * i);
+				glVertexAttribDivisorARB(instanceMatrixAttribute + i, 1);
+			}
+		}
+
 		glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, mesh->getVBOIndexes() );
-		glDrawRangeElements(GL_TRIANGLES, 0, vertexCount-1, indexCount, GL_UNSIGNED_INT, (char *)NULL);
+		if(instanceOnGpu == true) {
+			glDrawElementsInstancedARB(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (char *)NULL, instanceCount);
+		}
+		else {
+			drawMeshElements(vertexCount, indexCount, (char *)NULL, transforms);
+		}
 		glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
 		glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
 
+		if(blendOnGpu == true) {
+			blendProgram->deactivate();
+			glDisableVertexAttribArrayARB(nextVertexAttribute);
+			glDisableVertexAttribArrayARB(nextNormalAttribute);
+		}
+		else if(instanceOnGpu == true) {
+			instanceProgram->deactivate();
+			for(int i = 0; i < 4; ++i) {
+				glVertexAttribDivisorARB(instanceMatrixAttribute + i, 0);
+				glDisableVertexAttribArrayARB(instanceMatrixAttribute + i);
+			}
+			glDisableVertexAttribArrayARB(nextVertexAttribute);
+			glDisableVertexAttribArrayARB(nextNormalAttribute);
+		}
+
 		//glDrawRangeElements(GL_TRIANGLES, 0, vertexCount-1, indexCount, GL_UNSIGNED_INT, mesh->getIndices());
 
 		assertGl();
@@ -327,7 +550,7 @@ void ModelRendererGl::renderMesh(Mesh *mesh,int renderMode) {
 		//draw model
 		assertGl();
 
-		glDrawRangeElements(GL_TRIANGLES, 0, vertexCount-1, indexCount, GL_UNSIGNED_INT, mesh->getIndices());
+		drawMeshElements(vertexCount, indexCount, mesh->getIndices(), transforms);
 	}
 
 	// glow
@@ -371,6 +594,7 @@ void ModelRendererGl::renderMeshNormals(Mesh *mesh) {
 	}
 	else {
 		//printf("Rendering Mesh Normals WITHOUT VBO's\n");
+		mesh->resolveInterpolationData();
 
 		glBegin(GL_LINES);
 		for(unsigned int i = 0; i < mesh->getIndexCount(); ++i) {
@@ -384,4 +608,176 @@ void ModelRendererGl::renderMeshNormals(Mesh *mesh) {
 	}
 }
 
+void ModelRendererGl::initBlendProgram() {
+	blendProgramState= bpsUnavailable;
+
+	if(enableGpuInterpolation == false || getVBOSupported() == false ||
+		isGlExtensionSupported("GL_ARB_shader_objects") == false ||
+		isGlExtensionSupported("GL_ARB_vertex_shader") == false) {
+		return;
+	}
+
+	try {
+		GraphicsFactory *factory= GraphicsInterface::getInstance().getFactory();
+		if(factory == NULL) {
+			return;
+		}
+		blendShaderManager= factory->newShaderManager();
+		if(blendShaderManager == NULL) {
+			return;
+		}
+
+		VertexShader *vertexShader= blendShaderManager->newVertexShader();
+		vertexShader->loadCode("keyframe_blend_vertex", keyframeBlendVertexShader);
+
+		blendProgram= blendShaderManager->newShaderProgram();
+		blendProgram->attach(vertexShader, NULL);
+		static_cast<ShaderProgramGl *>(blendProgram)->bindAttribute("nextVertex", nextVertexAttribute);
+		static_cast<ShaderProgramGl *>(blendProgram)->bindAttribute("nextNormal", nextNormalAttribute);
+
+		blendShaderManager->init();
+
+		// make sure every uniform survived compilation before the first mesh needs it
+		blendProgram->activate();
+		blendProgram->setUniform("blendT", 0.f);
+		blendProgram->setUniform("lightCount", 0);
+		blendProgram->setUniform("lightingEnabled", 0);
+		blendProgram->setUniform("colorMaterialEnabled", 0);
+		blendProgram->deactivate();
+
+		blendProgramState= bpsReady;
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("**INFO** Vertex interpolation is done on the GPU\n");
+	}
+	catch(const exception &ex) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		if(blendShaderManager != NULL) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"%s\n",blendShaderManager->getLogString().c_str());
+		}
+		printf("**WARNING** GPU vertex interpolation unavailable, falling back to the CPU: %s\n",ex.what());
+
+		glUseProgramObjectARB(0);
+		endBlendProgram();
+		blendProgramState= bpsUnavailable;
+	}
+}
+
+void ModelRendererGl::endBlendProgram() {
+	if(blendShaderManager != NULL) {
+		blendShaderManager->end();
+		delete blendShaderManager;
+		blendShaderManager= NULL;
+	}
+	blendProgram= NULL;
+}
+
+bool ModelRendererGl::canBlendOnGpu(const Mesh *mesh) const {
+	// color picking and normal-less passes keep using the cpu arrays
+	return (blendProgramState == bpsReady && colorPickingMode == false &&
+			renderNormals == true && mesh->getFrameCount() > 1 &&
+			mesh->getInterpolationData() != NULL);
+}
+
+void ModelRendererGl::activateBlendProgram(const Mesh *mesh) {
+	blendProgram->activate();
+	blendProgram->setUniform("blendT", mesh->getInterpolationData()->getBlendT());
+	blendProgram->setUniform("lightCount", blendLightCount);
+	blendProgram->setUniform("lightingEnabled", (glIsEnabled(GL_LIGHTING) == GL_TRUE ? 1 : 0));
+	blendProgram->setUniform("colorMaterialEnabled", (glIsEnabled(GL_COLOR_MATERIAL) == GL_TRUE ? 1 : 0));
+}
+
+void ModelRendererGl::initInstanceProgram() {
+	instanceProgramState= bpsUnavailable;
+
+	if(enableInstancing == false || getVBOSupported() == false ||
+		isGlExtensionSupported("GL_ARB_shader_objects") == false ||
+		isGlExtensionSupported("GL_ARB_vertex_shader") == false ||
+		isGlExtensionSupported("GL_ARB_draw_instanced") == false ||
+		isGlExtensionSupported("GL_ARB_instanced_arrays") == false) {
+		return;
+	}
+
+	GLint maxAttributes= 0;
+	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS_ARB, &maxAttributes);
+	if(maxAttributes < instanceMatrixAttribute + 4) {
+		return;
+	}
+
+	try {
+		GraphicsFactory *factory= GraphicsInterface::getInstance().getFactory();
+		if(factory == NULL) {
+			return;
+		}
+		instanceShaderManager= factory->newShaderManager();
+		if(instanceShaderManager == NULL) {
+			return;
+		}
+
+		VertexShader *vertexShader= instanceShaderManager->newVertexShader();
+		vertexShader->loadCode("instanced_define", "#define INSTANCED\n");
+		vertexShader->loadCode("keyframe_blend_vertex", keyframeBlendVertexShader);
+
+		instanceProgram= instanceShaderManager->newShaderProgram();
+		instanceProgram->attach(vertexShader, NULL);
+		ShaderProgramGl *programGl= static_cast<ShaderProgramGl *>(instanceProgram);
+		programGl->bindAttribute("nextVertex", nextVertexAttribute);
+		programGl->bindAttribute("nextNormal", nextNormalAttribute);
+		programGl->bindAttribute("instanceMatrix0", instanceMatrixAttribute);
+		programGl->bindAttribute("instanceMatrix1", instanceMatrixAttribute + 1);
+		programGl->bindAttribute("instanceMatrix2", instanceMatrixAttribute + 2);
+		programGl->bindAttribute("instanceMatrix3", instanceMatrixAttribute + 3);
+
+		instanceShaderManager->init();
+
+		instanceProgram->activate();
+		instanceProgram->setUniform("blendT", 0.f);
+		instanceProgram->setUniform("lightCount", 0);
+		instanceProgram->setUniform("lightingEnabled", 0);
+		instanceProgram->setUniform("colorMaterialEnabled", 0);
+		instanceProgram->deactivate();
+
+		instanceProgramState= bpsReady;
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("**INFO** Identical models are drawn instanced\n");
+	}
+	catch(const exception &ex) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		if(instanceShaderManager != NULL) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"%s\n",instanceShaderManager->getLogString().c_str());
+		}
+		printf("**WARNING** Instanced model rendering unavailable, drawing instances one by one: %s\n",ex.what());
+
+		glUseProgramObjectARB(0);
+		endInstanceProgram();
+		instanceProgramState= bpsUnavailable;
+	}
+}
+
+void ModelRendererGl::endInstanceProgram() {
+	if(instanceVBO != 0) {
+		glDeleteBuffersARB(1, &instanceVBO);
+		instanceVBO= 0;
+	}
+	if(instanceShaderManager != NULL) {
+		instanceShaderManager->end();
+		delete instanceShaderManager;
+		instanceShaderManager= NULL;
+	}
+	instanceProgram= NULL;
+}
+
+bool ModelRendererGl::canInstanceOnGpu(const Mesh *mesh) const {
+	return (instanceProgramState == bpsReady && instanceCount > 0 &&
+			colorPickingMode == false && renderNormals == true &&
+			(mesh->getFrameCount() == 1 || mesh->getInterpolationData() != NULL));
+}
+
+void ModelRendererGl::activateInstanceProgram(const Mesh *mesh) {
+	float blendT= (mesh->getFrameCount() > 1 ? mesh->getInterpolationData()->getBlendT() : 0.f);
+
+	instanceProgram->activate();
+	instanceProgram->setUniform("blendT", blendT);
+	instanceProgram->setUniform("lightCount", blendLightCount);
+	instanceProgram->setUniform("lightingEnabled", (glIsEnabled(GL_LIGHTING) == GL_TRUE ? 1 : 0));
+	instanceProgram->setUniform("colorMaterialEnabled", (glIsEnabled(GL_COLOR_MATERIAL) == GL_TRUE ? 1 : 0));
+}
+
 }}}//end namespace
@@ -37,6 +37,8 @@ ParticleRendererGl::ParticleRendererGl(){
 		texCoordBuffer[i+2]= Vec2f(1.0f, 0.0f);
 		texCoordBuffer[i+3]= Vec2f(1.0f, 1.0f);
 	}
+
+	blendQuadBatchTexture= 0;
 }
 
 void ParticleRendererGl::renderManager(ParticleManager *pm, ModelRenderer *mr){
@@ -59,9 +61,16 @@ void ParticleRendererGl::renderManager(ParticleManager *pm, ModelRenderer *mr){
 	glDepthMask(GL_FALSE);
 	glEnable(GL_BLEND);
 
+	// the camera does not move while the particles are rendered
+	float modelview[16];
+	glGetFloatv(GL_MODELVIEW_MATRIX , modelview);
+	rightVector= Vec3f(modelview[0], modelview[4], modelview[8]);
+	upVector= Vec3f(modelview[1], modelview[5], modelview[9]);
+
 	//render
 	rendering= true;
 	pm->render(this, mr);
+	flushQuadBatches();
 	rendering= false;
 
 	// blend mode back to normal
@@ -79,60 +88,68 @@ void ParticleRendererGl::renderSystem(ParticleSystem *ps){
 	assertGl();
 	assert(rendering);
 
-	Vec3f rightVector;
-	Vec3f upVector;
-	float modelview[16];
-
-	//render particles
-	setBlendMode(ps->getBlendMode());
+	int aliveParticleCount= ps->getAliveParticleCount();
+	if(aliveParticleCount <= 0) {
+		return;
+	}
 
-	// get the current modelview state
-	glGetFloatv(GL_MODELVIEW_MATRIX , modelview);
-	rightVector= Vec3f(modelview[0], modelview[4], modelview[8]);
-	upVector= Vec3f(modelview[1], modelview[5], modelview[9]);
+	GLuint textureHandle= 0;
+	if(ps->getTexture() != NULL) {
+		textureHandle= static_cast<Texture2DGl*>(ps->getTexture())->getHandle();
+	}
 
-	// set state
-	if(ps->getTexture()!=NULL){
-		glBindTexture(GL_TEXTURE_2D, static_cast<Texture2DGl*>(ps->getTexture())->getHandle());
+	QuadBatch *batch= NULL;
+	if(ps->getBlendMode() == ParticleSystem::bmOne) {
+		if(blendQuadBatch.vertices.empty() == false) {
+			flushQuadBatches();
+		}
+		batch= &additiveQuadBatches[textureHandle];
 	}
-	else{
-		glBindTexture(GL_TEXTURE_2D, 0);
+	else {
+		if(blendQuadBatch.vertices.empty() == false && blendQuadBatchTexture != textureHandle) {
+			flushQuadBatches();
+		}
+		else {
+			for(QuadBatchMap::iterator iterMap = additiveQuadBatches.begin();
+				iterMap != additiveQuadBatches.end(); ++iterMap) {
+				if(iterMap->second.vertices.empty() == false) {
+					flushQuadBatches();
+					break;
+				}
+			}
+		}
+		blendQuadBatchTexture= textureHandle;
+		batch= &blendQuadBatch;
 	}
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_FOG);
-	glAlphaFunc(GL_GREATER, 0.0f);
-	glEnable(GL_TEXTURE_2D);
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-	glEnableClientState(GL_COLOR_ARRAY);
 
-	//fill vertex buffer with billboards
-	int bufferIndex= 0;
+	//fill the batch with billboards
+	size_t bufferIndex= batch->vertices.size();
+	batch->vertices.resize(bufferIndex + aliveParticleCount * 4);
+	batch->colors.resize(bufferIndex + aliveParticleCount * 4);
 
-	for(int i=0; i<ps->getAliveParticleCount(); ++i){
+	Vec3f *vertices= &batch->vertices[0];
+	Vec4f *colors= &batch->colors[0];
+	for(int i=0; i<aliveParticleCount; ++i){
 		const Particle *particle= ps->getParticle(i);
 		float size= particle->getSize()/2.0f;
-		Vec3f pos= particle->getPos();
-		Vec4f color= particle->getColor();
+		const Vec3f &pos= particle->pos;
+		const Vec4f &color= particle->color;
 
-		vertexBuffer[bufferIndex] = pos - (rightVector - upVector) * size;
-		vertexBuffer[bufferIndex+1] = pos - (rightVector + upVector) * size;
-		vertexBuffer[bufferIndex+2] = pos + (rightVector - upVector) * size;
-		vertexBuffer[bufferIndex+3] = pos + (rightVector + upVector) * size;
+		Vec3f right= rightVector * size;
+		Vec3f up= upVector * size;
 
-		colorBuffer[bufferIndex]= color;
-		colorBuffer[bufferIndex+1]= color;
-		colorBuffer[bufferIndex+2]= color;
-		colorBuffer[bufferIndex+3]= color;
+		vertices[bufferIndex] = pos - right + up;
+		vertices[bufferIndex+1] = pos - right - up;
+		vertices[bufferIndex+2] = pos + right - up;
+		vertices[bufferIndex+3] = pos + right + up;
 
-		bufferIndex+= 4;
+		colors[bufferIndex]= color;
+		colors[bufferIndex+1]= color;
+		colors[bufferIndex+2]= color;
+		colors[bufferIndex+3]= color;
 
-		if(bufferIndex >= bufferSize){
-			bufferIndex= 0;
-			renderBufferQuads(bufferSize);
-		}
+		bufferIndex+= 4;
 	}
-	renderBufferQuads(bufferIndex);
 
 	assertGl();
 }
@@ -141,6 +158,7 @@ void ParticleRendererGl::renderSystemLine(ParticleSystem *ps){
 
 	assertGl();
 	assert(rendering);
+	flushQuadBatches();
 
 	if(!ps->isEmpty()){
 		const Particle *particle= ps->getParticle(0);
@@ -185,6 +203,7 @@ void ParticleRendererGl::renderSystemLineAlpha(ParticleSystem *ps){
 
 	assertGl();
 	assert(rendering);
+	flushQuadBatches();
 
 	if(!ps->isEmpty()){
 		const Particle *particle= ps->getParticle(0);
@@ -230,6 +249,7 @@ void ParticleRendererGl::renderModel(GameParticleSystem *ps, ModelRenderer *mr){
 	//render model
 	Model *model = ps->getModel();
 	if(model != NULL) {
+		flushQuadBatches();
 
 		//init
 		glEnable(GL_LIGHTING);
@@ -290,6 +310,55 @@ void ParticleRendererGl::renderBufferLines(int lineCount){
 	glDrawArrays(GL_LINES, 0, lineCount);
 }
 
+void ParticleRendererGl::flushQuadBatches(){
+	for(QuadBatchMap::iterator iterMap = additiveQuadBatches.begin();
+		iterMap != additiveQuadBatches.end(); ++iterMap) {
+		renderQuadBatch(iterMap->second, iterMap->first, ParticleSystem::bmOne);
+	}
+	renderQuadBatch(blendQuadBatch, blendQuadBatchTexture, ParticleSystem::bmOneMinusAlpha);
+}
+
+void ParticleRendererGl::renderQuadBatch(QuadBatch &batch, GLuint textureHandle, ParticleSystem::BlendMode blendMode){
+	if(batch.vertices.empty() == true) {
+		return;
+	}
+	assertGl();
+
+	setBlendMode(blendMode);
+	glBindTexture(GL_TEXTURE_2D, textureHandle);
+	glDisable(GL_ALPHA_TEST);
+	glDisable(GL_FOG);
+	glAlphaFunc(GL_GREATER, 0.0f);
+	glEnable(GL_TEXTURE_2D);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+
+	// texture coordinates repeat for every quad, extend them as batches grow
+	size_t vertexCount= batch.vertices.size();
+	if(quadTexCoords.size() < vertexCount) {
+		size_t i= quadTexCoords.size();
+		quadTexCoords.resize(vertexCount);
+		for(; i < vertexCount; i+= 4) {
+			quadTexCoords[i]= Vec2f(0.0f, 1.0f);
+			quadTexCoords[i+1]= Vec2f(0.0f, 0.0f);
+			quadTexCoords[i+2]= Vec2f(1.0f, 0.0f);
+			quadTexCoords[i+3]= Vec2f(1.0f, 1.0f);
+		}
+	}
+
+	glVertexPointer(3, GL_FLOAT, 0, &batch.vertices[0]);
+	glTexCoordPointer(2, GL_FLOAT, 0, &quadTexCoords[0]);
+	glColorPointer(4, GL_FLOAT, 0, &batch.colors[0]);
+	glDrawArrays(GL_QUADS, 0, (GLsizei)vertexCount);
+
+	// keep the capacity for the next frame
+	batch.vertices.clear();
+	batch.colors.clear();
+
+	assertGl();
+}
+
 void ParticleRendererGl::setBlendMode(ParticleSystem::BlendMode blendMode){
 	switch(blendMode){
 	case ParticleSystem::bmOne:
@@ -61,12 +61,17 @@ bool ShaderProgramGl::link(string &messages){
 	FragmentShaderGl *fragmentShaderGl= static_cast<FragmentShaderGl*>(fragmentShader);
 
 	const ShaderSource *vss= vertexShaderGl->getSource();
-	const ShaderSource *fss= fragmentShaderGl->getSource();
-	messages= "Linking program: " + vss->getPathInfo() + ", " + fss->getPathInfo() + "\n";
+	messages= "Linking program: " + vss->getPathInfo();
+	if(fragmentShaderGl != NULL) {
+		messages+= ", " + fragmentShaderGl->getSource()->getPathInfo();
+	}
+	messages+= "\n";
 
-	//attach
+	//attach, a program without a fragment shader keeps the fixed function fragment stage
 	glAttachObjectARB(handle, vertexShaderGl->getHandle());
-	glAttachObjectARB(handle, fragmentShaderGl->getHandle());
+	if(fragmentShaderGl != NULL) {
+		glAttachObjectARB(handle, fragmentShaderGl->getHandle());
+	}
 
 	assertGl();
 
@@ -183,6 +188,10 @@ void ShaderGl::load(const string &path){
 	source.load(path);
 }
 
+void ShaderGl::loadCode(const string &pathInfo, const string &code){
+	source.loadCode(pathInfo, code);
+}
+
 bool ShaderGl::compile(string &messages){
 	
 	assertGl();
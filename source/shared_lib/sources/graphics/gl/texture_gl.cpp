@@ -16,6 +16,8 @@
 #include "conversion.h"
 #include <algorithm>
 #include "util.h"
+#include "checksum.h"
+#include "platform_common.h"
 #ifdef WIN32
 #include "glext.h"
 #endif
@@ -30,6 +32,7 @@ using namespace Platform;
 using namespace Shared::Util;
 
 bool TextureGl::enableATIHacks = false;
+string TextureGl::compressedTextureCachePath = "";
 
 static void setupGLExtensionMethods() {
 #ifdef WIN32
@@ -759,6 +762,172 @@ Texture2DGl::~Texture2DGl() {
 	end();
 }
 
+// =====================================================
+//	Compressed texture cache
+//
+//	The first time a texture is compressed by the driver its compressed
+//	mip chain is read back and stored under the checksum of the source
+//	pixels, later loads upload it with glCompressedTexImage2D and skip
+//	both the compression and the mipmap generation.
+// =====================================================
+
+static const uint32 compressedTextureCacheSignature = 0x4354474D; // "MGTC"
+static const uint32 compressedTextureCacheVersion = 1;
+
+static string getCompressedTextureCacheFile(const Pixmap2D &pixmap, const uint8 *pixels,
+		GLint glCompressionFormat, GLint glInternalFormat, bool mipmap) {
+	string cachePath = TextureGl::getCompressedTextureCachePath();
+	if(cachePath == "" || pixels == NULL || glCompressionFormat == glInternalFormat ||
+		pixmap.getPixels() == NULL || pixmap.getPixelByteCount() == 0) {
+		return "";
+	}
+
+	Checksum checksum;
+	checksum.addBytes(pixmap.getPixels(), pixmap.getPixelByteCount());
+	checksum.addInt(pixmap.getW());
+	checksum.addInt(pixmap.getH());
+	checksum.addInt(pixmap.getComponents());
+	checksum.addInt(glCompressionFormat);
+	checksum.addInt(mipmap == true ? 1 : 0);
+	return cachePath + "TEX_" + uIntToStr(checksum.getSum()) + "_" +
+			intToStr(pixmap.getW()) + "x" + intToStr(pixmap.getH()) + ".bin";
+}
+
+static int getCompressedTextureLevelCount(int width, int height, bool mipmap) {
+	int levels = 1;
+	if(mipmap == true) {
+		for(int size = max(width, height); size > 1; size /= 2) {
+			levels++;
+		}
+	}
+	return levels;
+}
+
+static bool loadCompressedTextureCache(const string &cacheFile, int width, int height, bool mipmap) {
+	if(cacheFile == "" || fileExists(cacheFile) == false) {
+		return false;
+	}
+
+#ifdef WIN32
+	FILE *fp = _wfopen(utf8_decode(cacheFile).c_str(), L"rb");
+#else
+	FILE *fp = fopen(cacheFile.c_str(),"rb");
+#endif
+	if(fp == NULL) {
+		return false;
+	}
+
+	uint32 header[6] = { 0 };
+	bool result = (fread(header, sizeof(header), 1, fp) == 1 &&
+				   header[0] == compressedTextureCacheSignature &&
+				   header[1] == compressedTextureCacheVersion &&
+				   (int)header[3] == width && (int)header[4] == height &&
+				   (int)header[5] == getCompressedTextureLevelCount(width, height, mipmap));
+
+	// read every level first so a truncated file never leaves a partial texture
+	vector<vector<uint8> > levelData;
+	vector<pair<int,int> > levelSizes;
+	for(int level = 0; result == true && level < (int)header[5]; ++level) {
+		uint32 levelHeader[3] = { 0 };
+		if(fread(levelHeader, sizeof(levelHeader), 1, fp) != 1 || levelHeader[2] == 0) {
+			result = false;
+			break;
+		}
+		levelSizes.push_back(make_pair((int)levelHeader[0], (int)levelHeader[1]));
+		levelData.push_back(vector<uint8>(levelHeader[2]));
+		if(fread(&levelData.back()[0], levelHeader[2], 1, fp) != 1) {
+			result = false;
+		}
+	}
+	fclose(fp);
+
+	if(result == false) {
+		SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] ignoring invalid compressed texture cache [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,cacheFile.c_str());
+		removeFile(cacheFile);
+		return false;
+	}
+
+	if(mipmap == true) {
+		glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE);
+	}
+	for(unsigned int level = 0; level < levelData.size(); ++level) {
+		glCompressedTexImage2D(GL_TEXTURE_2D, level, (GLenum)header[2],
+				levelSizes[level].first, levelSizes[level].second, 0,
+				(GLsizei)levelData[level].size(), &levelData[level][0]);
+	}
+
+	// a driver without this format rejects the data, the caller uploads the pixmap instead
+	if(glGetError() != GL_NO_ERROR) {
+		if(mipmap == true) {
+			glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+		}
+		return false;
+	}
+	return true;
+}
+
+static void saveCompressedTextureCache(const string &cacheFile, int width, int height, bool mipmap) {
+	if(cacheFile == "") {
+		return;
+	}
+
+	GLint compressed = GL_FALSE;
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &compressed);
+	if(compressed != GL_TRUE) {
+		// the upload fell back to an uncompressed format
+		return;
+	}
+
+	GLint internalFormat = 0;
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+
+	string tempFile = cacheFile + ".tmp";
+#ifdef WIN32
+	FILE *fp = _wfopen(utf8_decode(tempFile).c_str(), L"wb");
+#else
+	FILE *fp = fopen(tempFile.c_str(),"wb");
+#endif
+	if(fp == NULL) {
+		return;
+	}
+
+	const int levelCount = getCompressedTextureLevelCount(width, height, mipmap);
+	uint32 header[6] = { compressedTextureCacheSignature, compressedTextureCacheVersion,
+						 (uint32)internalFormat, (uint32)width, (uint32)height, (uint32)levelCount };
+	bool result = (fwrite(header, sizeof(header), 1, fp) == 1);
+
+	vector<uint8> levelData;
+	for(int level = 0; result == true && level < levelCount; ++level) {
+		GLint levelWidth = 0;
+		GLint levelHeight = 0;
+		GLint levelSize = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &levelWidth);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &levelHeight);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &levelSize);
+		if(levelSize <= 0 || glGetError() != GL_NO_ERROR) {
+			result = false;
+			break;
+		}
+
+		levelData.resize(levelSize);
+		glGetCompressedTexImage(GL_TEXTURE_2D, level, &levelData[0]);
+
+		uint32 levelHeader[3] = { (uint32)levelWidth, (uint32)levelHeight, (uint32)levelSize };
+		result = (glGetError() == GL_NO_ERROR &&
+				  fwrite(levelHeader, sizeof(levelHeader), 1, fp) == 1 &&
+				  fwrite(&levelData[0], levelSize, 1, fp) == 1);
+	}
+	fclose(fp);
+
+	if(result == true) {
+		removeFile(cacheFile);
+		result = renameFile(tempFile, cacheFile);
+	}
+	if(result == false) {
+		removeFile(tempFile);
+	}
+}
+
 void Texture2DGl::init(Filter filter, int maxAnisotropy) {
 	assertGl();
 
@@ -820,11 +989,17 @@ void Texture2DGl::init(Filter filter, int maxAnisotropy) {
 				pixmap.Scale(glFormat,next_power_of_2(pixmap.getW()),next_power_of_2(pixmap.getH()));
 			}
 
-			glTexImage2D(GL_TEXTURE_2D, 0, glCompressionFormat,
-							pixmap.getW(), pixmap.getH(), 0,
-							glFormat, GL_UNSIGNED_BYTE, pixels);
+			string cacheFile= getCompressedTextureCacheFile(pixmap, pixels, glCompressionFormat, glInternalFormat, true);
+			bool loadedFromCache= loadCompressedTextureCache(cacheFile, pixmap.getW(), pixmap.getH(), true);
 
-			GLint error= glGetError();
+			GLint error= GL_NO_ERROR;
+			if(loadedFromCache == false) {
+				glTexImage2D(GL_TEXTURE_2D, 0, glCompressionFormat,
+								pixmap.getW(), pixmap.getH(), 0,
+								glFormat, GL_UNSIGNED_BYTE, pixels);
+
+				error= glGetError();
+			}
 
 			// Now try without compression if we tried compression
 			if(error != GL_NO_ERROR && glCompressionFormat != glInternalFormat) {
@@ -866,6 +1041,10 @@ void Texture2DGl::init(Filter filter, int maxAnisotropy) {
 				snprintf(szBuf,8096,"Error building texture 2D mipmaps [%s], returned: %d [%s] for [%s] w = %d, h = %d, glCompressionFormat = %d",this->path.c_str(),error,errorString,(pixmap.getPath() != "" ? pixmap.getPath().c_str() : this->path.c_str()),pixmap.getW(),pixmap.getH(),glCompressionFormat);
 				throw megaglest_runtime_error(szBuf);
 			}
+
+			if(loadedFromCache == false) {
+				saveCompressedTextureCache(cacheFile, pixmap.getW(), pixmap.getH(), true);
+			}
 		}
 		else {
 			//build single texture
@@ -882,10 +1061,16 @@ void Texture2DGl::init(Filter filter, int maxAnisotropy) {
 				pixmap.Scale(glFormat,next_power_of_2(pixmap.getW()),next_power_of_2(pixmap.getH()));
 			}
 
-			glTexImage2D(GL_TEXTURE_2D, 0, glCompressionFormat,pixmap.getW(),
-					     pixmap.getH(),0, glFormat, GL_UNSIGNED_BYTE, pixels);
+			string cacheFile= getCompressedTextureCacheFile(pixmap, pixels, glCompressionFormat, glInternalFormat, false);
+			bool loadedFromCache= loadCompressedTextureCache(cacheFile, pixmap.getW(), pixmap.getH(), false);
 
-			GLint error= glGetError();
+			GLint error= GL_NO_ERROR;
+			if(loadedFromCache == false) {
+				glTexImage2D(GL_TEXTURE_2D, 0, glCompressionFormat,pixmap.getW(),
+						     pixmap.getH(),0, glFormat, GL_UNSIGNED_BYTE, pixels);
+
+				error= glGetError();
+			}
 
 			// Now try without compression if we tried compression
 			if(error != GL_NO_ERROR && glCompressionFormat != glInternalFormat) {
@@ -935,6 +1120,10 @@ void Texture2DGl::init(Filter filter, int maxAnisotropy) {
 				snprintf(szBuf,8096,"Error creating texture 2D path [%s], returned: %d [%s] (%X) [%s] w = %d, h = %d, glInternalFormat = %d, glFormat = %d, glCompressionFormat = %d",this->path.c_str(),error,errorString,error,pixmap.getPath().c_str(),pixmap.getW(),pixmap.getH(),glInternalFormat,glFormat,glCompressionFormat);
 				throw megaglest_runtime_error(szBuf);
 			}
+
+			if(loadedFromCache == false) {
+				saveCompressedTextureCache(cacheFile, pixmap.getW(), pixmap.getH(), false);
+			}
 		}
 		inited= true;
 		OutputTextureDebugInfo(format, pixmap.getComponents(),getPath(),pixmap.getPixelByteCount(),GL_TEXTURE_2D);
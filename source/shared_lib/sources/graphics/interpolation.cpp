@@ -14,6 +14,10 @@
 #include <cassert>
 #include <algorithm>
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 #include "model.h"
 #include "conversion.h"
 #include "util.h"
@@ -31,6 +35,7 @@ namespace Shared{ namespace Graphics{
 // =====================================================
 
 bool InterpolationData::enableInterpolation = true;
+int InterpolationData::interpolationSteps = 0;
 
 InterpolationData::InterpolationData(const Mesh *mesh) {
 	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
@@ -41,6 +46,15 @@ InterpolationData::InterpolationData(const Mesh *mesh) {
 	normals= NULL;
 	
 	raw_frame_ofs = 0;
+
+	blendPrevFrame= 0;
+	blendNextFrame= 0;
+	blendT= 0.f;
+
+	verticesPending= false;
+	normalsPending= false;
+	pendingT= 0.f;
+	pendingCycle= false;
 	
 	this->mesh= mesh;
 }
@@ -58,14 +72,65 @@ void InterpolationData::update(float t, bool cycle){
 }
 
 void InterpolationData::updateVertices(float t, bool cycle) {
-	update(mesh->getVertices(), vertices, t, cycle);
+	verticesPending= false;
+	update(mesh->getVertices(), vertices, verticesKey, t, cycle);
 }
 
 void InterpolationData::updateNormals(float t, bool cycle) {
-	update(mesh->getNormals(), normals, t, cycle);
+	normalsPending= false;
+	update(mesh->getNormals(), normals, normalsKey, t, cycle);
+}
+
+// Records the frame pair and blend factor without touching the cpu buffers,
+// the renderer blends the frames itself and calls resolvePendingUpdate()
+// only if it has to fall back to the cpu arrays
+void InterpolationData::updateFrameState(float t, bool cycle) {
+	uint32 prevFrame= 0;
+	uint32 nextFrame= 0;
+	float localT= 0.f;
+	if(computeFrames(t, cycle, prevFrame, nextFrame, localT) == true) {
+		setBlendState(prevFrame, nextFrame, localT);
+	}
+	verticesPending= true;
+	normalsPending= true;
+	pendingT= t;
+	pendingCycle= cycle;
+}
+
+void InterpolationData::setBlendState(uint32 prevFrame, uint32 nextFrame, float localT) {
+	// Without interpolation only the previous frame is shown, same as raw_frame_ofs
+	blendPrevFrame= prevFrame;
+	blendNextFrame= (enableInterpolation == true ? nextFrame : prevFrame);
+	blendT= (enableInterpolation == true ? localT : 0.f);
 }
 
-void InterpolationData::update(const Vec3f* src, Vec3f* &dest, float t, bool cycle) {
+void InterpolationData::resolvePendingUpdate() {
+	if(verticesPending == true) {
+		updateVertices(pendingT, pendingCycle);
+	}
+	if(normalsPending == true) {
+		updateNormals(pendingT, pendingCycle);
+	}
+}
+
+// dest[i] = prev[i] + (next[i] - prev[i]) * t over a flat float stream,
+// four lanes at a time when SSE is available
+void InterpolationData::lerpStream(const float *prev, const float *next, float *dest, uint32 floatCount, float t) {
+	uint32 i = 0;
+#if defined(__SSE__)
+	const __m128 t4 = _mm_set1_ps(t);
+	for(; i + 4 <= floatCount; i += 4) {
+		__m128 p = _mm_loadu_ps(prev + i);
+		__m128 n = _mm_loadu_ps(next + i);
+		_mm_storeu_ps(dest + i, _mm_add_ps(p, _mm_mul_ps(_mm_sub_ps(n, p), t4)));
+	}
+#endif
+	for(; i < floatCount; ++i) {
+		dest[i] = prev[i] + (next[i] - prev[i]) * t;
+	}
+}
+
+bool InterpolationData::computeFrames(float t, bool cycle, uint32 &prevFrame, uint32 &nextFrame, float &localT) const {
 
 	if(t <0.0f || t>1.0f) {
 		printf("ERROR t = [%f] for cycle [%d] f [%d] v [%d]\n",t,cycle,mesh->getFrameCount(),mesh->getVertexCount());
@@ -78,25 +143,38 @@ void InterpolationData::update(const Vec3f* src, Vec3f* &dest, float t, bool cyc
 	}
 
 	uint32 frameCount= mesh->getFrameCount();
-	uint32 vertexCount= mesh->getVertexCount();
-
-	if(frameCount > 1) {
-		//misc vars
-		uint32 prevFrame;
-		uint32 nextFrame;
-		float localT;
-
-		if(cycle == true) {
-			prevFrame= min<uint32>(static_cast<uint32>(t*frameCount), frameCount-1);
-			nextFrame= (prevFrame+1) % frameCount;
-			localT= t*frameCount - prevFrame;
-		}
-		else {
-			prevFrame= min<uint32> (static_cast<uint32> (t * (frameCount-1)), frameCount - 2);
-			nextFrame= min(prevFrame + 1, frameCount - 1);
-			localT= t * (frameCount-1) - prevFrame;
-			//printf(" prevFrame=%d nextFrame=%d localT=%f\n",prevFrame,nextFrame,localT);
-		}
+	if(frameCount <= 1) {
+		return false;
+	}
+
+	if(cycle == true) {
+		prevFrame= min<uint32>(static_cast<uint32>(t*frameCount), frameCount-1);
+		nextFrame= (prevFrame+1) % frameCount;
+		localT= t*frameCount - prevFrame;
+	}
+	else {
+		prevFrame= min<uint32> (static_cast<uint32> (t * (frameCount-1)), frameCount - 2);
+		nextFrame= min(prevFrame + 1, frameCount - 1);
+		localT= t * (frameCount-1) - prevFrame;
+		//printf(" prevFrame=%d nextFrame=%d localT=%f\n",prevFrame,nextFrame,localT);
+	}
+
+	if(interpolationSteps > 0) {
+		localT= static_cast<float>(static_cast<int>(localT * interpolationSteps + 0.5f)) / interpolationSteps;
+	}
+	return true;
+}
+
+void InterpolationData::update(const Vec3f* src, Vec3f* &dest, InterpolationKey &key, float t, bool cycle) {
+	uint32 prevFrame= 0;
+	uint32 nextFrame= 0;
+	float localT= 0.f;
+
+	if(computeFrames(t, cycle, prevFrame, nextFrame, localT) == true) {
+		uint32 frameCount= mesh->getFrameCount();
+		uint32 vertexCount= mesh->getVertexCount();
+
+		setBlendState(prevFrame, nextFrame, localT);
 
 		uint32 prevFrameBase= prevFrame*vertexCount;
 		uint32 nextFrameBase= nextFrame*vertexCount;
@@ -108,10 +186,19 @@ void InterpolationData::update(const Vec3f* src, Vec3f* &dest, float t, bool cyc
 		if(enableInterpolation) {
 			if(!dest) { // not previously allocated
 			      dest = new Vec3f[vertexCount];
+			      key.valid = false;
 			}
-			for(uint32 j=0; j<vertexCount; ++j){
-				dest[j]= src[prevFrameBase+j].lerp(localT, src[nextFrameBase+j]);
+			// Another unit sharing this model already produced this pose
+			if(key.matches(prevFrame, nextFrame, localT) == true) {
+				return;
 			}
+			lerpStream(src[prevFrameBase].ptr(), src[nextFrameBase].ptr(),
+					dest[0].ptr(), vertexCount * 3, localT);
+
+			key.valid = true;
+			key.prevFrame = prevFrame;
+			key.nextFrame = nextFrame;
+			key.localT = localT;
 		} else {
 			raw_frame_ofs = prevFrameBase;
 		}
@@ -195,6 +195,80 @@ void fromEndianMeshHeaderV2(MeshHeaderV2 &header) {
 	}
 }
 
+// =====================================================
+//	class ModelFileBuffer
+// =====================================================
+
+ModelFileBuffer::ModelFileBuffer() {
+	data		= NULL;
+	size		= 0;
+	position	= 0;
+}
+
+ModelFileBuffer::~ModelFileBuffer() {
+	delete [] data;
+	data = NULL;
+}
+
+bool ModelFileBuffer::loadFile(const string &path) {
+	delete [] data;
+	data		= NULL;
+	size		= 0;
+	position	= 0;
+
+#ifdef WIN32
+	FILE *f= _wfopen(utf8_decode(path).c_str(), L"rb");
+#else
+	FILE *f=fopen(path.c_str(),"rb");
+#endif
+	if(f == NULL) {
+		return false;
+	}
+
+	bool result = false;
+	if(fseek(f, 0, SEEK_END) == 0) {
+		long fileSize = ftell(f);
+		if(fileSize >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+			size = fileSize;
+			data = new uint8[size > 0 ? size : 1];
+			result = (size == 0 || fread(data, size, 1, f) == 1);
+		}
+	}
+	fclose(f);
+
+	if(result == false) {
+		delete [] data;
+		data = NULL;
+		size = 0;
+	}
+	return result;
+}
+
+// Same contract as fread: copies only whole items and returns their count
+std::size_t ModelFileBuffer::read(void *dest, std::size_t itemSize, std::size_t itemCount) {
+	if(itemSize == 0 || itemCount == 0) {
+		return 0;
+	}
+	std::size_t availableItems = (size - position) / itemSize;
+	if(availableItems > itemCount) {
+		availableItems = itemCount;
+	}
+	memcpy(dest, &data[position], availableItems * itemSize);
+	position += availableItems * itemSize;
+	return availableItems;
+}
+
+// Same contract as fseek with SEEK_CUR, except that seeking
+// past the end is reported as an error
+int ModelFileBuffer::seek(long offset) {
+	if((offset < 0 && (std::size_t)(-offset) > position) ||
+		(offset > 0 && (std::size_t)offset > size - position)) {
+		return -1;
+	}
+	position += offset;
+	return 0;
+}
+
 // =====================================================
 //	class Mesh
 // =====================================================
@@ -320,7 +394,19 @@ void Mesh::cleanupInterpolationData() {
 
 void Mesh::updateInterpolationData(float t, bool cycle) {
 	if(interpolationData != NULL) {
-		interpolationData->update(t, cycle);
+		// Animated meshes only get VBOs when the renderer blends the frames on the GPU
+		if(hasBuiltVBOs == true && frameCount > 1) {
+			interpolationData->updateFrameState(t, cycle);
+		}
+		else {
+			interpolationData->update(t, cycle);
+		}
+	}
+}
+
+void Mesh::resolveInterpolationData() {
+	if(interpolationData != NULL) {
+		interpolationData->resolvePendingUpdate();
 	}
 }
 
@@ -364,13 +450,16 @@ void Mesh::BuildVBOs() {
 			glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
 
 			// Our Copy Of The Data Is No Longer Necessary, It Is Safe In The Graphics Card
-			delete [] vertices; vertices = NULL;
-			delete [] texCoords; texCoords = NULL;
-			delete [] normals; normals = NULL;
-			delete [] indices; indices = NULL;
-
-			delete interpolationData;
-			interpolationData = NULL;
+			// Animated meshes keep theirs for the cpu interpolation fallback and unit selection
+			if(frameCount <= 1) {
+				delete [] vertices; vertices = NULL;
+				delete [] texCoords; texCoords = NULL;
+				delete [] normals; normals = NULL;
+				delete [] indices; indices = NULL;
+
+				delete interpolationData;
+				interpolationData = NULL;
+			}
 
 			hasBuiltVBOs = true;
 		}
@@ -409,13 +498,13 @@ string Mesh::findAlternateTexture(vector<string> conversionList, string textureF
 	return result;
 }
 
-void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
+void Mesh::loadV2(int meshIndex, const string &dir, ModelFileBuffer *f, TextureManager *textureManager,
 		bool deletePixMapAfterLoad, std::map<string,vector<pair<string, string> > > *loadedFileList,
 		string sourceLoader,string modelFile) {
 	this->textureManager = textureManager;
 	//read header
 	MeshHeaderV2 meshHeader;
-	size_t readBytes = fread(&meshHeader, sizeof(MeshHeaderV2), 1, f);
+	size_t readBytes = f->read(&meshHeader, sizeof(MeshHeaderV2), 1);
 	if(readBytes != 1) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
@@ -498,7 +587,7 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 	}
 
 	//read data
-	readBytes = fread(vertices, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
+	readBytes = f->read(vertices, sizeof(Vec3f)*frameCount*vertexCount, 1);
 	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
@@ -506,7 +595,7 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 	}
 	fromEndianVecArray<Vec3f>(vertices, frameCount*vertexCount);
 
-	readBytes = fread(normals, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
+	readBytes = f->read(normals, sizeof(Vec3f)*frameCount*vertexCount, 1);
 	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
@@ -515,7 +604,7 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 	fromEndianVecArray<Vec3f>(normals, frameCount*vertexCount);
 
 	if(textureFlags & (1<<mtDiffuse)) {
-		readBytes = fread(texCoords, sizeof(Vec2f)*vertexCount, 1, f);
+		readBytes = f->read(texCoords, sizeof(Vec2f)*vertexCount, 1);
 		if(readBytes != 1 && vertexCount != 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
@@ -523,7 +612,7 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 		}
 		fromEndianVecArray<Vec2f>(texCoords, vertexCount);
 	}
-	readBytes = fread(&diffuseColor, sizeof(Vec3f), 1, f);
+	readBytes = f->read(&diffuseColor, sizeof(Vec3f), 1);
 	if(readBytes != 1) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
@@ -531,7 +620,7 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 	}
 	fromEndianVecArray<Vec3f>(&diffuseColor, 1);
 
-	readBytes = fread(&opacity, sizeof(float32), 1, f);
+	readBytes = f->read(&opacity, sizeof(float32), 1);
 	if(readBytes != 1) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
@@ -539,13 +628,13 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 	}
 	opacity = Shared::PlatformByteOrder::fromCommonEndian(opacity);
 
-	int seek_result = fseek(f, sizeof(Vec4f)*(meshHeader.colorFrameCount-1), SEEK_CUR);
+	int seek_result = f->seek(sizeof(Vec4f)*(meshHeader.colorFrameCount-1));
 	if(seek_result != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fseek returned failure = %d [%u] on line: %d.",seek_result,indexCount,__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
-	readBytes = fread(indices, sizeof(uint32)*indexCount, 1, f);
+	readBytes = f->read(indices, sizeof(uint32)*indexCount, 1);
 	if(readBytes != 1 && indexCount != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,indexCount,__LINE__);
@@ -554,7 +643,7 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 	Shared::PlatformByteOrder::fromEndianTypeArray<uint32>(indices, indexCount);
 }
 
-void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
+void Mesh::loadV3(int meshIndex, const string &dir, ModelFileBuffer *f,
 		TextureManager *textureManager,bool deletePixMapAfterLoad,
 		std::map<string,vector<pair<string, string> > > *loadedFileList,
 		string sourceLoader,string modelFile) {
@@ -562,7 +651,7 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 
 	//read header
 	MeshHeaderV3 meshHeader;
-	size_t readBytes = fread(&meshHeader, sizeof(MeshHeaderV3), 1, f);
+	size_t readBytes = f->read(&meshHeader, sizeof(MeshHeaderV3), 1);
 	if(readBytes != 1) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
@@ -642,7 +731,7 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 	}
 
 	//read data
-	readBytes = fread(vertices, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
+	readBytes = f->read(vertices, sizeof(Vec3f)*frameCount*vertexCount, 1);
 	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
@@ -650,7 +739,7 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 	}
 	fromEndianVecArray<Vec3f>(vertices, frameCount*vertexCount);
 
-	readBytes = fread(normals, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
+	readBytes = f->read(normals, sizeof(Vec3f)*frameCount*vertexCount, 1);
 	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
@@ -660,7 +749,7 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 
 	if(textureFlags & (1<<mtDiffuse)) {
 		for(unsigned int i=0; i<meshHeader.texCoordFrameCount; ++i){
-			readBytes = fread(texCoords, sizeof(Vec2f)*vertexCount, 1, f);
+			readBytes = f->read(texCoords, sizeof(Vec2f)*vertexCount, 1);
 			if(readBytes != 1 && vertexCount != 0) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
@@ -669,7 +758,7 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 			fromEndianVecArray<Vec2f>(texCoords, vertexCount);
 		}
 	}
-	readBytes = fread(&diffuseColor, sizeof(Vec3f), 1, f);
+	readBytes = f->read(&diffuseColor, sizeof(Vec3f), 1);
 	if(readBytes != 1) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
@@ -677,7 +766,7 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 	}
 	fromEndianVecArray<Vec3f>(&diffuseColor, 1);
 
-	readBytes = fread(&opacity, sizeof(float32), 1, f);
+	readBytes = f->read(&opacity, sizeof(float32), 1);
 	if(readBytes != 1) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
@@ -685,14 +774,14 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 	}
 	opacity = Shared::PlatformByteOrder::fromCommonEndian(opacity);
 
-	int seek_result = fseek(f, sizeof(Vec4f)*(meshHeader.colorFrameCount-1), SEEK_CUR);
+	int seek_result = f->seek(sizeof(Vec4f)*(meshHeader.colorFrameCount-1));
 	if(seek_result != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fseek returned failure = %d [%u] on line: %d.",seek_result,indexCount,__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
 
-	readBytes = fread(indices, sizeof(uint32)*indexCount, 1, f);
+	readBytes = f->read(indices, sizeof(uint32)*indexCount, 1);
 	if(readBytes != 1 && indexCount != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,indexCount,__LINE__);
@@ -754,14 +843,14 @@ Texture2D* Mesh::loadMeshTexture(int meshIndex, int textureIndex,
 	return texture;
 }
 
-void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
+void Mesh::load(int meshIndex, const string &dir, ModelFileBuffer *f, TextureManager *textureManager,
 				bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList,
 				string sourceLoader,string modelFile) {
 	this->textureManager = textureManager;
 	
 	//read header
 	MeshHeader meshHeader;
-	size_t readBytes = fread(&meshHeader, sizeof(MeshHeader), 1, f);
+	size_t readBytes = f->read(&meshHeader, sizeof(MeshHeader), 1);
 	if(readBytes != 1) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
@@ -806,7 +895,7 @@ void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textu
 		if(meshHeader.textures & flag) {
 			uint8 cMapPath[mapPathSize+1];
 			memset(&cMapPath[0],0,mapPathSize+1);
-			readBytes = fread(cMapPath, mapPathSize, 1, f);
+			readBytes = f->read(cMapPath, mapPathSize, 1);
 			cMapPath[mapPathSize] = 0;
 			if(readBytes != 1 && mapPathSize != 0) {
 				char szBuf[8096]="";
@@ -837,7 +926,7 @@ void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textu
 	}
 
 	//read data
-	readBytes = fread(vertices, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
+	readBytes = f->read(vertices, sizeof(Vec3f)*frameCount*vertexCount, 1);
 	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
@@ -845,7 +934,7 @@ void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textu
 	}
 	fromEndianVecArray<Vec3f>(vertices, frameCount*vertexCount);
 
-	readBytes = fread(normals, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
+	readBytes = f->read(normals, sizeof(Vec3f)*frameCount*vertexCount, 1);
 	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
@@ -854,7 +943,7 @@ void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textu
 	fromEndianVecArray<Vec3f>(normals, frameCount*vertexCount);
 
 	if(meshHeader.textures!=0){
-		readBytes = fread(texCoords, sizeof(Vec2f)*vertexCount, 1, f);
+		readBytes = f->read(texCoords, sizeof(Vec2f)*vertexCount, 1);
 		if(readBytes != 1 && vertexCount != 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
@@ -862,7 +951,7 @@ void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textu
 		}
 		fromEndianVecArray<Vec2f>(texCoords, vertexCount);
 	}
-	readBytes = fread(indices, sizeof(uint32)*indexCount, 1, f);
+	readBytes = f->read(indices, sizeof(uint32)*indexCount, 1);
 	if(readBytes != 1 && indexCount != 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,indexCount,__LINE__);
@@ -1194,12 +1283,9 @@ void Model::loadG3d(const string &path, bool deletePixMapAfterLoad,
 		string sourceLoader) {
 
     try{
-#ifdef WIN32
-		FILE *f= _wfopen(utf8_decode(path).c_str(), L"rb");
-#else
-		FILE *f=fopen(path.c_str(),"rb");
-#endif
-		if (f == NULL) {
+		ModelFileBuffer fileBuffer;
+		ModelFileBuffer *f = &fileBuffer;
+		if (fileBuffer.loadFile(path) == false) {
 		    printf("In [%s::%s] cannot load file = [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,path.c_str());
 			throw megaglest_runtime_error("Error opening g3d model file [" + path + "]",true);
 		}
@@ -1212,9 +1298,8 @@ void Model::loadG3d(const string &path, bool deletePixMapAfterLoad,
 
 		//file header
 		FileHeader fileHeader;
-		size_t readBytes = fread(&fileHeader, sizeof(FileHeader), 1, f);
+		size_t readBytes = f->read(&fileHeader, sizeof(FileHeader), 1);
 		if(readBytes != 1) {
-			fclose(f);
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
 			throw megaglest_runtime_error(szBuf);
@@ -1226,8 +1311,6 @@ void Model::loadG3d(const string &path, bool deletePixMapAfterLoad,
 		memcpy(&fileId[0],reinterpret_cast<char*>(fileHeader.id),3);
 
 		if(strncmp(fileId, "G3D", 3) != 0) {
-			fclose(f);
-			f = NULL;
 		    printf("In [%s::%s] file = [%s] fileheader.id = [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,path.c_str(),fileId);
 			throw megaglest_runtime_error("Not a valid G3D model",true);
 		}
@@ -1239,7 +1322,7 @@ void Model::loadG3d(const string &path, bool deletePixMapAfterLoad,
 		if(fileHeader.version == 4) {
 			//model header
 			ModelHeader modelHeader;
-			readBytes = fread(&modelHeader, sizeof(ModelHeader), 1, f);
+			readBytes = f->read(&modelHeader, sizeof(ModelHeader), 1);
 			if(readBytes != 1) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
@@ -1273,7 +1356,7 @@ void Model::loadG3d(const string &path, bool deletePixMapAfterLoad,
 		}
 		//version 3
 		else if(fileHeader.version == 3) {
-			readBytes = fread(&meshCount, sizeof(meshCount), 1, f);
+			readBytes = f->read(&meshCount, sizeof(meshCount), 1);
 			if(readBytes != 1 && meshCount != 0) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,meshCount,__LINE__);
@@ -1300,7 +1383,7 @@ void Model::loadG3d(const string &path, bool deletePixMapAfterLoad,
 		}
 		//version 2
 		else if(fileHeader.version == 2) {
-			readBytes = fread(&meshCount, sizeof(meshCount), 1, f);
+			readBytes = f->read(&meshCount, sizeof(meshCount), 1);
 			if(readBytes != 1 && meshCount != 0) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,meshCount,__LINE__);
@@ -1330,8 +1413,6 @@ void Model::loadG3d(const string &path, bool deletePixMapAfterLoad,
 			throw megaglest_runtime_error("Invalid model version: "+ intToStr(fileHeader.version));
 		}
 
-		fclose(f);
-
 		autoJoinMeshFrames();
     }
     catch(megaglest_runtime_error& ex) {
@@ -206,20 +206,7 @@ void ParticleSystem::update() {
     	particleSystemStartDelay--;
     }
     else if(state != sPause) {
-		for(int i= 0; i < aliveParticleCount; ++i) {
-			updateParticle(&particles[i]);
-
-			if(deathTest(&particles[i])) {
-
-				//kill the particle
-				killParticle(&particles[i]);
-
-				//maintain alive particles at front of the array
-				if(aliveParticleCount > 0) {
-					particles[i]= particles[aliveParticleCount];
-				}
-			}
-		}
+		updateParticles();
 
 		if(state != ParticleSystem::sFade) {
 			emissionState= emissionState + emissionRate;
@@ -626,6 +613,24 @@ bool ParticleSystem::deathTest(Particle *p) {
 	return p->energy <= 0;
 }
 
+// Systems that do not provide their own batch update go through the virtual calls
+void ParticleSystem::updateParticles() {
+	for(int i= 0; i < aliveParticleCount; ++i) {
+		updateParticle(&particles[i]);
+
+		if(deathTest(&particles[i])) {
+
+			//kill the particle
+			killParticle(&particles[i]);
+
+			//maintain alive particles at front of the array
+			if(aliveParticleCount > 0) {
+				particles[i]= particles[aliveParticleCount];
+			}
+		}
+	}
+}
+
 void ParticleSystem::killParticle(Particle *p) {
 	aliveParticleCount--;
 }
@@ -2406,8 +2411,9 @@ bool ParticleManager::hasActiveParticleSystem(ParticleSystem::ParticleSystemType
 			//currentParticleCount+= ps->getAliveParticleCount();
 
 			bool showParticle= true;
-			if(dynamic_cast<UnitParticleSystem *> (ps) != NULL ||
-			   dynamic_cast<FireParticleSystem *> (ps) != NULL) {
+			ParticleSystem::ParticleSystemType systemType= ps->getParticleSystemType();
+			if(systemType == ParticleSystem::pst_UnitParticleSystem ||
+			   systemType == ParticleSystem::pst_FireParticleSystem) {
 				showParticle= ps->getVisible() || (ps->getState() == ParticleSystem::sFade);
 			}
 			if(showParticle == true){
@@ -2439,8 +2445,9 @@ void ParticleManager::update(int renderFps){
 			currentParticleCount+= ps->getAliveParticleCount();
 
 			bool showParticle= true;
-			if( dynamic_cast<UnitParticleSystem *> (ps) != NULL ||
-				dynamic_cast<FireParticleSystem *> (ps) != NULL) {
+			ParticleSystem::ParticleSystemType systemType= ps->getParticleSystemType();
+			if(systemType == ParticleSystem::pst_UnitParticleSystem ||
+			   systemType == ParticleSystem::pst_FireParticleSystem) {
 				showParticle = ps->getVisible() || (ps->getState() == ParticleSystem::sFade);
 			}
 			if(showParticle == true){
@@ -1416,6 +1416,22 @@ void Pixmap2D::copyImagePart(int x, int y, const Pixmap2D *sourcePixmap){
 	delete [] pixel;
 }
 
+// takes over the pixel buffer of the source image, leaving the source empty
+void Pixmap2D::transferPixels(Pixmap2D *sourcePixmap) {
+	deletePixels();
+
+	this->w= sourcePixmap->w;
+	this->h= sourcePixmap->h;
+	this->components= sourcePixmap->components;
+	this->pixels= sourcePixmap->pixels;
+	this->path= sourcePixmap->path;
+
+	sourcePixmap->pixels= NULL;
+	sourcePixmap->w= -1;
+	sourcePixmap->h= -1;
+	CalculatePixelsCRC(pixels,getPixelByteCount(), crc);
+}
+
 bool Pixmap2D::doDimensionsAgree(const Pixmap2D *pixmap){
 	return pixmap->getW() == w && pixmap->getH() == h;
 }
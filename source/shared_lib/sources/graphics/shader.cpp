@@ -43,4 +43,9 @@ void ShaderSource::load(const string &path){
 	}
 }
 
+void ShaderSource::loadCode(const string &pathInfo, const string &code){
+	this->pathInfo+= pathInfo + " ";
+	this->code+= code;
+}
+
 }}//end namespace
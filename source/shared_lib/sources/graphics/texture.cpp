@@ -13,10 +13,13 @@
 #include "util.h"
 #include <SDL.h>
 #include "platform_util.h"
+#include "platform_common.h"
+#include "thread.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Util;
 using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
 
 namespace Shared{ namespace Graphics{
 
@@ -226,7 +229,15 @@ void Texture2D::load(const string &path){
 	if (pixmap.getComponents() == -1) {
 		pixmap.init(defaultComponents);
 	}
-	pixmap.load(path);
+
+	Pixmap2D *preloadedPixmap = PixmapPreloadCache::take(path, pixmap.getComponents());
+	if(preloadedPixmap != NULL) {
+		pixmap.transferPixels(preloadedPixmap);
+		delete preloadedPixmap;
+	}
+	else {
+		pixmap.load(path);
+	}
 	this->path= path;
 }
 
@@ -239,6 +250,140 @@ void Texture2D::deletePixels() {
 	pixmap.deletePixels();
 }
 
+// =====================================================
+//	class PixmapPreloadCache
+// =====================================================
+
+static Mutex mutexPixmapPreloadCache(CODE_AT_LINE);
+
+bool PixmapPreloadCache::enabled = false;
+std::map<string,PixmapPreloadCache::DecodedPixmap> PixmapPreloadCache::decodedList;
+std::set<string> PixmapPreloadCache::decodingList;
+std::set<string> PixmapPreloadCache::claimedList;
+
+string PixmapPreloadCache::getKey(const string &path) {
+	string key = formatPath(path);
+	updatePathClimbingParts(key);
+	return key;
+}
+
+void PixmapPreloadCache::setEnabled(bool value) {
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(&mutexPixmapPreloadCache,mutexOwnerId);
+	enabled = value;
+}
+
+bool PixmapPreloadCache::getEnabled() {
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(&mutexPixmapPreloadCache,mutexOwnerId);
+	return enabled;
+}
+
+// Called by a loader thread before decoding, returns false if the main
+// thread already loaded the file (or another worker is handling it)
+bool PixmapPreloadCache::beginDecode(const string &path) {
+	string key = getKey(path);
+
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(&mutexPixmapPreloadCache,mutexOwnerId);
+	if(enabled == false ||
+		claimedList.find(key) != claimedList.end() ||
+		decodingList.find(key) != decodingList.end() ||
+		decodedList.find(key) != decodedList.end()) {
+		return false;
+	}
+	decodingList.insert(key);
+	return true;
+}
+
+// Called by a loader thread when decoding is done, pixmap is NULL
+// when the file could not be decoded
+void PixmapPreloadCache::endDecode(const string &path, Pixmap2D *pixmap) {
+	string key = getKey(path);
+
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(&mutexPixmapPreloadCache,mutexOwnerId);
+	decodingList.erase(key);
+	if(pixmap != NULL) {
+		if(enabled == true && claimedList.find(key) == claimedList.end()) {
+			DecodedPixmap &decoded	= decodedList[key];
+			decoded.pixmap			= pixmap;
+			decoded.decodedMillis	= Chrono::getCurMillis();
+		}
+		else {
+			delete pixmap;
+		}
+	}
+}
+
+// Drops the oldest unclaimed pixmaps while there are maxDecoded or more,
+// as long as they have waited at least minAgeMillis. Images the main thread
+// never asks for would otherwise hold their slots until the cache is cleared.
+// Returns the number of pixmaps left.
+std::size_t PixmapPreloadCache::evictDecoded(std::size_t maxDecoded, int64 minAgeMillis) {
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(&mutexPixmapPreloadCache,mutexOwnerId);
+	int64 now = Chrono::getCurMillis();
+	for(;decodedList.empty() == false && decodedList.size() >= maxDecoded;) {
+		std::map<string,DecodedPixmap>::iterator iterOldest = decodedList.begin();
+		for(std::map<string,DecodedPixmap>::iterator iterMap = decodedList.begin();
+			iterMap != decodedList.end(); ++iterMap) {
+			if(iterMap->second.decodedMillis < iterOldest->second.decodedMillis) {
+				iterOldest = iterMap;
+			}
+		}
+		if(now - iterOldest->second.decodedMillis < minAgeMillis) {
+			break;
+		}
+		delete iterOldest->second.pixmap;
+		decodedList.erase(iterOldest);
+	}
+	return decodedList.size();
+}
+
+// Returns the decoded pixmap (caller takes ownership) or NULL if the
+// caller must load the file itself. Waits if a worker is busy with it.
+Pixmap2D * PixmapPreloadCache::take(const string &path, int components) {
+	string key = getKey(path);
+
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(&mutexPixmapPreloadCache,mutexOwnerId);
+	if(enabled == false) {
+		return NULL;
+	}
+	for(;decodingList.find(key) != decodingList.end();) {
+		safeMutex.ReleaseLock(true);
+		sleep(1);
+		safeMutex.Lock();
+	}
+	claimedList.insert(key);
+
+	Pixmap2D *result = NULL;
+	std::map<string,DecodedPixmap>::iterator iterFind = decodedList.find(key);
+	if(iterFind != decodedList.end()) {
+		result = iterFind->second.pixmap;
+		decodedList.erase(iterFind);
+
+		if(result->getComponents() != components) {
+			delete result;
+			result = NULL;
+		}
+	}
+	return result;
+}
+
+void PixmapPreloadCache::clear() {
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(&mutexPixmapPreloadCache,mutexOwnerId);
+	enabled = false;
+	for(std::map<string,DecodedPixmap>::iterator iterMap = decodedList.begin();
+		iterMap != decodedList.end(); ++iterMap) {
+		delete iterMap->second.pixmap;
+	}
+	decodedList.clear();
+	claimedList.clear();
+}
+
 // =====================================================
 //	class Texture3D
 // =====================================================
@@ -27,7 +27,13 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
+#include <signal.h>
+
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
 
 #endif
 
@@ -1965,6 +1971,67 @@ bool executeShellCommand(string cmd, int expectedResult, ShellCommandOutputCallb
 	return result;
 }
 
+int forkProcessSessions(int sessionCount, vector<int> &sessionPids) {
+	sessionPids.clear();
+#ifndef WIN32
+	for(int index = 1; index < sessionCount; ++index) {
+		fflush(stdout);
+		fflush(stderr);
+		pid_t pid = fork();
+		if(pid == 0) {
+#if defined(__linux__)
+			// do not outlive the first session
+			prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+			sessionPids.clear();
+			return index;
+		}
+		else if(pid < 0) {
+			if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] could not fork session #%d, error: %s\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,index + 1,strerror(errno));
+			printf("Could not start session #%d, error: %s\n",index + 1,strerror(errno));
+			break;
+		}
+		sessionPids.push_back(pid);
+	}
+#endif
+	return 0;
+}
+
+void reapProcessSessions(vector<int> &sessionPids, bool stopSessions) {
+#ifndef WIN32
+	for(unsigned int index = 0; index < sessionPids.size();) {
+		pid_t pid = sessionPids[index];
+		if(stopSessions == true) {
+			kill(pid, SIGTERM);
+			waitpid(pid, NULL, 0);
+		}
+		else if(waitpid(pid, NULL, WNOHANG) == 0) {
+			++index;
+			continue;
+		}
+		sessionPids.erase(sessionPids.begin() + index);
+	}
+#endif
+}
+
+int getSessionPortStride(const vector<int> &sessionPorts, int sessionCount) {
+	// Two sessions clash when the distance between two of their ports is a
+	// multiple of the stride that sessionCount sessions can reach
+	for(int stride = 1;; ++stride) {
+		bool clash = false;
+		for(unsigned int first = 0; first < sessionPorts.size() && clash == false; ++first) {
+			for(unsigned int second = 0; second < sessionPorts.size() && clash == false; ++second) {
+				int distance = sessionPorts[second] - sessionPorts[first];
+				clash = (distance > 0 && distance % stride == 0 &&
+				         distance / stride < sessionCount);
+			}
+		}
+		if(clash == false) {
+			return stride;
+		}
+	}
+}
+
 bool removeFile(string file) {
 #ifdef WIN32
 	int result = _unlink(file.c_str());
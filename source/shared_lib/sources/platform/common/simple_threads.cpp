@@ -17,6 +17,14 @@
 #include "conversion.h"
 #include "platform_util.h"
 #include "cache_manager.h"
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#endif
+
 #include "leak_dumper.h"
 
 using namespace std;
@@ -384,6 +392,414 @@ void FileCRCPreCacheThread::execute() {
 	deleteSelfIfRequired();
 }
 
+// =====================================================
+//	class PixmapPreloadThread
+// =====================================================
+
+static const int64 pixmapPreloadUnclaimedMillis = 3000;
+
+PixmapPreloadThread::PixmapPreloadThread(const vector<string> &fileList,
+										unsigned int workerIndex,
+										unsigned int workerCount,
+										unsigned int maxDecodedPending) : BaseThread() {
+	this->fileList			= fileList;
+	this->workerIndex		= workerIndex;
+	this->workerCount		= (workerCount > 0 ? workerCount : 1);
+	this->maxDecodedPending	= maxDecodedPending;
+	uniqueID = "PixmapPreloadThread";
+}
+
+PixmapPreloadThread::~PixmapPreloadThread() {
+}
+
+bool PixmapPreloadThread::isPreloadableFile(const string &file) {
+	// Only the formats with a registered reader, so the
+	// reader lookup never has to insert into the shared map
+	string extension = toLower(extractExtension(file));
+	return (extension == "png" || extension == "jpg" ||
+			extension == "tga" || extension == "bmp");
+}
+
+bool PixmapPreloadThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
+	bool ret = (getExecutingTask() == false);
+	if(ret == false && deleteSelfIfShutdownDelayed == true) {
+	    setDeleteSelfOnExecutionDone(deleteSelfIfShutdownDelayed);
+	    deleteSelfIfRequired();
+	    signalQuit();
+	}
+
+	return ret;
+}
+
+void PixmapPreloadThread::execute() {
+	{
+		RunningStatusSafeWrapper runningStatus(this);
+		if(getQuitStatus() == true) {
+			deleteSelfIfRequired();
+			return;
+		}
+
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Pixmap preload worker %u of %u starting for %d files\n",workerIndex+1,workerCount,(int)fileList.size());
+
+		try {
+			for(unsigned int index = workerIndex; index < fileList.size(); index += workerCount) {
+				if(getQuitStatus() == true) {
+					break;
+				}
+
+				// Don't run too far ahead of the main thread, but make room
+				// once the oldest pixmaps have gone unclaimed for a while
+				for(;getQuitStatus() == false &&
+					 PixmapPreloadCache::evictDecoded(maxDecodedPending, pixmapPreloadUnclaimedMillis) >= maxDecodedPending;) {
+					sleep(5);
+				}
+				if(getQuitStatus() == true) {
+					break;
+				}
+
+				const string &file = fileList[index];
+				if(PixmapPreloadCache::beginDecode(file) == false) {
+					continue;
+				}
+
+				ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+				Pixmap2D *pixmap = NULL;
+				try {
+					pixmap = new Pixmap2D(Texture::defaultComponents);
+					pixmap->load(file);
+				}
+				catch(const exception &ex) {
+					// The main thread loads this one itself and reports the error
+					if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] file [%s] error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,file.c_str(),ex.what());
+					delete pixmap;
+					pixmap = NULL;
+				}
+				PixmapPreloadCache::endDecode(file, pixmap);
+			}
+		}
+		catch(const exception &ex) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		}
+		catch(...) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] UNKNOWN Error\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		}
+
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Pixmap preload worker %u of %u exiting\n",workerIndex+1,workerCount);
+	}
+	deleteSelfIfRequired();
+}
+
+// =====================================================
+//	class ContentCatalogThread
+// =====================================================
+
+#if defined(__linux__)
+static const uint32 contentCatalogWatchMask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+											IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF;
+#endif
+
+ContentCatalogThread::ContentCatalogThread() : BaseThread(),
+		mutexCatalog(new Mutex(CODE_AT_LINE)), changeSerial(0), watchHandle(-1) {
+	uniqueID = "ContentCatalogThread";
+#if defined(__linux__)
+	watchHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(watchHandle < 0) {
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] inotify_init1 failed, errno = %d, content changes will not be detected\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,errno);
+	}
+#endif
+}
+
+ContentCatalogThread::~ContentCatalogThread() {
+#if defined(__linux__)
+	if(watchHandle >= 0) {
+		close(watchHandle);
+		watchHandle = -1;
+	}
+#endif
+	delete mutexCatalog;
+	mutexCatalog = NULL;
+}
+
+string ContentCatalogThread::getEntryKey(const vector<string> &paths, const string &pathSearchString, const string &filterFileExt) {
+	string key = "";
+	for(unsigned int index = 0; index < paths.size(); ++index) {
+		key += paths[index] + "|";
+	}
+	return key + pathSearchString + "|" + filterFileExt;
+}
+
+void ContentCatalogThread::signalQuit() {
+	BaseThread::signalQuit();
+	semaphoreWork.signal();
+}
+
+bool ContentCatalogThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
+	bool ret = (getExecutingTask() == false);
+	if(ret == false && deleteSelfIfShutdownDelayed == true) {
+	    setDeleteSelfOnExecutionDone(deleteSelfIfShutdownDelayed);
+	    deleteSelfIfRequired();
+	    signalQuit();
+	}
+
+	return ret;
+}
+
+void ContentCatalogThread::queueEntry(const string &key, const vector<string> &paths, const string &pathSearchString,
+									const string &filterFileExt, bool forceNoCache, bool urgent) {
+	// mutexCatalog must be held by the caller
+	CatalogEntry &entry = entries[key];
+	if(entry.paths.empty() == true) {
+		entry.paths				= paths;
+		entry.pathSearchString	= pathSearchString;
+		entry.filterFileExt		= filterFileExt;
+	}
+	if(forceNoCache == true) {
+		entry.ready			= false;
+		entry.forceNoCache	= true;
+		entry.refreshGeneration++;
+	}
+	else if(entry.ready == true) {
+		return;
+	}
+
+	if(entry.queued == true) {
+		if(urgent == false) {
+			return;
+		}
+		std::deque<string>::iterator iterFind = std::find(pendingKeys.begin(),pendingKeys.end(),key);
+		if(iterFind != pendingKeys.end()) {
+			pendingKeys.erase(iterFind);
+		}
+	}
+	entry.queued = true;
+	if(urgent == true) {
+		pendingKeys.push_front(key);
+	}
+	else {
+		pendingKeys.push_back(key);
+	}
+	semaphoreWork.signal();
+}
+
+bool ContentCatalogThread::findChecksum(const vector<string> &paths, const string &pathSearchString,
+										const string &filterFileExt, uint32 &checksum) {
+	string key = getEntryKey(paths, pathSearchString, filterFileExt);
+
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(mutexCatalog,mutexOwnerId);
+	std::map<string,CatalogEntry>::iterator iterFind = entries.find(key);
+	if(iterFind != entries.end() && iterFind->second.ready == true) {
+		checksum = iterFind->second.checksum;
+		return true;
+	}
+	queueEntry(key, paths, pathSearchString, filterFileExt, false, true);
+	return false;
+}
+
+void ContentCatalogThread::prefetchChecksum(const vector<string> &paths, const string &pathSearchString,
+											const string &filterFileExt, bool forceNoCache) {
+	string key = getEntryKey(paths, pathSearchString, filterFileExt);
+
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(mutexCatalog,mutexOwnerId);
+	queueEntry(key, paths, pathSearchString, filterFileExt, forceNoCache, false);
+}
+
+unsigned int ContentCatalogThread::getChangeSerial() {
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(mutexCatalog,mutexOwnerId);
+	return changeSerial;
+}
+
+bool ContentCatalogThread::processNextEntry() {
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(mutexCatalog,mutexOwnerId);
+	if(pendingKeys.empty() == true) {
+		return false;
+	}
+	string key = pendingKeys.front();
+	pendingKeys.pop_front();
+	CatalogEntry entry = entries[key];
+	entries[key].queued			= false;
+	entries[key].forceNoCache	= false;
+	safeMutex.ReleaseLock(true);
+
+	ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+	uint32 checksum = getFolderTreeContentsCheckSumRecursively(entry.paths, entry.pathSearchString, entry.filterFileExt, NULL, entry.forceNoCache);
+	if(checksum == 0 && entry.forceNoCache == false) {
+		checksum = getFolderTreeContentsCheckSumRecursively(entry.paths, entry.pathSearchString, entry.filterFileExt, NULL, true);
+	}
+
+	safeMutex.Lock();
+	CatalogEntry &storedEntry = entries[key];
+	// A forced refresh that came in while this scan ran may have seen
+	// files it missed, leave the entry to the rescan queued for it
+	if(storedEntry.refreshGeneration == entry.refreshGeneration) {
+		if(storedEntry.ready == false || storedEntry.checksum != checksum) {
+			changeSerial++;
+		}
+		storedEntry.checksum	= checksum;
+		storedEntry.ready		= true;
+
+		// Lookups queued meanwhile are answered by this result
+		if(storedEntry.queued == true) {
+			std::deque<string>::iterator iterFind = std::find(pendingKeys.begin(),pendingKeys.end(),key);
+			if(iterFind != pendingKeys.end()) {
+				pendingKeys.erase(iterFind);
+			}
+			storedEntry.queued = false;
+		}
+	}
+	bool needWatches = (storedEntry.watched == false);
+	storedEntry.watched = true;
+	safeMutex.ReleaseLock();
+
+	if(needWatches == true) {
+		addWatches(key, entry);
+	}
+	return true;
+}
+
+void ContentCatalogThread::addWatches(const string &key, const CatalogEntry &entry) {
+#if defined(__linux__)
+	if(watchHandle < 0) {
+		return;
+	}
+	for(unsigned int index = 0; index < entry.paths.size(); ++index) {
+		string path = entry.paths[index] + entry.pathSearchString;
+		if(path.size() >= 2 && path.compare(path.size() - 2, 2, "/*") == 0) {
+			path.erase(path.size() - 2);
+		}
+		if(folderExists(path) == true) {
+			addWatchesRecursively(path, key);
+		}
+	}
+#endif
+}
+
+void ContentCatalogThread::addWatchesRecursively(const string &path, const string &key) {
+#if defined(__linux__)
+	int watchId = inotify_add_watch(watchHandle, path.c_str(), contentCatalogWatchMask);
+	if(watchId < 0) {
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] cannot watch [%s], errno = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,path.c_str(),errno);
+		return;
+	}
+	watchKeys[watchId].insert(key);
+	watchPaths[watchId] = path;
+
+	DIR *dir = opendir(path.c_str());
+	if(dir == NULL) {
+		return;
+	}
+	for(struct dirent *item = readdir(dir); item != NULL; item = readdir(dir)) {
+		string name = item->d_name;
+		if(name == "." || name == "..") {
+			continue;
+		}
+		string childPath = path + "/" + name;
+		if(isdir(childPath.c_str()) == true) {
+			addWatchesRecursively(childPath, key);
+		}
+	}
+	closedir(dir);
+#endif
+}
+
+void ContentCatalogThread::checkForChanges() {
+#if defined(__linux__)
+	if(watchHandle < 0) {
+		return;
+	}
+
+	std::set<string> changedKeys;
+	char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	for(;;) {
+		ssize_t length = read(watchHandle, buffer, sizeof(buffer));
+		if(length <= 0) {
+			break;
+		}
+		for(char *ptr = buffer; ptr < buffer + length;) {
+			const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			std::map<int,std::set<string> >::iterator iterFind = watchKeys.find(event->wd);
+			if(iterFind == watchKeys.end()) {
+				continue;
+			}
+			changedKeys.insert(iterFind->second.begin(),iterFind->second.end());
+
+			if((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)) && event->len > 0) {
+				string childPath = watchPaths[event->wd] + "/" + event->name;
+				for(std::set<string>::iterator iterKey = iterFind->second.begin();
+					iterKey != iterFind->second.end(); ++iterKey) {
+					addWatchesRecursively(childPath, *iterKey);
+				}
+			}
+			if(event->mask & IN_IGNORED) {
+				watchKeys.erase(event->wd);
+				watchPaths.erase(event->wd);
+			}
+		}
+	}
+
+	if(changedKeys.empty() == false) {
+		static string mutexOwnerId = CODE_AT_LINE;
+		MutexSafeWrapper safeMutex(mutexCatalog,mutexOwnerId);
+		for(std::set<string>::iterator iterKey = changedKeys.begin();
+			iterKey != changedKeys.end(); ++iterKey) {
+			std::map<string,CatalogEntry>::iterator iterEntry = entries.find(*iterKey);
+			if(iterEntry == entries.end()) {
+				continue;
+			}
+			if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Content catalog: [%s] changed on disk, recomputing\n",iterEntry->second.pathSearchString.c_str());
+
+			// Keep serving the old value until the new one is ready
+			CatalogEntry &entry = iterEntry->second;
+			entry.forceNoCache = true;
+			entry.refreshGeneration++;
+			if(entry.queued == false) {
+				entry.queued = true;
+				pendingKeys.push_back(*iterKey);
+			}
+		}
+	}
+#endif
+}
+
+void ContentCatalogThread::execute() {
+	{
+		RunningStatusSafeWrapper runningStatus(this);
+		if(getQuitStatus() == true) {
+			deleteSelfIfRequired();
+			return;
+		}
+
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Content catalog thread is running\n");
+
+		try {
+			for(;getQuitStatus() == false;) {
+				// Wake up now and then to pick up file change events
+				semaphoreWork.waitTillSignalled(250);
+				if(getQuitStatus() == true) {
+					break;
+				}
+				checkForChanges();
+				for(;getQuitStatus() == false && processNextEntry() == true;) {
+				}
+			}
+		}
+		catch(const exception &ex) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		}
+		catch(...) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] UNKNOWN Error\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		}
+
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Content catalog thread is exiting\n");
+	}
+	deleteSelfIfRequired();
+}
+
 SimpleTaskThread::SimpleTaskThread(	SimpleTaskCallbackInterface *simpleTaskInterface,
 									unsigned int executionCount,
 									unsigned int millisecsBetweenExecutions,
@@ -0,0 +1,819 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "content_transfer.h"
+#include "util.h"
+#include "platform_common.h"
+#include "checksum.h"
+#include "conversion.h"
+#include "compression_utils.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+using namespace Shared::CompressionUtil;
+
+namespace Shared { namespace PlatformCommon {
+
+enum ContentTransferMessageType {
+	ctm_ManifestRequest	= 1,
+	ctm_Manifest		= 2,
+	ctm_ChunkRequest	= 3,
+	ctm_Chunk			= 4
+};
+
+// Requests only carry names and offsets, answers at most one chunk
+static const uint32 maxContentTransferRequestSize	= 4096;
+static const uint32 maxContentTransferResponseSize	= 64 * 1024 * 1024;
+static const int contentTransferReplyTimeoutSeconds	= 30;
+static const int contentTransferRequestTimeoutSeconds	= 10;
+
+// =====================================================
+//	Wire helpers, integers in network byte order and
+//	strings as a 16 bit length followed by the bytes
+// =====================================================
+
+static void putUInt8(vector<unsigned char> &buf, uint8 value) {
+	buf.push_back(value);
+}
+
+static void putUInt32(vector<unsigned char> &buf, uint32 value) {
+	buf.push_back(static_cast<unsigned char>(value >> 24));
+	buf.push_back(static_cast<unsigned char>(value >> 16));
+	buf.push_back(static_cast<unsigned char>(value >> 8));
+	buf.push_back(static_cast<unsigned char>(value));
+}
+
+static void putString(vector<unsigned char> &buf, const string &value) {
+	uint16 length = static_cast<uint16>(min(value.size(),(size_t)0xFFFF));
+	buf.push_back(static_cast<unsigned char>(length >> 8));
+	buf.push_back(static_cast<unsigned char>(length));
+	buf.insert(buf.end(), value.begin(), value.begin() + length);
+}
+
+class ContentTransferReader {
+private:
+	const unsigned char *buf;
+	const unsigned char *bufEnd;
+	bool overrun;
+
+	bool available(unsigned int count) {
+		if(overrun == true || static_cast<unsigned int>(bufEnd - buf) < count) {
+			overrun = true;
+			return false;
+		}
+		return true;
+	}
+
+public:
+	ContentTransferReader(const unsigned char *buf, unsigned int size) :
+		buf(buf), bufEnd(buf + size), overrun(false) {}
+
+	uint8 getUInt8() {
+		return (available(1) ? *buf++ : 0);
+	}
+	uint32 getUInt32() {
+		if(available(4) == false) {
+			return 0;
+		}
+		uint32 value = (static_cast<uint32>(buf[0]) << 24) |
+		               (static_cast<uint32>(buf[1]) << 16) |
+		               (static_cast<uint32>(buf[2]) << 8)  |
+		                static_cast<uint32>(buf[3]);
+		buf += 4;
+		return value;
+	}
+	string getString() {
+		if(available(2) == false) {
+			return "";
+		}
+		uint16 length = static_cast<uint16>((buf[0] << 8) | buf[1]);
+		buf += 2;
+		if(available(length) == false) {
+			return "";
+		}
+		string value(reinterpret_cast<const char *>(buf), length);
+		buf += length;
+		return value;
+	}
+	const unsigned char * getBytes(unsigned int count) {
+		if(available(count) == false) {
+			return NULL;
+		}
+		const unsigned char *bytes = buf;
+		buf += count;
+		return bytes;
+	}
+	unsigned int getRemaining() const { return static_cast<unsigned int>(bufEnd - buf); }
+	const unsigned char * getPosition() const { return buf; }
+	bool hasOverrun() const { return overrun; }
+};
+
+static uint32 getContentFileCRC(const string &file, bool useCachedCRCs) {
+	if(useCachedCRCs == false) {
+		Checksum::removeFileFromCache(file);
+	}
+	Checksum checksum;
+	checksum.addFile(file);
+	return checksum.getSum();
+}
+
+static bool isContentPartFile(const string &file) {
+	return EndsWith(file, ".part");
+}
+
+static string getContentPartFile(const string &file, uint32 crc) {
+	// The CRC in the name keeps a changed file from resuming a stale part
+	char szBuf[40] = "";
+	snprintf(szBuf, 40, ".%08x.part", crc);
+	return file + szBuf;
+}
+
+// =====================================================
+//	class ContentManifest
+// =====================================================
+
+ContentManifest ContentManifest::buildFromFolder(const string &rootFolder, bool useCachedCRCs) {
+	ContentManifest manifest;
+
+	string root = rootFolder;
+	endPathWithSlash(root);
+	if(folderExists(root) == false) {
+		return manifest;
+	}
+
+	if(useCachedCRCs == true) {
+		vector<std::pair<string,uint32> > crcList = getFolderTreeContentsCheckSumListRecursively(root + "*", "", NULL);
+		for(unsigned int index = 0; index < crcList.size(); ++index) {
+			string file = crcList[index].first;
+			if(StartsWith(file, root) == false || isContentPartFile(file) == true) {
+				continue;
+			}
+			manifest.addEntry(ContentManifestEntry(file.substr(root.size()),
+									static_cast<uint32>(getFileSize(file)), crcList[index].second));
+		}
+	}
+	else {
+		vector<string> fileList = getFolderTreeContentsListRecursively(root + "*", "");
+		for(unsigned int index = 0; index < fileList.size(); ++index) {
+			string file = fileList[index];
+			if(StartsWith(file, root) == false || isContentPartFile(file) == true ||
+				EndsWith(file, ".git") == true) {
+				continue;
+			}
+			manifest.addEntry(ContentManifestEntry(file.substr(root.size()),
+									static_cast<uint32>(getFileSize(file)), getContentFileCRC(file, false)));
+		}
+	}
+	return manifest;
+}
+
+ContentManifest ContentManifest::buildFromFile(const string &file, bool useCachedCRCs) {
+	ContentManifest manifest;
+	if(fileExists(file) == true) {
+		manifest.addEntry(ContentManifestEntry(extractFileFromDirectoryPath(file),
+								static_cast<uint32>(getFileSize(file)), getContentFileCRC(file, useCachedCRCs)));
+	}
+	return manifest;
+}
+
+bool ContentManifest::isSafePath(const string &path) {
+	if(path == "" || path[0] == '/' || path[0] == '\\' || path.find(':') != string::npos) {
+		return false;
+	}
+	vector<string> parts;
+	Tokenize(path, parts, "/");
+	for(unsigned int index = 0; index < parts.size(); ++index) {
+		if(parts[index] == ".." || parts[index].find('\\') != string::npos) {
+			return false;
+		}
+	}
+	return true;
+}
+
+const ContentManifestEntry * ContentManifest::findEntry(const string &path) const {
+	for(unsigned int index = 0; index < entries.size(); ++index) {
+		if(entries[index].path == path) {
+			return &entries[index];
+		}
+	}
+	return NULL;
+}
+
+vector<ContentManifestEntry> ContentManifest::getChangedEntries(const ContentManifest &local) const {
+	vector<ContentManifestEntry> result;
+	for(unsigned int index = 0; index < entries.size(); ++index) {
+		const ContentManifestEntry *localEntry = local.findEntry(entries[index].path);
+		if(localEntry == NULL || localEntry->crc != entries[index].crc ||
+			localEntry->size != entries[index].size) {
+			result.push_back(entries[index]);
+		}
+	}
+	return result;
+}
+
+vector<string> ContentManifest::getExtraFiles(const ContentManifest &local) const {
+	vector<string> result;
+	for(unsigned int index = 0; index < local.entries.size(); ++index) {
+		if(findEntry(local.entries[index].path) == NULL) {
+			result.push_back(local.entries[index].path);
+		}
+	}
+	return result;
+}
+
+void ContentManifest::encode(vector<unsigned char> &buf) const {
+	putUInt32(buf, static_cast<uint32>(entries.size()));
+	for(unsigned int index = 0; index < entries.size(); ++index) {
+		putString(buf, entries[index].path);
+		putUInt32(buf, entries[index].size);
+		putUInt32(buf, entries[index].crc);
+	}
+}
+
+bool ContentManifest::decode(const unsigned char *buf, unsigned int size) {
+	entries.clear();
+	ContentTransferReader reader(buf, size);
+	uint32 count = reader.getUInt32();
+	for(uint32 index = 0; index < count && reader.hasOverrun() == false; ++index) {
+		ContentManifestEntry entry;
+		entry.path	= reader.getString();
+		entry.size	= reader.getUInt32();
+		entry.crc	= reader.getUInt32();
+		if(isSafePath(entry.path) == false) {
+			return false;
+		}
+		entries.push_back(entry);
+	}
+	return (reader.hasOverrun() == false);
+}
+
+// =====================================================
+//	class ContentTransferServerThread
+// =====================================================
+
+ContentTransferServerThread::ContentTransferServerThread(std::pair<string,string> mapsPath,
+		std::pair<string,string> tilesetsPath, std::pair<string,string> techtreesPath,
+		int portNumber, FTPClientValidationInterface *validationIntf) : BaseThread() {
+	this->mapsPath			= mapsPath;
+	this->tilesetsPath		= tilesetsPath;
+	this->techtreesPath		= techtreesPath;
+	this->portNumber		= portNumber;
+	this->validationIntf	= validationIntf;
+	this->serverSocket		= NULL;
+	uniqueID = "ContentTransferServerThread";
+}
+
+ContentTransferServerThread::~ContentTransferServerThread() {
+	for(unsigned int index = 0; index < clientSockets.size(); ++index) {
+		delete clientSockets[index];
+	}
+	clientSockets.clear();
+	delete serverSocket;
+	serverSocket = NULL;
+}
+
+bool ContentTransferServerThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
+	bool ret = (getExecutingTask() == false);
+	if(ret == false && deleteSelfIfShutdownDelayed == true) {
+	    setDeleteSelfOnExecutionDone(deleteSelfIfShutdownDelayed);
+	    deleteSelfIfRequired();
+	    signalQuit();
+	}
+
+	return ret;
+}
+
+string ContentTransferServerThread::getItemPath(ContentTransferType type, const string &name) const {
+	// "." would serve the whole search folder as one item
+	if(ContentManifest::isSafePath(name) == false || name.find('/') != string::npos ||
+		name == ".") {
+		return "";
+	}
+
+	vector<string> searchPaths;
+	switch(type) {
+		case ctt_Map:
+			searchPaths.push_back(mapsPath.first);
+			searchPaths.push_back(mapsPath.second);
+			break;
+		case ctt_Tileset:
+			searchPaths.push_back(tilesetsPath.first);
+			searchPaths.push_back(tilesetsPath.second);
+			break;
+		case ctt_Techtree:
+			searchPaths.push_back(techtreesPath.first);
+			searchPaths.push_back(techtreesPath.second);
+			break;
+		default:
+			return "";
+	}
+
+	for(unsigned int index = 0; index < searchPaths.size(); ++index) {
+		string path = searchPaths[index];
+		if(path == "") {
+			continue;
+		}
+		endPathWithSlash(path);
+		if(type == ctt_Map) {
+			if(fileExists(path + name + ".mgm") == true) {
+				return path + name + ".mgm";
+			}
+			if(fileExists(path + name + ".gbm") == true) {
+				return path + name + ".gbm";
+			}
+		}
+		else if(folderExists(path + name) == true) {
+			return path + name;
+		}
+	}
+	return "";
+}
+
+bool ContentTransferServerThread::isClientAllowed(Socket *socket) {
+	if(validationIntf == NULL) {
+		return true;
+	}
+	uint32 clientIp = socket->getConnectedIPAddress(socket->getIpAddress());
+	return (validationIntf->isValidClientType(clientIp) != 0);
+}
+
+static uint32 getContentFrameSize(const unsigned char *header) {
+	return (static_cast<uint32>(header[0]) << 24) | (static_cast<uint32>(header[1]) << 16) |
+		   (static_cast<uint32>(header[2]) << 8) | static_cast<uint32>(header[3]);
+}
+
+bool ContentTransferServerThread::isRequestComplete(Socket *socket) {
+	int available = socket->getDataToRead(true);
+	if(available <= 0) {
+		// Readable without data, the receive notices the disconnect
+		return true;
+	}
+	if(available < 4) {
+		return false;
+	}
+	unsigned char header[4];
+	if(socket->peek(header, 4) != 4) {
+		return true;
+	}
+	uint32 requestSize = getContentFrameSize(header);
+	if(requestSize == 0 || requestSize > maxContentTransferRequestSize) {
+		// Rejected as soon as it is read
+		return true;
+	}
+	return (static_cast<uint32>(available) >= 4 + requestSize);
+}
+
+bool ContentTransferServerThread::processRequest(Socket *socket) {
+	unsigned char header[4];
+	if(socket->receive(header, 4, true) != 4) {
+		return false;
+	}
+	uint32 requestSize = getContentFrameSize(header);
+	if(requestSize == 0 || requestSize > maxContentTransferRequestSize) {
+		return false;
+	}
+	vector<unsigned char> request(requestSize);
+	if(socket->receive(&request[0], requestSize, true) != (int)requestSize) {
+		return false;
+	}
+
+	ContentTransferReader reader(&request[0], requestSize);
+	uint8 messageType				= reader.getUInt8();
+	ContentTransferType type		= static_cast<ContentTransferType>(reader.getUInt8());
+	string name						= reader.getString();
+	string itemPath					= getItemPath(type, name);
+
+	vector<unsigned char> response;
+	putUInt32(response, 0);
+	if(messageType == ctm_ManifestRequest && reader.hasOverrun() == false) {
+		putUInt8(response, ctm_Manifest);
+		if(itemPath == "") {
+			putUInt8(response, cts_NotFound);
+		}
+		else {
+			putUInt8(response, cts_Ok);
+			ContentManifest manifest = (type == ctt_Map ?
+							ContentManifest::buildFromFile(itemPath, true) :
+							ContentManifest::buildFromFolder(itemPath, true));
+			manifest.encode(response);
+		}
+	}
+	else if(messageType == ctm_ChunkRequest) {
+		string path		= reader.getString();
+		uint32 offset	= reader.getUInt32();
+		uint32 crc		= reader.getUInt32();
+		if(reader.hasOverrun() == true) {
+			return false;
+		}
+
+		string file = "";
+		if(itemPath != "" && ContentManifest::isSafePath(path) == true) {
+			if(type == ctt_Map) {
+				file = (extractFileFromDirectoryPath(itemPath) == path ? itemPath : "");
+			}
+			else {
+				file = itemPath + "/" + path;
+			}
+		}
+
+		putUInt8(response, ctm_Chunk);
+		if(file == "" || fileExists(file) == false) {
+			putUInt8(response, cts_NotFound);
+		}
+		else if(getContentFileCRC(file, true) != crc) {
+			putUInt8(response, cts_Changed);
+		}
+		else {
+			vector<unsigned char> raw(ContentTransferClient::chunkSize);
+			uint32 rawLength = 0;
+#ifdef WIN32
+			FILE *fp = _wfopen(utf8_decode(file).c_str(), L"rb");
+#else
+			FILE *fp = fopen(file.c_str(), "rb");
+#endif
+			if(fp != NULL) {
+				if(fseek(fp, offset, SEEK_SET) == 0) {
+					rawLength = static_cast<uint32>(fread(&raw[0], 1, raw.size(), fp));
+				}
+				fclose(fp);
+			}
+
+			putUInt8(response, (fp != NULL ? cts_Ok : cts_NotFound));
+			putUInt32(response, offset);
+			putUInt32(response, rawLength);
+
+			std::pair<unsigned char *,unsigned long> compressed(NULL, 0);
+			if(rawLength > 0) {
+				compressed = compressMemoryToMemory(&raw[0], rawLength);
+			}
+			// Already compressed data (textures, sounds) goes as is
+			bool useCompressed = (compressed.first != NULL && compressed.second < rawLength);
+			putUInt8(response, useCompressed ? 1 : 0);
+			if(useCompressed == true) {
+				putUInt32(response, static_cast<uint32>(compressed.second));
+				response.insert(response.end(), compressed.first, compressed.first + compressed.second);
+			}
+			else {
+				putUInt32(response, rawLength);
+				response.insert(response.end(), raw.begin(), raw.begin() + rawLength);
+			}
+			delete [] compressed.first;
+		}
+	}
+	else {
+		return false;
+	}
+
+	uint32 responseSize = static_cast<uint32>(response.size() - 4);
+	response[0] = static_cast<unsigned char>(responseSize >> 24);
+	response[1] = static_cast<unsigned char>(responseSize >> 16);
+	response[2] = static_cast<unsigned char>(responseSize >> 8);
+	response[3] = static_cast<unsigned char>(responseSize);
+	return (socket->send(&response[0], (int)response.size()) == (int)response.size());
+}
+
+void ContentTransferServerThread::execute() {
+	{
+		RunningStatusSafeWrapper runningStatus(this);
+		if(getQuitStatus() == true) {
+			deleteSelfIfRequired();
+			return;
+		}
+
+		try {
+			serverSocket = new ServerSocket(true);
+			serverSocket->setBindPort(portNumber);
+			serverSocket->bind(portNumber);
+			serverSocket->listen();
+
+			if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Content transfer server listening on port %d\n",portNumber);
+
+			for(;getQuitStatus() == false;) {
+				bool servedRequest = false;
+				for(unsigned int index = 0; index < clientSockets.size() && getQuitStatus() == false;) {
+					Socket *client = clientSockets[index];
+					bool keepClient = (client->isSocketValid() == true);
+					if(keepClient == true && client->hasDataToRead() == true) {
+						if(isRequestComplete(client) == true) {
+							partialRequestTimes.erase(client);
+							ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+							keepClient = processRequest(client);
+							servedRequest = true;
+						}
+						// Waiting on the rest would stall every other client
+						else if(partialRequestTimes.find(client) == partialRequestTimes.end()) {
+							partialRequestTimes[client] = time(NULL);
+						}
+						else if(difftime(time(NULL),partialRequestTimes[client]) > contentTransferRequestTimeoutSeconds) {
+							if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] dropping content transfer client [%s], request incomplete for %d seconds\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,client->getIpAddress().c_str(),contentTransferRequestTimeoutSeconds);
+							keepClient = false;
+						}
+					}
+					if(keepClient == false) {
+						partialRequestTimes.erase(client);
+						delete client;
+						clientSockets.erase(clientSockets.begin() + index);
+						continue;
+					}
+					++index;
+				}
+
+				// Only block on the listener while no transfer is running
+				bool pendingConnection = (servedRequest == true ?
+						serverSocket->hasDataToRead() :
+						serverSocket->hasDataToReadWithWait(50000));
+				if(pendingConnection == true && getQuitStatus() == false) {
+					Socket *client = serverSocket->accept(false);
+					if(client != NULL) {
+						if(isClientAllowed(client) == true) {
+							clientSockets.push_back(client);
+						}
+						else {
+							if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] refusing content transfer client [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,client->getIpAddress().c_str());
+							delete client;
+						}
+					}
+				}
+			}
+		}
+		catch(const exception &ex) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		}
+		catch(...) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] UNKNOWN Error\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		}
+
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Content transfer server exiting\n");
+	}
+	deleteSelfIfRequired();
+}
+
+// =====================================================
+//	class ContentTransferClient
+// =====================================================
+
+ContentTransferClient::ContentTransferClient(const string &serverIp, int portNumber,
+											ContentTransferProgressInterface *progressIntf) {
+	this->serverIp				= serverIp;
+	this->portNumber			= portNumber;
+	this->maxConnectAttempts	= 3;
+	this->progressIntf			= progressIntf;
+	this->socket				= NULL;
+}
+
+ContentTransferClient::~ContentTransferClient() {
+	disconnect();
+}
+
+bool ContentTransferClient::connect() {
+	disconnect();
+	try {
+		socket = new ClientSocket();
+		socket->connect(Ip(serverIp), portNumber);
+	}
+	catch(const exception &ex) {
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] connect to [%s:%d] failed [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,serverIp.c_str(),portNumber,ex.what());
+	}
+	if(socket == NULL || socket->isConnected() == false) {
+		disconnect();
+		return false;
+	}
+	return true;
+}
+
+void ContentTransferClient::disconnect() {
+	delete socket;
+	socket = NULL;
+}
+
+bool ContentTransferClient::exchange(const vector<unsigned char> &request, vector<unsigned char> &response) {
+	vector<unsigned char> frame;
+	putUInt32(frame, static_cast<uint32>(request.size()));
+	frame.insert(frame.end(), request.begin(), request.end());
+
+	for(int attempt = 0; attempt < maxConnectAttempts; ++attempt) {
+		if(attempt > 0) {
+			sleep(250 * attempt);
+		}
+		if(socket == NULL && connect() == false) {
+			continue;
+		}
+
+		if(socket->send(&frame[0], (int)frame.size()) == (int)frame.size()) {
+			// The server may first have to scan the folder for its manifest
+			time_t waitStart = time(NULL);
+			bool replied = false;
+			for(;socket->isConnected() == true &&
+				 difftime(time(NULL),waitStart) <= contentTransferReplyTimeoutSeconds;) {
+				if(socket->hasDataToReadWithWait(100000) == true) {
+					replied = true;
+					break;
+				}
+			}
+
+			unsigned char header[4];
+			if(replied == true && socket->receive(header, 4, true) == 4) {
+				uint32 responseSize = getContentFrameSize(header);
+				if(responseSize > 0 && responseSize <= maxContentTransferResponseSize) {
+					response.resize(responseSize);
+					if(socket->receive(&response[0], responseSize, true) == (int)responseSize) {
+						return true;
+					}
+				}
+			}
+		}
+		// Resume on a fresh connection
+		disconnect();
+	}
+	return false;
+}
+
+bool ContentTransferClient::fetchFile(ContentTransferType type, const string &name, const string &destFolder,
+									const ContentManifestEntry &entry, double &bytesDone, double bytesTotal,
+									string &error) {
+	string file = destFolder + entry.path;
+	string partFile = getContentPartFile(file, entry.crc);
+	createDirectoryPaths(extractDirectoryPathFromFile(file));
+
+	uint32 offset = (fileExists(partFile) == true ? static_cast<uint32>(getFileSize(partFile)) : 0);
+	if(offset > entry.size) {
+		removeFile(partFile);
+		offset = 0;
+	}
+	bytesDone += offset;
+
+#ifdef WIN32
+	FILE *fp = _wfopen(utf8_decode(partFile).c_str(), L"ab");
+#else
+	FILE *fp = fopen(partFile.c_str(), "ab");
+#endif
+	if(fp == NULL) {
+		error = "cannot write [" + partFile + "]";
+		return false;
+	}
+
+	for(;offset < entry.size;) {
+		vector<unsigned char> request;
+		putUInt8(request, ctm_ChunkRequest);
+		putUInt8(request, static_cast<uint8>(type));
+		putString(request, name);
+		putString(request, entry.path);
+		putUInt32(request, offset);
+		putUInt32(request, entry.crc);
+
+		vector<unsigned char> response;
+		if(exchange(request, response) == false) {
+			// Keep the part file so the next attempt resumes here
+			fclose(fp);
+			error = "lost connection to the server while receiving [" + entry.path + "]";
+			return false;
+		}
+
+		ContentTransferReader reader(&response[0], (unsigned int)response.size());
+		uint8 messageType	= reader.getUInt8();
+		uint8 status		= reader.getUInt8();
+		uint32 chunkOffset	= reader.getUInt32();
+		uint32 rawLength	= reader.getUInt32();
+		uint8 compressed	= reader.getUInt8();
+		uint32 dataLength	= reader.getUInt32();
+		const unsigned char *data = reader.getBytes(dataLength);
+		if(messageType != ctm_Chunk || status != cts_Ok) {
+			fclose(fp);
+			removeFile(partFile);
+			error = (status == cts_Changed ? "[" + entry.path + "] changed on the server" :
+											 "server cannot send [" + entry.path + "]");
+			return false;
+		}
+		if(reader.hasOverrun() == true || chunkOffset != offset || rawLength == 0 ||
+			offset + rawLength > entry.size) {
+			fclose(fp);
+			error = "invalid chunk for [" + entry.path + "]";
+			return false;
+		}
+
+		size_t written = 0;
+		if(compressed != 0) {
+			std::pair<unsigned char *,unsigned long> raw = extractMemoryToMemory(
+					const_cast<unsigned char *>(data), dataLength, rawLength);
+			if(raw.second == rawLength) {
+				written = fwrite(raw.first, 1, rawLength, fp);
+			}
+			delete [] raw.first;
+		}
+		else if(dataLength == rawLength) {
+			written = fwrite(data, 1, rawLength, fp);
+		}
+		if(written != rawLength) {
+			fclose(fp);
+			error = "cannot write [" + partFile + "]";
+			return false;
+		}
+
+		offset		+= rawLength;
+		bytesDone	+= rawLength;
+		if(progressIntf != NULL &&
+			progressIntf->ContentTransfer_Progress(name, bytesDone, bytesTotal) == false) {
+			fclose(fp);
+			error = "aborted";
+			return false;
+		}
+	}
+	fclose(fp);
+
+	if(fileExists(file) == true) {
+		removeFile(file);
+	}
+	renameFile(partFile, file);
+	if(getContentFileCRC(file, false) != entry.crc) {
+		removeFile(file);
+		error = "CRC mismatch for [" + entry.path + "]";
+		return false;
+	}
+	return true;
+}
+
+bool ContentTransferClient::fetch(ContentTransferType type, const string &name, const string &destFolder, string &error) {
+	// "." would serve the whole search folder as one item
+	if(ContentManifest::isSafePath(name) == false || name.find('/') != string::npos ||
+		name == ".") {
+		error = "invalid name [" + name + "]";
+		return false;
+	}
+
+	vector<unsigned char> request;
+	putUInt8(request, ctm_ManifestRequest);
+	putUInt8(request, static_cast<uint8>(type));
+	putString(request, name);
+
+	vector<unsigned char> response;
+	if(exchange(request, response) == false) {
+		error = "no answer from " + serverIp + ":" + intToStr(portNumber);
+		return false;
+	}
+
+	ContentTransferReader reader(&response[0], (unsigned int)response.size());
+	uint8 messageType	= reader.getUInt8();
+	uint8 status		= reader.getUInt8();
+	ContentManifest remote;
+	if(messageType != ctm_Manifest || status != cts_Ok ||
+		remote.decode(reader.getPosition(), reader.getRemaining()) == false) {
+		error = (status == cts_NotFound ? "server does not have [" + name + "]" :
+										  "invalid manifest for [" + name + "]");
+		return false;
+	}
+
+	string itemFolder = destFolder;
+	endPathWithSlash(itemFolder);
+	ContentManifest local;
+	if(type == ctt_Map) {
+		// Maps share one folder, only look at the file the server has
+		for(unsigned int index = 0; index < remote.getEntries().size(); ++index) {
+			ContentManifest mapManifest = ContentManifest::buildFromFile(itemFolder + remote.getEntries()[index].path, false);
+			if(mapManifest.getEntries().empty() == false) {
+				local.addEntry(mapManifest.getEntries()[0]);
+			}
+		}
+	}
+	else {
+		itemFolder += name + "/";
+		local = ContentManifest::buildFromFolder(itemFolder, false);
+	}
+
+	vector<ContentManifestEntry> changedEntries = remote.getChangedEntries(local);
+	double bytesTotal = 0;
+	for(unsigned int index = 0; index < changedEntries.size(); ++index) {
+		bytesTotal += changedEntries[index].size;
+	}
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Content transfer of [%s]: %d of %d files to fetch, %.0f bytes\n",name.c_str(),(int)changedEntries.size(),(int)remote.getEntries().size(),bytesTotal);
+
+	double bytesDone = 0;
+	for(unsigned int index = 0; index < changedEntries.size(); ++index) {
+		if(fetchFile(type, name, itemFolder, changedEntries[index], bytesDone, bytesTotal, error) == false) {
+			disconnect();
+			return false;
+		}
+	}
+	disconnect();
+
+	// Files the server doesn't have would change the folder CRC
+	if(type != ctt_Map) {
+		vector<string> extraFiles = remote.getExtraFiles(local);
+		for(unsigned int index = 0; index < extraFiles.size(); ++index) {
+			removeFile(itemFolder + extraFiles[index]);
+		}
+	}
+	return true;
+}
+
+}}//end namespace
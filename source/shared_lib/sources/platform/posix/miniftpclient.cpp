@@ -245,6 +245,8 @@ FTPClientThread::FTPClientThread(int portNumber, string serverUrl,
 
 	uniqueID = "FTPClientThread";
     this->portNumber    = portNumber;
+    this->contentTransferPort = 0;
+    this->contentTransferDownloadType = ftp_cct_Map;
     this->serverUrl     = serverUrl;
     this->mapsPath      = mapsPath;
     this->tilesetsPath  = tilesetsPath;
@@ -376,6 +378,9 @@ void FTPClientThread::getMapFromServer(pair<string,string> mapFileName) {
 		result = getMapFromServer(mapFileName, "", "");
 	}
 	else {
+		result = getContentFromServer(ctt_Map, ftp_cct_Map, mapFileName.first, this->mapsPath.second);
+	}
+	if(result.first != ftp_crt_SUCCESS && mapFileName.second == "" && this->getQuitStatus() == false) {
 		pair<string,string> findMapFileName = mapFileName;
 		findMapFileName.first += + ".mgm";
 
@@ -475,7 +480,10 @@ void FTPClientThread::getTilesetFromServer(pair<string,string> tileSetName) {
 			this->fileArchiveExtractCommandSuccessResult);
 
 	pair<FTP_Client_ResultType,string> result = make_pair(ftp_crt_FAIL,"");
-	if(findArchive == true) {
+	if(tileSetName.second == "") {
+		result = getContentFromServer(ctt_Tileset, ftp_cct_Tileset, tileSetName.first, this->tilesetsPath.second);
+	}
+	if(result.first != ftp_crt_SUCCESS && findArchive == true && this->getQuitStatus() == false) {
 		if(tileSetName.second != "") {
 			//result = getTilesetFromServer(tileSetName, "", "", "", findArchive);
 			result = getTilesetFromServer(tileSetName, "", "", "", true);
@@ -663,7 +671,10 @@ void FTPClientThread::getTechtreeFromServer(pair<string,string> techtreeName) {
 	bool findArchive = executeShellCommand(
 			this->fileArchiveExtractCommand,
 			this->fileArchiveExtractCommandSuccessResult);
-	if(findArchive == true) {
+	if(techtreeName.second == "") {
+		result = getContentFromServer(ctt_Techtree, ftp_cct_Techtree, techtreeName.first, this->techtreesPath.second);
+	}
+	if(result.first != ftp_crt_SUCCESS && findArchive == true && this->getQuitStatus() == false) {
 		if(techtreeName.second != "") {
 			result = getTechtreeFromServer(techtreeName, "", "");
 		}
@@ -741,6 +752,54 @@ pair<FTP_Client_ResultType,string>  FTPClientThread::getTechtreeFromServer(pair<
 
 }
 
+pair<FTP_Client_ResultType,string> FTPClientThread::getContentFromServer(ContentTransferType contentType,
+		FTP_Client_CallbackType downloadType, string itemName, string destFolder) {
+	pair<FTP_Client_ResultType,string> result = make_pair(ftp_crt_FAIL,"");
+	if(this->contentTransferPort <= 0 || serverUrl == "" || destFolder == "") {
+		return result;
+	}
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("===> FTP Client thread about to fetch [%s] from content transfer port %d\n",itemName.c_str(),this->contentTransferPort);
+
+	this->contentTransferDownloadType = downloadType;
+	ContentTransferClient client(serverUrl, this->contentTransferPort, this);
+	string error = "";
+	if(client.fetch(contentType, itemName, destFolder, error) == true) {
+		result.first = ftp_crt_SUCCESS;
+	}
+	else {
+		result.second = error;
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line %d] content transfer of [%s] failed [%s], falling back to ftp\n",__FILE__,__FUNCTION__,__LINE__,itemName.c_str(),error.c_str());
+	}
+	return result;
+}
+
+bool FTPClientThread::ContentTransfer_Progress(const string &itemName, double bytesDone, double bytesTotal) {
+	if(this->getQuitStatus() == true) {
+		return false;
+	}
+
+	static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(this->getProgressMutex(),mutexOwnerId);
+	this->getProgressMutex()->setOwnerId(mutexOwnerId);
+	if(this->pCBObject != NULL) {
+		FTPClientCallbackInterface::FtpProgressStats stats;
+		stats.download_total	= bytesTotal;
+		stats.download_now		= bytesDone;
+		stats.upload_total		= 0;
+		stats.upload_now		= 0;
+		stats.currentFilename	= itemName;
+		stats.downloadType		= this->contentTransferDownloadType;
+
+		this->pCBObject->FTPClient_CallbackEvent(
+				itemName,
+				ftp_cct_DownloadProgress,
+				make_pair(ftp_crt_SUCCESS,""),
+				&stats);
+	}
+	return true;
+}
+
 void FTPClientThread::getScenarioFromServer(pair<string,string> fileName) {
 	pair<FTP_Client_ResultType,string> result = make_pair(ftp_crt_FAIL,"");
 	bool findArchive = executeShellCommand(
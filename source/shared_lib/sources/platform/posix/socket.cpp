@@ -20,10 +20,14 @@
 #if defined(HAVE_SYS_FILIO_H) /* needed for FIONREAD on Solaris 2.5 */
   #include <sys/filio.h>
 #endif
+#if defined(__linux__)
+  #include <sys/epoll.h>
+#endif
 
 #include "conversion.h"
 #include "util.h"
 #include "platform_util.h"
+#include "content_transfer.h"
 #include <algorithm>
 
 #ifdef WIN32
@@ -78,6 +82,12 @@ int ServerSocket::ftpServerPort = 61358;
 int ServerSocket::maxPlayerCount = -1;
 int ServerSocket::externalPort  = Socket::broadcast_portno;
 BroadCastClientSocketThread *ClientSocket::broadCastClientThread = NULL;
+int Socket::simulatedLatencyMillis = 0;
+Mutex Socket::simulatedLatencySynchAccessor;
+std::set<Socket *> Socket::simulatedLatencySockets;
+SimulatedLatencySocketThread *Socket::simulatedLatencyThread = NULL;
+Mutex SocketReadReactor::reactorAccessor;
+SocketReadReactor *SocketReadReactor::reactor = NULL;
 SDL_Thread *ServerSocket::upnpdiscoverThread = NULL;
 bool ServerSocket::cancelUpnpdiscoverThread = false;
 Mutex ServerSocket::mutexUpnpdiscoverThread;
@@ -1000,6 +1010,12 @@ void Socket::simpleTask(BaseThread *callingThread)  {
 */
 
 Socket::~Socket() {
+	// Must happen before taking any socket mutex, the latency thread
+	// holds the shim mutex while it writes to this socket
+	MutexSafeWrapper safeMutexLatency(&simulatedLatencySynchAccessor,CODE_AT_LINE);
+	simulatedLatencySockets.erase(this);
+	safeMutexLatency.ReleaseLock();
+
 	MutexSafeWrapper safeMutexSocketDestructorFlag(inSocketDestructorSynchAccessor,CODE_AT_LINE);
 	if(this->inSocketDestructor == true) {
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] this->inSocketDestructor == true\n",__FILE__,__FUNCTION__,__LINE__);
@@ -1049,6 +1065,8 @@ void Socket::disconnectSocket() {
         MutexSafeWrapper safeMutex1(dataSynchAccessorWrite,CODE_AT_LINE);
 
         if(isSocketValid() == true) {
+        // Leave the epoll set while the descriptor still belongs to us
+        SocketReadReactor::unwatchSocket(this);
         ::shutdown(sock,2);
 #ifndef WIN32
         ::close(sock);
@@ -1284,6 +1302,94 @@ int Socket::getDataToRead(bool wantImmediateReply) {
 }
 
 int Socket::send(const void *data, int dataSize) {
+	if(simulatedLatencyMillis <= 0 || simulatedLatencyThread == NULL) {
+		return sendImmediate(data, dataSize);
+	}
+	if(isSocketValid() == false || dataSize <= 0) {
+		return -1;
+	}
+
+	// Queue the data, SimulatedLatencySocketThread writes it once it is due
+	const char *sendBuf = static_cast<const char *>(data);
+	MutexSafeWrapper safeMutex(&simulatedLatencySynchAccessor,CODE_AT_LINE);
+	simulatedLatencyQueue.push_back(std::make_pair(
+			Chrono::getCurMillis() + simulatedLatencyMillis,
+			std::vector<char>(sendBuf, sendBuf + dataSize)));
+	simulatedLatencySockets.insert(this);
+	return dataSize;
+}
+
+void Socket::setSimulatedLatencyMillis(int value) {
+	if(value > 0 && simulatedLatencyThread == NULL) {
+		static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+		simulatedLatencyThread = new SimulatedLatencySocketThread();
+		simulatedLatencyThread->setUniqueID(mutexOwnerId);
+		simulatedLatencyThread->start();
+	}
+	simulatedLatencyMillis = value;
+	if(value <= 0) {
+		stopSimulatedLatencyThread();
+	}
+}
+
+void Socket::flushSimulatedLatencyQueues() {
+	MutexSafeWrapper safeMutex(&simulatedLatencySynchAccessor,CODE_AT_LINE);
+	int64 now = Chrono::getCurMillis();
+	for(std::set<Socket *>::iterator iterMap = simulatedLatencySockets.begin();
+		iterMap != simulatedLatencySockets.end();) {
+		Socket *socket = *iterMap;
+		std::deque<std::pair<int64,std::vector<char> > > &queue = socket->simulatedLatencyQueue;
+		while(queue.empty() == false &&
+			(queue.front().first <= now || simulatedLatencyMillis <= 0)) {
+			std::vector<char> &data = queue.front().second;
+			socket->sendImmediate(&data[0], (int)data.size());
+			queue.pop_front();
+		}
+		if(queue.empty() == true) {
+			simulatedLatencySockets.erase(iterMap++);
+		}
+		else {
+			++iterMap;
+		}
+	}
+}
+
+void Socket::stopSimulatedLatencyThread() {
+	if(simulatedLatencyThread != NULL) {
+		simulatedLatencyThread->shutdownAndWait();
+		delete simulatedLatencyThread;
+		simulatedLatencyThread = NULL;
+	}
+	// Whatever is still held back goes out now
+	flushSimulatedLatencyQueues();
+}
+
+int Socket::sendWithoutWait(const void *data, int dataSize) {
+	int bytesSent = -1;
+	int lastSocketError = 0;
+	if(isSocketValid() == true)	{
+		MutexSafeWrapper safeMutex(dataSynchAccessorWrite,CODE_AT_LINE);
+		if(isSocketValid() == true)	{
+#ifdef __APPLE__
+			bytesSent = ::send(sock, (const char *)data, dataSize, SO_NOSIGPIPE);
+#else
+			bytesSent = ::send(sock, (const char *)data, dataSize, MSG_NOSIGNAL | MSG_DONTWAIT);
+#endif
+			lastSocketError = getLastSocketError();
+		}
+		safeMutex.ReleaseLock();
+	}
+
+	if(bytesSent < 0 && lastSocketError == PLATFORM_SOCKET_TRY_AGAIN) {
+		return 0;
+	}
+	if(bytesSent < 0) {
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] ERROR WRITING SOCKET DATA, err = %d error = %s dataSize = %d\n",__FILE__,__FUNCTION__,__LINE__,bytesSent,getLastSocketErrorFormattedText(&lastSocketError).c_str(),dataSize);
+	}
+	return bytesSent;
+}
+
+int Socket::sendImmediate(const void *data, int dataSize) {
 	const int MAX_SEND_WAIT_SECONDS = 3;
 
 	int bytesSent= 0;
@@ -2122,6 +2228,217 @@ void ClientSocket::connect(const Ip &ip, int port)
 	}
 }
 
+// =====================================================
+//	class SocketReadReactor
+// =====================================================
+
+SocketReadReactor::SocketReadReactor() : BaseThread() {
+	uniqueID = "SocketReadReactor";
+#if defined(__linux__)
+	// the size is only a hint on current kernels
+	epollFd = epoll_create(16);
+#else
+	epollFd = -1;
+#endif
+}
+
+SocketReadReactor::~SocketReadReactor() {
+#if defined(__linux__)
+	if(epollFd >= 0) {
+		::close(epollFd);
+	}
+#endif
+	epollFd = -1;
+}
+
+bool SocketReadReactor::isAvailable() {
+#if defined(__linux__)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void SocketReadReactor::removeListener(Semaphore *readySignal) {
+	std::map<Semaphore *,Listener>::iterator iterFind = listeners.find(readySignal);
+	if(iterFind == listeners.end()) {
+		return;
+	}
+	PLATFORM_SOCKET socketId = iterFind->second.socketId;
+	listeners.erase(iterFind);
+
+	// Another listener may still watch the same socket
+	for(std::map<Semaphore *,Listener>::iterator iterMap = listeners.begin();
+		iterMap != listeners.end(); ++iterMap) {
+		if(iterMap->second.socketId == socketId) {
+			return;
+		}
+	}
+	removeSocketId(socketId);
+}
+
+void SocketReadReactor::removeSocketId(PLATFORM_SOCKET socketId) {
+#if defined(__linux__)
+	struct epoll_event event;
+	memset(&event, 0, sizeof(event));
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, socketId, &event);
+#endif
+}
+
+bool SocketReadReactor::watchSocket(Semaphore *readySignal, Socket *socket) {
+	if(isAvailable() == false || socket == NULL || socket->isSocketValid() == false) {
+		return false;
+	}
+	PLATFORM_SOCKET socketId = socket->getSocketId();
+
+	MutexSafeWrapper safeMutex(&reactorAccessor,CODE_AT_LINE);
+	if(reactor == NULL) {
+		reactor = new SocketReadReactor();
+		if(reactor->epollFd < 0) {
+			if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] epoll_create failed: %s\n",__FILE__,__FUNCTION__,__LINE__,Socket::getLastSocketErrorFormattedText().c_str());
+			delete reactor;
+			reactor = NULL;
+			return false;
+		}
+		static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+		reactor->setUniqueID(mutexOwnerId);
+		reactor->start();
+	}
+
+	// Closing a socket unwatches it, so a socket still listed here is
+	// still in the epoll set
+	std::map<Semaphore *,Listener>::iterator iterFind = reactor->listeners.find(readySignal);
+	if(iterFind != reactor->listeners.end()) {
+		if(iterFind->second.socket == socket && iterFind->second.socketId == socketId) {
+			return true;
+		}
+		reactor->removeListener(readySignal);
+	}
+
+#if defined(__linux__)
+	bool alreadyWatched = false;
+	for(std::map<Semaphore *,Listener>::iterator iterMap = reactor->listeners.begin();
+		iterMap != reactor->listeners.end(); ++iterMap) {
+		if(iterMap->second.socketId == socketId) {
+			alreadyWatched = true;
+			break;
+		}
+	}
+	if(alreadyWatched == false) {
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+		event.data.fd = socketId;
+		if(epoll_ctl(reactor->epollFd, EPOLL_CTL_ADD, socketId, &event) != 0) {
+			if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] epoll_ctl failed for socket " PLATFORM_SOCKET_FORMAT_TYPE ": %s\n",__FILE__,__FUNCTION__,__LINE__,socketId,Socket::getLastSocketErrorFormattedText().c_str());
+			return false;
+		}
+	}
+#endif
+	Listener &listener	= reactor->listeners[readySignal];
+	listener.socket		= socket;
+	listener.socketId	= socketId;
+
+	// Data that arrived before the socket was added raises no edge
+	readySignal->signal();
+	return true;
+}
+
+void SocketReadReactor::unwatchSocket(Semaphore *readySignal) {
+	MutexSafeWrapper safeMutex(&reactorAccessor,CODE_AT_LINE);
+	if(reactor != NULL) {
+		reactor->removeListener(readySignal);
+	}
+}
+
+void SocketReadReactor::unwatchSocket(Socket *socket) {
+	MutexSafeWrapper safeMutex(&reactorAccessor,CODE_AT_LINE);
+	if(reactor == NULL) {
+		return;
+	}
+	bool watched = false;
+	PLATFORM_SOCKET socketId = 0;
+	for(std::map<Semaphore *,Listener>::iterator iterMap = reactor->listeners.begin();
+		iterMap != reactor->listeners.end();) {
+		if(iterMap->second.socket == socket) {
+			watched		= true;
+			socketId	= iterMap->second.socketId;
+			reactor->listeners.erase(iterMap++);
+		}
+		else {
+			++iterMap;
+		}
+	}
+	if(watched == true) {
+		reactor->removeSocketId(socketId);
+	}
+}
+
+void SocketReadReactor::shutdownReactor() {
+	MutexSafeWrapper safeMutex(&reactorAccessor,CODE_AT_LINE);
+	SocketReadReactor *stopReactor = reactor;
+	reactor = NULL;
+	safeMutex.ReleaseLock();
+
+	if(stopReactor != NULL) {
+		stopReactor->shutdownAndWait();
+		delete stopReactor;
+	}
+}
+
+void SocketReadReactor::execute() {
+	RunningStatusSafeWrapper runningStatus(this);
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"Socket read reactor thread is running\n");
+
+#if defined(__linux__)
+	const int maxEvents = 32;
+	struct epoll_event events[maxEvents];
+
+	for(;getQuitStatus() == false;) {
+		// Wake up now and then to notice a quit request
+		int eventCount = epoll_wait(epollFd, events, maxEvents, 100);
+		if(eventCount < 0) {
+			if(errno != EINTR) {
+				if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] epoll_wait failed: %s\n",__FILE__,__FUNCTION__,__LINE__,Socket::getLastSocketErrorFormattedText().c_str());
+				sleep(10);
+			}
+			continue;
+		}
+
+		MutexSafeWrapper safeMutex(&reactorAccessor,CODE_AT_LINE);
+		for(int index = 0; index < eventCount; ++index) {
+			PLATFORM_SOCKET socketId = events[index].data.fd;
+			for(std::map<Semaphore *,Listener>::iterator iterMap = listeners.begin();
+				iterMap != listeners.end(); ++iterMap) {
+				if(iterMap->second.socketId == socketId) {
+					iterMap->first->signal();
+				}
+			}
+		}
+	}
+#endif
+}
+
+// =====================================================
+//	class SimulatedLatencySocketThread
+// =====================================================
+
+SimulatedLatencySocketThread::SimulatedLatencySocketThread() : BaseThread() {
+	uniqueID = "SimulatedLatencySocketThread";
+}
+
+void SimulatedLatencySocketThread::execute() {
+	RunningStatusSafeWrapper runningStatus(this);
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"Simulated latency thread is running, latency = %d msecs\n",Socket::getSimulatedLatencyMillis());
+
+	for(;getQuitStatus() == false;) {
+		Socket::flushSimulatedLatencyQueues();
+		sleep(1);
+	}
+}
+
 //=======================================================================
 // Function :		discovery response thread
 // Description:		Runs in its own thread to listen for broadcasts from
@@ -2291,6 +2608,20 @@ ServerSocket::ServerSocket(bool basicMode) : Socket() {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
+vector<int> ServerSocket::getHostedGamePorts(int gamePort, int ftpPort, int maxPlayers,
+                                             int adminPort, int spectatorPort) {
+	vector<int> ports;
+	ports.push_back(gamePort);
+	ports.push_back(ftpPort);
+	for(int index = 1; index <= maxPlayers; ++index) {
+		ports.push_back(ftpPort + index);
+	}
+	ports.push_back(Shared::PlatformCommon::ContentTransferServerThread::getDefaultPort(ftpPort,maxPlayers));
+	ports.push_back(adminPort);
+	ports.push_back(spectatorPort);
+	return ports;
+}
+
 ServerSocket::~ServerSocket() {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
@@ -2605,6 +2936,13 @@ void ServerSocket::UPNPInitStatus(bool result) {
             UPNPPortForwardList.push_back(this->getFTPServerPort() + clientIndex);
         }
 
+        // Content transfer port, right after the passive ports
+        if(ServerSocket::maxPlayerCount > 0) {
+            int contentTransferPort = Shared::PlatformCommon::ContentTransferServerThread::getDefaultPort(this->getFTPServerPort(),ServerSocket::maxPlayerCount);
+            UPNPPortForwardList.push_back(contentTransferPort);
+            UPNPPortForwardList.push_back(contentTransferPort);
+        }
+
         UPNP_Tools::NETaddRedirects(UPNPPortForwardList,false);
     }
 }
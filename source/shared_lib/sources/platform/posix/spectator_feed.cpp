@@ -0,0 +1,620 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "spectator_feed.h"
+#include "util.h"
+#include "platform_common.h"
+#include "conversion.h"
+#include "compression_utils.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+using namespace Shared::CompressionUtil;
+
+namespace Shared { namespace PlatformCommon {
+
+// The hello a spectator sends: magic, version and role
+static const char spectatorFeedMagic[4]				= { 'Z', 'G', 'S', 'F' };
+static const uint8 spectatorFeedVersion				= 1;
+static const int spectatorFeedHelloSize				= 6;
+// Record header: type, frame and payload length
+static const int spectatorRecordHeaderSize			= 9;
+static const uint32 maxSpectatorRecordSize			= 64 * 1024 * 1024;
+static const int spectatorHelloTimeoutSeconds		= 10;
+static const int spectatorUpstreamRetrySeconds		= 2;
+static const int spectatorDeliveryTimeoutSeconds	= 10;
+// Unsent data past which a spectator is dropped, more than one snapshot
+static const size_t maxSpectatorBacklogSize			= 16 * 1024 * 1024;
+
+static void putUInt32(unsigned char *buf, uint32 value) {
+	buf[0] = static_cast<unsigned char>(value >> 24);
+	buf[1] = static_cast<unsigned char>(value >> 16);
+	buf[2] = static_cast<unsigned char>(value >> 8);
+	buf[3] = static_cast<unsigned char>(value);
+}
+
+static uint32 getUInt32(const unsigned char *buf) {
+	return (static_cast<uint32>(buf[0]) << 24) | (static_cast<uint32>(buf[1]) << 16) |
+		   (static_cast<uint32>(buf[2]) << 8) | static_cast<uint32>(buf[3]);
+}
+
+// =====================================================
+//	class SpectatorRecord
+// =====================================================
+
+bool SpectatorRecord::setPayloadData(const string &data) {
+	payload.clear();
+	if(data.empty() == true || data.size() > maxSpectatorRecordSize) {
+		return false;
+	}
+
+	std::pair<unsigned char *,unsigned long> compressed = compressMemoryToMemory(
+			reinterpret_cast<unsigned char *>(const_cast<char *>(data.data())), (unsigned long)data.size());
+	if(compressed.first == NULL) {
+		return false;
+	}
+	payload.resize(4);
+	putUInt32(&payload[0], static_cast<uint32>(data.size()));
+	payload.insert(payload.end(), compressed.first, compressed.first + compressed.second);
+	delete [] compressed.first;
+	return true;
+}
+
+bool SpectatorRecord::getPayloadData(string &data) const {
+	data.clear();
+	if(payload.size() <= 4) {
+		return false;
+	}
+	uint32 rawLength = getUInt32(&payload[0]);
+	if(rawLength == 0 || rawLength > maxSpectatorRecordSize) {
+		return false;
+	}
+	std::pair<unsigned char *,unsigned long> raw = extractMemoryToMemory(
+			const_cast<unsigned char *>(&payload[4]), (unsigned long)payload.size() - 4, rawLength);
+	bool result = (raw.first != NULL && raw.second == rawLength);
+	if(result == true) {
+		data.assign(reinterpret_cast<const char *>(raw.first), rawLength);
+	}
+	delete [] raw.first;
+	return result;
+}
+
+bool SpectatorRecord::loadPayloadFromFile(const string &file) {
+	payload.clear();
+	FILE *fp = fopen(file.c_str(), "rb");
+	if(fp == NULL) {
+		return false;
+	}
+	string data;
+	char buf[8192];
+	for(size_t readBytes = 0; (readBytes = fread(buf, 1, sizeof(buf), fp)) > 0;) {
+		data.append(buf, readBytes);
+	}
+	fclose(fp);
+	return setPayloadData(data);
+}
+
+bool SpectatorRecord::savePayloadToFile(const string &file) const {
+	string data;
+	if(getPayloadData(data) == false) {
+		return false;
+	}
+	bool result = false;
+	FILE *fp = fopen(file.c_str(), "wb");
+	if(fp != NULL) {
+		result = (fwrite(data.data(), 1, data.size(), fp) == data.size());
+		fclose(fp);
+	}
+	return result;
+}
+
+// =====================================================
+//	class SpectatorFeedServerThread
+// =====================================================
+
+SpectatorFeedServerThread::SpectatorFeedServerThread(int portNumber, int delaySeconds, int maxSpectators) :
+	BaseThread(), mutexRecords(CODE_AT_LINE) {
+	this->portNumber	= portNumber;
+	this->delaySeconds	= max(delaySeconds, 0);
+	this->maxSpectators	= maxSpectators;
+	this->upstreamPort	= 0;
+	this->upstream		= NULL;
+	this->lastUpstreamAttempt = 0;
+	this->snapshotBuilder	= NULL;
+	this->snapshotSeconds	= 0;
+	this->builderSerial		= 0;
+	this->builderFrame		= 0;
+	this->builderHasNewFrames = false;
+	this->lastSnapshotTime	= 0;
+	this->firstSerial	= 0;
+	this->ended			= false;
+	this->endedMillis	= 0;
+	this->spectatorCount= 0;
+	this->serverSocket	= NULL;
+	uniqueID = "SpectatorFeedServerThread";
+}
+
+SpectatorFeedServerThread::~SpectatorFeedServerThread() {
+	for(unsigned int index = 0; index < spectators.size(); ++index) {
+		delete spectators[index].socket;
+	}
+	spectators.clear();
+	delete upstream;
+	upstream = NULL;
+	delete snapshotBuilder;
+	snapshotBuilder = NULL;
+	delete serverSocket;
+	serverSocket = NULL;
+}
+
+bool SpectatorFeedServerThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
+	bool ret = (getExecutingTask() == false);
+	if(ret == false && deleteSelfIfShutdownDelayed == true) {
+	    setDeleteSelfOnExecutionDone(deleteSelfIfShutdownDelayed);
+	    deleteSelfIfRequired();
+	    signalQuit();
+	}
+
+	return ret;
+}
+
+void SpectatorFeedServerThread::setUpstream(const string &ip, int port) {
+	upstreamIp		= ip;
+	upstreamPort	= port;
+}
+
+void SpectatorFeedServerThread::setSnapshotBuilder(SpectatorSnapshotBuilderInterface *builder, int snapshotSeconds) {
+	delete snapshotBuilder;
+	snapshotBuilder			= builder;
+	this->snapshotSeconds	= snapshotSeconds;
+}
+
+void SpectatorFeedServerThread::addRecord(SpectatorRecordType type, int32 frame, const vector<unsigned char> &payload) {
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&mutexRecords,mutexOwnerId);
+	if(ended == true) {
+		return;
+	}
+	records.push_back(SpectatorRecord());
+	SpectatorRecord &record	= records.back();
+	record.type				= type;
+	record.frame			= frame;
+	record.payload			= payload;
+	record.publishedMillis	= Chrono::getCurMillis();
+	if(type == srt_End) {
+		ended		= true;
+		endedMillis	= record.publishedMillis;
+	}
+}
+
+void SpectatorFeedServerThread::endFeed() {
+	addRecord(srt_End, 0, vector<unsigned char>());
+}
+
+bool SpectatorFeedServerThread::isEnded() {
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&mutexRecords,mutexOwnerId);
+	return ended;
+}
+
+int SpectatorFeedServerThread::getSpectatorCount() {
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&mutexRecords,mutexOwnerId);
+	return spectatorCount;
+}
+
+void SpectatorFeedServerThread::acceptSpectators(bool wait) {
+	bool pendingConnection = (wait == true ?
+			serverSocket->hasDataToReadWithWait(20000) :
+			serverSocket->hasDataToRead());
+	if(pendingConnection == false || getQuitStatus() == true) {
+		return;
+	}
+
+	Socket *socket = serverSocket->accept(false);
+	if(socket == NULL) {
+		return;
+	}
+	if(maxSpectators > 0 && (int)spectators.size() >= maxSpectators) {
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] spectator limit %d reached, refusing [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,maxSpectators,socket->getIpAddress().c_str());
+		delete socket;
+		return;
+	}
+
+	// Sends must never wait for a spectator
+	socket->setBlock(false);
+
+	Spectator spectator;
+	spectator.socket		= socket;
+	spectator.connectedTime	= time(NULL);
+	spectators.push_back(spectator);
+}
+
+bool SpectatorFeedServerThread::receiveHello(Spectator &spectator) {
+	if(spectator.socket->hasDataToRead() == false) {
+		return (difftime(time(NULL),spectator.connectedTime) <= spectatorHelloTimeoutSeconds);
+	}
+
+	unsigned char hello[spectatorFeedHelloSize];
+	if(spectator.socket->receive(hello, spectatorFeedHelloSize, true) != spectatorFeedHelloSize ||
+		memcmp(hello, spectatorFeedMagic, sizeof(spectatorFeedMagic)) != 0 ||
+		hello[4] != spectatorFeedVersion ||
+		(hello[5] != sr_Viewer && hello[5] != sr_Relay)) {
+		return false;
+	}
+	spectator.role			= static_cast<SpectatorRole>(hello[5]);
+	spectator.helloReceived	= true;
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Spectator %s connected from [%s]\n",(spectator.role == sr_Relay ? "relay" : "viewer"),spectator.socket->getIpAddress().c_str());
+	return true;
+}
+
+void SpectatorFeedServerThread::queueRecord(Spectator &spectator, const SpectatorRecord &record) {
+	unsigned char header[spectatorRecordHeaderSize];
+	header[0] = record.type;
+	putUInt32(&header[1], static_cast<uint32>(record.frame));
+	putUInt32(&header[5], static_cast<uint32>(record.payload.size()));
+	spectator.backlog.insert(spectator.backlog.end(), header, header + spectatorRecordHeaderSize);
+	spectator.backlog.insert(spectator.backlog.end(), record.payload.begin(), record.payload.end());
+}
+
+// Hands the socket what it takes right away and keeps the rest
+bool SpectatorFeedServerThread::sendBacklog(Spectator &spectator) {
+	if(spectator.backlog.empty() == true) {
+		return true;
+	}
+	int bytesSent = spectator.socket->sendWithoutWait(&spectator.backlog[0], (int)spectator.backlog.size());
+	if(bytesSent < 0) {
+		return false;
+	}
+	spectator.backlog.erase(spectator.backlog.begin(), spectator.backlog.begin() + bytesSent);
+	return true;
+}
+
+// Where a spectator starting from a snapshot of this frame goes on,
+// called with mutexRecords held
+int64 SpectatorFeedServerThread::findFirstRecordAfter(int32 frame) {
+	for(unsigned int index = 0; index < records.size(); ++index) {
+		const SpectatorRecord &record = records[index];
+		if(record.type == srt_End || (record.type == srt_Frame && record.frame > frame)) {
+			return firstSerial + index;
+		}
+	}
+	return firstSerial + (int64)records.size();
+}
+
+bool SpectatorFeedServerThread::updateSpectator(Spectator &spectator, int64 releaseMillis) {
+	// Spectators only ever send their hello, anything else is a close
+	if(spectator.socket->hasDataToRead() == true) {
+		char discard[256];
+		if(spectator.socket->receive(discard, sizeof(discard), false) <= 0) {
+			return false;
+		}
+	}
+
+	// Whatever is left from before goes first
+	if(sendBacklog(spectator) == false) {
+		return false;
+	}
+	if(spectator.backlog.size() > maxSpectatorBacklogSize) {
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Spectator [%s] fell too far behind, dropping it\n",spectator.socket->getIpAddress().c_str());
+		return false;
+	}
+
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&mutexRecords,mutexOwnerId);
+	if(spectator.joined == false) {
+		for(int index = (int)records.size() - 1; index >= 0; --index) {
+			if(records[index].type == srt_Snapshot && records[index].publishedMillis <= releaseMillis) {
+				spectator.joined		= true;
+				spectator.snapshotFrame	= records[index].frame;
+				spectator.nextSerial	= findFirstRecordAfter(records[index].frame);
+				queueRecord(spectator, records[index]);
+				break;
+			}
+		}
+		if(spectator.joined == false) {
+			return true;
+		}
+	}
+	if(spectator.nextSerial < firstSerial) {
+		return false;
+	}
+	for(;spectator.nextSerial < firstSerial + (int64)records.size(); ++spectator.nextSerial) {
+		const SpectatorRecord &record = records[spectator.nextSerial - firstSerial];
+		if(record.publishedMillis > releaseMillis) {
+			break;
+		}
+		// Viewers start from one snapshot, relays keep the newer ones for their own spectators
+		if(record.type != srt_Snapshot) {
+			queueRecord(spectator, record);
+		}
+		else if(spectator.role == sr_Relay && record.frame > spectator.snapshotFrame) {
+			spectator.snapshotFrame = record.frame;
+			queueRecord(spectator, record);
+		}
+	}
+	safeMutex.ReleaseLock();
+
+	return sendBacklog(spectator);
+}
+
+void SpectatorFeedServerThread::pruneRecords(int64 releaseMillis) {
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&mutexRecords,mutexOwnerId);
+
+	// New spectators start at the newest released snapshot,
+	// joined ones still need everything from their position on
+	int64 keepSerial = firstSerial;
+	for(int index = (int)records.size() - 1; index >= 0; --index) {
+		if(records[index].type == srt_Snapshot && records[index].publishedMillis <= releaseMillis) {
+			keepSerial = min(firstSerial + index, findFirstRecordAfter(records[index].frame));
+			break;
+		}
+	}
+	if(snapshotBuilder != NULL) {
+		keepSerial = min(keepSerial, builderSerial);
+	}
+	int joinedCount = 0;
+	for(unsigned int index = 0; index < spectators.size(); ++index) {
+		if(spectators[index].joined == true) {
+			keepSerial = min(keepSerial, spectators[index].nextSerial);
+			joinedCount++;
+		}
+	}
+	while(firstSerial < keepSerial && records.empty() == false) {
+		records.pop_front();
+		firstSerial++;
+	}
+	spectatorCount = joinedCount;
+}
+
+bool SpectatorFeedServerThread::isDelivered(int64 releaseMillis) {
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&mutexRecords,mutexOwnerId);
+	if(ended == false) {
+		return false;
+	}
+	// Spectators that stopped reading don't hold the thread forever
+	if(releaseMillis > endedMillis + spectatorDeliveryTimeoutSeconds * 1000) {
+		return true;
+	}
+	for(unsigned int index = 0; index < spectators.size(); ++index) {
+		if(spectators[index].joined == true &&
+			(spectators[index].nextSerial < firstSerial + (int64)records.size() ||
+			 spectators[index].backlog.empty() == false)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void SpectatorFeedServerThread::updateUpstream() {
+	if(upstreamIp == "" || isEnded() == true) {
+		return;
+	}
+
+	if(upstream == NULL) {
+		if(difftime(time(NULL),lastUpstreamAttempt) < spectatorUpstreamRetrySeconds) {
+			return;
+		}
+		lastUpstreamAttempt = time(NULL);
+
+		upstream = new SpectatorFeedClient(upstreamIp, upstreamPort, sr_Relay);
+		if(upstream->connect() == false) {
+			delete upstream;
+			upstream = NULL;
+			return;
+		}
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Spectator relay connected to [%s:%d]\n",upstreamIp.c_str(),upstreamPort);
+	}
+
+	SpectatorRecord record;
+	for(int count = 0; count < 1000 && upstream->receiveRecord(record, 0) == true; ++count) {
+		addRecord(static_cast<SpectatorRecordType>(record.type), record.frame, record.payload);
+	}
+	if(upstream->isConnected() == false) {
+		// Frames missed while reconnecting could not be replayed, end here
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Spectator relay lost [%s:%d]\n",upstreamIp.c_str(),upstreamPort);
+		endFeed();
+	}
+}
+
+void SpectatorFeedServerThread::updateSnapshot() {
+	if(snapshotBuilder == NULL) {
+		return;
+	}
+
+	// Copy the new frames out so the game can keep adding records
+	vector<SpectatorRecord> frames;
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&mutexRecords,mutexOwnerId);
+	if(ended == true) {
+		return;
+	}
+	for(builderSerial = max(builderSerial, firstSerial);
+		builderSerial < firstSerial + (int64)records.size(); ++builderSerial) {
+		const SpectatorRecord &record = records[builderSerial - firstSerial];
+		if(record.type == srt_Frame) {
+			frames.push_back(record);
+		}
+	}
+	safeMutex.ReleaseLock();
+
+	for(unsigned int index = 0; index < frames.size(); ++index) {
+		snapshotBuilder->SpectatorFeed_AddFrame(frames[index].frame, frames[index].payload);
+		builderFrame		= frames[index].frame;
+		builderHasNewFrames	= true;
+	}
+
+	bool firstSnapshot = (lastSnapshotTime == 0);
+	if(firstSnapshot == false && (snapshotSeconds <= 0 || builderHasNewFrames == false ||
+		difftime(time(NULL),lastSnapshotTime) < snapshotSeconds)) {
+		return;
+	}
+	lastSnapshotTime	= time(NULL);
+	builderHasNewFrames	= false;
+
+	string data;
+	SpectatorRecord snapshot;
+	if(snapshotBuilder->SpectatorFeed_BuildSnapshot(builderFrame, data) == true &&
+		snapshot.setPayloadData(data) == true) {
+		addRecord(srt_Snapshot, builderFrame, snapshot.payload);
+	}
+	else {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] could not build the spectator snapshot for frame %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,builderFrame);
+	}
+}
+
+void SpectatorFeedServerThread::execute() {
+	{
+		RunningStatusSafeWrapper runningStatus(this);
+		if(getQuitStatus() == true) {
+			deleteSelfIfRequired();
+			return;
+		}
+
+		try {
+			serverSocket = new ServerSocket(true);
+			serverSocket->setBindPort(portNumber);
+			serverSocket->bind(portNumber);
+			serverSocket->listen(maxSpectators > 0 ? maxSpectators : 64);
+
+			if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Spectator feed listening on port %d, delay %d seconds\n",portNumber,delaySeconds);
+
+			for(;getQuitStatus() == false;) {
+				updateUpstream();
+				updateSnapshot();
+
+				int64 releaseMillis = Chrono::getCurMillis() - (int64)delaySeconds * 1000;
+				for(unsigned int index = 0; index < spectators.size() && getQuitStatus() == false;) {
+					Spectator &spectator = spectators[index];
+					bool keepSpectator = spectator.socket->isSocketValid();
+					if(keepSpectator == true) {
+						ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+						keepSpectator = (spectator.helloReceived == true ?
+								updateSpectator(spectator, releaseMillis) :
+								receiveHello(spectator));
+					}
+					if(keepSpectator == false) {
+						delete spectator.socket;
+						spectators.erase(spectators.begin() + index);
+						continue;
+					}
+					++index;
+				}
+				pruneRecords(releaseMillis);
+				if(isDelivered(releaseMillis) == true) {
+					break;
+				}
+
+				// The wait on the listener paces the loop
+				acceptSpectators(true);
+			}
+		}
+		catch(const exception &ex) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		}
+		catch(...) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] UNKNOWN Error\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		}
+
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Spectator feed exiting\n");
+	}
+	deleteSelfIfRequired();
+}
+
+// =====================================================
+//	class SpectatorFeedClient
+// =====================================================
+
+SpectatorFeedClient::SpectatorFeedClient(const string &serverIp, int portNumber, SpectatorRole role) {
+	this->serverIp		= serverIp;
+	this->portNumber	= portNumber;
+	this->role			= role;
+	this->socket		= NULL;
+}
+
+SpectatorFeedClient::~SpectatorFeedClient() {
+	disconnect();
+}
+
+bool SpectatorFeedClient::connect() {
+	disconnect();
+	try {
+		socket = new ClientSocket();
+		socket->connect(Ip(serverIp), portNumber);
+	}
+	catch(const exception &ex) {
+		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] connect to [%s:%d] failed [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,serverIp.c_str(),portNumber,ex.what());
+	}
+	if(socket == NULL || socket->isConnected() == false) {
+		disconnect();
+		return false;
+	}
+
+	unsigned char hello[spectatorFeedHelloSize];
+	memcpy(hello, spectatorFeedMagic, sizeof(spectatorFeedMagic));
+	hello[4] = spectatorFeedVersion;
+	hello[5] = static_cast<unsigned char>(role);
+	if(socket->send(hello, spectatorFeedHelloSize) != spectatorFeedHelloSize) {
+		disconnect();
+		return false;
+	}
+	return true;
+}
+
+void SpectatorFeedClient::disconnect() {
+	delete socket;
+	socket = NULL;
+}
+
+bool SpectatorFeedClient::isConnected() {
+	return (socket != NULL && socket->isSocketValid() == true);
+}
+
+bool SpectatorFeedClient::receiveRecord(SpectatorRecord &record, int waitMillis) {
+	if(isConnected() == false) {
+		return false;
+	}
+	bool hasData = (waitMillis > 0 ?
+			socket->hasDataToReadWithWait(waitMillis * 1000) :
+			socket->hasDataToRead());
+	if(hasData == false) {
+		return false;
+	}
+
+	unsigned char header[spectatorRecordHeaderSize];
+	if(socket->receive(header, spectatorRecordHeaderSize, true) != spectatorRecordHeaderSize) {
+		disconnect();
+		return false;
+	}
+	uint32 payloadSize = getUInt32(&header[5]);
+	if(payloadSize > maxSpectatorRecordSize ||
+		(header[0] != srt_Snapshot && header[0] != srt_Frame && header[0] != srt_End)) {
+		disconnect();
+		return false;
+	}
+
+	record.type				= header[0];
+	record.frame			= static_cast<int32>(getUInt32(&header[1]));
+	record.publishedMillis	= Chrono::getCurMillis();
+	record.payload.resize(payloadSize);
+	if(payloadSize > 0 &&
+		socket->receive(&record.payload[0], payloadSize, true) != (int)payloadSize) {
+		disconnect();
+		return false;
+	}
+	return true;
+}
+
+}}//end namespace
@@ -326,11 +326,8 @@ SystemFlags::~SystemFlags() {
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 }
 
-void SystemFlags::Close() {
-	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
-
+void SystemFlags::stopThreadedLogger() {
     if(threadLogger != NULL) {
-        SystemFlags::ENABLE_THREADED_LOGGING = false;
         //SystemFlags::SHUTDOWN_PROGRAM_MODE=true;
         time_t elapsed = time(NULL);
         threadLogger->signalQuit();
@@ -354,6 +351,15 @@ void SystemFlags::Close() {
         //threadLogger = NULL;
 		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
     }
+}
+
+void SystemFlags::Close() {
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+
+    if(threadLogger != NULL) {
+        SystemFlags::ENABLE_THREADED_LOGGING = false;
+        stopThreadedLogger();
+    }
 
 	if(SystemFlags::debugLogFileList != NULL) {
 		if(SystemFlags::haveSpecialOutputCommandLineOption == false) {
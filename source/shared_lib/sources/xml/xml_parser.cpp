@@ -444,35 +444,38 @@ XmlNode *XmlIoRapid::load(const string &path, const std::map<string,string> &map
 	return rootNode;
 }
 
-void XmlIoRapid::save(const string &path, const XmlNode *node){
-	try {
-		if(node == NULL) {
-			throw megaglest_runtime_error("node == NULL during save!");
-		}
+static void buildRapidDocument(xml_document<> &doc, const XmlNode *node) {
+	if(node == NULL) {
+		throw megaglest_runtime_error("node == NULL during save!");
+	}
 
-		xml_document<> doc;
+	// xml declaration
+	xml_node<>* decl = doc.allocate_node(node_declaration);
+	decl->append_attribute(doc.allocate_attribute(doc.allocate_string("version"), doc.allocate_string("1.0")));
+	decl->append_attribute(doc.allocate_attribute(doc.allocate_string("encoding"), doc.allocate_string("utf-8")));
+	decl->append_attribute(doc.allocate_attribute(doc.allocate_string("standalone"), doc.allocate_string("no")));
+	doc.append_node(decl);
 
-		// xml declaration
-		xml_node<>* decl = doc.allocate_node(node_declaration);
-		decl->append_attribute(doc.allocate_attribute(doc.allocate_string("version"), doc.allocate_string("1.0")));
-		decl->append_attribute(doc.allocate_attribute(doc.allocate_string("encoding"), doc.allocate_string("utf-8")));
-		decl->append_attribute(doc.allocate_attribute(doc.allocate_string("standalone"), doc.allocate_string("no")));
-		doc.append_node(decl);
+	// root node
+	xml_node<>* root = doc.allocate_node(node_element, doc.allocate_string(node->getName().c_str()));
+	for(unsigned int i = 0; i < node->getAttributeCount() ; ++i){
+		XmlAttribute *attr = node->getAttribute(i);
+		root->append_attribute(doc.allocate_attribute(
+				doc.allocate_string(attr->getName().c_str()),
+				doc.allocate_string(attr->getValue("",false).c_str())));
+	}
+	doc.append_node(root);
 
-		// root node
-		xml_node<>* root = doc.allocate_node(node_element, doc.allocate_string(node->getName().c_str()));
-		for(unsigned int i = 0; i < node->getAttributeCount() ; ++i){
-			XmlAttribute *attr = node->getAttribute(i);
-			root->append_attribute(doc.allocate_attribute(
-					doc.allocate_string(attr->getName().c_str()),
-					doc.allocate_string(attr->getValue("",false).c_str())));
-		}
-		doc.append_node(root);
+	// child nodes
+	for(unsigned int i = 0; i < node->getChildCount(); ++i) {
+		root->append_node(node->getChild(i)->buildElement(&doc));
+	}
+}
 
-		// child nodes
-		for(unsigned int i = 0; i < node->getChildCount(); ++i) {
-			root->append_node(node->getChild(i)->buildElement(&doc));
-		}
+void XmlIoRapid::save(const string &path, const XmlNode *node){
+	try {
+		xml_document<> doc;
+		buildRapidDocument(doc, node);
 
 //		std::string xml_as_string;
 //		// watch for name collisions here, print() is a very common function name!
@@ -511,6 +514,44 @@ void XmlIoRapid::save(const string &path, const XmlNode *node){
 	}
 }
 
+void XmlIoRapid::saveToString(string &xml, const XmlNode *node) {
+	try {
+		xml_document<> doc;
+		buildRapidDocument(doc, node);
+
+		xml.clear();
+		print(std::back_inserter(xml), doc);
+	}
+	catch(const exception &e){
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Exception while saving to memory: %s\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,e.what());
+		throw megaglest_runtime_error(string("Exception while saving to memory msg: ") + e.what());
+	}
+}
+
+XmlNode *XmlIoRapid::loadFromString(const string &xml, const std::map<string,string> &mapTagReplacementValues,
+		bool skipUpdatePathClimbingParts) {
+	if(xml.empty() == true) {
+		throw megaglest_runtime_error("Error loading XML from memory: no data",true);
+	}
+
+	try {
+		// rapidxml parses in place and needs the terminating 0
+		vector<char> buffer(xml.begin(), xml.end());
+		buffer.push_back(0);
+		replaceAllBetweenTokens(buffer, "<!--","-->", "", true);
+
+		xml_document<> doc;
+		doc.parse<parse_no_data_nodes|parse_validate_closing_tags>(&buffer.front());
+		return new XmlNode(doc.first_node(),mapTagReplacementValues, skipUpdatePathClimbingParts);
+	}
+	catch(parse_error& ex) {
+		throw megaglest_runtime_error(string("Error loading XML from memory\nMessage: ") + ex.what(),true);
+	}
+	catch(megaglest_runtime_error& ex) {
+		throw megaglest_runtime_error(string("Error loading XML from memory\nMessage: ") + ex.what(),!ex.wantStackTrace());
+	}
+}
+
 // =====================================================
 //	class XmlTree
 // =====================================================
@@ -598,6 +639,17 @@ void XmlTree::save(const string &path) {
 	}
 }
 
+void XmlTree::saveToString(string &xml) {
+	// Every engine keeps the same XmlNode tree, rapidxml prints it
+	XmlIoRapid::getInstance().saveToString(xml, rootNode);
+}
+
+void XmlTree::loadFromString(const string &xml, const std::map<string,string> &mapTagReplacementValues) {
+	clearRootNode();
+	// Without a path there is no recursive load to check for
+	this->rootNode= XmlIoRapid::getInstance().loadFromString(xml, mapTagReplacementValues, this->skipUpdatePathClimbingParts);
+}
+
 void XmlTree::clearRootNode() {
 	if(this->skipStackCheck == false) {
 		LoadStack &loadStack = CacheManager::getCachedItem<LoadStack>(loadStackCacheName);
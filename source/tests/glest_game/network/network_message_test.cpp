@@ -0,0 +1,199 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "network_message.h"
+#include "network_protocol.h"
+#include "conversion.h"
+#include <vector>
+
+using namespace Shared::Util;
+using namespace Glest::Game;
+
+//
+// Tests for the network message wire schema
+//
+class NetworkMessageTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( NetworkMessageTest );
+
+	CPPUNIT_TEST( test_launch_matches_old_pack_layout );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+private:
+
+	// Packs one value at a time with the old pack() format letters
+	class OldPacker {
+	public:
+		unsigned char *buf;
+		unsigned int size;
+
+		explicit OldPacker(unsigned char *buf) : buf(buf), size(0) {}
+
+		void value(const char *format, int value) {
+			add(pack(buf + size, format, value));
+		}
+		void value(const char *format, uint32 value) {
+			add(pack(buf + size, format, value));
+		}
+		void text(const char *format, char *value) {
+			add(pack(buf + size, format, value));
+		}
+		void add(unsigned int count) {
+			size += count;
+		}
+	};
+
+	static void fillLaunchData(NetworkMessageLaunch::Data &data) {
+		data.description	= "description";
+		data.map			= "map";
+		data.tileset		= "tileset";
+		data.tech			= "tech";
+		for(int index = 0; index < GameConstants::maxPlayers; ++index) {
+			data.factionTypeNames[index]		= "faction" + intToStr(index);
+			data.networkPlayerNames[index]		= "player" + intToStr(index);
+			data.networkPlayerPlatform[index]	= "platform" + intToStr(index);
+			data.networkPlayerStatuses[index]	= -index;
+			data.networkPlayerLanguages[index]	= "language" + intToStr(index);
+			data.factionControls[index]			= index + 1;
+			data.resourceMultiplierIndex[index]	= index + 2;
+			data.teams[index]					= index + 3;
+			data.startLocationIndex[index]		= index + 4;
+			data.networkPlayerUUID[index]		= "uuid" + intToStr(index);
+		}
+		data.mapCRC		= 0x11223344;
+		data.mapFilter	= 7;
+		data.tilesetCRC	= 0x55667788;
+		data.techCRC	= 0x99AABBCC;
+		for(int index = 0; index < 20; ++index) {
+			data.factionNameList[index]	= "crcfaction" + intToStr(index);
+			data.factionCRCList[index]	= 0x01000000 + index;
+		}
+		data.thisFactionIndex					= 3;
+		data.factionCount						= 4;
+		data.defaultResources					= 1;
+		data.defaultUnits						= 0;
+		data.defaultVictoryConditions			= 1;
+		data.fogOfWar							= 1;
+		data.allowObservers						= 0;
+		data.enableObserverModeAtEndGame		= 1;
+		data.enableServerControlledAI			= 1;
+		data.networkFramePeriod					= 200;
+		data.networkPauseGameForLaggedClients	= 1;
+		data.pathFinderType						= 0;
+		data.flagTypes1							= 0x80000001;
+		data.aiAcceptSwitchTeamPercentChance	= 30;
+		data.cpuReplacementMultiplier			= 10;
+		data.masterserver_admin					= -1;
+		data.masterserver_admin_factionIndex	= 5;
+		data.scenario							= "scenario";
+		data.networkAllowNativeLanguageTechtree	= 1;
+		data.gameUUID							= "gameuuid";
+	}
+
+	// The argument order of the pack() call that NetworkMessageLaunch
+	// used before its fields were described by wireFields()
+	static unsigned int packLaunchTheOldWay(unsigned char *buf, int8 messageType,
+			NetworkMessageLaunch::Data &data) {
+		const int maxPlayers = GameConstants::maxPlayers;
+		OldPacker old(buf);
+		old.value("c", messageType);
+		old.text("256s", data.description.getBuffer());
+		old.text("60s", data.map.getBuffer());
+		old.text("60s", data.tileset.getBuffer());
+		old.text("60s", data.tech.getBuffer());
+		for(int i = 0; i < maxPlayers; ++i) old.text("60s", data.factionTypeNames[i].getBuffer());
+		for(int i = 0; i < maxPlayers; ++i) old.text("60s", data.networkPlayerNames[i].getBuffer());
+		for(int i = 0; i < maxPlayers; ++i) old.text("60s", data.networkPlayerPlatform[i].getBuffer());
+		for(int i = 0; i < maxPlayers; ++i) old.value("l", data.networkPlayerStatuses[i]);
+		for(int i = 0; i < maxPlayers; ++i) old.text("60s", data.networkPlayerLanguages[i].getBuffer());
+		old.value("L", data.mapCRC);
+		old.value("c", data.mapFilter);
+		old.value("L", data.tilesetCRC);
+		old.value("L", data.techCRC);
+		for(int i = 0; i < 20; ++i) old.text("60s", data.factionNameList[i].getBuffer());
+		for(int i = 0; i < 20; ++i) old.value("L", data.factionCRCList[i]);
+		for(int i = 0; i < maxPlayers; ++i) old.value("c", data.factionControls[i]);
+		for(int i = 0; i < maxPlayers; ++i) old.value("c", data.resourceMultiplierIndex[i]);
+		old.value("c", data.thisFactionIndex);
+		old.value("c", data.factionCount);
+		for(int i = 0; i < maxPlayers; ++i) old.value("c", data.teams[i]);
+		for(int i = 0; i < maxPlayers; ++i) old.value("c", data.startLocationIndex[i]);
+		old.value("c", data.defaultResources);
+		old.value("c", data.defaultUnits);
+		old.value("c", data.defaultVictoryConditions);
+		old.value("c", data.fogOfWar);
+		old.value("c", data.allowObservers);
+		old.value("c", data.enableObserverModeAtEndGame);
+		old.value("c", data.enableServerControlledAI);
+		old.value("C", data.networkFramePeriod);
+		old.value("c", data.networkPauseGameForLaggedClients);
+		old.value("c", data.pathFinderType);
+		old.value("L", data.flagTypes1);
+		old.value("c", data.aiAcceptSwitchTeamPercentChance);
+		old.value("c", data.cpuReplacementMultiplier);
+		old.value("l", data.masterserver_admin);
+		old.value("l", data.masterserver_admin_factionIndex);
+		old.text("256s", data.scenario.getBuffer());
+		for(int i = 0; i < maxPlayers; ++i) old.text("60s", data.networkPlayerUUID[i].getBuffer());
+		old.value("c", data.networkAllowNativeLanguageTechtree);
+		old.text("60s", data.gameUUID.getBuffer());
+		return old.size;
+	}
+
+public:
+
+	void test_launch_matches_old_pack_layout() {
+		int8 messageType = 2;
+		NetworkMessageLaunch::Data data;
+		fillLaunchData(data);
+
+		std::vector<unsigned char> oldBuf(16384);
+		unsigned int oldSize = packLaunchTheOldWay(&oldBuf[0], messageType, data);
+
+		NetworkWireSize wireSize;
+		NetworkMessageLaunch::wireData(wireSize, messageType, data);
+		CPPUNIT_ASSERT_EQUAL( oldSize, wireSize.getSize() );
+
+		std::vector<unsigned char> newBuf(oldBuf.size());
+		NetworkWireWriter writer(&newBuf[0]);
+		NetworkMessageLaunch::wireData(writer, messageType, data);
+		CPPUNIT_ASSERT_EQUAL( oldSize, writer.getSize() );
+		CPPUNIT_ASSERT( memcmp(&oldBuf[0], &newBuf[0], oldSize) == 0 );
+
+		// Reading the old bytes back gives the same message
+		int8 readType = 0;
+		NetworkMessageLaunch::Data readData;
+		NetworkWireReader reader(&oldBuf[0], oldSize);
+		NetworkMessageLaunch::wireData(reader, readType, readData);
+		CPPUNIT_ASSERT_EQUAL( false, reader.hasOverrun() );
+		CPPUNIT_ASSERT_EQUAL( messageType, readType );
+		CPPUNIT_ASSERT_EQUAL( data.mapCRC, readData.mapCRC );
+		CPPUNIT_ASSERT_EQUAL( data.mapFilter, readData.mapFilter );
+		CPPUNIT_ASSERT_EQUAL( data.tilesetCRC, readData.tilesetCRC );
+		CPPUNIT_ASSERT_EQUAL( data.techCRC, readData.techCRC );
+		CPPUNIT_ASSERT_EQUAL( string("gameuuid"), readData.gameUUID.getString() );
+
+		std::vector<unsigned char> roundTripBuf(oldBuf.size());
+		NetworkWireWriter roundTripWriter(&roundTripBuf[0]);
+		NetworkMessageLaunch::wireData(roundTripWriter, readType, readData);
+		CPPUNIT_ASSERT_EQUAL( oldSize, roundTripWriter.getSize() );
+		CPPUNIT_ASSERT( memcmp(&oldBuf[0], &roundTripBuf[0], oldSize) == 0 );
+
+		// A short buffer is reported instead of read past
+		NetworkWireReader shortReader(&oldBuf[0], oldSize - 1);
+		NetworkMessageLaunch::wireData(shortReader, readType, readData);
+		CPPUNIT_ASSERT_EQUAL( true, shortReader.hasOverrun() );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( NetworkMessageTest );
@@ -38,6 +38,7 @@ class ModelTest : public CppUnit::TestFixture {
 
 	CPPUNIT_TEST( test_ColorPicking_loop );
 	CPPUNIT_TEST( test_ColorPicking_prime );
+	CPPUNIT_TEST( test_ModelFileBuffer_read );
 
 	CPPUNIT_TEST_SUITE_END();
 	// End of Fixture registration
@@ -100,6 +101,37 @@ public:
 		BaseColorPickEntity::setTrackColorUse(false);
 	}
 
+	void test_ModelFileBuffer_read() {
+		const string testFile = "model_file_buffer_test.bin";
+		const uint32 values[5] = { 1, 2, 3, 4, 5 };
+		FILE *f = fopen(testFile.c_str(),"wb");
+		CPPUNIT_ASSERT( f != NULL );
+		CPPUNIT_ASSERT_EQUAL( (size_t)5, fwrite(values, sizeof(uint32), 5, f) );
+		fclose(f);
+
+		ModelFileBuffer buffer;
+		CPPUNIT_ASSERT_EQUAL( false, buffer.loadFile(testFile + ".missing") );
+		CPPUNIT_ASSERT_EQUAL( true, buffer.loadFile(testFile) );
+		unlink(testFile.c_str());
+		CPPUNIT_ASSERT_EQUAL( sizeof(values), buffer.getSize() );
+
+		uint32 readValues[5] = { 0, 0, 0, 0, 0 };
+		CPPUNIT_ASSERT_EQUAL( (size_t)2, buffer.read(readValues, sizeof(uint32), 2) );
+		CPPUNIT_ASSERT_EQUAL( (uint32)2, readValues[1] );
+
+		// Seeking outside of the file fails and leaves the position alone
+		CPPUNIT_ASSERT_EQUAL( -1, buffer.seek(-9) );
+		CPPUNIT_ASSERT_EQUAL( -1, buffer.seek(13) );
+		CPPUNIT_ASSERT_EQUAL( 0, buffer.seek(4) );
+		CPPUNIT_ASSERT_EQUAL( sizeof(uint32) * 3, buffer.getPosition() );
+
+		// Like fread only whole items are returned
+		CPPUNIT_ASSERT_EQUAL( (size_t)1, buffer.read(readValues, sizeof(uint32) * 2, 1) );
+		CPPUNIT_ASSERT_EQUAL( (uint32)4, readValues[0] );
+		CPPUNIT_ASSERT_EQUAL( (size_t)0, buffer.read(readValues, sizeof(uint32), 1) );
+		CPPUNIT_ASSERT_EQUAL( (size_t)0, buffer.read(readValues, 0, 1) );
+	}
+
 };
 
 
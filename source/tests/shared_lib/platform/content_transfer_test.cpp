@@ -0,0 +1,309 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "content_transfer.h"
+#include "platform_common.h"
+#include "checksum.h"
+#include "util.h"
+#include "conversion.h"
+#include <stdio.h>
+#include <vector>
+
+using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
+
+//
+// Tests for the content transfer server and client
+//
+class ContentTransferTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ContentTransferTest );
+
+	CPPUNIT_TEST( test_manifest_encode_decode );
+	CPPUNIT_TEST( test_manifest_rejects_unsafe_paths );
+	CPPUNIT_TEST( test_fetch_tileset_over_loopback );
+	CPPUNIT_TEST( test_fetch_resumes_part_file );
+	CPPUNIT_TEST( test_partial_request_does_not_stall_server );
+	CPPUNIT_TEST( test_chunk_request_path_tricks_refused );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+private:
+
+	// Records what the client reports while it fetches
+	class ProgressRecorder : public ContentTransferProgressInterface {
+	public:
+		vector<double> bytesDoneList;
+
+		virtual bool ContentTransfer_Progress(const string &itemName, double bytesDone, double bytesTotal) {
+			bytesDoneList.push_back(bytesDone);
+			return true;
+		}
+	};
+
+	string rootFolder;
+	string serverFolder;
+	string clientFolder;
+	string bigData;
+	int portNumber;
+	ContentTransferServerThread *server;
+
+	void writeTestFile(const string &file, const string &data) {
+		createDirectoryPaths(extractDirectoryPathFromFile(file));
+		FILE *fp = fopen(file.c_str(), "wb");
+		CPPUNIT_ASSERT( fp != NULL );
+		fwrite(data.c_str(), 1, data.size(), fp);
+		fclose(fp);
+	}
+
+	// Compares both trees by their fresh manifests
+	bool isSameContent(const string &sourceFolder, const string &destFolder) {
+		ContentManifest source = ContentManifest::buildFromFolder(sourceFolder, false);
+		ContentManifest dest = ContentManifest::buildFromFolder(destFolder, false);
+		return (source.getEntries().empty() == false &&
+				source.getChangedEntries(dest).empty() == true &&
+				source.getExtraFiles(dest).empty() == true);
+	}
+
+	// The folder CRC the lobby compares, read fresh from disk
+	uint32 getTreeCRC(const string &folder, const string &name) {
+		Checksum::clearFileCache();
+		vector<string> paths;
+		paths.push_back(folder);
+		return getFolderTreeContentsCheckSumRecursively(paths, "/" + name + "/*", "", NULL, true);
+	}
+
+	void assertSameTileset() {
+		CPPUNIT_ASSERT( isSameContent(serverFolder + "test_tileset", clientFolder + "test_tileset") );
+		uint32 serverCRC = getTreeCRC(rootFolder + "server", "test_tileset");
+		CPPUNIT_ASSERT( serverCRC != 0 );
+		CPPUNIT_ASSERT_EQUAL( serverCRC, getTreeCRC(rootFolder + "client", "test_tileset") );
+	}
+
+	static void putUInt32(vector<unsigned char> &buf, uint32 value) {
+		buf.push_back(static_cast<unsigned char>(value >> 24));
+		buf.push_back(static_cast<unsigned char>(value >> 16));
+		buf.push_back(static_cast<unsigned char>(value >> 8));
+		buf.push_back(static_cast<unsigned char>(value));
+	}
+
+	static void putString(vector<unsigned char> &buf, const string &value) {
+		buf.push_back(static_cast<unsigned char>(value.size() >> 8));
+		buf.push_back(static_cast<unsigned char>(value.size()));
+		buf.insert(buf.end(), value.begin(), value.end());
+	}
+
+	// Sends a chunk request the way a client that skips its own checks
+	// would and returns the status of the reply, -1 without a reply
+	int requestChunk(const string &name, const string &path, uint32 crc) {
+		const unsigned char chunkRequest = 3;
+		const unsigned char chunkReply = 4;
+
+		vector<unsigned char> request;
+		putUInt32(request, 0);
+		request.push_back(chunkRequest);
+		request.push_back(ctt_Tileset);
+		putString(request, name);
+		putString(request, path);
+		putUInt32(request, 0);
+		putUInt32(request, crc);
+		vector<unsigned char> size;
+		putUInt32(size, static_cast<uint32>(request.size() - 4));
+		copy(size.begin(), size.end(), request.begin());
+
+		ClientSocket socket;
+		socket.connect(Ip("127.0.0.1"), portNumber);
+		if(socket.isConnected() == false ||
+			socket.send(&request[0], (int)request.size()) != (int)request.size()) {
+			return -1;
+		}
+		unsigned char reply[6];
+		for(int attempt = 0; attempt < 20 && socket.hasDataToReadWithWait(250000) == false; ++attempt) {
+		}
+		if(socket.receive(reply, 6, true) != 6 || reply[4] != chunkReply) {
+			return -1;
+		}
+		return reply[5];
+	}
+
+	void startServer() {
+		// Text compresses, the larger file spans several chunks
+		bigData = "";
+		for(int index = 0; bigData.size() < 3 * ContentTransferClient::chunkSize; ++index) {
+			bigData += "line " + intToStr(index) + " of the test texture\n";
+		}
+		writeTestFile(serverFolder + "test_tileset/test_tileset.xml", "<tileset/>");
+		writeTestFile(serverFolder + "test_tileset/textures/big.txt", bigData);
+		writeTestFile(serverFolder + "test_tileset/sounds/a.txt", "sound a");
+
+		server = new ContentTransferServerThread(
+				make_pair(serverFolder, string("")), make_pair(serverFolder, string("")),
+				make_pair(serverFolder, string("")), portNumber, NULL);
+		server->start();
+		sleep(250);
+	}
+
+public:
+
+	void setUp() {
+		rootFolder = "content_transfer_test/";
+		serverFolder = rootFolder + "server/";
+		clientFolder = rootFolder + "client/";
+		portNumber = 61490;
+		server = NULL;
+		removeFolder(rootFolder);
+		createDirectoryPaths(clientFolder);
+	}
+
+	void tearDown() {
+		if(server != NULL) {
+			server->shutdownAndWait();
+			delete server;
+			server = NULL;
+		}
+		removeFolder(rootFolder);
+	}
+
+	void test_manifest_encode_decode() {
+		ContentManifest manifest;
+		manifest.addEntry(ContentManifestEntry("tileset.xml", 120, 0x12345678));
+		manifest.addEntry(ContentManifestEntry("textures/grass.png", 65537, 0xDEADBEEF));
+
+		vector<unsigned char> buf;
+		manifest.encode(buf);
+
+		ContentManifest decoded;
+		CPPUNIT_ASSERT_EQUAL( true, decoded.decode(&buf[0], (unsigned int)buf.size()) );
+		CPPUNIT_ASSERT_EQUAL( (size_t)2, decoded.getEntries().size() );
+		CPPUNIT_ASSERT( decoded.getChangedEntries(manifest).empty() == true );
+		CPPUNIT_ASSERT_EQUAL( (uint32)65537, decoded.findEntry("textures/grass.png")->size );
+
+		// A truncated manifest must not decode
+		CPPUNIT_ASSERT_EQUAL( false, decoded.decode(&buf[0], (unsigned int)buf.size() - 3) );
+	}
+
+	void test_manifest_rejects_unsafe_paths() {
+		CPPUNIT_ASSERT_EQUAL( true, ContentManifest::isSafePath("models/tree.g3d") );
+		CPPUNIT_ASSERT_EQUAL( false, ContentManifest::isSafePath("") );
+		CPPUNIT_ASSERT_EQUAL( false, ContentManifest::isSafePath("/etc/passwd") );
+		CPPUNIT_ASSERT_EQUAL( false, ContentManifest::isSafePath("../maps/x.mgm") );
+		CPPUNIT_ASSERT_EQUAL( false, ContentManifest::isSafePath("models/../../x") );
+		CPPUNIT_ASSERT_EQUAL( false, ContentManifest::isSafePath("c:/x") );
+	}
+
+	void test_fetch_tileset_over_loopback() {
+		bool debug_verbose_tests = false;
+		SystemFlags::VERBOSE_MODE_ENABLED = debug_verbose_tests;
+
+		startServer();
+
+		ContentTransferClient client("127.0.0.1", portNumber);
+		client.setMaxConnectAttempts(5);
+		string error = "";
+
+		// Empty client
+		bool result = client.fetch(ctt_Tileset, "test_tileset", clientFolder, error);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE( error, true, result );
+		assertSameTileset();
+
+		// Changed, removed and extra files on the client
+		writeTestFile(clientFolder + "test_tileset/textures/big.txt", "stale");
+		removeFile(clientFolder + "test_tileset/sounds/a.txt");
+		writeTestFile(clientFolder + "test_tileset/extra.txt", "not on the server");
+
+		result = client.fetch(ctt_Tileset, "test_tileset", clientFolder, error);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE( error, true, result );
+		assertSameTileset();
+
+		// Unknown items are refused, path tricks never leave the client
+		CPPUNIT_ASSERT_EQUAL( false, client.fetch(ctt_Tileset, "missing", clientFolder, error) );
+		CPPUNIT_ASSERT_EQUAL( false, client.fetch(ctt_Tileset, "..", clientFolder, error) );
+	}
+
+	void test_fetch_resumes_part_file() {
+		bool debug_verbose_tests = false;
+		SystemFlags::VERBOSE_MODE_ENABLED = debug_verbose_tests;
+
+		startServer();
+		ContentTransferClient client("127.0.0.1", portNumber);
+		client.setMaxConnectAttempts(5);
+		string error = "";
+		CPPUNIT_ASSERT_EQUAL_MESSAGE( error, true, client.fetch(ctt_Tileset, "test_tileset", clientFolder, error) );
+
+		// A transfer that broke off past the first chunk
+		ContentManifest manifest = ContentManifest::buildFromFolder(serverFolder + "test_tileset", false);
+		const ContentManifestEntry *entry = manifest.findEntry("textures/big.txt");
+		CPPUNIT_ASSERT( entry != NULL );
+		const uint32 partSize = ContentTransferClient::chunkSize + 1000;
+		string file = clientFolder + "test_tileset/textures/big.txt";
+		char partSuffix[40] = "";
+		snprintf(partSuffix, 40, ".%08x.part", entry->crc);
+		removeFile(file);
+		writeTestFile(file + partSuffix, bigData.substr(0, partSize));
+
+		ProgressRecorder progress;
+		ContentTransferClient resumingClient("127.0.0.1", portNumber, &progress);
+		resumingClient.setMaxConnectAttempts(5);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE( error, true, resumingClient.fetch(ctt_Tileset, "test_tileset", clientFolder, error) );
+
+		// Only what was missing after the part file was requested
+		uint32 remaining = entry->size - partSize;
+		uint32 chunkCount = (remaining + ContentTransferClient::chunkSize - 1) / ContentTransferClient::chunkSize;
+		CPPUNIT_ASSERT_EQUAL( (size_t)chunkCount, progress.bytesDoneList.size() );
+		CPPUNIT_ASSERT_EQUAL( (double)(partSize + ContentTransferClient::chunkSize), progress.bytesDoneList[0] );
+		CPPUNIT_ASSERT_EQUAL( (double)entry->size, progress.bytesDoneList.back() );
+		CPPUNIT_ASSERT_EQUAL( false, fileExists(file + partSuffix) );
+		assertSameTileset();
+	}
+
+	void test_partial_request_does_not_stall_server() {
+		bool debug_verbose_tests = false;
+		SystemFlags::VERBOSE_MODE_ENABLED = debug_verbose_tests;
+
+		startServer();
+
+		// A client that stops in the middle of a request header
+		ClientSocket stalledClient;
+		stalledClient.connect(Ip("127.0.0.1"), portNumber);
+		CPPUNIT_ASSERT_EQUAL( true, stalledClient.isConnected() );
+		unsigned char header[2] = { 0, 0 };
+		CPPUNIT_ASSERT_EQUAL( 2, stalledClient.send(header, 2) );
+		sleep(250);
+
+		// Everyone else is still served meanwhile
+		ContentTransferClient client("127.0.0.1", portNumber);
+		client.setMaxConnectAttempts(5);
+		string error = "";
+		int64 start = Chrono::getCurMillis();
+		CPPUNIT_ASSERT_EQUAL_MESSAGE( error, true, client.fetch(ctt_Tileset, "test_tileset", clientFolder, error) );
+		CPPUNIT_ASSERT( Chrono::getCurMillis() - start < 5000 );
+		assertSameTileset();
+	}
+
+	void test_chunk_request_path_tricks_refused() {
+		bool debug_verbose_tests = false;
+		SystemFlags::VERBOSE_MODE_ENABLED = debug_verbose_tests;
+
+		startServer();
+		ContentManifest manifest = ContentManifest::buildFromFolder(serverFolder + "test_tileset", false);
+		const ContentManifestEntry *entry = manifest.findEntry("sounds/a.txt");
+		CPPUNIT_ASSERT( entry != NULL );
+
+		// The client refuses these itself, the server has to as well
+		CPPUNIT_ASSERT_EQUAL( (int)cts_Ok, requestChunk("test_tileset", "sounds/a.txt", entry->crc) );
+		CPPUNIT_ASSERT_EQUAL( (int)cts_NotFound, requestChunk("test_tileset", "../test_tileset/sounds/a.txt", entry->crc) );
+		CPPUNIT_ASSERT_EQUAL( (int)cts_NotFound, requestChunk("..", "server/test_tileset/sounds/a.txt", entry->crc) );
+		CPPUNIT_ASSERT_EQUAL( (int)cts_NotFound, requestChunk(".", "test_tileset/sounds/a.txt", entry->crc) );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ContentTransferTest );
@@ -0,0 +1,220 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "platform_common.h"
+#include "socket.h"
+#include "content_transfer.h"
+#include "checksum.h"
+#include "util.h"
+#include "conversion.h"
+#include <stdio.h>
+#include <vector>
+#include <set>
+#include <algorithm>
+
+#ifndef WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace Shared::Util;
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+
+//
+// Tests for hosting several sessions from one process
+//
+class ProcessSessionsTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ProcessSessionsTest );
+
+	CPPUNIT_TEST( test_sessions_share_preloaded_checksums );
+	CPPUNIT_TEST( test_stop_sessions );
+	CPPUNIT_TEST( test_session_ports_do_not_overlap );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+private:
+
+	string rootFolder;
+	string savedCRCCachePath;
+
+	void writeTestFile(const string &file, const string &data) {
+		createDirectoryPaths(extractDirectoryPathFromFile(file));
+		FILE *fp = fopen(file.c_str(), "ab");
+		CPPUNIT_ASSERT( fp != NULL );
+		fwrite(data.c_str(), 1, data.size(), fp);
+		fclose(fp);
+	}
+
+	static uint32 getMapChecksum(const string &file) {
+		Checksum checksum;
+		checksum.addFile(file);
+		return checksum.getSum();
+	}
+
+	// Counts the ports that more than one session would listen on
+	static int countSharedSessionPorts(const vector<int> &sessionPorts,
+	                                   int sessionCount, int stride) {
+		set<int> usedPorts;
+		int sharedPorts = 0;
+		for(int sessionIndex = 0; sessionIndex < sessionCount; ++sessionIndex) {
+			for(unsigned int index = 0; index < sessionPorts.size(); ++index) {
+				if(usedPorts.insert(sessionPorts[index] + sessionIndex * stride).second == false) {
+					++sharedPorts;
+				}
+			}
+		}
+		return sharedPorts;
+	}
+
+	// Looks everything up over and over for a while, the way each
+	// hosted game does, and counts the lookups that differ from the
+	// values preloaded before the sessions were started
+	static int lookupPreloaded(const vector<string> &techPaths, const vector<string> &techs,
+			const vector<uint32> &techCRCs, const string &mapFile, uint32 mapCRC) {
+		int mismatches = 0;
+		int64 start = Chrono::getCurMillis();
+		while(Chrono::getCurMillis() - start < 2000) {
+			for(unsigned int index = 0; index < techs.size(); ++index) {
+				if(getFolderTreeContentsCheckSumRecursively(techPaths, "/" + techs[index] + "/*",
+						".xml", NULL) != techCRCs[index]) {
+					mismatches++;
+				}
+			}
+			if(getMapChecksum(mapFile) != mapCRC) {
+				mismatches++;
+			}
+			sleep(0);
+		}
+		return mismatches;
+	}
+
+public:
+
+	void setUp() {
+		rootFolder = "process_sessions_test/";
+		removeFolder(rootFolder);
+		createDirectoryPaths(rootFolder + "crc/");
+		savedCRCCachePath = getCRCCacheFilePath();
+		setCRCCacheFilePath(rootFolder + "crc/");
+	}
+
+	void tearDown() {
+		setCRCCacheFilePath(savedCRCCachePath);
+		removeFolder(rootFolder);
+	}
+
+	void test_sessions_share_preloaded_checksums() {
+#ifndef WIN32
+		const int sessionCount = 4;
+
+		vector<string> techPaths;
+		techPaths.push_back(rootFolder + "techs");
+		vector<string> techs;
+		for(int index = 0; index < 3; ++index) {
+			string tech = "tech_" + intToStr(index);
+			techs.push_back(tech);
+			writeTestFile(rootFolder + "techs/" + tech + "/" + tech + ".xml", "<tech-tree/>");
+			writeTestFile(rootFolder + "techs/" + tech + "/factions/f/f.xml", "<faction " + tech + "/>");
+		}
+		string mapFile = rootFolder + "maps/test.mgm";
+		writeTestFile(mapFile, "map data");
+
+		// Preload before starting the sessions, like the headless server does
+		vector<uint32> techCRCs;
+		for(unsigned int index = 0; index < techs.size(); ++index) {
+			techCRCs.push_back(getFolderTreeContentsCheckSumRecursively(techPaths,
+					"/" + techs[index] + "/*", ".xml", NULL));
+			CPPUNIT_ASSERT( techCRCs[index] != 0 );
+		}
+		uint32 mapCRC = getMapChecksum(mapFile);
+
+		// Anything read from disk from now on differs from what was preloaded
+		removeFolder(rootFolder + "crc/");
+		createDirectoryPaths(rootFolder + "crc/");
+		for(unsigned int index = 0; index < techs.size(); ++index) {
+			writeTestFile(rootFolder + "techs/" + techs[index] + "/" + techs[index] + ".xml", "<changed/>");
+		}
+		writeTestFile(mapFile, "changed");
+
+		vector<int> sessionPids;
+		int sessionIndex = forkProcessSessions(sessionCount, sessionPids);
+		if(sessionIndex > 0) {
+			_exit(lookupPreloaded(techPaths, techs, techCRCs, mapFile, mapCRC) == 0 ? 0 : 1);
+		}
+		CPPUNIT_ASSERT_EQUAL( sessionCount - 1, (int)sessionPids.size() );
+		CPPUNIT_ASSERT_EQUAL( 0, lookupPreloaded(techPaths, techs, techCRCs, mapFile, mapCRC) );
+
+		for(unsigned int index = 0; index < sessionPids.size(); ++index) {
+			int status = -1;
+			CPPUNIT_ASSERT_EQUAL( sessionPids[index], (int)waitpid(sessionPids[index], &status, 0) );
+			CPPUNIT_ASSERT( WIFEXITED(status) );
+			CPPUNIT_ASSERT_EQUAL( 0, WEXITSTATUS(status) );
+		}
+		reapProcessSessions(sessionPids, false);
+		CPPUNIT_ASSERT_EQUAL( (size_t)0, sessionPids.size() );
+
+		// The preloaded values came from memory, a fresh scan sees the change
+		Checksum::clearFileCache();
+		CPPUNIT_ASSERT( getFolderTreeContentsCheckSumRecursively(techPaths,
+				"/" + techs[0] + "/*", ".xml", NULL, true) != techCRCs[0] );
+		CPPUNIT_ASSERT( getMapChecksum(mapFile) != mapCRC );
+#endif
+	}
+
+	void test_stop_sessions() {
+#ifndef WIN32
+		vector<int> sessionPids;
+		int sessionIndex = forkProcessSessions(3, sessionPids);
+		if(sessionIndex > 0) {
+			for(;;) {
+				sleep(100);
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL( (size_t)2, sessionPids.size() );
+
+		// Running sessions are kept until they are stopped
+		reapProcessSessions(sessionPids, false);
+		CPPUNIT_ASSERT_EQUAL( (size_t)2, sessionPids.size() );
+		reapProcessSessions(sessionPids, true);
+		CPPUNIT_ASSERT_EQUAL( (size_t)0, sessionPids.size() );
+#endif
+	}
+
+	void test_session_ports_do_not_overlap() {
+		const int sessionCount = 4;
+		const int maxPlayers = 10;
+
+		// The default game, FTP, admin and spectator ports
+		vector<int> sessionPorts = ServerSocket::getHostedGamePorts(61357, 61358, maxPlayers, 61355, 61356);
+		CPPUNIT_ASSERT_EQUAL( (size_t)(maxPlayers + 5), sessionPorts.size() );
+		CPPUNIT_ASSERT( find(sessionPorts.begin(), sessionPorts.end(),
+		                     ContentTransferServerThread::getDefaultPort(61358, maxPlayers)) != sessionPorts.end() );
+
+		int stride = getSessionPortStride(sessionPorts, sessionCount);
+		CPPUNIT_ASSERT_EQUAL( maxPlayers + 5, stride );
+		CPPUNIT_ASSERT_EQUAL( 0, countSharedSessionPorts(sessionPorts, sessionCount, stride) );
+		// The old fixed stride put the content transfer port of one
+		// session on the FTP port of the next
+		CPPUNIT_ASSERT( countSharedSessionPorts(sessionPorts, sessionCount, 11) > 0 );
+
+		// Ports configured apart from the others are kept apart too
+		sessionPorts = ServerSocket::getHostedGamePorts(7000, 7001, maxPlayers, 7020, 7040);
+		stride = getSessionPortStride(sessionPorts, sessionCount);
+		CPPUNIT_ASSERT_EQUAL( 0, countSharedSessionPorts(sessionPorts, sessionCount, stride) );
+		CPPUNIT_ASSERT( stride < 40 );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ProcessSessionsTest );
@@ -0,0 +1,107 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "socket.h"
+#include "platform_common.h"
+#include "util.h"
+
+using namespace Shared::Util;
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+
+//
+// Tests for the epoll read reactor
+//
+class SocketReadReactorTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( SocketReadReactorTest );
+
+	CPPUNIT_TEST( test_watch_once_until_closed );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+private:
+
+	static Socket *acceptClient(ServerSocket &server) {
+		for(int attempt = 0; attempt < 20; ++attempt) {
+			if(server.hasDataToReadWithWait(250000) == true) {
+				return server.accept(false);
+			}
+		}
+		return NULL;
+	}
+
+	static bool sendByte(ClientSocket &client) {
+		unsigned char data = 1;
+		return (client.send(&data, 1) == 1);
+	}
+
+public:
+
+	void tearDown() {
+		SocketReadReactor::shutdownReactor();
+	}
+
+	void test_watch_once_until_closed() {
+		if(SocketReadReactor::isAvailable() == false) {
+			return;
+		}
+		bool debug_verbose_tests = false;
+		SystemFlags::VERBOSE_MODE_ENABLED = debug_verbose_tests;
+
+		const int portNumber = 61495;
+		ServerSocket server(true);
+		server.setBindPort(portNumber);
+		server.bind(portNumber);
+		server.listen(4);
+
+		ClientSocket client;
+		client.connect(Ip("127.0.0.1"), portNumber);
+		CPPUNIT_ASSERT_EQUAL( true, client.isConnected() );
+		Socket *accepted = acceptClient(server);
+		CPPUNIT_ASSERT( accepted != NULL );
+
+		// A new watch signals once for data that came before it
+		Semaphore readReady;
+		CPPUNIT_ASSERT_EQUAL( true, SocketReadReactor::watchSocket(&readReady, accepted) );
+		CPPUNIT_ASSERT_EQUAL( true, readReady.tryDecrement() );
+		CPPUNIT_ASSERT_EQUAL( false, readReady.tryDecrement() );
+
+		// Watching it again changes nothing
+		CPPUNIT_ASSERT_EQUAL( true, SocketReadReactor::watchSocket(&readReady, accepted) );
+		CPPUNIT_ASSERT_EQUAL( false, readReady.tryDecrement() );
+
+		CPPUNIT_ASSERT_EQUAL( true, sendByte(client) );
+		CPPUNIT_ASSERT_EQUAL( 0, readReady.waitTillSignalled(2000) );
+
+		// A closed socket is no longer watched, its replacement is
+		// watched from scratch even if it gets the same descriptor
+		delete accepted;
+		ClientSocket secondClient;
+		secondClient.connect(Ip("127.0.0.1"), portNumber);
+		CPPUNIT_ASSERT_EQUAL( true, secondClient.isConnected() );
+		accepted = acceptClient(server);
+		CPPUNIT_ASSERT( accepted != NULL );
+
+		CPPUNIT_ASSERT_EQUAL( true, SocketReadReactor::watchSocket(&readReady, accepted) );
+		CPPUNIT_ASSERT_EQUAL( 0, readReady.waitTillSignalled(2000) );
+		for(;readReady.tryDecrement() == true;) {
+		}
+		CPPUNIT_ASSERT_EQUAL( true, sendByte(secondClient) );
+		CPPUNIT_ASSERT_EQUAL( 0, readReady.waitTillSignalled(2000) );
+
+		SocketReadReactor::unwatchSocket(&readReady);
+		delete accepted;
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( SocketReadReactorTest );
@@ -0,0 +1,379 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "spectator_feed.h"
+#include "platform_common.h"
+#include "util.h"
+#include "conversion.h"
+#include <vector>
+
+#ifndef WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
+
+// Runs a relay until its feed is over, in its own process
+// where it can, the way it runs next to a real server
+static int runRelay(int listenPort, int upstreamPort) {
+	SpectatorFeedServerThread *relay = new SpectatorFeedServerThread(listenPort, 0, 0);
+	relay->setUpstream("127.0.0.1", upstreamPort);
+	relay->start();
+	for(sleep(250); relay->getRunningStatus() == true;) {
+		sleep(100);
+	}
+	bool ended = relay->isEnded();
+	relay->shutdownAndWait();
+	delete relay;
+	return (ended == true ? 0 : 1);
+}
+
+//
+// Tests for the spectator feed, its relay and its viewers
+//
+class SpectatorFeedTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( SpectatorFeedTest );
+
+	CPPUNIT_TEST( test_snapshot_payload_roundtrip );
+	CPPUNIT_TEST( test_delayed_feed_through_relay_process );
+	CPPUNIT_TEST( test_snapshot_published_after_its_frames );
+	CPPUNIT_TEST( test_snapshots_built_by_feed );
+	CPPUNIT_TEST( test_stalled_viewer_does_not_delay_others );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+private:
+
+	// Lists the frames it was given, the way the server lists commands
+	class FrameListBuilder : public SpectatorSnapshotBuilderInterface {
+	public:
+		string frames;
+
+		FrameListBuilder() : frames("frames") {}
+
+		virtual void SpectatorFeed_AddFrame(int32 frame, const vector<unsigned char> &payload) {
+			frames += " " + intToStr(frame);
+		}
+		virtual bool SpectatorFeed_BuildSnapshot(int32 frame, string &data) {
+			data = frames;
+			return true;
+		}
+	};
+
+	static vector<unsigned char> toPayload(const string &text) {
+		return vector<unsigned char>(text.begin(), text.end());
+	}
+
+	// Waits for the next record, false on timeout or disconnect
+	static bool receive(SpectatorFeedClient &client, SpectatorRecord &record, int timeoutMillis) {
+		int64 start = Chrono::getCurMillis();
+		while(Chrono::getCurMillis() - start < timeoutMillis) {
+			if(client.receiveRecord(record, 100) == true) {
+				return true;
+			}
+			if(client.isConnected() == false) {
+				return false;
+			}
+		}
+		return false;
+	}
+
+	static bool connect(SpectatorFeedClient &client) {
+		for(int attempt = 0; attempt < 20; ++attempt) {
+			if(client.connect() == true) {
+				return true;
+			}
+			sleep(250);
+		}
+		return false;
+	}
+
+public:
+
+	void test_snapshot_payload_roundtrip() {
+		string file = "spectator_feed_test.xml";
+		string data = "";
+		for(int index = 0; index < 1000; ++index) {
+			data += "<NetworkCommand worldFrameCount=\"" + intToStr(index) + "\"/>\n";
+		}
+		FILE *fp = fopen(file.c_str(), "wb");
+		CPPUNIT_ASSERT( fp != NULL );
+		fwrite(data.c_str(), 1, data.size(), fp);
+		fclose(fp);
+
+		SpectatorRecord record;
+		CPPUNIT_ASSERT_EQUAL( true, record.loadPayloadFromFile(file) );
+		CPPUNIT_ASSERT( record.payload.size() < data.size() );
+		removeFile(file);
+
+		CPPUNIT_ASSERT_EQUAL( true, record.savePayloadToFile(file) );
+		fp = fopen(file.c_str(), "rb");
+		CPPUNIT_ASSERT( fp != NULL );
+		vector<char> readBack(data.size() + 1);
+		size_t readBytes = fread(&readBack[0], 1, readBack.size(), fp);
+		fclose(fp);
+		removeFile(file);
+		CPPUNIT_ASSERT_EQUAL( data, string(&readBack[0], readBytes) );
+
+		string readData;
+		CPPUNIT_ASSERT_EQUAL( true, record.getPayloadData(readData) );
+		CPPUNIT_ASSERT_EQUAL( data, readData );
+		SpectatorRecord memoryRecord;
+		CPPUNIT_ASSERT_EQUAL( true, memoryRecord.setPayloadData(data) );
+		CPPUNIT_ASSERT( memoryRecord.payload == record.payload );
+
+		// A truncated snapshot must not be written out
+		record.payload.resize(record.payload.size() / 2);
+		CPPUNIT_ASSERT_EQUAL( false, record.savePayloadToFile(file) );
+		removeFile(file);
+	}
+
+	void test_delayed_feed_through_relay_process() {
+		bool debug_verbose_tests = false;
+		SystemFlags::VERBOSE_MODE_ENABLED = debug_verbose_tests;
+
+		const int originPort	= 61491;
+		const int relayPort		= 61492;
+		const int delayMillis	= 1000;
+
+#ifndef WIN32
+		// Fork before any thread runs in this process
+		pid_t relayPid = fork();
+		CPPUNIT_ASSERT( relayPid >= 0 );
+		if(relayPid == 0) {
+			_exit(runRelay(relayPort, originPort));
+		}
+#else
+		class RelayThread : public BaseThread {
+		public:
+			int result;
+			RelayThread() : result(-1) {}
+			virtual void execute() {
+				RunningStatusSafeWrapper runningStatus(this);
+				result = runRelay(61492, 61491);
+			}
+		};
+		RelayThread *relayThread = new RelayThread();
+		relayThread->start();
+#endif
+
+		SpectatorFeedServerThread *origin = new SpectatorFeedServerThread(originPort, delayMillis / 1000, 0);
+		origin->start();
+		origin->addRecord(srt_Snapshot, 0, toPayload("snapshot 0"));
+
+		// The first viewer gets nothing before the delay has passed
+		SpectatorFeedClient early("127.0.0.1", originPort);
+		CPPUNIT_ASSERT_EQUAL( true, connect(early) );
+		int64 published = Chrono::getCurMillis();
+		origin->addRecord(srt_Frame, 10, toPayload("frame 10"));
+
+		SpectatorRecord record;
+		CPPUNIT_ASSERT_EQUAL( true, receive(early, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Snapshot, record.type );
+		CPPUNIT_ASSERT_EQUAL( true, receive(early, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Frame, record.type );
+		CPPUNIT_ASSERT_EQUAL( (int32)10, record.frame );
+		CPPUNIT_ASSERT( Chrono::getCurMillis() - published >= delayMillis - 50 );
+
+		// The relay keeps every snapshot, viewers only start from one
+		SpectatorFeedClient relayed("127.0.0.1", relayPort);
+		CPPUNIT_ASSERT_EQUAL( true, connect(relayed) );
+
+		origin->addRecord(srt_Snapshot, 20, toPayload("snapshot 20"));
+		origin->addRecord(srt_Frame, 30, toPayload("frame 30"));
+		sleep(delayMillis + 500);
+
+		// A late viewer starts at the newest released snapshot
+		SpectatorFeedClient late("127.0.0.1", originPort);
+		CPPUNIT_ASSERT_EQUAL( true, connect(late) );
+		CPPUNIT_ASSERT_EQUAL( true, receive(late, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Snapshot, record.type );
+		CPPUNIT_ASSERT_EQUAL( (int32)20, record.frame );
+		CPPUNIT_ASSERT_EQUAL( string("snapshot 20"), string(record.payload.begin(), record.payload.end()) );
+		CPPUNIT_ASSERT_EQUAL( true, receive(late, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (int32)30, record.frame );
+
+		CPPUNIT_ASSERT_EQUAL( true, receive(early, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Frame, record.type );
+		CPPUNIT_ASSERT_EQUAL( (int32)30, record.frame );
+
+		// Through the relay: some snapshot first, then up to frame 30
+		CPPUNIT_ASSERT_EQUAL( true, receive(relayed, record, 10000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Snapshot, record.type );
+		for(;record.frame < 30;) {
+			CPPUNIT_ASSERT_EQUAL( true, receive(relayed, record, 10000) );
+		}
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Frame, record.type );
+
+		origin->endFeed();
+		CPPUNIT_ASSERT_EQUAL( true, receive(early, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_End, record.type );
+		CPPUNIT_ASSERT_EQUAL( true, receive(late, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_End, record.type );
+		CPPUNIT_ASSERT_EQUAL( true, receive(relayed, record, 10000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_End, record.type );
+		early.disconnect();
+		late.disconnect();
+		relayed.disconnect();
+
+#ifndef WIN32
+		int status = -1;
+		CPPUNIT_ASSERT_EQUAL( relayPid, waitpid(relayPid, &status, 0) );
+		CPPUNIT_ASSERT( WIFEXITED(status) );
+		CPPUNIT_ASSERT_EQUAL( 0, WEXITSTATUS(status) );
+#else
+		for(;relayThread->getRunningStatus() == true;) {
+			sleep(100);
+		}
+		CPPUNIT_ASSERT_EQUAL( 0, relayThread->result );
+		relayThread->shutdownAndWait();
+		delete relayThread;
+#endif
+
+		origin->shutdownAndWait();
+		delete origin;
+	}
+
+	void test_snapshot_published_after_its_frames() {
+		bool debug_verbose_tests = false;
+		SystemFlags::VERBOSE_MODE_ENABLED = debug_verbose_tests;
+
+		const int originPort = 61493;
+		SpectatorFeedServerThread *origin = new SpectatorFeedServerThread(originPort, 0, 0);
+		origin->start();
+
+		// The snapshot of frame 10 was still being built when frame 20 came
+		origin->addRecord(srt_Snapshot, 0, toPayload("snapshot 0"));
+		origin->addRecord(srt_Frame, 10, toPayload("frame 10"));
+		origin->addRecord(srt_Frame, 20, toPayload("frame 20"));
+		origin->addRecord(srt_Snapshot, 10, toPayload("snapshot 10"));
+		origin->addRecord(srt_Frame, 30, toPayload("frame 30"));
+
+		SpectatorFeedClient viewer("127.0.0.1", originPort);
+		CPPUNIT_ASSERT_EQUAL( true, connect(viewer) );
+		SpectatorRecord record;
+		CPPUNIT_ASSERT_EQUAL( true, receive(viewer, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Snapshot, record.type );
+		CPPUNIT_ASSERT_EQUAL( (int32)10, record.frame );
+		CPPUNIT_ASSERT_EQUAL( true, receive(viewer, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Frame, record.type );
+		CPPUNIT_ASSERT_EQUAL( (int32)20, record.frame );
+		CPPUNIT_ASSERT_EQUAL( true, receive(viewer, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Frame, record.type );
+		CPPUNIT_ASSERT_EQUAL( (int32)30, record.frame );
+
+		origin->endFeed();
+		CPPUNIT_ASSERT_EQUAL( true, receive(viewer, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_End, record.type );
+		viewer.disconnect();
+
+		origin->shutdownAndWait();
+		delete origin;
+	}
+
+	void test_snapshots_built_by_feed() {
+		bool debug_verbose_tests = false;
+		SystemFlags::VERBOSE_MODE_ENABLED = debug_verbose_tests;
+
+		const int originPort = 61494;
+		SpectatorFeedServerThread *origin = new SpectatorFeedServerThread(originPort, 0, 0);
+		origin->setSnapshotBuilder(new FrameListBuilder(), 1);
+		origin->start();
+
+		// The first snapshot is built right away
+		SpectatorFeedClient early("127.0.0.1", originPort);
+		CPPUNIT_ASSERT_EQUAL( true, connect(early) );
+		SpectatorRecord record;
+		string data;
+		CPPUNIT_ASSERT_EQUAL( true, receive(early, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Snapshot, record.type );
+		CPPUNIT_ASSERT_EQUAL( (int32)0, record.frame );
+		CPPUNIT_ASSERT_EQUAL( true, record.getPayloadData(data) );
+		CPPUNIT_ASSERT_EQUAL( string("frames"), data );
+
+		// Later ones from the frames published since
+		origin->addRecord(srt_Frame, 10, toPayload("frame 10"));
+		origin->addRecord(srt_Frame, 20, toPayload("frame 20"));
+		sleep(2500);
+
+		SpectatorFeedClient late("127.0.0.1", originPort);
+		CPPUNIT_ASSERT_EQUAL( true, connect(late) );
+		CPPUNIT_ASSERT_EQUAL( true, receive(late, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Snapshot, record.type );
+		CPPUNIT_ASSERT_EQUAL( (int32)20, record.frame );
+		CPPUNIT_ASSERT_EQUAL( true, record.getPayloadData(data) );
+		CPPUNIT_ASSERT_EQUAL( string("frames 10 20"), data );
+
+		origin->addRecord(srt_Frame, 30, toPayload("frame 30"));
+		CPPUNIT_ASSERT_EQUAL( true, receive(late, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Frame, record.type );
+		CPPUNIT_ASSERT_EQUAL( (int32)30, record.frame );
+
+		// Viewers already watching only get the frames
+		for(int32 frame = 10; frame <= 30; frame += 10) {
+			CPPUNIT_ASSERT_EQUAL( true, receive(early, record, 5000) );
+			CPPUNIT_ASSERT_EQUAL( (uint8)srt_Frame, record.type );
+			CPPUNIT_ASSERT_EQUAL( frame, record.frame );
+		}
+		early.disconnect();
+		late.disconnect();
+
+		origin->shutdownAndWait();
+		delete origin;
+	}
+
+	void test_stalled_viewer_does_not_delay_others() {
+		bool debug_verbose_tests = false;
+		SystemFlags::VERBOSE_MODE_ENABLED = debug_verbose_tests;
+
+		const int originPort = 61496;
+		SpectatorFeedServerThread *origin = new SpectatorFeedServerThread(originPort, 0, 0);
+		origin->start();
+		origin->addRecord(srt_Snapshot, 0, toPayload("snapshot 0"));
+
+		// Connected, but never reads a byte
+		SpectatorFeedClient stalled("127.0.0.1", originPort);
+		CPPUNIT_ASSERT_EQUAL( true, connect(stalled) );
+		SpectatorFeedClient viewer("127.0.0.1", originPort);
+		CPPUNIT_ASSERT_EQUAL( true, connect(viewer) );
+		SpectatorRecord record;
+		CPPUNIT_ASSERT_EQUAL( true, receive(viewer, record, 5000) );
+		CPPUNIT_ASSERT_EQUAL( (uint8)srt_Snapshot, record.type );
+
+		// Far more than the socket buffers of the stalled viewer hold
+		const vector<unsigned char> payload(512 * 1024, 'x');
+		for(int32 frame = 1; frame <= 64; ++frame) {
+			int64 published = Chrono::getCurMillis();
+			origin->addRecord(srt_Frame, frame, payload);
+			CPPUNIT_ASSERT_EQUAL( true, receive(viewer, record, 5000) );
+			CPPUNIT_ASSERT_EQUAL( frame, record.frame );
+			CPPUNIT_ASSERT( Chrono::getCurMillis() - published < 1000 );
+		}
+
+		// Its backlog grew past the limit and it was dropped
+		for(int attempt = 0; attempt < 20 && origin->getSpectatorCount() != 1; ++attempt) {
+			sleep(100);
+		}
+		CPPUNIT_ASSERT_EQUAL( 1, origin->getSpectatorCount() );
+		stalled.disconnect();
+		viewer.disconnect();
+
+		origin->shutdownAndWait();
+		delete origin;
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( SpectatorFeedTest );
@@ -245,6 +245,8 @@ class XmlTreeTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST( test_init );
 	CPPUNIT_TEST_EXCEPTION( test_load_simultaneously_same_file,  megaglest_runtime_error );
 	CPPUNIT_TEST( test_load_simultaneously_different_file );
+	CPPUNIT_TEST( test_save_load_string );
+	CPPUNIT_TEST_EXCEPTION( test_load_string_malformed,  megaglest_runtime_error );
 
 	CPPUNIT_TEST_SUITE_END();
 	// End of Fixture registration
@@ -314,6 +316,25 @@ public:
 		XmlTree xmlInstance2;
 		xmlInstance2.load(test_filename2, std::map<string,string>());
 	}
+	void test_save_load_string() {
+		XmlTree xmlInstance;
+		xmlInstance.init("snapshot");
+		xmlInstance.getRootNode()->addChild("Game")->addAttribute("frame", "20", std::map<string,string>());
+
+		string xml;
+		xmlInstance.saveToString(xml);
+		CPPUNIT_ASSERT( xml.empty() == false );
+
+		XmlTree loaded;
+		loaded.loadFromString(xml, std::map<string,string>());
+		CPPUNIT_ASSERT( loaded.getRootNode() != NULL );
+		CPPUNIT_ASSERT_EQUAL( string("snapshot"), loaded.getRootNode()->getName() );
+		CPPUNIT_ASSERT_EQUAL( 20, loaded.getRootNode()->getChild("Game")->getAttribute("frame")->getIntValue() );
+	}
+	void test_load_string_malformed() {
+		XmlTree xmlInstance;
+		xmlInstance.loadFromString("<snapshot><Game></snapshot>", std::map<string,string>());
+	}
 };
 
 